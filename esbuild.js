@@ -1,9 +1,43 @@
 const esbuild = require('esbuild');
+const fs = require('fs');
+const path = require('path');
 
 const production = process.argv.includes('--production');
 const watch = process.argv.includes('--watch');
 
+const mediaDir = 'dist/media';
+
+// Webview viewer scripts, served from dist/media through asWebviewUri
+const viewerEntries = {
+  matViewer: 'src/matImage/matViewer.js',
+  matCompareViewer: 'src/matImage/matCompareViewer.js',
+  threadGridViewer: 'src/threads/threadGridViewer.js',
+  plotViewer: 'src/plot/plotViewer.js',
+  pointCloudViewer: 'src/pointCloud/pointCloudViewer.js'
+};
+
 async function main() {
+  const webviewCtx = await esbuild.context({
+    entryPoints: viewerEntries,
+    bundle: true,
+    format: 'iife',
+    platform: 'browser',
+    target: 'es2022',
+    // Identifiers are kept: the viewers build worker scripts from their own
+    // functions' source, which refers to the other functions by name
+    minifyWhitespace: production,
+    minifySyntax: production,
+    sourcemap: !production,
+    sourcesContent: false,
+    outdir: mediaDir,
+    entryNames: '[name]-[hash]',
+    metafile: true,
+    logLevel: 'warning',
+    plugins: [
+      viewerManifestPlugin,
+      esbuildProblemMatcherPlugin
+    ]
+  });
   const ctx = await esbuild.context({
     entryPoints: ['src/extension.ts'],
     bundle: true,
@@ -21,13 +55,43 @@ async function main() {
     ]
   });
   if (watch) {
+    await webviewCtx.watch();
     await ctx.watch();
   } else {
+    await webviewCtx.rebuild();
+    await webviewCtx.dispose();
     await ctx.rebuild();
     await ctx.dispose();
   }
 }
 
+/**
+ * Writes dist/media/manifest.json (viewer name -> hashed file name) for
+ * WebviewAssets and removes bundles left over from earlier builds.
+ * @type {import('esbuild').Plugin}
+ */
+const viewerManifestPlugin = {
+  name: 'viewer-manifest',
+
+  setup(build) {
+    build.onEnd(result => {
+      if (!result.metafile) return;
+      const manifest = {};
+      const keep = new Set(['manifest.json']);
+      for (const [output, info] of Object.entries(result.metafile.outputs)) {
+        const file = path.basename(output);
+        keep.add(file);
+        const entry = Object.entries(viewerEntries).find(([, source]) => source === info.entryPoint);
+        if (entry) manifest[entry[0]] = file;
+      }
+      fs.writeFileSync(path.join(mediaDir, 'manifest.json'), JSON.stringify(manifest, null, 2));
+      for (const file of fs.readdirSync(mediaDir)) {
+        if (!keep.has(file)) fs.unlinkSync(path.join(mediaDir, file));
+      }
+    });
+  }
+};
+
 /**
  * @type {import('esbuild').Plugin}
  */
@@ -1,5 +1,5 @@
 import * as vscode from 'vscode';
-import { isMat, isPoint3Vector, is1DVector, isLikely1DMat, is1DSet, isMatx, is2DStdArray, is1DStdArray, isPoint3StdArray, is2DCStyleArray, is1DCStyleArray, is3DCStyleArray, is3DStdArray, isUninitializedOrInvalid, isUninitializedMat, isUninitializedMatFromChildren, isUninitializedVector, isPointerType, getPointerEvaluateExpression, isPCLPointCloudType } from './utils/opencv';
+import { isMat, isPoint3Vector, is1DVector, isLikely1DMat, is1DSet, isMatx, is2DStdArray, is1DStdArray, isPoint3StdArray, is2DCStyleArray, is1DCStyleArray, is3DCStyleArray, is3DStdArray, isUninitializedOrInvalid, isUninitializedMat, isUninitializedMatFromChildren, isUninitializedVector, isPointerType, isPCLPointCloudType } from './utils/opencv';
 import { SyncManager } from './utils/syncManager';
 import { PanelManager } from './utils/panelManager';
 
@@ -35,6 +35,84 @@ function getColoredIcon(kind: 'mat' | 'pointcloud' | 'plot' | 'group', color: st
     return { light: iconUri, dark: iconUri };
 }
 
+// ============== Variable classification ==============
+
+/**
+ * What the type string alone says about a variable. isMatx, isPoint3Vector,
+ * is1DVector and is1DSet also read sizes from the value; those are redone per
+ * variable when the type matches.
+ */
+interface TypeClassification {
+    isMat: boolean;
+    matx: ReturnType<typeof isMatx>;
+    // Generic cv::Matx whose dimensions can only be guessed from the value
+    matxFromValue: boolean;
+    point3: ReturnType<typeof isPoint3Vector>;
+    vector1D: ReturnType<typeof is1DVector>;
+    set1D: ReturnType<typeof is1DSet>;
+    pclInfo: ReturnType<typeof isPCLPointCloudType>;
+    stdArray2D: ReturnType<typeof is2DStdArray>;
+    stdArray1D: ReturnType<typeof is1DStdArray>;
+    stdArrayPoint3: ReturnType<typeof isPoint3StdArray>;
+    stdArray3D: ReturnType<typeof is3DStdArray>;
+    cStyleArray2D: ReturnType<typeof is2DCStyleArray>;
+    cStyleArray1D: ReturnType<typeof is1DCStyleArray>;
+    cStyleArray3D: ReturnType<typeof is3DCStyleArray>;
+}
+
+interface TypeEntry {
+    pointerInfo: { isPointer: boolean; baseType: string };
+    // null when no visualizer handles the type
+    classification: TypeClassification | null;
+}
+
+function classifyTypeString(type: string): TypeClassification | null {
+    const info = { type };
+    const matx = isMatx(info);
+    const c: TypeClassification = {
+        isMat: isMat(info),
+        matx,
+        matxFromValue: !matx.isMatx && /cv::Matx\b/.test(type),
+        point3: isPoint3Vector(info),
+        vector1D: is1DVector(info),
+        set1D: is1DSet(info),
+        pclInfo: isPCLPointCloudType(type),
+        stdArray2D: is2DStdArray(info),
+        stdArray1D: is1DStdArray(info),
+        stdArrayPoint3: isPoint3StdArray(info),
+        stdArray3D: is3DStdArray(info),
+        cStyleArray2D: is2DCStyleArray(info),
+        cStyleArray1D: is1DCStyleArray(info),
+        cStyleArray3D: is3DCStyleArray(info)
+    };
+    const visualizable = c.isMat || c.matx.isMatx || c.matxFromValue || c.point3.isPoint3 || c.vector1D.is1D || c.set1D.isSet ||
+        c.pclInfo.isPCL || c.stdArray2D.is2DArray || c.stdArray1D.is1DArray || c.stdArrayPoint3.isPoint3Array ||
+        c.stdArray3D.is3DArray || c.cStyleArray2D.is2DArray || c.cStyleArray1D.is1DArray || c.cStyleArray3D.is3DArray;
+    return visualizable ? c : null;
+}
+
+// ============== Deferred probes ==============
+
+/**
+ * Some details need debugger round trips: the members of a cv::Mat (real size,
+ * 1D-ness, signs of being uninitialized) and size() of containers whose summary
+ * has none (GDB). These run PROBE_CONCURRENCY at a time after the tree is shown,
+ * and the tree is redrawn with their answers.
+ */
+interface ProbeResult {
+    uninitialized?: boolean;
+    rows?: number;
+    cols?: number;
+    size1D?: number;
+    size?: number;
+}
+
+const PROBE_CONCURRENCY = 4;
+const PROBE_REFRESH_MS = 100;
+const PROBE_PENDING: ProbeResult = {};
+// Size shown while a probe is outstanding
+const PENDING_SIZE = '…';
+
 function getColoredCircleIcon(color: string): { light: vscode.Uri, dark: vscode.Uri } {
     // Create a simple filled circle SVG
     const svg = `<svg xmlns="http://www.w3.org/2000/svg" viewBox="0 0 16 16" width="16" height="16"><circle cx="8" cy="8" r="6" fill="${color}"/></svg>`;
@@ -165,6 +243,15 @@ export class CVVariablesProvider implements vscode.TreeDataProvider<CVVariable |
 
     private variables: CVVariable[] = [];
     private groups: CVGroup[] = [];
+
+    private typeCache = new Map<string, TypeEntry>();
+    private typeCacheSession: string | undefined;
+
+    private probeKey = '';
+    private probeResults = new Map<string, ProbeResult>();
+    private probeQueue: (() => Promise<void>)[] = [];
+    private probesRunning = 0;
+    private probeRefreshTimer: NodeJS.Timeout | undefined;
     
     refresh(): void {
         this._onDidChangeTreeData.fire();
@@ -267,21 +354,19 @@ export class CVVariablesProvider implements vscode.TreeDataProvider<CVVariable |
             }
             
             const scopesResponse = await debugSession.customRequest('scopes', { frameId });
-            
+            this.beginProbes(`${debugSession.id}:${frameId}:${PanelManager.getDebugStateVersion()}`);
+
             const visualizableVariables: CVVariable[] = [];
-            const variablePromises: Promise<CVVariable | null>[] = [];
-            
+
             for (const scope of scopesResponse.scopes) {
                 const variablesResponse = await debugSession.customRequest('variables', {
                     variablesReference: scope.variablesReference
                 });
-                
+
                 for (const v of variablesResponse.variables) {
                     const variableName = v.evaluateName || v.name;
-                    
-                    // Check if this is a pointer type
-                    const pointerInfo = isPointerType(v.type || "");
-                    
+                    const { pointerInfo, classification } = this.classifyType(debugSession.id, v.type || "");
+
                     // Check if variable is uninitialized or invalid
                     const valueStr = v.value || v.result || "";
                     if (isUninitializedOrInvalid(valueStr)) {
@@ -310,12 +395,15 @@ export class CVVariablesProvider implements vscode.TreeDataProvider<CVVariable |
                         visualizableVariables.push(warningVar);
                         continue; // Skip further processing for this variable
                     }
-                    
+
+                    // Nothing we can visualize, whatever the value
+                    if (!classification) continue;
+
                     // For pointer types, we need to check the dereferenced type
                     // Create a virtual variableInfo with the base type for type checking
                     let typeCheckInfo = v;
                     let actualEvaluateName = variableName;
-                    
+
                     if (pointerInfo.isPointer) {
                         // Check if pointer is null
                         const ptrValue = v.value || "";
@@ -323,343 +411,22 @@ export class CVVariablesProvider implements vscode.TreeDataProvider<CVVariable |
                             console.log(`Pointer "${variableName}" is null, skipping`);
                             continue;
                         }
-                        
+
                         // Create a virtual type info with the base type for type checking
                         typeCheckInfo = {
                             ...v,
                             type: pointerInfo.baseType
                         };
                         actualEvaluateName = `(*${variableName})`;
-                        console.log(`Detected pointer type: ${v.type} -> base type: ${pointerInfo.baseType}`);
-                    }
-                    
-                    // Special check for cv::Mat - check if it has suspicious member values
-                    if (isUninitializedMat(typeCheckInfo)) {
-                        console.warn(`cv::Mat "${variableName}" appears to be uninitialized (suspicious member values)`);
-                        const warningVar = new CVVariable(
-                            variableName,
-                            v.type || 'cv::Mat',
-                            variableName,
-                            0,
-                            valueStr,
-                            vscode.TreeItemCollapsibleState.None,
-                            'mat',
-                            0,
-                            '⚠️ uninitialized Mat',
-                            false,
-                            undefined,
-                            undefined,
-                            pointerInfo.isPointer,
-                            pointerInfo.baseType
-                        );
-                        warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
-                        warningVar.tooltip = `cv::Mat appears to be uninitialized.\nSuspicious values detected (e.g., datastart=<not available>, unreasonable dimensions).\nValue: ${valueStr}`;
-                        warningVar.contextValue = 'cvVariable:uninitialized';
-                        visualizableVariables.push(warningVar);
-                        continue;
                     }
-                    
-                    const isM = isMat(typeCheckInfo);
-                    const matxInfo = isMatx(typeCheckInfo);
-                    const point3 = isPoint3Vector(typeCheckInfo);
-                    const vector1D = is1DVector(typeCheckInfo);
-                    const set1D = is1DSet(typeCheckInfo);
-                    // PCL detection (before std::array so the type string check is fast)
-                    const pclInfo = isPCLPointCloudType(typeCheckInfo.type || "");
-                    // std::array detection
-                    const stdArray2D = is2DStdArray(typeCheckInfo);
-                    const stdArray1D = is1DStdArray(typeCheckInfo);
-                    const stdArrayPoint3 = isPoint3StdArray(typeCheckInfo);
-                    const stdArray3D = is3DStdArray(typeCheckInfo);
-                    // C-style array detection
-                    const cStyleArray2D = is2DCStyleArray(typeCheckInfo);
-                    const cStyleArray1D = is1DCStyleArray(typeCheckInfo);
-                    const cStyleArray3D = is3DCStyleArray(typeCheckInfo);
-
-                    const checkVariable = async (): Promise<CVVariable | null> => {
-                        let is1DM = isLikely1DMat(typeCheckInfo);
-                        const confirmed1DSize = SyncManager.getConfirmed1DSize(variableName);
-                        let r = 0, c = 0;
-                        
-                        // For pointers, we need to get the dereferenced variable info
-                        let varRefToUse = v.variablesReference;
-                        if (pointerInfo.isPointer && v.variablesReference > 0) {
-                            try {
-                                // Get the dereferenced variable's children
-                                const derefChildren = await debugSession.customRequest('variables', {
-                                    variablesReference: v.variablesReference
-                                });
-                                // For pointers, the first child is usually the dereferenced value
-                                if (derefChildren.variables && derefChildren.variables.length > 0) {
-                                    const derefVar = derefChildren.variables[0];
-                                    if (derefVar.variablesReference > 0) {
-                                        varRefToUse = derefVar.variablesReference;
-                                    }
-                                }
-                            } catch (e) {
-                                console.log(`Failed to get dereferenced variable info for ${variableName}:`, e);
-                            }
-                        }
-                        
-                        if (isM) {
-                            const dimMatch = v.value.match(/\[\s*(\d+)\s*x\s*(\d+)\s*\]/) || v.value.match(/(\d+)\s*x\s*(\d+)/);
-                            if (dimMatch) {
-                                r = parseInt(dimMatch[1]);
-                                c = parseInt(dimMatch[2]);
-                            }
-                        }
-
-                        if (isM && varRefToUse > 0 && (r === 0 || c === 0 || (!is1DM.is1D && confirmed1DSize === undefined))) {
-                            try {
-                                const children = await debugSession.customRequest('variables', {
-                                    variablesReference: varRefToUse
-                                });
-                                
-                                // Check if Mat is uninitialized by examining children
-                                if (isUninitializedMatFromChildren(children.variables)) {
-                                    console.warn(`cv::Mat "${variableName}" appears to be uninitialized (from children analysis)`);
-                                    const warningVar = new CVVariable(
-                                        variableName,
-                                        v.type || 'cv::Mat',
-                                        variableName,
-                                        0,
-                                        v.value || '',
-                                        vscode.TreeItemCollapsibleState.None,
-                                        'mat',
-                                        0,
-                                        '⚠️ uninitialized',
-                                        false,
-                                        undefined,
-                                        undefined
-                                    );
-                                    warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
-                                    warningVar.tooltip = `cv::Mat appears to be uninitialized.\nDetected: datastart/dataend unavailable, unreasonable dimensions, or suspicious channel count.`;
-                                    warningVar.contextValue = 'cvVariable:uninitialized';
-                                    return warningVar;
-                                }
-                                
-                                let ch = 1;
-                                let matVarRef = 0;
-                                
-                                for (const child of children.variables) {
-                                    const val = parseInt(child.value);
-                                    if (child.name === 'rows') r = val;
-                                    else if (child.name === 'cols') c = val;
-                                    else if (child.name === 'flags') {
-                                        if (!isNaN(val)) ch = (((val & 0xFFF) >> 3) & 63) + 1;
-                                    }
-                                    // For cv::Mat_<T>, find the base cv::Mat member
-                                    else if ((child.name === 'cv::Mat' || child.name.includes('cv::Mat') || 
-                                              (child.name === 'Mat' && child.value?.includes('rows'))) && 
-                                             child.variablesReference > 0) {
-                                        matVarRef = child.variablesReference;
-                                    }
-                                }
-                                
-                                // If rows/cols not found directly, try from base cv::Mat member (for cv::Mat_<T>)
-                                if ((r === 0 || c === 0) && matVarRef > 0) {
-                                    const matChildren = await debugSession.customRequest('variables', {
-                                        variablesReference: matVarRef
-                                    });
-                                    for (const mc of matChildren.variables) {
-                                        const val = parseInt(mc.value);
-                                        if (mc.name === 'rows') r = val;
-                                        else if (mc.name === 'cols') c = val;
-                                        else if (mc.name === 'flags') {
-                                            if (!isNaN(val)) ch = (((val & 0xFFF) >> 3) & 63) + 1;
-                                        }
-                                    }
-                                }
-                                
-                                if (ch === 1 && (r === 1 || c === 1) && r * c > 0) {
-                                    is1DM = { is1D: true, size: r * c };
-                                    SyncManager.markAs1D(variableName, r * c);
-                                }
-                            } catch (e) {}
-                        }
-
-                        if (isM || matxInfo.isMatx || point3.isPoint3 || vector1D.is1D || set1D.isSet || is1DM.is1D || confirmed1DSize !== undefined ||
-                            stdArray2D.is2DArray || stdArray1D.is1DArray || stdArrayPoint3.isPoint3Array || cStyleArray2D.is2DArray || cStyleArray1D.is1DArray ||
-                            stdArray3D.is3DArray || cStyleArray3D.is3DArray || pclInfo.isPCL) {
-                            let kind: 'mat' | 'pointcloud' | 'plot' = 'mat';
-                            let size = 0;
-                            let sizeInfo = '';
-
-                            // pcl::PointCloud<T> - point cloud
-                            if (pclInfo.isPCL) {
-                                kind = 'pointcloud';
-                                // Try to get size from value string (size= pattern or width*height later)
-                                const sizeMatch = v.value?.match(/size=(\d+)/) ||
-                                                  v.value?.match(/\[(\d+)\]/);
-                                size = sizeMatch ? parseInt(sizeMatch[1]) : 0;
-                                sizeInfo = size > 0 ? `${size} points` : `pcl::${pclInfo.pointType}`;
-                            }
-                            // std::array<Point3f/d> - point cloud
-                            else if (stdArrayPoint3.isPoint3Array) {
-                                // Check for uninitialized
-                                if (isUninitializedVector(stdArrayPoint3.size)) {
-                                    const warningVar = new CVVariable(
-                                        variableName, v.type || 'std::array<Point3>', variableName, 0, v.value || '',
-                                        vscode.TreeItemCollapsibleState.None, 'pointcloud', 0, '⚠️ uninitialized',
-                                        false, undefined, undefined
-                                    );
-                                    warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
-                                    warningVar.tooltip = `Array appears to be uninitialized.\nSuspicious size: ${stdArrayPoint3.size}`;
-                                    warningVar.contextValue = 'cvVariable:uninitialized';
-                                    return warningVar;
-                                }
-                                kind = 'pointcloud';
-                                size = stdArrayPoint3.size;
-                                sizeInfo = size > 0 ? `${size} points` : '';
-                            }
-                            // std::vector<Point3f/d> - point cloud
-                            else if (point3.isPoint3) {
-                                kind = 'pointcloud';
-                                size = point3.size || 0;
-                                // Try to extract size from value if available
-                                if (size === 0) {
-                                    const sizeMatch = v.value.match(/size=(\d+)/) || 
-                                                      v.value.match(/of length (\d+)/) ||
-                                                      v.value.match(/\[(\d+)\]/);
-                                    if (sizeMatch) size = parseInt(sizeMatch[1]);
-                                }
-                                // GDB fallback: try evaluate
-                                if (size === 0) {
-                                    try {
-                                        const sizeResp = await debugSession.customRequest("evaluate", {
-                                            expression: `(long long)${variableName}.size()`,
-                                            frameId,
-                                            context: "watch"
-                                        });
-                                        const parsed = parseInt(sizeResp.result);
-                                        if (!isNaN(parsed) && parsed > 0) size = parsed;
-                                    } catch (e) {}
-                                }
-                                // Check for uninitialized after getting size
-                                if (isUninitializedVector(size)) {
-                                    const warningVar = new CVVariable(
-                                        variableName, v.type || 'std::vector<Point3>', variableName, 0, v.value || '',
-                                        vscode.TreeItemCollapsibleState.None, 'pointcloud', 0, '⚠️ uninitialized',
-                                        false, undefined, undefined
-                                    );
-                                    warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
-                                    warningVar.tooltip = `Vector appears to be uninitialized.\nSuspicious size: ${size}`;
-                                    warningVar.contextValue = 'cvVariable:uninitialized';
-                                    return warningVar;
-                                }
-                                sizeInfo = size > 0 ? `${size} points` : '';
-                            }
-                            // 1D std::array - plot
-                            else if (stdArray1D.is1DArray) {
-                                kind = 'plot';
-                                size = stdArray1D.size;
-                                sizeInfo = size > 0 ? `${size} elements` : '';
-                            }
-                            // 1D C-style array - plot
-                            else if (cStyleArray1D.is1DArray) {
-                                kind = 'plot';
-                                size = cStyleArray1D.size;
-                                sizeInfo = size > 0 ? `${size} elements` : '';
-                            }
-                            // 1D vector/set/Mat - plot
-                            else if (vector1D.is1D || set1D.isSet || is1DM.is1D || confirmed1DSize !== undefined) {
-                                kind = 'plot';
-                                size = confirmed1DSize || (vector1D.is1D ? vector1D.size : (set1D.isSet ? set1D.size : is1DM.size));
-                                // GDB fallback: try evaluate for vectors/sets
-                                if (size === 0 && (vector1D.is1D || set1D.isSet)) {
-                                    try {
-                                        const sizeResp = await debugSession.customRequest("evaluate", {
-                                            expression: `(long long)${variableName}.size()`,
-                                            frameId,
-                                            context: "watch"
-                                        });
-                                        const parsed = parseInt(sizeResp.result);
-                                        if (!isNaN(parsed) && parsed > 0) size = parsed;
-                                    } catch (e) {}
-                                }
-                                // Check for uninitialized vector/set
-                                if ((vector1D.is1D || set1D.isSet) && isUninitializedVector(size)) {
-                                    const typeName = vector1D.is1D ? `std::vector<${vector1D.elementType}>` : `std::set<${set1D.elementType}>`;
-                                    const warningVar = new CVVariable(
-                                        variableName, v.type || typeName, variableName, 0, v.value || '',
-                                        vscode.TreeItemCollapsibleState.None, 'plot', 0, '⚠️ uninitialized',
-                                        false, undefined, undefined
-                                    );
-                                    warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
-                                    warningVar.tooltip = `Container appears to be uninitialized.\nSuspicious size: ${size}`;
-                                    warningVar.contextValue = 'cvVariable:uninitialized';
-                                    return warningVar;
-                                }
-                                sizeInfo = size > 0 ? `${size} elements` : '';
-                            }
-                            // 3D std::array - multi-channel image
-                            else if (stdArray3D.is3DArray) {
-                                kind = 'mat';
-                                size = stdArray3D.height * stdArray3D.width * stdArray3D.channels;
-                                sizeInfo = `${stdArray3D.height}x${stdArray3D.width}x${stdArray3D.channels}`;
-                            }
-                            // 3D C-style array - multi-channel image
-                            else if (cStyleArray3D.is3DArray) {
-                                kind = 'mat';
-                                size = cStyleArray3D.height * cStyleArray3D.width * cStyleArray3D.channels;
-                                sizeInfo = `${cStyleArray3D.height}x${cStyleArray3D.width}x${cStyleArray3D.channels}`;
-                            }
-                            // 2D std::array - image
-                            else if (stdArray2D.is2DArray) {
-                                kind = 'mat';
-                                size = stdArray2D.rows * stdArray2D.cols;
-                                sizeInfo = `${stdArray2D.rows}x${stdArray2D.cols}`;
-                            }
-                            // cv::Matx - image
-                            else if (matxInfo.isMatx) {
-                                kind = 'mat';
-                                size = matxInfo.rows * matxInfo.cols;
-                                sizeInfo = `${matxInfo.rows}x${matxInfo.cols}`;
-                            }
-                            // 2D C-style array - image
-                            else if (cStyleArray2D.is2DArray) {
-                                kind = 'mat';
-                                size = cStyleArray2D.rows * cStyleArray2D.cols;
-                                sizeInfo = `${cStyleArray2D.rows}x${cStyleArray2D.cols}`;
-                            }
-                            // cv::Mat - image
-                            else if (isM) {
-                                kind = 'mat';
-                                size = r * c;
-                                sizeInfo = (r > 0 && c > 0) ? `${r}x${c}` : '';
-                            }
-                            
-                            const pairedVars = SyncManager.getPairedVariables(variableName);
-                            const groupIndex = SyncManager.getGroupIndex(variableName);
-                            return new CVVariable(
-                                v.name,
-                                v.type,
-                                pointerInfo.isPointer ? actualEvaluateName : variableName,
-                                v.variablesReference,
-                                v.value,
-                                vscode.TreeItemCollapsibleState.None,
-                                kind,
-                                size,
-                                sizeInfo,
-                                pairedVars.length > 0,
-                                pairedVars.length > 0 ? pairedVars.join(', ') : undefined,
-                                groupIndex,
-                                pointerInfo.isPointer,
-                                pointerInfo.baseType,
-                                debugSession.id  // Pass sessionId
-                            );
-                        }
-                        return null;
-                    };
 
-                    variablePromises.push(checkVariable());
+                    const res = this.buildVariable(debugSession, frameId, v, typeCheckInfo, variableName, actualEvaluateName, pointerInfo, classification);
+                    if (res) visualizableVariables.push(res);
                 }
             }
-            
-            const results = await Promise.all(variablePromises);
-            for (const res of results) {
-                if (res) visualizableVariables.push(res);
-            }
+
+            // The tree goes out now; debugger probes refine it once they answer
+            this.pumpProbes();
             
             this.variables = visualizableVariables;
             
@@ -737,4 +504,434 @@ export class CVVariablesProvider implements vscode.TreeDataProvider<CVVariable |
             return [];
         }
     }
+
+    /**
+     * Classification of a type string, computed once per session. Frames repeat
+     * the same few types, and most locals are of types we cannot visualize, so
+     * those are dismissed with a map lookup.
+     */
+    private classifyType(sessionId: string, type: string): TypeEntry {
+        if (this.typeCacheSession !== sessionId) {
+            this.typeCache.clear();
+            this.typeCacheSession = sessionId;
+        }
+        let entry = this.typeCache.get(type);
+        if (!entry) {
+            const pointerInfo = isPointerType(type);
+            entry = { pointerInfo, classification: classifyTypeString(pointerInfo.isPointer ? pointerInfo.baseType : type) };
+            this.typeCache.set(type, entry);
+        }
+        return entry;
+    }
+
+    /**
+     * Tree item for a variable already known to be of a visualizable type. Uses
+     * only what the variables response says; details that need a debugger round
+     * trip come from probes queued here and show as pending until they answer.
+     */
+    private buildVariable(
+        debugSession: vscode.DebugSession,
+        frameId: number,
+        v: any,
+        typeCheckInfo: any,
+        variableName: string,
+        actualEvaluateName: string,
+        pointerInfo: { isPointer: boolean; baseType: string },
+        classification: TypeClassification
+    ): CVVariable | null {
+        // Special check for cv::Mat - check if it has suspicious member values
+        const valueStr = v.value || v.result || "";
+        if (classification.isMat && isUninitializedMat(typeCheckInfo)) {
+            console.warn(`cv::Mat "${variableName}" appears to be uninitialized (suspicious member values)`);
+            const warningVar = new CVVariable(
+                variableName,
+                v.type || 'cv::Mat',
+                variableName,
+                0,
+                valueStr,
+                vscode.TreeItemCollapsibleState.None,
+                'mat',
+                0,
+                '⚠️ uninitialized Mat',
+                false,
+                undefined,
+                undefined,
+                pointerInfo.isPointer,
+                pointerInfo.baseType
+            );
+            warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
+            warningVar.tooltip = `cv::Mat appears to be uninitialized.\nSuspicious values detected (e.g., datastart=<not available>, unreasonable dimensions).\nValue: ${valueStr}`;
+            warningVar.contextValue = 'cvVariable:uninitialized';
+            return warningVar;
+        }
+
+        // Type-only results come from the cache; those with a size in the value string are redone
+        const isM = classification.isMat;
+        const matxInfo = classification.matxFromValue ? isMatx(typeCheckInfo) : classification.matx;
+        const point3 = classification.point3.isPoint3 ? isPoint3Vector(typeCheckInfo) : classification.point3;
+        const vector1D = classification.vector1D.is1D ? is1DVector(typeCheckInfo) : classification.vector1D;
+        const set1D = classification.set1D.isSet ? is1DSet(typeCheckInfo) : classification.set1D;
+        const {
+            pclInfo, stdArray2D, stdArray1D, stdArrayPoint3, stdArray3D, cStyleArray2D, cStyleArray1D, cStyleArray3D
+        } = classification;
+
+        const is1DM = isM ? isLikely1DMat(typeCheckInfo) : { is1D: false, size: 0 };
+        const confirmed1DSize = SyncManager.getConfirmed1DSize(variableName);
+        let r = 0, c = 0;
+        let matProbePending = false;
+
+        if (isM) {
+            const dimMatch = v.value.match(/\[\s*(\d+)\s*x\s*(\d+)\s*\]/) || v.value.match(/(\d+)\s*x\s*(\d+)/);
+            if (dimMatch) {
+                r = parseInt(dimMatch[1]);
+                c = parseInt(dimMatch[2]);
+            }
+        }
+
+        if (isM && v.variablesReference > 0 && (r === 0 || c === 0 || (!is1DM.is1D && confirmed1DSize === undefined))) {
+            const probe = this.probeMat(debugSession, v, variableName, pointerInfo.isPointer);
+            if (!probe) {
+                matProbePending = true;
+            } else if (probe.uninitialized) {
+                console.warn(`cv::Mat "${variableName}" appears to be uninitialized (from children analysis)`);
+                const warningVar = new CVVariable(
+                    variableName,
+                    v.type || 'cv::Mat',
+                    variableName,
+                    0,
+                    v.value || '',
+                    vscode.TreeItemCollapsibleState.None,
+                    'mat',
+                    0,
+                    '⚠️ uninitialized',
+                    false,
+                    undefined,
+                    undefined
+                );
+                warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
+                warningVar.tooltip = `cv::Mat appears to be uninitialized.\nDetected: datastart/dataend unavailable, unreasonable dimensions, or suspicious channel count.`;
+                warningVar.contextValue = 'cvVariable:uninitialized';
+                return warningVar;
+            } else {
+                if (probe.rows) r = probe.rows;
+                if (probe.cols) c = probe.cols;
+                if (probe.size1D) {
+                    is1DM.is1D = true;
+                    is1DM.size = probe.size1D;
+                }
+            }
+        }
+
+        if (isM || matxInfo.isMatx || point3.isPoint3 || vector1D.is1D || set1D.isSet || is1DM.is1D || confirmed1DSize !== undefined ||
+            stdArray2D.is2DArray || stdArray1D.is1DArray || stdArrayPoint3.isPoint3Array || cStyleArray2D.is2DArray || cStyleArray1D.is1DArray ||
+            stdArray3D.is3DArray || cStyleArray3D.is3DArray || pclInfo.isPCL) {
+            let kind: 'mat' | 'pointcloud' | 'plot' = 'mat';
+            let size = 0;
+            let sizeInfo = '';
+            let sizePending = false;
+
+            // pcl::PointCloud<T> - point cloud
+            if (pclInfo.isPCL) {
+                kind = 'pointcloud';
+                // Try to get size from value string (size= pattern or width*height later)
+                const sizeMatch = v.value?.match(/size=(\d+)/) ||
+                                  v.value?.match(/\[(\d+)\]/);
+                size = sizeMatch ? parseInt(sizeMatch[1]) : 0;
+                sizeInfo = size > 0 ? `${size} points` : `pcl::${pclInfo.pointType}`;
+            }
+            // std::array<Point3f/d> - point cloud
+            else if (stdArrayPoint3.isPoint3Array) {
+                // Check for uninitialized
+                if (isUninitializedVector(stdArrayPoint3.size)) {
+                    const warningVar = new CVVariable(
+                        variableName, v.type || 'std::array<Point3>', variableName, 0, v.value || '',
+                        vscode.TreeItemCollapsibleState.None, 'pointcloud', 0, '⚠️ uninitialized',
+                        false, undefined, undefined
+                    );
+                    warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
+                    warningVar.tooltip = `Array appears to be uninitialized.\nSuspicious size: ${stdArrayPoint3.size}`;
+                    warningVar.contextValue = 'cvVariable:uninitialized';
+                    return warningVar;
+                }
+                kind = 'pointcloud';
+                size = stdArrayPoint3.size;
+                sizeInfo = size > 0 ? `${size} points` : '';
+            }
+            // std::vector<Point3f/d> - point cloud
+            else if (point3.isPoint3) {
+                kind = 'pointcloud';
+                size = point3.size || 0;
+                // Try to extract size from value if available
+                if (size === 0) {
+                    const sizeMatch = v.value.match(/size=(\d+)/) || 
+                                      v.value.match(/of length (\d+)/) ||
+                                      v.value.match(/\[(\d+)\]/);
+                    if (sizeMatch) size = parseInt(sizeMatch[1]);
+                }
+                // GDB fallback: evaluate size() once the tree is shown
+                if (size === 0) {
+                    const probe = this.probeSize(debugSession, variableName, frameId);
+                    if (!probe) sizePending = true;
+                    else size = probe.size || 0;
+                }
+                // Check for uninitialized after getting size
+                if (isUninitializedVector(size)) {
+                    const warningVar = new CVVariable(
+                        variableName, v.type || 'std::vector<Point3>', variableName, 0, v.value || '',
+                        vscode.TreeItemCollapsibleState.None, 'pointcloud', 0, '⚠️ uninitialized',
+                        false, undefined, undefined
+                    );
+                    warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
+                    warningVar.tooltip = `Vector appears to be uninitialized.\nSuspicious size: ${size}`;
+                    warningVar.contextValue = 'cvVariable:uninitialized';
+                    return warningVar;
+                }
+                sizeInfo = size > 0 ? `${size} points` : (sizePending ? PENDING_SIZE : '');
+            }
+            // 1D std::array - plot
+            else if (stdArray1D.is1DArray) {
+                kind = 'plot';
+                size = stdArray1D.size;
+                sizeInfo = size > 0 ? `${size} elements` : '';
+            }
+            // 1D C-style array - plot
+            else if (cStyleArray1D.is1DArray) {
+                kind = 'plot';
+                size = cStyleArray1D.size;
+                sizeInfo = size > 0 ? `${size} elements` : '';
+            }
+            // 1D vector/set/Mat - plot
+            else if (vector1D.is1D || set1D.isSet || is1DM.is1D || confirmed1DSize !== undefined) {
+                kind = 'plot';
+                size = confirmed1DSize || (vector1D.is1D ? vector1D.size : (set1D.isSet ? set1D.size : is1DM.size));
+                // GDB fallback: evaluate size() for vectors/sets once the tree is shown
+                if (size === 0 && (vector1D.is1D || set1D.isSet)) {
+                    const probe = this.probeSize(debugSession, variableName, frameId);
+                    if (!probe) sizePending = true;
+                    else size = probe.size || 0;
+                }
+                // Check for uninitialized vector/set
+                if ((vector1D.is1D || set1D.isSet) && isUninitializedVector(size)) {
+                    const typeName = vector1D.is1D ? `std::vector<${vector1D.elementType}>` : `std::set<${set1D.elementType}>`;
+                    const warningVar = new CVVariable(
+                        variableName, v.type || typeName, variableName, 0, v.value || '',
+                        vscode.TreeItemCollapsibleState.None, 'plot', 0, '⚠️ uninitialized',
+                        false, undefined, undefined
+                    );
+                    warningVar.iconPath = new vscode.ThemeIcon('warning', new vscode.ThemeColor('problemsWarningIcon.foreground'));
+                    warningVar.tooltip = `Container appears to be uninitialized.\nSuspicious size: ${size}`;
+                    warningVar.contextValue = 'cvVariable:uninitialized';
+                    return warningVar;
+                }
+                sizeInfo = size > 0 ? `${size} elements` : (sizePending ? PENDING_SIZE : '');
+            }
+            // 3D std::array - multi-channel image
+            else if (stdArray3D.is3DArray) {
+                kind = 'mat';
+                size = stdArray3D.height * stdArray3D.width * stdArray3D.channels;
+                sizeInfo = `${stdArray3D.height}x${stdArray3D.width}x${stdArray3D.channels}`;
+            }
+            // 3D C-style array - multi-channel image
+            else if (cStyleArray3D.is3DArray) {
+                kind = 'mat';
+                size = cStyleArray3D.height * cStyleArray3D.width * cStyleArray3D.channels;
+                sizeInfo = `${cStyleArray3D.height}x${cStyleArray3D.width}x${cStyleArray3D.channels}`;
+            }
+            // 2D std::array - image
+            else if (stdArray2D.is2DArray) {
+                kind = 'mat';
+                size = stdArray2D.rows * stdArray2D.cols;
+                sizeInfo = `${stdArray2D.rows}x${stdArray2D.cols}`;
+            }
+            // cv::Matx - image
+            else if (matxInfo.isMatx) {
+                kind = 'mat';
+                size = matxInfo.rows * matxInfo.cols;
+                sizeInfo = `${matxInfo.rows}x${matxInfo.cols}`;
+            }
+            // 2D C-style array - image
+            else if (cStyleArray2D.is2DArray) {
+                kind = 'mat';
+                size = cStyleArray2D.rows * cStyleArray2D.cols;
+                sizeInfo = `${cStyleArray2D.rows}x${cStyleArray2D.cols}`;
+            }
+            // cv::Mat - image
+            else if (isM) {
+                kind = 'mat';
+                size = r * c;
+                sizeInfo = (r > 0 && c > 0) ? `${r}x${c}` : (matProbePending ? PENDING_SIZE : '');
+            }
+            
+            const pairedVars = SyncManager.getPairedVariables(variableName);
+            const groupIndex = SyncManager.getGroupIndex(variableName);
+            return new CVVariable(
+                v.name,
+                v.type,
+                pointerInfo.isPointer ? actualEvaluateName : variableName,
+                v.variablesReference,
+                v.value,
+                vscode.TreeItemCollapsibleState.None,
+                kind,
+                size,
+                sizeInfo,
+                pairedVars.length > 0,
+                pairedVars.length > 0 ? pairedVars.join(', ') : undefined,
+                groupIndex,
+                pointerInfo.isPointer,
+                pointerInfo.baseType,
+                debugSession.id  // Pass sessionId
+            );
+        }
+        return null;
+    }
+
+    // ============== Deferred debugger probes ==============
+
+    /**
+     * Start collecting probes for `key` (session, frame and debug state). Results
+     * of another key are dropped, and probes of it still running are ignored when
+     * they answer.
+     */
+    private beginProbes(key: string) {
+        if (key === this.probeKey) return;
+        this.probeKey = key;
+        this.probeResults.clear();
+        this.probeQueue = [];
+    }
+
+    /**
+     * The result of probe `id` for the current key, or undefined when it has not
+     * answered yet, in which case `run` is queued unless it already is.
+     */
+    private probe(id: string, run: () => Promise<ProbeResult>): ProbeResult | undefined {
+        const result = this.probeResults.get(id);
+        if (result === undefined) {
+            this.enqueueProbe(id, run);
+            return undefined;
+        }
+        return result === PROBE_PENDING ? undefined : result;
+    }
+
+    private enqueueProbe(id: string, run: () => Promise<ProbeResult>) {
+        const key = this.probeKey;
+        this.probeResults.set(id, PROBE_PENDING);
+        this.probeQueue.push(async () => {
+            let result: ProbeResult = {};
+            try {
+                result = await run();
+            } catch (e) {
+                console.log(`CVVariablesProvider: probe ${id} failed:`, e);
+            }
+            if (key !== this.probeKey) return;
+            this.probeResults.set(id, result);
+            this.scheduleProbeRefresh();
+        });
+    }
+
+    private pumpProbes() {
+        while (this.probesRunning < PROBE_CONCURRENCY && this.probeQueue.length > 0) {
+            const task = this.probeQueue.shift()!;
+            this.probesRunning++;
+            task().finally(() => {
+                this.probesRunning--;
+                this.pumpProbes();
+            });
+        }
+    }
+
+    // Answers arrive one by one; redraw the tree once per burst
+    private scheduleProbeRefresh() {
+        if (this.probeRefreshTimer) return;
+        this.probeRefreshTimer = setTimeout(() => {
+            this.probeRefreshTimer = undefined;
+            this._onDidChangeTreeData.fire();
+        }, PROBE_REFRESH_MS);
+    }
+
+    private probeSize(debugSession: vscode.DebugSession, variableName: string, frameId: number): ProbeResult | undefined {
+        return this.probe(`size:${variableName}`, async () => {
+            const sizeResp = await debugSession.customRequest("evaluate", {
+                expression: `(long long)${variableName}.size()`,
+                frameId,
+                context: "watch"
+            });
+            const parsed = parseInt(sizeResp.result);
+            return { size: !isNaN(parsed) && parsed > 0 ? parsed : 0 };
+        });
+    }
+
+    /**
+     * Rows, cols and 1D-ness of a cv::Mat from its members, or whether they look
+     * uninitialized. Pointers are dereferenced here, only for the Mats that need it.
+     */
+    private probeMat(debugSession: vscode.DebugSession, v: any, variableName: string, isPointer: boolean): ProbeResult | undefined {
+        return this.probe(`mat:${variableName}`, async () => {
+            let varRefToUse = v.variablesReference;
+            if (isPointer) {
+                try {
+                    // Get the dereferenced variable's children
+                    const derefChildren = await debugSession.customRequest('variables', {
+                        variablesReference: v.variablesReference
+                    });
+                    // For pointers, the first child is usually the dereferenced value
+                    if (derefChildren.variables && derefChildren.variables.length > 0) {
+                        const derefVar = derefChildren.variables[0];
+                        if (derefVar.variablesReference > 0) {
+                            varRefToUse = derefVar.variablesReference;
+                        }
+                    }
+                } catch (e) {
+                    console.log(`Failed to get dereferenced variable info for ${variableName}:`, e);
+                }
+            }
+
+            const children = await debugSession.customRequest('variables', {
+                variablesReference: varRefToUse
+            });
+
+            // Check if Mat is uninitialized by examining children
+            if (isUninitializedMatFromChildren(children.variables)) {
+                return { uninitialized: true };
+            }
+
+            let r = 0, c = 0, ch = 1;
+            let matVarRef = 0;
+
+            for (const child of children.variables) {
+                const val = parseInt(child.value);
+                if (child.name === 'rows') r = val;
+                else if (child.name === 'cols') c = val;
+                else if (child.name === 'flags') {
+                    if (!isNaN(val)) ch = (((val & 0xFFF) >> 3) & 63) + 1;
+                }
+                // For cv::Mat_<T>, find the base cv::Mat member
+                else if ((child.name === 'cv::Mat' || child.name.includes('cv::Mat') ||
+                          (child.name === 'Mat' && child.value?.includes('rows'))) &&
+                         child.variablesReference > 0) {
+                    matVarRef = child.variablesReference;
+                }
+            }
+
+            // If rows/cols not found directly, try from base cv::Mat member (for cv::Mat_<T>)
+            if ((r === 0 || c === 0) && matVarRef > 0) {
+                const matChildren = await debugSession.customRequest('variables', {
+                    variablesReference: matVarRef
+                });
+                for (const mc of matChildren.variables) {
+                    const val = parseInt(mc.value);
+                    if (mc.name === 'rows') r = val;
+                    else if (mc.name === 'cols') c = val;
+                    else if (mc.name === 'flags') {
+                        if (!isNaN(val)) ch = (((val & 0xFFF) >> 3) & 63) + 1;
+                    }
+                }
+            }
+
+            if (ch === 1 && (r === 1 || c === 1) && r * c > 0) {
+                SyncManager.markAs1D(variableName, r * c);
+                return { rows: r, cols: c, size1D: r * c };
+            }
+            return { rows: r, cols: c };
+        });
+    }
 }
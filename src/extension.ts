@@ -1,14 +1,21 @@
 import * as vscode from "vscode";
-import { getEvaluateContext, is2DStdArrayEnhanced, is2DCStyleArrayEnhanced, is1DCStyleArrayEnhanced, is3DCStyleArrayEnhanced, is3DStdArrayEnhanced } from "./utils/debugger";
+import { getEvaluateContext, initializeReadTuning, releaseDumpFiles, is2DStdArrayEnhanced, is2DCStyleArrayEnhanced, is1DCStyleArrayEnhanced, is3DCStyleArrayEnhanced, is3DStdArrayEnhanced } from "./utils/debugger";
 import { drawPointCloud, drawStdArrayPointCloud, drawPCLPointCloud } from "./pointCloud/pointCloudProvider";
 import { drawMatImage, drawMatxImage, draw2DStdArrayImage, draw3DArrayImage } from "./matImage/matProvider";
 import { drawPlot, drawStdArrayPlot, drawCStyleArrayPlot } from "./plot/plotProvider";
 import { CVVariablesProvider, CVVariable, CVGroup } from "./cvVariablesProvider";
 import { PanelManager } from "./utils/panelManager";
 import { SyncManager } from "./utils/syncManager";
+import { WebviewAssets } from "./utils/webviewAssets";
+import { FrameRecorder } from "./utils/frameRecorder";
+import { MatCompare } from "./matImage/matCompare";
+import { ThreadGrid } from "./threads/threadGrid";
+import { RefreshScheduler } from "./utils/refreshScheduler";
+import { TraceStatus } from "./utils/traceStatus";
+import { runCancellable, isReadCancelled } from "./utils/cancellation";
 import { isPoint3Vector, isMat, is1DVector, isLikely1DMat, is1DSet, isMatx, is2DStdArray, is1DStdArray, isPoint3StdArray, is2DCStyleArray, is1DCStyleArray, is3DCStyleArray, is3DStdArray, isUninitializedOrInvalid, isUninitializedMat, isUninitializedMatFromChildren, isUninitializedVector, isPointerType, getPointerEvaluateExpression, isPCLPointCloud } from "./utils/opencv";
 import { getMatInfoFromVariables } from "./matImage/matProvider";
-import { logDebug, logInfo, logError } from "./utils/logger";
+import { logDebug, logInfo, logError, runTraced, tracePanelId } from "./utils/logger";
 
 // Request management: cancel old requests when new ones arrive
 interface PendingRequest {
@@ -33,83 +40,53 @@ export function activate(context: vscode.ExtensionContext) {
   // This enables "Move into New Window" and "Copy into New Window" functionality
   PanelManager.initialize(context);
 
+  // Locate the bundled viewer scripts served to the webviews
+  WebviewAssets.initialize(context);
+
+  // Per-panel recordings across debug steps live in the extension's storage
+  FrameRecorder.initialize(context);
+
+  // Restore per-debugger readMemory chunk size / concurrency learned in earlier sessions
+  initializeReadTuning(context.globalState);
+
+  // Hot-path tracing (off unless cv-debugmate.tracing.enabled) and its status bar item
+  TraceStatus.initialize(context);
+
   const cvVariablesProvider = new CVVariablesProvider();
   vscode.window.registerTreeDataProvider("cv-debugmate-variables", cvVariablesProvider);
 
-  // Auto refresh when debug session stops or stack frame changes
-  let isRefreshing = false;
+  // Auto refresh when debug session stops or stack frame changes. Bursts of
+  // events coalesce into one refresh of the newest frame; reads still running
+  // for the frame being left are cancelled. Step refreshes let the panel's
+  // fingerprint decide whether anything is sent.
+  const refreshScheduler = new RefreshScheduler(
+    ({ variableName, force }) => visualizeVariable({ name: variableName, evaluateName: variableName }, force, false),
+    (sessionId) => {
+      for (const [key, request] of pendingRequests.entries()) {
+        if (key.startsWith(`${sessionId}:`)) {
+          request.cancel();
+          request.cancelled = true;
+        }
+      }
+    }
+  );
   context.subscriptions.push(
     vscode.debug.onDidChangeActiveStackItem(() => {
       cvVariablesProvider.refresh();
       // Debug position moved, increment global version
       PanelManager.incrementDebugStateVersion();
       // Step triggered: Refresh visible panels
-      if (!isRefreshing) {
-        refreshVisiblePanels(false);
+      refreshScheduler.request();
+      const session = vscode.debug.activeDebugSession;
+      if (session) {
+        ThreadGrid.refresh(session.id);
       }
     })
   );
 
-  async function refreshVisiblePanels(force: boolean = false) {
-    const debugSession = vscode.debug.activeDebugSession;
-    if (!debugSession) {
-      isRefreshing = false;
-      return;
-    }
-    
-    // Prevent concurrent refresh operations
-    if (isRefreshing) {
-      logDebug("Skipping refresh - already in progress");
-      return;
-    }
-    isRefreshing = true;
-
-    try {
-      const panels = PanelManager.getAllPanels();
-      const visiblePanels: { viewType: string; sessionId: string; variableName: string }[] = [];
-      
-      for (const [key, entry] of panels.entries()) {
-        // Skip panels that are being disposed
-        if ((entry.panel as any)._isDisposing) continue;
-        
-        if (entry.panel.visible) {
-          const parts = key.split(':::');
-          const [viewType, sessionId, variableName] = parts;
-          if (sessionId === debugSession.id) {
-            visiblePanels.push({ viewType, sessionId, variableName });
-          }
-        }
-      }
-      
-      // Double-check debug session is still active before refreshing
-      if (!vscode.debug.activeDebugSession || vscode.debug.activeDebugSession.id !== debugSession.id) {
-        logDebug("Debug session changed during refresh preparation, aborting");
-        return;
-      }
-      
-      // Limit concurrent refreshes to avoid overwhelming the debugger
-      const MAX_CONCURRENT = 2;
-      for (let i = 0; i < visiblePanels.length; i += MAX_CONCURRENT) {
-        // Check again before each batch
-        if (!vscode.debug.activeDebugSession || vscode.debug.activeDebugSession.id !== debugSession.id) {
-          logDebug("Debug session changed during refresh, aborting");
-          break;
-        }
-        
-        const batch = visiblePanels.slice(i, i + MAX_CONCURRENT);
-        await Promise.all(batch.map(async ({ variableName }) => {
-          try {
-            await visualizeVariable({ name: variableName, evaluateName: variableName }, true, false);
-          } catch (e) {
-            logDebug(`Failed to refresh panel for ${variableName}:`, e);
-          }
-        }));
-      }
-    } catch (e) {
-      logError("Error in refreshVisiblePanels:", e);
-    } finally {
-      isRefreshing = false;
-    }
+  // Panels shown again after missing steps; nothing in flight is stale
+  function refreshVisiblePanels() {
+    refreshScheduler.request(false);
   }
 
   // Clear when debug session terminates
@@ -117,6 +94,9 @@ export function activate(context: vscode.ExtensionContext) {
     vscode.debug.onDidTerminateDebugSession((session) => {
       cvVariablesProvider.refresh();
       PanelManager.closeSessionPanels(session.id);
+      MatCompare.closeSession(session.id);
+      ThreadGrid.closeSession(session.id);
+      releaseDumpFiles(session.id);
       SyncManager.clearAllStates(); // Clear all saved view states
     })
   );
@@ -234,6 +214,59 @@ export function activate(context: vscode.ExtensionContext) {
     })
   );
 
+  // Compare a Mat with a paired one
+  context.subscriptions.push(
+    vscode.commands.registerCommand("cv-debugmate.compareVariables", async (cvVar: CVVariable) => {
+      const debugSession = vscode.debug.activeDebugSession;
+      if (!debugSession) {
+        vscode.window.showErrorMessage("No active debug session.");
+        return;
+      }
+      const pairedVars = cvVariablesProvider.getPairedVariables(cvVar.name);
+      if (pairedVars.length === 0) {
+        vscode.window.showInformationMessage(`${cvVar.name} is not paired with another image.`);
+        return;
+      }
+      const other = pairedVars.length === 1
+        ? pairedVars[0]
+        : await vscode.window.showQuickPick(pairedVars, { placeHolder: `Select a variable to compare with ${cvVar.name}` });
+      if (!other) {
+        return;
+      }
+
+      const variables = cvVariablesProvider.getVariables();
+      await MatCompare.open(debugSession, cvVar.name, other, async (name) => {
+        const variable = variables.find(v => v.name === name) || { name, evaluateName: name };
+        await visualizeVariable(variable, false, false);
+      });
+    })
+  );
+
+  // Show a variable of every stopped thread in one grid
+  context.subscriptions.push(
+    vscode.commands.registerCommand("cv-debugmate.captureAcrossThreads", async (cvVar?: CVVariable) => {
+      const debugSession = vscode.debug.activeDebugSession;
+      if (!debugSession) {
+        vscode.window.showErrorMessage("No active debug session.");
+        return;
+      }
+      const name = cvVar?.evaluateName || cvVar?.name || await vscode.window.showInputBox({
+        prompt: "Variable to capture in every stopped thread",
+        placeHolder: "e.g. thread_img"
+      });
+      if (!name) {
+        return;
+      }
+      ThreadGrid.open(debugSession, name.trim());
+    })
+  );
+
+  // Performance tracing: on/off, and export of the recorded spans
+  context.subscriptions.push(
+    vscode.commands.registerCommand("cv-debugmate.toggleTracing", () => TraceStatus.toggle()),
+    vscode.commands.registerCommand("cv-debugmate.exportTrace", () => TraceStatus.exportTrace())
+  );
+
   // Add variable to group command
   context.subscriptions.push(
     vscode.commands.registerCommand("cv-debugmate.addToGroup", async (group: CVGroup) => {
@@ -309,7 +342,13 @@ export function activate(context: vscode.ExtensionContext) {
       // Create promise for this request
       const requestPromise = (async () => {
         try {
-          await visualizeVariableInternal(variable, variableName, panelVariableName, isPointer, baseType, shouldForce, reveal, debugSession, cancellationCheck);
+          // Reads anywhere below see cancellationCheck through the cancellation scope,
+          // and their trace spans are attributed to this panel
+          await runTraced(tracePanelId(debugSession.id, panelVariableName), () =>
+            runCancellable(cancellationCheck, () =>
+              visualizeVariableInternal(variable, variableName, panelVariableName, isPointer, baseType, shouldForce, reveal, debugSession, cancellationCheck)
+            )
+          );
         } finally {
           // Only delete if this is still the current request
           const current = pendingRequests.get(requestKey);
@@ -323,6 +362,10 @@ export function activate(context: vscode.ExtensionContext) {
       await requestPromise;
       
     } catch (error: any) {
+      if (isReadCancelled(error)) {
+        logDebug(`Request for ${variable.name || variable.evaluateName} superseded, read cancelled`);
+        return;
+      }
       if (reveal) vscode.window.showErrorMessage(`Error: ${error.message || error}`);
       logError("ERROR during execution:", error);
     }
@@ -766,7 +809,7 @@ export function activate(context: vscode.ExtensionContext) {
         }
         
         // Confirm if it's really 1D Mat
-        let matInfo = await getMatInfoFromVariables(debugSession, variableInfo.variablesReference);
+        let matInfo = await getMatInfoFromVariables(debugSession, variableInfo.variablesReference, variableInfo.type);
         
         // Fallback for rows/cols if they are 0 (likely failed to read from variablesReference)
         if (matInfo.rows === 0 || matInfo.cols === 0) {
@@ -790,7 +833,7 @@ export function activate(context: vscode.ExtensionContext) {
           
           await drawPlot(debugSession, variableName, matInfo, reveal, shouldForce, undefined, false, panelVariableName);
         } else {
-          await drawMatImage(debugSession, variableInfo, frameId, variableName, reveal, shouldForce, panelVariableName);
+          await drawMatImage(debugSession, variableInfo, frameId, variableName, reveal, shouldForce, panelVariableName, cancellationCheck);
         }
       } else if (vector1D.is1D) {
         await drawPlot(debugSession, variableName, vector1D.elementType, reveal, shouldForce, variableInfo, false, panelVariableName);
@@ -828,4 +871,7 @@ export function activate(context: vscode.ExtensionContext) {
       }
     )
   );
+
+  // Extension API, used by the benchmark harness (src/test/bench.test.ts)
+  return { onDidRender: PanelManager.onDidRender };
 }
@@ -0,0 +1,181 @@
+import * as vscode from "vscode";
+import { PanelManager } from "../utils/panelManager";
+import { WebviewAssets } from "../utils/webviewAssets";
+import { getWebviewContentForMatCompare } from "./matCompareWebview";
+
+/**
+ * Compare view for two paired Mats.
+ *
+ * A compare panel reads nothing itself: it is sent the buffers the two
+ * variables' Mat panels already hold (`_lastMatData`, read through the read
+ * cache), and one side again whenever its Mat panel draws new data. The viewer
+ * uploads both as textures and computes the difference image in its fragment
+ * shader; the error statistics run in a worker. Source panels of an open
+ * comparison are refreshed on each step even while hidden (RefreshScheduler).
+ */
+
+export interface MatSnapshot {
+  buffer: Buffer;
+  rows: number;
+  cols: number;
+  channels: number;
+  depth: number;
+}
+
+type Side = "a" | "b";
+
+interface CompareEntry {
+  panel: vscode.WebviewPanel;
+  sessionId: string;
+  names: { a: string; b: string };
+  ready: boolean;
+}
+
+export class MatCompare {
+  private static entries: Map<string, CompareEntry> = new Map();
+
+  /**
+   * Open (or reveal) the comparison of `nameA` and `nameB`. `load` draws a
+   * variable in its Mat panel when that panel holds no data yet.
+   */
+  static async open(
+    debugSession: vscode.DebugSession,
+    nameA: string,
+    nameB: string,
+    load: (name: string) => Promise<void>
+  ) {
+    const key = `${debugSession.id}:::${nameA}:::${nameB}`;
+    const existing = this.entries.get(key);
+    if (existing) {
+      existing.panel.reveal(undefined, false);
+      return;
+    }
+
+    for (const name of [nameA, nameB]) {
+      if (!this.snapshotOf(debugSession.id, name)) {
+        await load(name);
+      }
+    }
+    const a = this.snapshotOf(debugSession.id, nameA);
+    const b = this.snapshotOf(debugSession.id, nameB);
+    if (!a || !b) {
+      vscode.window.showErrorMessage(
+        `Cannot compare ${nameA} and ${nameB}: both must be non-empty Mats small enough to load whole (tiled Mats are not supported).`
+      );
+      return;
+    }
+    const mismatch = describeMismatch(a, b);
+    if (mismatch) {
+      vscode.window.showErrorMessage(`Cannot compare ${nameA} and ${nameB}: ${mismatch}.`);
+      return;
+    }
+
+    const panel = vscode.window.createWebviewPanel(
+      "MatCompareViewer",
+      `Compare: ${nameA} ⟷ ${nameB}`,
+      { viewColumn: vscode.ViewColumn.Active, preserveFocus: false },
+      {
+        enableScripts: true,
+        retainContextWhenHidden: true,
+        localResourceRoots: WebviewAssets.localResourceRoots,
+      }
+    );
+    const entry: CompareEntry = { panel, sessionId: debugSession.id, names: { a: nameA, b: nameB }, ready: false };
+    this.entries.set(key, entry);
+
+    panel.onDidDispose(() => {
+      (panel as any)._isDisposing = true;
+      this.entries.delete(key);
+    });
+    panel.webview.onDidReceiveMessage((message) => {
+      if (message.command === "ready") {
+        entry.ready = true;
+        for (const side of ["a", "b"] as Side[]) {
+          const data = this.snapshotOf(entry.sessionId, entry.names[side]);
+          if (data) this.post(entry, side, data);
+        }
+      }
+    });
+    panel.webview.html = getWebviewContentForMatCompare(panel.webview, nameA, nameB);
+  }
+
+  /**
+   * Called when the Mat panel of `name` has drawn `data`.
+   */
+  static update(sessionId: string, name: string, data: MatSnapshot) {
+    for (const entry of this.entries.values()) {
+      if (entry.sessionId !== sessionId || !entry.ready) continue;
+      if (entry.names.a === name) this.post(entry, "a", data);
+      if (entry.names.b === name) this.post(entry, "b", data);
+    }
+  }
+
+  /**
+   * Whether an open comparison shows `name`, so its panel refreshes while hidden.
+   */
+  static isSource(sessionId: string, name: string): boolean {
+    for (const entry of this.entries.values()) {
+      if (entry.sessionId === sessionId && (entry.names.a === name || entry.names.b === name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Whether `panel` is the Mat panel of a side of an open comparison, which
+   * reads its buffer from that panel.
+   */
+  static isSourcePanel(panel: vscode.WebviewPanel): boolean {
+    for (const entry of this.entries.values()) {
+      if (PanelManager.getPanel("MatImageViewer", entry.sessionId, entry.names.a) === panel ||
+          PanelManager.getPanel("MatImageViewer", entry.sessionId, entry.names.b) === panel) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static closeSession(sessionId: string) {
+    for (const entry of Array.from(this.entries.values())) {
+      if (entry.sessionId === sessionId) entry.panel.dispose();
+    }
+  }
+
+  private static snapshotOf(sessionId: string, name: string): MatSnapshot | undefined {
+    const panel = PanelManager.getPanel("MatImageViewer", sessionId, name);
+    if (!panel || (panel as any)._isDisposing) return undefined;
+    return (panel as any)._lastMatData as MatSnapshot | undefined;
+  }
+
+  private static post(entry: CompareEntry, side: Side, data: MatSnapshot) {
+    if ((entry.panel as any)._isDisposing) return;
+    try {
+      entry.panel.webview.postMessage({
+        command: "compareData",
+        side,
+        name: entry.names[side],
+        rows: data.rows,
+        cols: data.cols,
+        channels: data.channels,
+        depth: data.depth,
+        data: new Uint8Array(data.buffer),
+      });
+    } catch (e) {
+      // Panel was disposed, ignore
+    }
+  }
+}
+
+function describeMismatch(a: MatSnapshot, b: MatSnapshot): string | undefined {
+  if (a.rows !== b.rows || a.cols !== b.cols) {
+    return `sizes differ (${a.cols}x${a.rows} vs ${b.cols}x${b.rows})`;
+  }
+  if (a.channels !== b.channels) {
+    return `channel counts differ (${a.channels} vs ${b.channels})`;
+  }
+  if (a.channels > 4) {
+    return `${a.channels} channels are more than the compare view shows`;
+  }
+  return undefined;
+}
@@ -0,0 +1,607 @@
+// Mat compare viewer script, loaded by the shell from getWebviewContentForMatCompare.
+// esbuild.js bundles it into dist/media; the variable names come from the
+// viewer-config block.
+//
+// Both Mats are uploaded as WebGL2 textures and every view (abs/signed diff,
+// split, blink) is computed per fragment, so the UI thread never walks the
+// pixels. Depths WebGL cannot sample directly (everything but 8U and 32F) are
+// widened to float32 in the worker, which also computes the error statistics
+// and answers pixel lookups.
+import { bytesToTypedArray, getHalfFloatLut } from './matDecode.js';
+
+const viewerConfig = JSON.parse(document.getElementById('viewer-config').textContent);
+
+(function() {
+    const vscode = acquireVsCodeApi();
+    const canvas = document.getElementById('canvas');
+    const statsInfo = document.getElementById('statsInfo');
+    const pixelInfo = document.getElementById('pixelInfo');
+    const messageBox = document.getElementById('message');
+    const rangeInput = document.getElementById('diffRange');
+    const thresholdInput = document.getElementById('threshold');
+    const highlightInput = document.getElementById('highlight');
+    const splitInput = document.getElementById('splitPos');
+    const blinkInput = document.getElementById('blinkMs');
+
+    const names = { a: viewerConfig.nameA, b: viewerConfig.nameB };
+    const MODES = { abs: 0, signed: 1, split: 2, blink: 3 };
+
+    // Per side: { rows, cols, channels, depth, version, texture, scale }
+    const sides = { a: null, b: null };
+    const versions = { a: 0, b: 0 };
+    let stats = null;
+    let statsPending = false;
+    let statsQueued = false;
+
+    let mode = 'abs';
+    let diffRange = null; // null: follow the largest difference
+    let threshold = 0;
+    let highlight = highlightInput.checked;
+    let split = 0.5;
+    let blinkShowsB = false;
+    let blinkTimer = null;
+
+    let zoom = 1;
+    let offsetX = 0;
+    let offsetY = 0;
+    let fitted = false;
+    let drawQueued = false;
+
+    function showMessage(text) {
+        messageBox.textContent = text || '';
+    }
+
+    // ---- Worker: statistics, float conversion, pixel lookups ----
+
+    function statsWorkerMain() {
+        const images = { a: null, b: null };
+
+        self.onmessage = (event) => {
+            const msg = event.data;
+            if (msg.type === 'image') {
+                const values = bytesToTypedArray(msg.data, msg.depth);
+                images[msg.side] = { values, cols: msg.cols, channels: msg.channels, version: msg.version };
+                if (msg.needsFloat) {
+                    const floats = new Float32Array(values);
+                    self.postMessage({ type: 'texture', side: msg.side, version: msg.version, data: floats }, [floats.buffer]);
+                }
+            } else if (msg.type === 'stats') {
+                const a = images.a, b = images.b;
+                const current = a && b && a.version === msg.versions.a && b.version === msg.versions.b;
+                self.postMessage({ type: 'stats', versions: msg.versions, threshold: msg.threshold, stats: current ? compareStats(a, b, msg.threshold) : null });
+            } else if (msg.type === 'pixel') {
+                const pick = (image) => {
+                    if (!image) return null;
+                    const start = (msg.y * image.cols + msg.x) * image.channels;
+                    return Array.from(image.values.subarray(start, start + image.channels));
+                };
+                self.postMessage({ type: 'pixel', x: msg.x, y: msg.y, a: pick(images.a), b: pick(images.b) });
+            }
+        };
+
+        function compareStats(a, b, threshold) {
+            const va = a.values, vb = b.values, channels = a.channels;
+            const n = Math.min(va.length, vb.length);
+            let maxAbs = 0, maxAt = 0, sumAbs = 0, sumSq = 0, over = 0;
+            let lo = Infinity, hi = -Infinity;
+            for (let p = 0; p < n; p += channels) {
+                let pixelMax = 0;
+                for (let c = 0; c < channels; c++) {
+                    const x = va[p + c], y = vb[p + c];
+                    if (x < lo) lo = x;
+                    if (x > hi) hi = x;
+                    if (y < lo) lo = y;
+                    if (y > hi) hi = y;
+                    const d = y - x;
+                    const ad = d < 0 ? -d : d;
+                    sumAbs += ad;
+                    sumSq += d * d;
+                    if (ad > pixelMax) pixelMax = ad;
+                }
+                if (pixelMax > maxAbs) {
+                    maxAbs = pixelMax;
+                    maxAt = p / channels;
+                }
+                if (pixelMax > threshold) over++;
+            }
+            return {
+                maxAbs,
+                maxX: maxAt % a.cols,
+                maxY: Math.floor(maxAt / a.cols),
+                meanAbs: n > 0 ? sumAbs / n : 0,
+                rmse: n > 0 ? Math.sqrt(sumSq / n) : 0,
+                over,
+                pixels: n / channels,
+                min: lo,
+                max: hi
+            };
+        }
+    }
+
+    function createStatsWorker() {
+        const source = [
+            'let halfFloatLut = null;',
+            bytesToTypedArray, getHalfFloatLut,
+            '(' + statsWorkerMain + ')();'
+        ].map(String).join('\n');
+        const worker = new Worker(URL.createObjectURL(new Blob([source], { type: 'text/javascript' })));
+        worker.onmessage = (event) => onWorkerResult(event.data);
+        worker.onerror = (event) => {
+            console.error('[MatCompare] Stats worker failed:', event.message);
+            showMessage('The statistics worker failed: ' + event.message);
+        };
+        return worker;
+    }
+
+    // ---- WebGL ----
+
+    const gl = canvas.getContext('webgl2', { antialias: false });
+    if (!gl) {
+        showMessage('The compare view needs WebGL2, which this webview does not provide.');
+        return;
+    }
+    const worker = createStatsWorker();
+
+    const VERTEX_SHADER = `#version 300 es
+        in vec2 aPos;
+        void main() { gl_Position = vec4(aPos, 0.0, 1.0); }`;
+
+    const FRAGMENT_SHADER = `#version 300 es
+        precision highp float;
+        uniform sampler2D uA;
+        uniform sampler2D uB;
+        uniform float uScaleA;      // 255 for normalized 8U textures, 1 for float
+        uniform float uScaleB;
+        uniform vec2 uSize;         // image cols, rows
+        uniform vec2 uOffset;       // image origin in device pixels
+        uniform float uZoom;        // device pixels per image pixel
+        uniform float uCanvasHeight;
+        uniform int uMode;
+        uniform int uChannels;
+        uniform float uRange;       // difference shown at full intensity
+        uniform float uThreshold;
+        uniform bool uHighlight;
+        uniform vec2 uValueRange;   // min, max of A and B for split/blink
+        uniform float uSplit;
+        uniform bool uShowB;
+        out vec4 outColor;
+
+        vec3 toRgb(vec4 v) {
+            if (uChannels == 1) return v.rrr;
+            if (uChannels == 2) return vec3(v.r, v.g, 0.0);
+            return v.bgr; // Mats store BGR(A)
+        }
+
+        vec3 diverging(float t) {
+            vec3 mid = vec3(0.97);
+            return t < 0.0
+                ? mix(mid, vec3(0.23, 0.30, 0.75), -t)
+                : mix(mid, vec3(0.71, 0.02, 0.15), t);
+        }
+
+        void main() {
+            vec2 frag = vec2(gl_FragCoord.x, uCanvasHeight - gl_FragCoord.y);
+            vec2 p = (frag - uOffset) / uZoom;
+            if (p.x < 0.0 || p.y < 0.0 || p.x >= uSize.x || p.y >= uSize.y) {
+                outColor = vec4(0.2, 0.2, 0.2, 1.0);
+                return;
+            }
+            ivec2 texel = ivec2(p);
+            vec4 mask = vec4(1.0, uChannels > 1 ? 1.0 : 0.0, uChannels > 2 ? 1.0 : 0.0, uChannels > 3 ? 1.0 : 0.0);
+            vec4 a = texelFetch(uA, texel, 0) * uScaleA * mask;
+            vec4 b = texelFetch(uB, texel, 0) * uScaleB * mask;
+            vec4 d = b - a;
+            vec4 ad = abs(d);
+            float largest = max(max(ad.r, ad.g), max(ad.b, ad.a));
+
+            if (uMode == 0) {
+                vec3 c = (uChannels >= 3 ? toRgb(ad) : vec3(largest)) / uRange;
+                if (uHighlight && largest > uThreshold) c = vec3(1.0, 0.0, 1.0);
+                outColor = vec4(clamp(c, 0.0, 1.0), 1.0);
+            } else if (uMode == 1) {
+                float mean = dot(d, vec4(1.0)) / float(uChannels);
+                outColor = vec4(diverging(clamp(mean / uRange, -1.0, 1.0)), 1.0);
+            } else {
+                bool showB = uMode == 2 ? p.x >= uSplit * uSize.x : uShowB;
+                float span = max(uValueRange.y - uValueRange.x, 1e-20);
+                vec3 c = (toRgb(showB ? b : a) - uValueRange.x) / span;
+                if (uMode == 2 && abs(frag.x - (uOffset.x + uSplit * uSize.x * uZoom)) < 1.0) c = vec3(1.0, 0.85, 0.0);
+                outColor = vec4(clamp(c, 0.0, 1.0), 1.0);
+            }
+        }`;
+
+    function compileShader(type, source) {
+        const shader = gl.createShader(type);
+        gl.shaderSource(shader, source);
+        gl.compileShader(shader);
+        if (!gl.getShaderParameter(shader, gl.COMPILE_STATUS)) {
+            throw new Error(gl.getShaderInfoLog(shader) || 'shader compile failed');
+        }
+        return shader;
+    }
+
+    const program = gl.createProgram();
+    try {
+        gl.attachShader(program, compileShader(gl.VERTEX_SHADER, VERTEX_SHADER));
+        gl.attachShader(program, compileShader(gl.FRAGMENT_SHADER, FRAGMENT_SHADER));
+        gl.linkProgram(program);
+        if (!gl.getProgramParameter(program, gl.LINK_STATUS)) {
+            throw new Error(gl.getProgramInfoLog(program) || 'link failed');
+        }
+    } catch (e) {
+        showMessage('Could not build the compare shader: ' + e.message);
+        return;
+    }
+    gl.useProgram(program);
+
+    const uniforms = {};
+    for (const name of ['uA', 'uB', 'uScaleA', 'uScaleB', 'uSize', 'uOffset', 'uZoom', 'uCanvasHeight', 'uMode',
+        'uChannels', 'uRange', 'uThreshold', 'uHighlight', 'uValueRange', 'uSplit', 'uShowB']) {
+        uniforms[name] = gl.getUniformLocation(program, name);
+    }
+    gl.uniform1i(uniforms.uA, 0);
+    gl.uniform1i(uniforms.uB, 1);
+
+    // One triangle covering the viewport
+    const vao = gl.createVertexArray();
+    gl.bindVertexArray(vao);
+    gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer());
+    gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 3, -1, -1, 3]), gl.STATIC_DRAW);
+    const aPos = gl.getAttribLocation(program, 'aPos');
+    gl.enableVertexAttribArray(aPos);
+    gl.vertexAttribPointer(aPos, 2, gl.FLOAT, false, 0, 0);
+
+    const FORMATS = [gl.RED, gl.RG, gl.RGB, gl.RGBA];
+    const BYTE_FORMATS = [gl.R8, gl.RG8, gl.RGB8, gl.RGBA8];
+    const FLOAT_FORMATS = [gl.R32F, gl.RG32F, gl.RGB32F, gl.RGBA32F];
+
+    function uploadTexture(side, values, isFloat) {
+        const s = sides[side];
+        if (s.texture) gl.deleteTexture(s.texture);
+        const texture = gl.createTexture();
+        gl.activeTexture(side === 'a' ? gl.TEXTURE0 : gl.TEXTURE1);
+        gl.bindTexture(gl.TEXTURE_2D, texture);
+        // texelFetch reads exact texels; NEAREST also keeps float textures complete
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.NEAREST);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.NEAREST);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_S, gl.CLAMP_TO_EDGE);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_T, gl.CLAMP_TO_EDGE);
+        gl.pixelStorei(gl.UNPACK_ALIGNMENT, 1);
+        const c = s.channels - 1;
+        gl.texImage2D(gl.TEXTURE_2D, 0, isFloat ? FLOAT_FORMATS[c] : BYTE_FORMATS[c], s.cols, s.rows, 0,
+            FORMATS[c], isFloat ? gl.FLOAT : gl.UNSIGNED_BYTE, values);
+        s.texture = texture;
+        s.scale = isFloat ? 1 : 255;
+        scheduleDraw();
+    }
+
+    function comparable() {
+        const a = sides.a, b = sides.b;
+        if (!a || !b) return false;
+        return a.rows === b.rows && a.cols === b.cols && a.channels === b.channels;
+    }
+
+    function describeState() {
+        const a = sides.a, b = sides.b;
+        if (!a || !b) return 'Waiting for data...';
+        if (a.rows === 0 || a.cols === 0 || b.rows === 0 || b.cols === 0) return 'One of the Mats is empty.';
+        if (a.rows !== b.rows || a.cols !== b.cols) {
+            return 'Sizes differ: ' + names.a + ' is ' + a.cols + 'x' + a.rows + ', ' + names.b + ' is ' + b.cols + 'x' + b.rows + '.';
+        }
+        if (a.channels !== b.channels) {
+            return 'Channel counts differ: ' + a.channels + ' vs ' + b.channels + '.';
+        }
+        const maxSize = gl.getParameter(gl.MAX_TEXTURE_SIZE);
+        if (a.cols > maxSize || a.rows > maxSize) {
+            return 'The image is larger than this GPU\'s ' + maxSize + ' px texture limit.';
+        }
+        return '';
+    }
+
+    function scheduleDraw() {
+        if (drawQueued) return;
+        drawQueued = true;
+        requestAnimationFrame(() => {
+            drawQueued = false;
+            draw();
+        });
+    }
+
+    function resizeCanvas() {
+        const dpr = window.devicePixelRatio || 1;
+        const width = Math.round(canvas.clientWidth * dpr);
+        const height = Math.round(canvas.clientHeight * dpr);
+        if (canvas.width !== width || canvas.height !== height) {
+            canvas.width = width;
+            canvas.height = height;
+        }
+    }
+
+    function fitView() {
+        const a = sides.a;
+        if (!a || a.cols === 0 || a.rows === 0) return;
+        resizeCanvas();
+        zoom = Math.min(canvas.width / a.cols, canvas.height / a.rows) * 0.95;
+        offsetX = (canvas.width - a.cols * zoom) / 2;
+        offsetY = (canvas.height - a.rows * zoom) / 2;
+    }
+
+    function draw() {
+        resizeCanvas();
+        gl.viewport(0, 0, canvas.width, canvas.height);
+        gl.clearColor(0.2, 0.2, 0.2, 1);
+        gl.clear(gl.COLOR_BUFFER_BIT);
+        if (!comparable() || !sides.a.texture || !sides.b.texture) return;
+        if (!fitted) {
+            fitView();
+            fitted = true;
+        }
+
+        const a = sides.a, b = sides.b;
+        gl.activeTexture(gl.TEXTURE0);
+        gl.bindTexture(gl.TEXTURE_2D, a.texture);
+        gl.activeTexture(gl.TEXTURE1);
+        gl.bindTexture(gl.TEXTURE_2D, b.texture);
+
+        const bothBytes = a.depth === 0 && b.depth === 0;
+        const valueRange = bothBytes || !stats ? [0, bothBytes ? 255 : 1] : [stats.min, stats.max];
+        gl.uniform1f(uniforms.uScaleA, a.scale);
+        gl.uniform1f(uniforms.uScaleB, b.scale);
+        gl.uniform2f(uniforms.uSize, a.cols, a.rows);
+        gl.uniform2f(uniforms.uOffset, offsetX, offsetY);
+        gl.uniform1f(uniforms.uZoom, zoom);
+        gl.uniform1f(uniforms.uCanvasHeight, canvas.height);
+        gl.uniform1i(uniforms.uMode, MODES[mode]);
+        gl.uniform1i(uniforms.uChannels, a.channels);
+        gl.uniform1f(uniforms.uRange, effectiveRange());
+        gl.uniform1f(uniforms.uThreshold, threshold);
+        gl.uniform1i(uniforms.uHighlight, highlight ? 1 : 0);
+        gl.uniform2f(uniforms.uValueRange, valueRange[0], valueRange[1]);
+        gl.uniform1f(uniforms.uSplit, split);
+        gl.uniform1i(uniforms.uShowB, blinkShowsB ? 1 : 0);
+        gl.drawArrays(gl.TRIANGLES, 0, 3);
+    }
+
+    function effectiveRange() {
+        if (diffRange !== null && diffRange > 0) return diffRange;
+        return stats && stats.maxAbs > 0 ? stats.maxAbs : 1;
+    }
+
+    // ---- Data and statistics ----
+
+    function onCompareData(msg) {
+        const side = msg.side;
+        const old = sides[side];
+        if (old && old.texture) gl.deleteTexture(old.texture);
+        names[side] = msg.name;
+        sides[side] = {
+            rows: msg.rows, cols: msg.cols, channels: msg.channels, depth: msg.depth,
+            version: ++versions[side], texture: null, scale: 1
+        };
+        stats = null;
+
+        const maxSize = gl.getParameter(gl.MAX_TEXTURE_SIZE);
+        const tooLarge = msg.cols > maxSize || msg.rows > maxSize;
+        showMessage(describeState());
+
+        const bytes = msg.data;
+        const needsFloat = msg.depth !== 0 && msg.depth !== 5;
+        if (!tooLarge && msg.rows > 0 && msg.cols > 0 && msg.channels <= 4) {
+            if (msg.depth === 0) {
+                uploadTexture(side, bytes, false);
+            } else if (msg.depth === 5) {
+                const aligned = bytes.byteOffset % 4 === 0 ? bytes : bytes.slice();
+                uploadTexture(side, new Float32Array(aligned.buffer, aligned.byteOffset, aligned.byteLength / 4), true);
+            }
+        }
+        // The textures hold their own copy; the worker takes the bytes
+        worker.postMessage({
+            type: 'image', side, version: sides[side].version, data: bytes, depth: msg.depth,
+            cols: msg.cols, channels: msg.channels, needsFloat: needsFloat && !tooLarge
+        }, [bytes.buffer]);
+        requestStats();
+        renderStats();
+        scheduleDraw();
+    }
+
+    function requestStats() {
+        if (!comparable()) return;
+        if (statsPending) {
+            statsQueued = true;
+            return;
+        }
+        statsPending = true;
+        statsQueued = false;
+        worker.postMessage({ type: 'stats', versions: { a: sides.a.version, b: sides.b.version }, threshold });
+    }
+
+    function onWorkerResult(msg) {
+        if (msg.type === 'texture') {
+            const s = sides[msg.side];
+            if (s && s.version === msg.version) uploadTexture(msg.side, msg.data, true);
+        } else if (msg.type === 'stats') {
+            statsPending = false;
+            const current = comparable() && msg.versions.a === sides.a.version && msg.versions.b === sides.b.version;
+            if (current && msg.stats && msg.threshold === threshold) {
+                stats = msg.stats;
+                renderStats();
+                scheduleDraw();
+            } else if (msg.stats) {
+                statsQueued = true;
+            }
+            if (statsQueued) requestStats();
+        } else if (msg.type === 'pixel') {
+            pixelPending = false;
+            renderPixel(msg);
+            if (pixelWanted) {
+                const next = pixelWanted;
+                pixelWanted = null;
+                requestPixel(next.x, next.y);
+            }
+        }
+    }
+
+    function formatValue(v) {
+        if (!Number.isFinite(v)) return String(v);
+        return Number.isInteger(v) ? String(v) : v.toPrecision(6);
+    }
+
+    function renderStats() {
+        const a = sides.a;
+        const header = names.a + ' ⟷ ' + names.b + (a ? '   ' + a.cols + 'x' + a.rows + ' ' + a.channels + 'ch' : '');
+        if (!stats) {
+            statsInfo.textContent = header + (comparable() ? '\nComputing statistics...' : '');
+            return;
+        }
+        const percent = stats.pixels > 0 ? (100 * stats.over / stats.pixels).toFixed(2) : '0.00';
+        statsInfo.textContent = header +
+            '\nmax |B-A| ' + formatValue(stats.maxAbs) + ' at (' + stats.maxX + ', ' + stats.maxY + ')' +
+            '   mean ' + formatValue(stats.meanAbs) + '   RMSE ' + formatValue(stats.rmse) +
+            '\n> ' + formatValue(threshold) + ': ' + stats.over + ' / ' + stats.pixels + ' px (' + percent + '%)';
+        if (diffRange === null) rangeInput.placeholder = formatValue(effectiveRange());
+    }
+
+    // ---- Pixel lookups (one in flight) ----
+
+    let pixelPending = false;
+    let pixelWanted = null;
+
+    function requestPixel(x, y) {
+        if (pixelPending) {
+            pixelWanted = { x, y };
+            return;
+        }
+        pixelPending = true;
+        worker.postMessage({ type: 'pixel', x, y });
+    }
+
+    function renderPixel(msg) {
+        if (!msg.a || !msg.b) {
+            pixelInfo.textContent = '';
+            return;
+        }
+        const diff = msg.b.map((v, i) => v - msg.a[i]);
+        const list = (values) => '[' + values.map(formatValue).join(', ') + ']';
+        pixelInfo.textContent = '(' + msg.x + ', ' + msg.y + ')' +
+            '\nA   ' + list(msg.a) + '\nB   ' + list(msg.b) + '\nB-A ' + list(diff);
+    }
+
+    // ---- Interaction ----
+
+    let dragging = false;
+    let lastX = 0;
+    let lastY = 0;
+
+    canvas.addEventListener('mousedown', (e) => {
+        dragging = true;
+        lastX = e.clientX;
+        lastY = e.clientY;
+        canvas.classList.add('dragging');
+    });
+    window.addEventListener('mouseup', () => {
+        dragging = false;
+        canvas.classList.remove('dragging');
+    });
+    canvas.addEventListener('mousemove', (e) => {
+        const dpr = window.devicePixelRatio || 1;
+        if (dragging) {
+            offsetX += (e.clientX - lastX) * dpr;
+            offsetY += (e.clientY - lastY) * dpr;
+            lastX = e.clientX;
+            lastY = e.clientY;
+            scheduleDraw();
+        }
+        if (!comparable()) return;
+        const x = Math.floor((e.offsetX * dpr - offsetX) / zoom);
+        const y = Math.floor((e.offsetY * dpr - offsetY) / zoom);
+        if (x >= 0 && y >= 0 && x < sides.a.cols && y < sides.a.rows) {
+            requestPixel(x, y);
+        } else {
+            pixelWanted = null;
+            pixelInfo.textContent = '';
+        }
+    });
+    canvas.addEventListener('wheel', (e) => {
+        e.preventDefault();
+        const dpr = window.devicePixelRatio || 1;
+        const factor = e.deltaY < 0 ? 1.2 : 1 / 1.2;
+        const mx = e.offsetX * dpr;
+        const my = e.offsetY * dpr;
+        offsetX = mx - (mx - offsetX) * factor;
+        offsetY = my - (my - offsetY) * factor;
+        zoom *= factor;
+        scheduleDraw();
+    }, { passive: false });
+    window.addEventListener('resize', scheduleDraw);
+
+    function setMode(next) {
+        mode = next;
+        for (const button of document.querySelectorAll('#modeGroup button')) {
+            button.classList.toggle('active', button.dataset.mode === mode);
+        }
+        const diffMode = mode === 'abs' || mode === 'signed';
+        document.getElementById('rangeGroup').classList.toggle('hidden', !diffMode);
+        document.getElementById('splitGroup').classList.toggle('hidden', mode !== 'split');
+        document.getElementById('blinkGroup').classList.toggle('hidden', mode !== 'blink');
+        updateBlink();
+        scheduleDraw();
+    }
+
+    function updateBlink() {
+        if (blinkTimer) {
+            clearInterval(blinkTimer);
+            blinkTimer = null;
+        }
+        blinkShowsB = false;
+        if (mode !== 'blink') return;
+        const interval = Math.max(100, Number(blinkInput.value) || 500);
+        blinkTimer = setInterval(() => {
+            blinkShowsB = !blinkShowsB;
+            scheduleDraw();
+        }, interval);
+    }
+
+    for (const button of document.querySelectorAll('#modeGroup button')) {
+        button.addEventListener('click', () => setMode(button.dataset.mode));
+    }
+    rangeInput.addEventListener('change', () => {
+        const value = Number(rangeInput.value);
+        diffRange = rangeInput.value !== '' && value > 0 ? value : null;
+        scheduleDraw();
+    });
+    document.getElementById('autoRange').addEventListener('click', () => {
+        diffRange = null;
+        rangeInput.value = '';
+        renderStats();
+        scheduleDraw();
+    });
+    thresholdInput.addEventListener('change', () => {
+        threshold = Math.max(0, Number(thresholdInput.value) || 0);
+        requestStats();
+        renderStats();
+        scheduleDraw();
+    });
+    highlightInput.addEventListener('change', () => {
+        highlight = highlightInput.checked;
+        scheduleDraw();
+    });
+    splitInput.addEventListener('input', () => {
+        split = Number(splitInput.value) / 1000;
+        scheduleDraw();
+    });
+    blinkInput.addEventListener('change', updateBlink);
+    document.getElementById('reset').addEventListener('click', () => {
+        fitView();
+        scheduleDraw();
+    });
+
+    window.addEventListener('message', (event) => {
+        const message = event.data;
+        if (message.command === 'compareData') {
+            onCompareData(message);
+        }
+    });
+
+    renderStats();
+    vscode.postMessage({ command: 'ready' });
+})();
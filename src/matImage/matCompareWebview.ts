@@ -0,0 +1,137 @@
+import * as vscode from "vscode";
+import { WebviewAssets } from "../utils/webviewAssets";
+
+export function getWebviewContentForMatCompare(
+  webview: vscode.Webview,
+  nameA: string,
+  nameB: string
+): string {
+  const nonce = getNonce();
+
+  return `
+    <!DOCTYPE html>
+    <html lang="en">
+    <head>
+        <meta charset="UTF-8">
+        <meta name="viewport" content="width=device-width, initial-scale=1.0">
+        <meta http-equiv="Content-Security-Policy" content="default-src 'none'; style-src ${webview.cspSource} 'nonce-${nonce}' 'unsafe-inline'; script-src 'nonce-${nonce}'; worker-src blob:;">
+        <title>Matrix Compare Viewer</title>
+        <style nonce="${nonce}">
+            body { margin: 0; overflow: hidden; font-family: Arial, sans-serif; background-color: #333; }
+            #canvas { position: absolute; top: 0; left: 0; width: 100vw; height: 100vh; cursor: grab; }
+            #canvas.dragging { cursor: grabbing; }
+            #controls {
+                position: absolute;
+                top: 10px;
+                left: 10px;
+                background: rgba(255,255,255,0.9);
+                color: #111;
+                padding: 10px;
+                border-radius: 5px;
+                box-shadow: 0 2px 5px rgba(0,0,0,0.2);
+                user-select: none;
+                z-index: 1000;
+                display: flex;
+                gap: 8px;
+                align-items: center;
+                flex-wrap: wrap;
+                max-width: calc(100vw - 40px);
+            }
+            #controls label { color: #111; font-size: 12px; }
+            .ctrl-group { display: inline-flex; align-items: center; gap: 6px; }
+            .ctrl-group.hidden { display: none; }
+            button {
+                padding: 5px 10px;
+                cursor: pointer;
+                border: 1px solid #ccc;
+                border-radius: 3px;
+                background: white;
+                color: #111;
+            }
+            button:hover { background: #f0f0f0; }
+            button.active { background: #e7f1ff; border-color: #7db5ff; }
+            input[type="number"] { width: 80px; font-size: 12px; }
+            #statsInfo, #pixelInfo {
+                font-family: monospace;
+                font-size: 11px;
+                white-space: pre;
+                color: #333;
+            }
+            #statsInfo { flex-basis: 100%; }
+            #pixelInfo {
+                position: absolute;
+                bottom: 10px;
+                left: 10px;
+                background: rgba(255,255,255,0.9);
+                padding: 8px 10px;
+                border-radius: 5px;
+                box-shadow: 0 2px 5px rgba(0,0,0,0.2);
+                z-index: 1000;
+            }
+            #pixelInfo:empty { display: none; }
+            #message {
+                position: absolute;
+                top: 50%;
+                left: 50%;
+                transform: translate(-50%, -50%);
+                background: rgba(0,0,0,0.7);
+                color: white;
+                padding: 20px;
+                border-radius: 10px;
+                z-index: 2000;
+                max-width: 70vw;
+                text-align: center;
+            }
+            #message:empty { display: none; }
+        </style>
+    </head>
+    <body>
+        <canvas id="canvas"></canvas>
+        <div id="controls">
+            <span class="ctrl-group" id="modeGroup">
+                <label>View:</label>
+                <button data-mode="abs" class="active" title="|B - A|, largest channel difference">Abs Diff</button>
+                <button data-mode="signed" title="B - A averaged over channels; blue where B is lower, red where it is higher">Signed Diff</button>
+                <button data-mode="split" title="A left of the divider, B right of it">Split</button>
+                <button data-mode="blink" title="Alternate between A and B">Blink</button>
+            </span>
+            <span class="ctrl-group" id="rangeGroup">
+                <label for="diffRange">Range:</label>
+                <input type="number" id="diffRange" min="0" step="any" title="Difference shown at full intensity">
+                <button id="autoRange" title="Use the largest difference">Auto</button>
+            </span>
+            <span class="ctrl-group" id="thresholdGroup">
+                <label for="threshold">Threshold:</label>
+                <input type="number" id="threshold" min="0" step="any" value="0">
+                <label><input type="checkbox" id="highlight"> Highlight</label>
+            </span>
+            <span class="ctrl-group hidden" id="splitGroup">
+                <label for="splitPos">Divider:</label>
+                <input type="range" id="splitPos" min="0" max="1000" value="500">
+            </span>
+            <span class="ctrl-group hidden" id="blinkGroup">
+                <label for="blinkMs">Every (ms):</label>
+                <input type="number" id="blinkMs" min="100" step="50" value="500">
+            </span>
+            <span class="ctrl-group">
+                <button id="reset">Reset View</button>
+            </span>
+            <div id="statsInfo"></div>
+        </div>
+        <div id="pixelInfo"></div>
+        <div id="message">Waiting for data...</div>
+        ${WebviewAssets.viewerScripts(webview, "matCompareViewer", { nameA, nameB }, nonce)}
+    </body>
+    </html>
+  `;
+}
+
+function getNonce() {
+  let text = "";
+  const possible =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+  for (let i = 0; i < 32; i++) {
+    text += possible.charAt(Math.floor(Math.random() * possible.length));
+  }
+  return text;
+}
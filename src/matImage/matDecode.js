@@ -0,0 +1,50 @@
+// Mat element decoding shared by the Mat viewers. Bundled into matViewer.js
+// and matCompareViewer.js by esbuild.js.
+//
+// The viewers also inline these functions into their worker scripts by
+// source, so they refer to nothing but each other and `halfFloatLut`, which
+// each worker script declares for itself.
+
+let halfFloatLut = null;
+
+// The elements of raw Mat bytes as a typed array of the depth (viewed in
+// place except CV_16F, widened to float32)
+export function bytesToTypedArray(bytes, depth) {
+    const buf = bytes.buffer;
+    const offset = bytes.byteOffset;
+    const length = bytes.byteLength;
+    switch (depth) {
+        case 0: return new Uint8Array(buf, offset, length);    // CV_8U
+        case 1: return new Int8Array(buf, offset, length);     // CV_8S
+        case 2: return new Uint16Array(buf, offset, length / 2);   // CV_16U
+        case 3: return new Int16Array(buf, offset, length / 2);    // CV_16S
+        case 4: return new Int32Array(buf, offset, length / 4);    // CV_32S
+        case 5: return new Float32Array(buf, offset, length / 4);  // CV_32F
+        case 6: return new Float64Array(buf, offset, length / 8);  // CV_64F
+        case 7: {                                                  // CV_16F, widened via LUT
+            const halves = (offset & 1) ? new Uint16Array(bytes.slice().buffer) : new Uint16Array(buf, offset, length / 2);
+            const lut = getHalfFloatLut();
+            const values = new Float32Array(halves.length);
+            for (let i = 0; i < halves.length; i++) values[i] = lut[halves[i]];
+            return values;
+        }
+        default: return new Uint8Array(buf, offset, length);
+    }
+}
+
+// Every half-float bit pattern decoded once
+export function getHalfFloatLut() {
+    if (halfFloatLut) return halfFloatLut;
+    halfFloatLut = new Float32Array(65536);
+    for (let h = 0; h < 65536; h++) {
+        const sign = (h & 0x8000) ? -1 : 1;
+        const exponent = (h >> 10) & 0x1f;
+        const mantissa = h & 0x3ff;
+        let v;
+        if (exponent === 0) v = mantissa * Math.pow(2, -24);           // subnormal
+        else if (exponent === 31) v = mantissa ? NaN : Infinity;
+        else v = (1 + mantissa / 1024) * Math.pow(2, exponent - 15);
+        halfFloatLut[h] = sign * v;
+    }
+    return halfFloatLut;
+}
@@ -2,16 +2,51 @@ import * as vscode from "vscode";
 import { 
   evaluateWithTimeout, 
   isUsingLLDB, 
+  tracedCustomRequest,
   readMemoryChunked,
+  readMemoryViaDumpFile,
+  readMemoryGathered,
   getMemorySample,
   get2DStdArrayDataPointer,
   getCStyle2DArrayDataPointer,
   get3DArrayDataPointer
 } from "../utils/debugger";
 import { getBytesPerElement } from "../utils/opencv";
+import { readPublishedSegment, SEGMENT_KIND_MAT } from "../utils/sharedMemory";
+import { matUpdateMessage } from "../utils/tileDiff";
 import { getWebviewContentForMat } from "./matWebview";
+import {
+  TILE_SIZE,
+  LARGE_IMAGE_BYTES,
+  MatLayout,
+  TiledImageInfo,
+  TileCache,
+  getOverviewLevel,
+  getLevelSize,
+  readPyramidRegion,
+  serveTileRequest
+} from "./matTiles";
+import { RasterSource, bufferRasterSource, writeTiff, writeNpyImage } from "../utils/exporters";
+import { FrameRecorder } from "../utils/frameRecorder";
+import { MatCompare } from "./matCompare";
+import { isReadCancelled } from "../utils/cancellation";
+import {
+  SliceAxes,
+  VolumeLayout,
+  cancelSlicePrefetch,
+  clampSliceIndex,
+  getNdMatLayout,
+  getVolumeLayout,
+  prefetchSlices,
+  readSlice,
+  sameVolumeShape,
+  sliceAddress,
+  sliceRowBytes
+} from "./matSlices";
 import { PanelManager } from "../utils/panelManager";
 import { SyncManager } from "../utils/syncManager";
+import { StrategyCache } from "../utils/strategyCache";
+import { logDebug, tracePost } from "../utils/logger";
 
 // Function to draw the cv::Mat image
 export async function drawMatImage(
@@ -21,7 +56,8 @@ export async function drawMatImage(
   variableName: string,
   reveal: boolean = true,
   force: boolean = false,
-  panelVariableName?: string
+  panelVariableName?: string,
+  cancellationCheck?: () => boolean
 ) {
   // Use panelVariableName for panel management, variableName for data access
   const panelName = panelVariableName || variableName;
@@ -39,17 +75,25 @@ export async function drawMatImage(
     console.log("variableInfo:", JSON.stringify(variableInfo, null, 2));
     
     let rows: number, cols: number, channels: number, depth: number, dataPtr: string = "";
+    // Row step in bytes; 0 when unknown or the Mat is continuous
+    let step = 0;
+    // N-D Mats (dims > 2) are shown slice by slice
+    let dims = 2, sizePtr = "", stepPtr = "";
     
     if (usingLLDB) {
       // For LLDB, we must use variables request - evaluate won't work
       if (variableInfo.variablesReference && variableInfo.variablesReference > 0) {
         console.log("Using LLDB variables request to get Mat info");
-        const matInfo = await getMatInfoFromVariables(debugSession, variableInfo.variablesReference);
+        const matInfo = await getMatInfoFromVariables(debugSession, variableInfo.variablesReference, variableInfo.type);
         rows = matInfo.rows;
         cols = matInfo.cols;
         channels = matInfo.channels;
         depth = matInfo.depth;
         dataPtr = matInfo.dataPtr;
+        step = matInfo.step;
+        dims = matInfo.dims;
+        sizePtr = matInfo.sizePtr;
+        stepPtr = matInfo.stepPtr;
       } else {
         // Try to get variablesReference from scopes
         console.log("No variablesReference, trying to get from scopes...");
@@ -74,12 +118,16 @@ export async function drawMatImage(
         
         if (foundVariable && foundVariable.variablesReference > 0) {
           console.log("Found variable in scopes:", foundVariable.name);
-          const matInfo = await getMatInfoFromVariables(debugSession, foundVariable.variablesReference);
+          const matInfo = await getMatInfoFromVariables(debugSession, foundVariable.variablesReference, foundVariable.type);
           rows = matInfo.rows;
           cols = matInfo.cols;
           channels = matInfo.channels;
           depth = matInfo.depth;
           dataPtr = matInfo.dataPtr;
+          step = matInfo.step;
+          dims = matInfo.dims;
+          sizePtr = matInfo.sizePtr;
+          stepPtr = matInfo.stepPtr;
         } else {
           throw new Error("Cannot access Mat variable in LLDB. Make sure it's a valid cv::Mat.");
         }
@@ -91,12 +139,16 @@ export async function drawMatImage(
       // because .depth() and .channels() method calls may not work via evaluate
       if (variableInfo.variablesReference && variableInfo.variablesReference > 0) {
         console.log("Using variablesReference to get Mat info for cppvsdbg/cppdbg");
-        const matInfo = await getMatInfoFromVariables(debugSession, variableInfo.variablesReference);
+        const matInfo = await getMatInfoFromVariables(debugSession, variableInfo.variablesReference, variableInfo.type);
         rows = matInfo.rows;
         cols = matInfo.cols;
         channels = matInfo.channels;
         depth = matInfo.depth;
         dataPtr = matInfo.dataPtr;
+        step = matInfo.step;
+        dims = matInfo.dims;
+        sizePtr = matInfo.sizePtr;
+        stepPtr = matInfo.stepPtr;
         console.log(`Mat info from variablesReference: ${rows}x${cols}, ${channels} channels, depth=${depth}, dataPtr=${dataPtr}`);
       } else {
         // Fallback: use evaluate expressions
@@ -117,6 +169,17 @@ export async function drawMatImage(
         rows = parseInt(rowsResponse.result);
         cols = parseInt(colsResponse.result);
         dataPtr = dataResponse.result;
+
+        if (rows < 0 || cols < 0) {
+          const [dimsResponse, sizeResponse, stepPtrResponse] = await Promise.all([
+            evaluateWithTimeout(debugSession, `${variableName}.dims`, frameId, 5000),
+            evaluateWithTimeout(debugSession, `${variableName}.size.p`, frameId, 5000),
+            evaluateWithTimeout(debugSession, `${variableName}.step.p`, frameId, 5000)
+          ]);
+          dims = parseInt(dimsResponse.result) || 2;
+          sizePtr = sizeResponse.result;
+          stepPtr = stepPtrResponse.result;
+        }
         
         // Parse depth and channels from flags (same logic as LLDB)
         const flags = parseInt(flagsResponse.result);
@@ -125,6 +188,16 @@ export async function drawMatImage(
           depth = type & 7;  // CV_MAT_DEPTH_MASK = 7
           channels = ((type >> 3) & 63) + 1;  // ((type >> 3) & 63) gives (channels - 1)
           console.log(`Extracted from flags ${flags}: depth=${depth}, channels=${channels}`);
+
+          // ROIs and padded Mats are not continuous: their rows are step[0] bytes apart
+          if (!(flags & MAT_CONTINUOUS_FLAG)) {
+            try {
+              const stepResponse = await evaluateWithTimeout(debugSession, `${variableName}.step.buf[0]`, frameId, 5000);
+              step = parseInt(stepResponse.result) || 0;
+            } catch (e) {
+              console.log("Failed to get Mat step:", e);
+            }
+          }
         } else {
           // Last resort: try .depth() and .channels()
           const channelsExp = `${variableName}.channels()`;
@@ -141,15 +214,24 @@ export async function drawMatImage(
 
     console.log(`Matrix info: ${rows}x${cols}, ${channels} channels, depth=${depth}`);
 
+    if (dims > 2) {
+      const layout = await getNdMatLayout(debugSession, { dims, sizePtr, stepPtr, dataPtr, channels, depth });
+      await drawSlicedVolume(debugSession, panelName, variableName, layout, reveal, force);
+      return;
+    }
+
     const bytesPerElement = getBytesPerElement(depth);
     const totalBytes = rows * cols * channels * bytesPerElement;
+    const rowBytes = cols * channels * bytesPerElement;
+    // Continuous Mats (and unknown step) are read as one dense buffer
+    const matStep = step > rowBytes ? step : rowBytes;
+    const spanBytes = rows > 0 ? (rows - 1) * matStep + rowBytes : 0;
+    if (matStep > rowBytes) {
+      console.log(`Mat is not continuous: step=${matStep}, row=${rowBytes} bytes`);
+    }
 
     const panelTitle = `View: ${panelName}`;
-    // Check if panel is already fresh with this hard state token
-    // Now including memory sampling to detect internal pixel changes
-    // BUT only skip if it's NOT a focus-triggered refresh
-    const sample = await getMemorySample(debugSession, dataPtr, totalBytes);
-    const stateToken = `${rows}|${cols}|${channels}|${depth}|${dataPtr}|${sample}`;
+    const matPtr = dataPtr.match(/0x[0-9a-fA-F]+/)?.[0];
     
     // Pass dataPtr to enable panel sharing between variables pointing to the same data
     const panel = PanelManager.getOrCreatePanel(
@@ -161,6 +243,21 @@ export async function drawMatImage(
       dataPtr  // Enable sharing panels by data pointer
     );
 
+    // Huge Mats are never read whole: the webview asks for the tiles it shows
+    const tiled = !!matPtr && totalBytes >= LARGE_IMAGE_BYTES;
+    // A new panel for a large Mat shows a strided preview first and then fills in
+    // row bands, instead of staying blank until every byte has been read
+    const progressive = !tiled && !!matPtr && totalBytes >= PROGRESSIVE_MIN_BYTES &&
+      !(panel.webview.html && panel.webview.html.length > 0);
+
+    // Check if panel is already fresh with this hard state token
+    // Now including memory sampling to detect internal pixel changes
+    // BUT only skip if it's NOT a focus-triggered refresh.
+    // Tiled and progressive loads are sampled even in hash mode, which would read
+    // the whole Mat before the first tile or preview row
+    const sample = await getMemorySample(debugSession, dataPtr, spanBytes, tiled || progressive);
+    const stateToken = `${rows}|${cols}|${channels}|${depth}|${dataPtr}|${sample}`;
+
     if (!force && PanelManager.isPanelFresh("MatImageViewer", debugSession.id, panelName, stateToken)) {
       console.log(`Mat panel is already up-to-date with token: ${stateToken}`);
       return;
@@ -177,6 +274,25 @@ export async function drawMatImage(
     const dataSize = rows * cols * channels;
     console.log(`Total data size: ${dataSize} elements`);
 
+    if (tiled) {
+      await drawTiledMat(debugSession, panel, panelName, variableName, stateToken, matPtr!, rows, cols, channels, depth, matStep);
+      return;
+    }
+
+    // Leaving tiled or slice mode (the Mat shrank or became 2D): rebuild the webview for a complete buffer
+    if ((panel as any)._tiledInfo || (panel as any)._sliceLayout) {
+      (panel as any)._tiledInfo = undefined;
+      (panel as any)._tiledLayout = undefined;
+      (panel as any)._tileHandler = undefined;
+      (panel as any)._sliceLayout = undefined;
+      (panel as any)._sliceHandler = undefined;
+      setupMatPanel(panel, debugSession, panelName, variableName, rows, cols, channels, depth);
+    }
+
+    if (progressive) {
+      setupMatPanel(panel, debugSession, panelName, variableName, rows, cols, channels, depth);
+    }
+
     // Read data with progress indicator
     const dataResult = await vscode.window.withProgress(
       {
@@ -186,6 +302,31 @@ export async function drawMatImage(
       },
       async (progress) => {
         progress.report({ message: "Starting to read pixel data..." });
+
+        // A segment published by cvdm::publish skips readMemory entirely
+        const published = await readPublishedSegment(debugSession, dataPtr, totalBytes, SEGMENT_KIND_MAT, matStep);
+        if (published) {
+          return { buffer: published.buffer };
+        }
+
+        if (progressive) {
+          const streamed = await loadMatProgressively(
+            debugSession,
+            panel,
+            matPtr!,
+            rows,
+            cols,
+            channels * bytesPerElement,
+            matStep,
+            frameId,
+            progress,
+            cancellationCheck
+          );
+          if (streamed.buffer || streamed.aborted) {
+            return { ...streamed, streamed: true };
+          }
+          console.log("[drawMatImage] Progressive load failed, falling back to a full read");
+        }
         
         if (usingLLDB && dataPtr) {
           // For LLDB, use direct memory read with the pointer
@@ -195,7 +336,8 @@ export async function drawMatImage(
             frameId,
             dataSize,
             depth,
-            progress
+            progress,
+            { rows, step: matStep }
           );
         } else {
           return await readMatDataFast(
@@ -204,7 +346,8 @@ export async function drawMatImage(
             frameId,
             dataSize,
             depth,
-            progress
+            progress,
+            { rows, step: matStep }
           );
         }
       }
@@ -217,9 +360,29 @@ export async function drawMatImage(
       return;
     }
 
+    // A superseded progressive load leaves its preview; the newer request redraws
+    if ((dataResult as any).aborted) {
+      console.log("[drawMatImage] Progressive load was cancelled");
+      return;
+    }
+
     // Update state token AFTER data is read
     PanelManager.updateStateToken("MatImageViewer", debugSession.id, panelName, stateToken);
 
+    // Keep the last buffer sent to this panel so the next step can send only changed tiles
+    const previousData = (panel as any)._lastMatData as
+      { buffer: Buffer; rows: number; cols: number; channels: number; depth: number } | undefined;
+    if (dataResult.buffer) {
+      (panel as any)._lastMatData = { buffer: dataResult.buffer, rows, cols, channels, depth };
+      FrameRecorder.capture(panel, { kind: 'mat', data: dataResult.buffer, rows, cols, channels, depth });
+      MatCompare.update(debugSession.id, panelName, (panel as any)._lastMatData);
+    }
+
+    // Progressive loading already streamed every row to the webview
+    if ((dataResult as any).streamed) {
+      return;
+    }
+
     // If panel already has content, only send data to preserve view state (zoom/pan)
     if (panel.webview.html && panel.webview.html.length > 0) {
       console.log("Panel already has HTML, sending only data to preserve view state");
@@ -237,7 +400,18 @@ export async function drawMatImage(
           console.log("[drawMatImage] Aborting data send - panel is being disposed (2)");
           return;
         }
-        
+
+        // Same geometry as last time: diff in tiles and send only what changed.
+        // A forced refresh (reload / moved panel) always sends the complete image.
+        const update = matUpdateMessage(previousData, { buffer, rows, cols, channels, depth }, bytesPerElement, !!force);
+        if (!update) {
+          console.log("[drawMatImage] No pixel changes since last update");
+          return;
+        }
+        if (update.command === 'deltaData') {
+          console.log(`[drawMatImage] Sending ${update.tiles.length} dirty tiles instead of ${buffer.length} bytes`);
+        }
+
         // CRITICAL: Use setTimeout to defer postMessage, allowing VS Code to process
         // any pending events (like panel disposal) before we try to send data.
         setTimeout(() => {
@@ -245,15 +419,15 @@ export async function drawMatImage(
             return;
           }
           try {
-            panel.webview.postMessage({
-              command: 'completeData',
-              data: new Uint8Array(buffer),
-              rows, cols, channels, depth 
-            });
+            tracePost(panel.webview, update);
           } catch (e) {
             // Panel was disposed, ignore
           }
         }, 0);
+        // Tiles leave the view as it is
+        if (update.command === 'deltaData') {
+          return;
+        }
         
         // Restore saved view state if available
         const savedState = SyncManager.getSavedState(variableName);
@@ -275,58 +449,7 @@ export async function drawMatImage(
       }
     }
 
-    panel.webview.html = getWebviewContentForMat(
-      panel.webview,
-      rows,
-      cols,
-      channels,
-      depth,
-      { base64: "" } // Don't embed data directly, send via message
-    );
-
-    // Send ready signal immediately so webview knows this is not a moved panel
-    panel.webview.postMessage({ command: 'ready' });
-
-    SyncManager.registerPanel(panelName, panel);
-    
-    // Dispose previous listener if it exists to avoid multiple listeners on reused panel
-    if ((panel as any)._syncListener) {
-      (panel as any)._syncListener.dispose();
-    }
-
-    (panel as any)._syncListener = panel.webview.onDidReceiveMessage(
-      async (message) => {
-        // Ignore all messages if panel is being disposed
-        if ((panel as any)._isDisposing) {
-          return;
-        }
-        if (message.command === 'viewChanged') {
-          SyncManager.syncView(panelName, message.state);
-        } else if (message.command === 'pixelHighlight') {
-          SyncManager.syncPixelHighlight(panelName, message.pixelX, message.pixelY);
-        } else if (message.command === 'webviewReady') {
-          console.log(`[DEBUG-TRACE] webviewReady received for ${panelName}, restoring state`);
-          SyncManager.restoreState(panelName);
-        } else if (message.command === 'reload') {
-          const reloadStartTime = Date.now();
-          console.log(`[DEBUG-TRACE] reload message received for ${variableName} at ${reloadStartTime}`);
-          
-          // Check if debug session is still active before reloading
-          const currentSession = vscode.debug.activeDebugSession;
-          if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
-            console.log(`[DEBUG-TRACE] reload: starting executeCommand (fire-and-forget) at ${Date.now()}`);
-            // CRITICAL: Fire-and-forget - don't await to avoid blocking
-            Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: variableName, evaluateName: variableName, skipToken: true }))
-              .then(() => console.log(`[DEBUG-TRACE] reload: executeCommand completed at ${Date.now()}`))
-              .catch((e: Error) => console.log(`[DEBUG-TRACE] reload: executeCommand failed:`, e));
-          } else {
-            console.log('Skipping reload - debug session is no longer active or panel is disposing');
-          }
-          
-          console.log(`[DEBUG-TRACE] reload handler finished for ${variableName} at ${Date.now()}`);
-        }
-      }
-    );
+    setupMatPanel(panel, debugSession, panelName, variableName, rows, cols, channels, depth);
 
     // Send complete data at once to webview (webview has its own memory space)
     const buffer = dataResult.buffer;
@@ -336,26 +459,20 @@ export async function drawMatImage(
 
     // CRITICAL: Use setTimeout to defer postMessage
     if ((panel as any)._isDisposing) {
-      console.log(`[DEBUG-TRACE] postMessage skipped - panel disposing (before setTimeout)`);
       return;
     }
     
-    console.log(`[DEBUG-TRACE] postMessage: scheduling setTimeout at ${Date.now()}`);
     setTimeout(() => {
-      console.log(`[DEBUG-TRACE] postMessage: setTimeout callback at ${Date.now()}, isDisposing=${(panel as any)._isDisposing}`);
       if ((panel as any)._isDisposing) {
-        console.log(`[DEBUG-TRACE] postMessage skipped - panel disposing (in setTimeout)`);
         return;
       }
       try {
-        console.log(`[DEBUG-TRACE] postMessage: sending completeData (${buffer.length} bytes) at ${Date.now()}`);
-        panel.webview.postMessage({
+        tracePost(panel.webview, {
           command: 'completeData',
           data: new Uint8Array(buffer)
         });
-        console.log(`[DEBUG-TRACE] postMessage: sent successfully at ${Date.now()}`);
       } catch (e) {
-        console.log(`[DEBUG-TRACE] postMessage: FAILED with error:`, e);
+        logDebug("[drawMatImage] postMessage failed - panel likely disposed:", e);
       }
     }, 0);
   } catch (error) {
@@ -364,45 +481,554 @@ export async function drawMatImage(
   }
 }
 
+// Mats at least this large are loaded progressively into a new panel
+const PROGRESSIVE_MIN_BYTES = 16 * 1024 * 1024;
+// Target size of the strided preview (every Nth row, N >= 8)
+const PREVIEW_BYTES = 1024 * 1024;
+const PREVIEW_MIN_STRIDE = 8;
+const PREVIEW_CONCURRENCY = 8;
+// Rows are streamed in bands of about this many bytes, a few bands at a time so
+// the chunked reader never drains between bands
+const BAND_BYTES = 4 * 1024 * 1024;
+const BANDS_IN_FLIGHT = 3;
+
+function postToPanel(panel: vscode.WebviewPanel, message: any) {
+  setTimeout(() => {
+    if ((panel as any)._isDisposing) {
+      return;
+    }
+    try {
+      tracePost(panel.webview, message);
+    } catch (e) {
+      // Panel was disposed, ignore
+    }
+  }, 0);
+}
+
+/**
+ * Read a Mat in two passes: first every `stride`-th row (one small readMemory per row)
+ * so the webview can show a coarse preview almost immediately, then the full image in
+ * row bands that replace the preview as they arrive (BANDS_IN_FLIGHT read at once,
+ * in whatever order they complete).
+ *
+ * Returns the complete buffer, `aborted` when cancelled or the panel was closed,
+ * or neither when a read failed and the caller should fall back to a full read.
+ */
+async function loadMatProgressively(
+  debugSession: vscode.DebugSession,
+  panel: vscode.WebviewPanel,
+  dataPtr: string,
+  rows: number,
+  cols: number,
+  bytesPerPixel: number,
+  step: number,
+  frameId: number | undefined,
+  progress: vscode.Progress<{ message?: string; increment?: number }>,
+  cancellationCheck?: () => boolean
+): Promise<{ buffer: Buffer | null; aborted?: boolean }> {
+  const rowBytes = cols * bytesPerPixel;
+  const totalBytes = rows * rowBytes;
+  const base = BigInt(dataPtr);
+  const isAborted = () => (panel as any)._isDisposing || (cancellationCheck ? cancellationCheck() : false);
+  const startTime = Date.now();
+
+  // Pass 1: strided preview rows
+  const stride = Math.max(PREVIEW_MIN_STRIDE, Math.ceil(totalBytes / PREVIEW_BYTES));
+  const previewRows = Math.ceil(rows / stride);
+  const preview = Buffer.alloc(previewRows * rowBytes);
+  progress.report({ message: `Reading preview (every ${stride}th row)...` });
+
+  let nextRow = 0;
+  let failed = false;
+  const readPreviewRows = async () => {
+    while (!failed && nextRow < previewRows) {
+      if (isAborted()) return;
+      const i = nextRow++;
+      try {
+        const response = await tracedCustomRequest(debugSession, "readMemory", {
+          memoryReference: "0x" + (base + BigInt(i * stride * step)).toString(16),
+          offset: 0,
+          count: rowBytes
+        });
+        const data = response && response.data ? Buffer.from(response.data, "base64") : null;
+        if (!data || data.length !== rowBytes) {
+          failed = true;
+          return;
+        }
+        data.copy(preview, i * rowBytes);
+      } catch (e) {
+        console.log(`[Progressive] Preview row ${i * stride} failed:`, e);
+        failed = true;
+      }
+    }
+  };
+  await Promise.all(Array.from({ length: Math.min(PREVIEW_CONCURRENCY, previewRows) }, () => readPreviewRows()));
+  if (isAborted()) return { buffer: null, aborted: true };
+  if (failed) return { buffer: null };
+
+  console.log(`[Progressive] Preview of ${previewRows} rows ready in ${Date.now() - startTime}ms`);
+  postToPanel(panel, { command: 'previewData', stride, data: new Uint8Array(preview) });
+
+  // Pass 2: full-resolution row bands
+  const buffer = Buffer.alloc(totalBytes);
+  const bandRows = Math.max(1, Math.floor(BAND_BYTES / rowBytes));
+  const bandCount = Math.ceil(rows / bandRows);
+  let nextBand = 0;
+  let loadedRows = 0;
+  const readBands = async () => {
+    while (!failed && nextBand < bandCount) {
+      if (isAborted()) return;
+      const y = nextBand++ * bandRows;
+      const height = Math.min(bandRows, rows - y);
+      const band = await readMemoryGathered(
+        debugSession,
+        "0x" + (base + BigInt(y * step)).toString(16),
+        height,
+        rowBytes,
+        step,
+        frameId,
+        undefined,
+        cancellationCheck
+      );
+      if (isAborted()) return;
+      if (!band || band.length !== height * rowBytes) {
+        console.log(`[Progressive] Band at row ${y} failed`);
+        failed = true;
+        return;
+      }
+      band.copy(buffer, y * rowBytes);
+      postToPanel(panel, { command: 'bandData', y, height, data: new Uint8Array(band) });
+      loadedRows += height;
+      progress.report({
+        message: `Loaded ${loadedRows} / ${rows} rows`,
+        increment: 100 / bandCount
+      });
+    }
+  };
+  await Promise.all(Array.from({ length: Math.min(BANDS_IN_FLIGHT, bandCount) }, () => readBands()));
+  if (isAborted()) return { buffer: null, aborted: true };
+  if (failed) return { buffer: null };
+
+  postToPanel(panel, { command: 'progressiveDone' });
+  console.log(`[Progressive] Loaded ${totalBytes} bytes in ${Date.now() - startTime}ms`);
+  return { buffer };
+}
+
+/**
+ * Show a huge Mat in tiled mode: send a decimated overview, then serve the
+ * webview's viewport tile requests (see matTiles.ts) until the next refresh.
+ */
+async function drawTiledMat(
+  debugSession: vscode.DebugSession,
+  panel: vscode.WebviewPanel,
+  panelName: string,
+  variableName: string,
+  stateToken: string,
+  dataPtr: string,
+  rows: number,
+  cols: number,
+  channels: number,
+  depth: number,
+  step: number
+) {
+  const layout: MatLayout = {
+    base: BigInt(dataPtr),
+    rows,
+    cols,
+    bytesPerPixel: channels * getBytesPerElement(depth),
+    step
+  };
+  const overviewLevel = getOverviewLevel(rows, cols);
+  const overviewSize = getLevelSize(rows, cols, overviewLevel);
+  const cacheKey = `${debugSession.id}|${stateToken}`;
+
+  const overview = await vscode.window.withProgress(
+    {
+      location: vscode.ProgressLocation.Notification,
+      title: "Loading OpenCV Mat",
+      cancellable: false
+    },
+    async (progress) => {
+      progress.report({ message: `Reading ${overviewSize.width}x${overviewSize.height} overview of ${cols}x${rows} image...` });
+      const key = `${cacheKey}|overview`;
+      const cached = TileCache.get(key);
+      if (cached) {
+        return cached;
+      }
+      const region = await readPyramidRegion(debugSession, layout, overviewLevel, 0, 0, overviewSize.width, overviewSize.height);
+      if (region) {
+        TileCache.set(key, region);
+      }
+      return region;
+    }
+  );
+
+  if ((panel as any)._isDisposing) {
+    console.log("[drawMatImage] Panel was disposed during overview read, aborting");
+    return;
+  }
+  if (!overview) {
+    throw new Error("Failed to read Mat overview");
+  }
+
+  PanelManager.updateStateToken("MatImageViewer", debugSession.id, panelName, stateToken);
+
+  // A tiled webview is built for one geometry; anything else gets fresh HTML
+  const previous = (panel as any)._tiledInfo;
+  const sameLayout = previous && previous.rows === rows && previous.cols === cols &&
+    previous.channels === channels && previous.depth === depth;
+  if (!sameLayout || !(panel.webview.html && panel.webview.html.length > 0)) {
+    setupMatPanel(panel, debugSession, panelName, variableName, rows, cols, channels, depth, {
+      tileSize: TILE_SIZE,
+      overviewLevel
+    });
+  }
+  (panel as any)._tiledInfo = { rows, cols, channels, depth };
+  (panel as any)._tiledLayout = layout;
+  (panel as any)._lastMatData = undefined;
+  (panel as any)._sliceLayout = undefined;
+  (panel as any)._sliceHandler = undefined;
+
+  // Requests queued by the webview for older data are dropped by the token check
+  (panel as any)._tileToken = stateToken;
+  (panel as any)._tileHandler = (message: any) =>
+    serveTileRequest(
+      debugSession,
+      panel,
+      layout,
+      cacheKey,
+      message.level,
+      message.tiles,
+      () => (panel as any)._tileToken === stateToken
+    );
+
+  console.log(`[drawMatImage] Tiled mode: overview level ${overviewLevel} (${overview.length} bytes)`);
+  postToPanel(panel, { command: 'overviewData', data: new Uint8Array(overview) });
+}
+
+/**
+ * Show an N-D Mat or volume one 2D slice at a time (see matSlices.ts). The slice
+ * the panel was on is kept across steps while the shape stays the same; the
+ * webview's sliders ask for other slices until the next refresh.
+ */
+async function drawSlicedVolume(
+  debugSession: vscode.DebugSession,
+  panelName: string,
+  variableName: string,
+  layout: VolumeLayout,
+  reveal: boolean,
+  force: boolean
+) {
+  const { rows, cols, channels, depth } = layout;
+  const sliceBytes = rows * sliceRowBytes(layout);
+  if (sliceBytes >= LARGE_IMAGE_BYTES) {
+    throw new Error(`Slices of ${cols}x${rows} are too large to show`);
+  }
+
+  const panel = PanelManager.getOrCreatePanel(
+    "MatImageViewer",
+    `View: ${panelName}`,
+    debugSession.id,
+    panelName,
+    reveal,
+    "0x" + layout.base.toString(16)
+  );
+
+  const previous = (panel as any)._sliceLayout as VolumeLayout | undefined;
+  const sameShape = !!previous && sameVolumeShape(previous, layout);
+  const index = sameShape || (panel as any)._sliceIndex
+    ? clampSliceIndex(layout, (panel as any)._sliceIndex)
+    : layout.shape.map(() => 0);
+  const address = sliceAddress(layout, index);
+  const sample = await getMemorySample(debugSession, address, sliceBytes);
+  const stateToken = `${layout.shape.join("x")}|${rows}|${cols}|${channels}|${depth}|${address}|${sample}`;
+  if (!force && sameShape && PanelManager.isPanelFresh("MatImageViewer", debugSession.id, panelName, stateToken)) {
+    console.log(`Slice panel is already up-to-date with token: ${stateToken}`);
+    return;
+  }
+
+  const buffer = await vscode.window.withProgress(
+    {
+      location: vscode.ProgressLocation.Notification,
+      title: `Loading slice [${index.join(", ")}] of ${layout.shape.join("x")}x${rows}x${cols}`,
+      cancellable: false
+    },
+    (progress) => readSlice(debugSession, layout, index, progress)
+  );
+  if ((panel as any)._isDisposing) {
+    console.log("[drawSlicedVolume] Panel was disposed during slice read, aborting");
+    return;
+  }
+  if (!buffer) {
+    throw new Error("Failed to read the slice");
+  }
+
+  PanelManager.updateStateToken("MatImageViewer", debugSession.id, panelName, stateToken);
+  if ((panel as any)._tiledInfo) {
+    (panel as any)._tiledInfo = undefined;
+    (panel as any)._tiledLayout = undefined;
+    (panel as any)._tileHandler = undefined;
+  }
+  if (!sameShape || !(panel.webview.html && panel.webview.html.length > 0)) {
+    setupMatPanel(panel, debugSession, panelName, variableName, rows, cols, channels, depth, undefined, {
+      shape: layout.shape,
+      index
+    });
+  }
+  (panel as any)._sliceLayout = layout;
+  (panel as any)._sliceHandler = (message: any) => serveSliceRequest(debugSession, panel, panelName, layout, message);
+  keepSlice(debugSession, panel, panelName, layout, index, buffer);
+  FrameRecorder.capture(panel, { kind: 'mat', data: buffer, rows, cols, channels, depth });
+
+  postToPanel(panel, { command: 'completeData', data: new Uint8Array(buffer), rows, cols, channels, depth, sliceIndex: index });
+  prefetchSlices(debugSession, panel, layout, index, layout.shape.length - 1);
+}
+
+// A slider moved: read the slice it points at and the next ones along that axis
+async function serveSliceRequest(
+  debugSession: vscode.DebugSession,
+  panel: vscode.WebviewPanel,
+  panelName: string,
+  layout: VolumeLayout,
+  message: any
+) {
+  const index = clampSliceIndex(layout, message.index);
+  // The slice asked for goes before the neighbours of the previous one
+  cancelSlicePrefetch(panel);
+  let buffer: Buffer | null = null;
+  try {
+    buffer = await readSlice(debugSession, layout, index);
+  } catch (e) {
+    console.log("[Slices] Slice read failed:", e);
+  }
+  if ((panel as any)._isDisposing || (panel as any)._sliceLayout !== layout) {
+    return;
+  }
+  if (!buffer) {
+    postToPanel(panel, { command: 'sliceFailed', sliceIndex: (panel as any)._sliceIndex || index });
+    return;
+  }
+  keepSlice(debugSession, panel, panelName, layout, index, buffer);
+  const { rows, cols, channels, depth } = layout;
+  postToPanel(panel, { command: 'completeData', data: new Uint8Array(buffer), rows, cols, channels, depth, sliceIndex: index });
+  prefetchSlices(debugSession, panel, layout, index, Number(message.axis));
+}
+
+function keepSlice(
+  debugSession: vscode.DebugSession,
+  panel: vscode.WebviewPanel,
+  panelName: string,
+  layout: VolumeLayout,
+  index: number[],
+  buffer: Buffer
+) {
+  const { rows, cols, channels, depth } = layout;
+  (panel as any)._sliceIndex = index;
+  (panel as any)._lastMatData = { buffer, rows, cols, channels, depth };
+  MatCompare.update(debugSession.id, panelName, (panel as any)._lastMatData);
+}
+
+// Set the Mat webview HTML and wire its messages (sync, highlight, reload)
+function setupMatPanel(
+  panel: vscode.WebviewPanel,
+  debugSession: vscode.DebugSession,
+  panelName: string,
+  variableName: string,
+  rows: number,
+  cols: number,
+  channels: number,
+  depth: number,
+  tiled?: TiledImageInfo,
+  slices?: SliceAxes
+) {
+  panel.webview.html = getWebviewContentForMat(
+    panel.webview,
+    rows,
+    cols,
+    channels,
+    depth,
+    { base64: "" }, // Don't embed data directly, send via message
+    tiled,
+    slices
+  );
+
+  // Send ready signal immediately so webview knows this is not a moved panel
+  panel.webview.postMessage({ command: 'ready' });
+
+  SyncManager.registerPanel(panelName, panel);
+  
+  // Dispose previous listener if it exists to avoid multiple listeners on reused panel
+  if ((panel as any)._syncListener) {
+    (panel as any)._syncListener.dispose();
+  }
+
+  (panel as any)._syncListener = panel.webview.onDidReceiveMessage(
+    async (message) => {
+      // Ignore all messages if panel is being disposed
+      if ((panel as any)._isDisposing) {
+        return;
+      }
+      if (message.command === 'viewChanged') {
+        SyncManager.syncView(panelName, message.state);
+      } else if (message.command === 'pixelHighlight') {
+        SyncManager.syncPixelHighlight(panelName, message.pixelX, message.pixelY);
+      } else if (message.command === 'webviewReady') {
+        logDebug(`webviewReady received for ${panelName}, restoring state`);
+        SyncManager.restoreState(panelName);
+      } else if (message.command === 'requestTiles') {
+        const tileHandler = (panel as any)._tileHandler;
+        if (tileHandler) {
+          tileHandler(message).catch((e: Error) => console.log("[Tiles] Tile request failed:", e));
+        }
+      } else if (message.command === 'selectSlice') {
+        const sliceHandler = (panel as any)._sliceHandler;
+        if (sliceHandler) {
+          sliceHandler(message).catch((e: Error) => console.log("[Slices] Slice request failed:", e));
+        }
+      } else if (message.command === 'exportData') {
+        await exportMatData(panel, debugSession, panelName, message.format);
+      } else if (message.command === 'reload') {
+        const reloadStartTime = Date.now();
+        logDebug(`reload message received for ${variableName} at ${reloadStartTime}`);
+        
+        // Check if debug session is still active before reloading
+        const currentSession = vscode.debug.activeDebugSession;
+        if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
+          logDebug(`reload: starting executeCommand (fire-and-forget) at ${Date.now()}`);
+          // CRITICAL: Fire-and-forget - don't await to avoid blocking
+          Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: variableName, evaluateName: variableName, skipToken: true }))
+            .then(() => logDebug(`reload: executeCommand completed at ${Date.now()}`))
+            .catch((e: Error) => logDebug(`reload: executeCommand failed:`, e));
+        } else {
+          console.log('Skipping reload - debug session is no longer active or panel is disposing');
+        }
+        
+        logDebug(`reload handler finished for ${variableName} at ${Date.now()}`);
+      }
+    }
+  );
+}
+
+/**
+ * Save the data behind a Mat panel as TIFF or NPY, streamed to the file chosen by
+ * the user. Whole images are written from the buffer the panel was drawn from;
+ * tiled ones are read from the debuggee in row bands while the file is written.
+ */
+async function exportMatData(
+  panel: vscode.WebviewPanel,
+  debugSession: vscode.DebugSession,
+  panelName: string,
+  format: string
+) {
+  const isTiff = format === 'tiff';
+  const fileExt = isTiff ? 'tiff' : 'npy';
+  try {
+    let source: RasterSource | undefined;
+    const data = (panel as any)._lastMatData as
+      { buffer: Buffer; rows: number; cols: number; channels: number; depth: number } | undefined;
+    const tiledInfo = (panel as any)._tiledInfo as
+      { rows: number; cols: number; channels: number; depth: number } | undefined;
+    const layout = (panel as any)._tiledLayout as MatLayout | undefined;
+    if (data) {
+      source = bufferRasterSource(data.buffer, data.rows, data.cols, data.channels, data.depth);
+    } else if (tiledInfo && layout) {
+      source = {
+        ...tiledInfo,
+        readRows: async (y0, count) => {
+          const band = await readPyramidRegion(debugSession, layout, 0, 0, y0, tiledInfo.cols, count);
+          if (!band) {
+            throw new Error(`Failed to read rows ${y0}-${y0 + count - 1}`);
+          }
+          return band;
+        }
+      };
+    }
+    if (!source) {
+      vscode.window.showWarningMessage(`No image data to save for ${panelName}; reload the variable first.`);
+      return;
+    }
+
+    const uri = await vscode.window.showSaveDialog({
+      defaultUri: vscode.Uri.file(`${panelName}.${fileExt}`),
+      filters: isTiff
+        ? { "TIFF Images": ["tiff", "tif"], "All Files": ["*"] }
+        : { "NumPy Arrays": ["npy"], "All Files": ["*"] }
+    });
+    if (!uri) {
+      return;
+    }
+
+    const target = source;
+    await vscode.window.withProgress(
+      {
+        location: vscode.ProgressLocation.Notification,
+        title: `Saving ${panelName} (${target.cols}x${target.rows}) as ${fileExt.toUpperCase()}`,
+        cancellable: false
+      },
+      () => isTiff ? writeTiff(uri.fsPath, target) : writeNpyImage(uri.fsPath, target)
+    );
+    vscode.window.showInformationMessage(`Image saved to ${uri.fsPath}`);
+  } catch (error) {
+    vscode.window.showErrorMessage(`Failed to save image: ${error}`);
+    console.error("Error saving image:", error);
+  }
+}
+
+export interface MatInfo {
+  rows: number;
+  cols: number;
+  channels: number;
+  depth: number;
+  dataPtr: string;
+  step: number;
+  // dims > 2: rows and cols are -1, the shape is at size.p and the steps at step.p
+  dims: number;
+  sizePtr: string;
+  stepPtr: string;
+}
+
 // Get Mat info from LLDB variables request
 export async function getMatInfoFromVariables(
   debugSession: vscode.DebugSession,
-  variablesReference: number
-): Promise<{ rows: number; cols: number; channels: number; depth: number; dataPtr: string }> {
+  variablesReference: number,
+  typeName?: string
+): Promise<MatInfo> {
   // Get the children of the Mat variable
-  console.log("Getting Mat variables from reference:", variablesReference);
-  const varsResponse = await debugSession.customRequest("variables", {
+  logDebug("Getting Mat variables from reference:", variablesReference);
+  const varsResponse = await tracedCustomRequest(debugSession, "variables", {
     variablesReference: variablesReference
   });
   
-  console.log("Mat variables count:", varsResponse.variables.length);
+  logDebug("Mat variables count:", varsResponse.variables.length);
   for (const v of varsResponse.variables) {
-    console.log(`  ${v.name} = ${v.value} (memRef: ${v.memoryReference}, varRef: ${v.variablesReference})`);
+    logDebug(`  ${v.name} = ${v.value} (memRef: ${v.memoryReference}, varRef: ${v.variablesReference})`);
   }
   
-  let rows = 0, cols = 0, channels = 1, depth = 0, dataPtr = "";
-  let flags = 0;
+  let rows = 0, cols = 0, channels = 1, depth = 0, dataPtr = "", step = 0;
+  let flags = 0, dims = 2;
+  let stepVariable: any = null;
+  let sizeVariable: any = null;
+
+  // Which layout worked for this type before ("inner" Mat member or "direct" fields)
+  const typeKey = typeName ? StrategyCache.normalizeType(typeName) : "";
+  const knownPath = typeKey ? StrategyCache.get(debugSession, "matInfo", typeKey) : undefined;
   
   // Check if this is a cv::Mat_<T> with an internal cv::Mat member
   // For cv::Mat_<T>, the actual Mat data is stored in an internal cv::Mat member
-  for (const v of varsResponse.variables) {
+  for (const v of (knownPath === "direct" ? [] : varsResponse.variables)) {
     const name = v.name;
     const value = v.value;
     
     // If we find a cv::Mat member (for cv::Mat_<T>), recursively get its info
     if (name === "cv::Mat" || name.includes("cv::Mat") || (name === "Mat" && value.includes("rows"))) {
-      console.log(`Found internal Mat member: ${name}, recursively getting info...`);
+      logDebug(`Found internal Mat member: ${name}, recursively getting info...`);
       if (v.variablesReference > 0) {
         const innerMatInfo = await getMatInfoFromVariables(debugSession, v.variablesReference);
-        rows = innerMatInfo.rows;
-        cols = innerMatInfo.cols;
-        channels = innerMatInfo.channels;
-        depth = innerMatInfo.depth;
-        dataPtr = innerMatInfo.dataPtr;
-        console.log(`Got Mat info from internal Mat member: ${rows}x${cols}, ${channels} channels, depth=${depth}, dataPtr=${dataPtr}`);
+        logDebug(`Got Mat info from internal Mat member: ${innerMatInfo.rows}x${innerMatInfo.cols}, ${innerMatInfo.channels} channels, depth=${innerMatInfo.depth}, dataPtr=${innerMatInfo.dataPtr}`);
         // Return immediately if we got info from internal Mat
-        if (rows > 0 && cols > 0 && dataPtr) {
-          return { rows, cols, channels, depth, dataPtr };
+        if (((innerMatInfo.rows > 0 && innerMatInfo.cols > 0) || innerMatInfo.dims > 2) && innerMatInfo.dataPtr) {
+          if (typeKey) StrategyCache.set(debugSession, "matInfo", typeKey, "inner");
+          return innerMatInfo;
         }
       }
     }
@@ -422,42 +1048,42 @@ export async function getMatInfoFromVariables(
       // 1. First check if memoryReference is available (most reliable)
       if (v.memoryReference) {
         dataPtr = v.memoryReference;
-        console.log("Got data pointer from memoryReference:", dataPtr);
+        logDebug("Got data pointer from memoryReference:", dataPtr);
       } 
       // 2. Try to extract from value string
       else {
         const ptrMatch = value.match(/0x[0-9a-fA-F]+/);
         if (ptrMatch) {
           dataPtr = ptrMatch[0];
-          console.log("Got data pointer from value:", dataPtr);
+          logDebug("Got data pointer from value:", dataPtr);
         }
       }
       // 3. If still no pointer and has variablesReference, try to expand
       if (!dataPtr && v.variablesReference > 0) {
         try {
-          const dataVars = await debugSession.customRequest("variables", {
+          const dataVars = await tracedCustomRequest(debugSession, "variables", {
             variablesReference: v.variablesReference
           });
-          console.log("Expanded data variable:", dataVars.variables.map((x: any) => x.name + "=" + x.value));
+          logDebug("Expanded data variable:", dataVars.variables.map((x: any) => x.name + "=" + x.value));
           // Look for __ptr or raw pointer value
           for (const dv of dataVars.variables) {
             if (dv.memoryReference) {
               dataPtr = dv.memoryReference;
-              console.log("Got data pointer from expanded memoryReference:", dataPtr);
+              logDebug("Got data pointer from expanded memoryReference:", dataPtr);
               break;
             }
             const ptrMatch2 = dv.value?.match(/0x[0-9a-fA-F]+/);
             if (ptrMatch2) {
               dataPtr = ptrMatch2[0];
-              console.log("Got data pointer from expanded value:", dataPtr);
+              logDebug("Got data pointer from expanded value:", dataPtr);
               break;
             }
           }
         } catch (e) {
-          console.log("Failed to expand data variable:", e);
+          logDebug("Failed to expand data variable:", e);
         }
       }
-      console.log("Final extracted data pointer:", dataPtr, "from value:", value);
+      logDebug("Final extracted data pointer:", dataPtr, "from value:", value);
     } else if (name === "flags") {
       flags = parseInt(value);
       // Extract depth and channels from flags
@@ -467,19 +1093,112 @@ export async function getMatInfoFromVariables(
       const type = flags & 0xFFF;
       depth = type & 7;  // CV_MAT_DEPTH_MASK = 7
       channels = ((type >> 3) & 63) + 1;  // ((type >> 3) & 63) gives (channels - 1)
-      console.log(`Extracted from flags ${flags} (0x${flags.toString(16)}): type=0x${type.toString(16)}, depth=${depth}, channels=${channels}`);
+      logDebug(`Extracted from flags ${flags} (0x${flags.toString(16)}): type=0x${type.toString(16)}, depth=${depth}, channels=${channels}`);
+    } else if (name === "step") {
+      stepVariable = v;
+    } else if (name === "dims") {
+      dims = parseInt(value) || 2;
+    } else if (name === "size") {
+      sizeVariable = v;
     }
   }
+
+  // N-D Mats (rows = cols = -1) are described by size.p[] and step.p[]
+  if (dims > 2) {
+    const sizePtr = sizeVariable ? await getPointerMember(debugSession, sizeVariable) : "";
+    const stepPtr = stepVariable ? await getPointerMember(debugSession, stepVariable) : "";
+    logDebug(`N-D Mat: dims=${dims}, size.p=${sizePtr}, step.p=${stepPtr}, dataPtr=${dataPtr}`);
+    return { rows, cols, channels, depth, dataPtr, step: 0, dims, sizePtr, stepPtr };
+  }
+
+  // Only ROIs and padded Mats need the row step; continuous Mats skip the lookup
+  if (stepVariable && !isNaN(flags) && !(flags & MAT_CONTINUOUS_FLAG)) {
+    step = await getMatStepFromVariable(debugSession, stepVariable);
+    logDebug(`Mat is not continuous, step[0]=${step}`);
+  }
   
   // If channels wasn't found properly, try to infer from type string
   if (channels === 1 && flags > 0) {
     // Check if it's likely a color image based on common formats
     // CV_8UC3 has flags where channel info might be encoded differently
-    console.log("Warning: channels might be incorrect, defaulting to inferred value");
+    logDebug("Warning: channels might be incorrect, defaulting to inferred value");
   }
   
-  console.log(`Final Mat info: rows=${rows}, cols=${cols}, channels=${channels}, depth=${depth}, dataPtr=${dataPtr}`);
-  return { rows, cols, channels, depth, dataPtr };
+  logDebug(`Final Mat info: rows=${rows}, cols=${cols}, channels=${channels}, depth=${depth}, dataPtr=${dataPtr}`);
+  if (typeKey && rows > 0 && cols > 0 && dataPtr) {
+    StrategyCache.set(debugSession, "matInfo", typeKey, "direct");
+  }
+  return { rows, cols, channels, depth, dataPtr, step, dims, sizePtr: "", stepPtr: "" };
+}
+
+// The `p` pointer of a MatSize / MatStep member, from its summary
+// ("{p = 0x...}") or its expanded children
+async function getPointerMember(debugSession: vscode.DebugSession, variable: any): Promise<string> {
+  const summary = String(variable.value || "").match(/0x[0-9a-fA-F]+/);
+  if (summary) {
+    return summary[0];
+  }
+  if (!(variable.variablesReference > 0)) {
+    return "";
+  }
+  try {
+    const children = await tracedCustomRequest(debugSession, "variables", {
+      variablesReference: variable.variablesReference
+    });
+    const p = children.variables.find((c: any) => c.name === "p");
+    if (p) {
+      return p.memoryReference || String(p.value || "").match(/0x[0-9a-fA-F]+/)?.[0] || "";
+    }
+  } catch (e) {
+    logDebug("Failed to expand Mat member:", e);
+  }
+  return "";
+}
+
+// step[0] of a cv::Mat. MatStep is { size_t* p; size_t buf[2]; } and shows up either
+// as a summary ("{p = 0x..., buf = {1920, 3}}") or as expandable p/buf children.
+async function getMatStepFromVariable(debugSession: vscode.DebugSession, stepVariable: any): Promise<number> {
+  const summary = String(stepVariable.value || "").match(/buf\s*=[^{]*\{\s*(\d+)/);
+  if (summary) {
+    return parseInt(summary[1]);
+  }
+  if (!(stepVariable.variablesReference > 0)) {
+    return 0;
+  }
+  try {
+    const stepVars = await tracedCustomRequest(debugSession, "variables", {
+      variablesReference: stepVariable.variablesReference
+    });
+    for (const sv of stepVars.variables) {
+      if (sv.name === "[0]") {
+        return parseInt(sv.value) || 0;
+      }
+      if (sv.name === "buf") {
+        const inline = String(sv.value || "").match(/\{\s*(\d+)/);
+        if (inline) {
+          return parseInt(inline[1]);
+        }
+        if (sv.variablesReference > 0) {
+          const bufVars = await tracedCustomRequest(debugSession, "variables", {
+            variablesReference: sv.variablesReference
+          });
+          const first = bufVars.variables.find((b: any) => b.name === "[0]") || bufVars.variables[0];
+          return first ? parseInt(first.value) || 0 : 0;
+        }
+      }
+    }
+  } catch (e) {
+    logDebug("Failed to expand Mat step:", e);
+  }
+  return 0;
+}
+
+// cv::Mat::CONTINUOUS_FLAG
+const MAT_CONTINUOUS_FLAG = 1 << 14;
+
+// Rows of a non-continuous Mat (ROI, padding) are further apart than one row
+function isStrided(layout: { rows: number; step: number } | undefined, totalBytes: number): boolean {
+  return !!layout && layout.rows > 1 && layout.step > totalBytes / layout.rows;
 }
 
 // Read Mat data using single readMemory call (fastest)
@@ -489,7 +1208,8 @@ export async function readMatDataFast(
   frameId: number,
   dataSize: number,
   depth: number,
-  progress: vscode.Progress<{ message?: string; increment?: number }>
+  progress: vscode.Progress<{ message?: string; increment?: number }>,
+  layout?: { rows: number; step: number }
 ): Promise<{ buffer: Buffer | null }> {
   const bytesPerElement = getBytesPerElement(depth);
   const totalBytes = dataSize * bytesPerElement;
@@ -520,11 +1240,26 @@ export async function readMatDataFast(
     return { buffer: null };
   }
   
-  console.log(`Data pointer: ${dataPtr}, reading ${totalBytes} bytes in chunked requests`);
+  console.log(`Data pointer: ${dataPtr}, reading ${totalBytes} bytes`);
   progress.report({ message: `Reading ${totalBytes} bytes...` });
   
-  // Chunked readMemory calls for ALL data
+  // Prefer a binary dump file, fall back to chunked readMemory calls
   try {
+    if (isStrided(layout, totalBytes)) {
+      const gathered = await readMemoryGathered(
+        debugSession, dataPtr, layout!.rows, totalBytes / layout!.rows, layout!.step, frameId, progress
+      );
+      if (!gathered) {
+        vscode.window.showErrorMessage("readMemory returned no data");
+      }
+      return { buffer: gathered };
+    }
+
+    const dumped = await readMemoryViaDumpFile(debugSession, dataPtr, totalBytes, frameId);
+    if (dumped) {
+      return { buffer: dumped };
+    }
+
     const buffer = await readMemoryChunked(debugSession, dataPtr, totalBytes, progress);
     
     if (buffer) {
@@ -535,6 +1270,7 @@ export async function readMatDataFast(
       return { buffer: null };
     }
   } catch (e: any) {
+    if (isReadCancelled(e)) throw e;
     console.log("readMemory error:", e.message || e);
     vscode.window.showErrorMessage(
       `readMemory failed: ${e.message || e}. Please use cppvsdbg or lldb.`
@@ -550,7 +1286,8 @@ export async function readMatDataForLLDB(
   frameId: number,
   dataSize: number,
   depth: number,
-  progress: vscode.Progress<{ message?: string; increment?: number }>
+  progress: vscode.Progress<{ message?: string; increment?: number }>,
+  layout?: { rows: number; step: number }
 ): Promise<{ buffer: Buffer | null }> {
   const bytesPerElement = getBytesPerElement(depth);
   const totalBytes = dataSize * bytesPerElement;
@@ -563,11 +1300,26 @@ export async function readMatDataForLLDB(
     return { buffer: null };
   }
   
-  console.log(`LLDB: Reading ${totalBytes} bytes in chunked requests`);
+  console.log(`LLDB: Reading ${totalBytes} bytes`);
   progress.report({ message: `Reading ${totalBytes} bytes...` });
   
-  // Chunked readMemory calls for ALL data
+  // Prefer a binary dump file, fall back to chunked readMemory calls
   try {
+    if (isStrided(layout, totalBytes)) {
+      const gathered = await readMemoryGathered(
+        debugSession, dataPtr, layout!.rows, totalBytes / layout!.rows, layout!.step, frameId, progress
+      );
+      if (!gathered) {
+        vscode.window.showErrorMessage("LLDB readMemory returned no data");
+      }
+      return { buffer: gathered };
+    }
+
+    const dumped = await readMemoryViaDumpFile(debugSession, dataPtr, totalBytes, frameId);
+    if (dumped) {
+      return { buffer: dumped };
+    }
+
     const buffer = await readMemoryChunked(debugSession, dataPtr, totalBytes, progress);
     
     if (buffer) {
@@ -578,6 +1330,7 @@ export async function readMatDataForLLDB(
       return { buffer: null };
     }
   } catch (e: any) {
+    if (isReadCancelled(e)) throw e;
     console.log("LLDB readMemory error:", e.message || e);
     vscode.window.showWarningMessage(
       `LLDB readMemory failed: ${e.message || e}. Creating placeholder image.`
@@ -718,6 +1471,11 @@ export async function drawMatxImage(
     
     // Update state token
     PanelManager.updateStateToken("MatImageViewer", debugSession.id, panelName, stateToken);
+    if (dataResult.buffer) {
+      (panel as any)._lastMatData = { buffer: dataResult.buffer, rows, cols, channels, depth };
+      FrameRecorder.capture(panel, { kind: 'mat', data: dataResult.buffer, rows, cols, channels, depth });
+      MatCompare.update(debugSession.id, panelName, (panel as any)._lastMatData);
+    }
     
     // If panel already has content, only send data
     if (panel.webview.html && panel.webview.html.length > 0) {
@@ -734,7 +1492,7 @@ export async function drawMatxImage(
         // CRITICAL: Don't await postMessage - it can block and cause debug freeze
         try {
           // Fire and forget - don't await
-          panel.webview.postMessage({
+          tracePost(panel.webview, {
             command: 'completeData',
             data: new Uint8Array(buffer),
             rows, cols, channels, depth
@@ -772,16 +1530,18 @@ export async function drawMatxImage(
         } else if (message.command === 'pixelHighlight') {
           SyncManager.syncPixelHighlight(panelName, message.pixelX, message.pixelY);
         } else if (message.command === 'webviewReady') {
-          console.log(`[DEBUG-TRACE] webviewReady received for Matx ${panelName}, restoring state`);
+          logDebug(`webviewReady received for Matx ${panelName}, restoring state`);
           SyncManager.restoreState(panelName);
+        } else if (message.command === 'exportData') {
+          await exportMatData(panel, debugSession, panelName, message.format);
         } else if (message.command === 'reload') {
           // Check if debug session is still active before reloading
           const currentSession = vscode.debug.activeDebugSession;
           if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
             // CRITICAL: Fire-and-forget - don't await to avoid blocking
             Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: variableName, evaluateName: variableName, skipToken: true }))
-              .then(() => console.log(`[DEBUG-TRACE] Matx reload completed`))
-              .catch((e: Error) => console.log(`[DEBUG-TRACE] Matx reload failed:`, e));
+              .then(() => logDebug(`Matx reload completed`))
+              .catch((e: Error) => logDebug(`Matx reload failed:`, e));
           } else {
             console.log('Skipping reload - debug session is no longer active or has changed');
           }
@@ -804,7 +1564,7 @@ export async function drawMatxImage(
     
     try {
       // Fire and forget - don't await
-      panel.webview.postMessage({
+      tracePost(panel.webview, {
         command: 'completeData',
         data: new Uint8Array(buffer)
       });
@@ -841,7 +1601,7 @@ export async function draw2DStdArrayImage(
     const bytesPerElement = getBytesPerElement(depth);
     const totalBytes = dataSize * bytesPerElement;
     
-    console.log(`[DEBUG-TRACE] draw2DStdArrayImage START at ${Date.now()}: ${rows}x${cols}, depth=${depth}, totalBytes=${totalBytes}`);
+    logDebug(`draw2DStdArrayImage START at ${Date.now()}: ${rows}x${cols}, depth=${depth}, totalBytes=${totalBytes}`);
     
     const panelTitle = `View: ${panelName}`;
     
@@ -849,25 +1609,25 @@ export async function draw2DStdArrayImage(
     // Determine if this is a C-style array or std::array based on type information
     const isCStyleArray = variableInfo.type && /\s*\[\s*\d+\s*\]\s*\[\s*\d+\s*\]/.test(variableInfo.type);
     let dataPtr: string | null;
-    console.log(`[DEBUG-TRACE] draw2DStdArrayImage: getting data pointer at ${Date.now()}`);
+    logDebug(`draw2DStdArrayImage: getting data pointer at ${Date.now()}`);
     if (isCStyleArray) {
       dataPtr = await getCStyle2DArrayDataPointer(debugSession, variableName, frameId, variableInfo);
     } else {
       dataPtr = await get2DStdArrayDataPointer(debugSession, variableName, frameId, variableInfo);
     }
-    console.log(`[DEBUG-TRACE] draw2DStdArrayImage: got data pointer at ${Date.now()}, dataPtr=${dataPtr}`);
+    logDebug(`draw2DStdArrayImage: got data pointer at ${Date.now()}, dataPtr=${dataPtr}`);
     
     if (!dataPtr) {
       throw new Error("Cannot get data pointer from 2D std::array. Make sure it's a valid std::array.");
     }
     
     // Check if panel is fresh
-    console.log(`[DEBUG-TRACE] draw2DStdArrayImage: getting memory sample at ${Date.now()}`);
+    logDebug(`draw2DStdArrayImage: getting memory sample at ${Date.now()}`);
     const sample = await getMemorySample(debugSession, dataPtr, totalBytes);
-    console.log(`[DEBUG-TRACE] draw2DStdArrayImage: got memory sample at ${Date.now()}`);
+    logDebug(`draw2DStdArrayImage: got memory sample at ${Date.now()}`);
     const stateToken = `${rows}|${cols}|${channels}|${depth}|${dataPtr}|${sample}`;
     
-    console.log(`[DEBUG-TRACE] draw2DStdArrayImage: getting/creating panel at ${Date.now()}`);
+    logDebug(`draw2DStdArrayImage: getting/creating panel at ${Date.now()}`);
     const panel = PanelManager.getOrCreatePanel(
       "MatImageViewer",
       panelTitle,
@@ -876,11 +1636,11 @@ export async function draw2DStdArrayImage(
       reveal,
       dataPtr  // Enable sharing panels by data pointer
     );
-    console.log(`[DEBUG-TRACE] draw2DStdArrayImage: got panel at ${Date.now()}, isDisposing=${(panel as any)._isDisposing}`);
+    logDebug(`draw2DStdArrayImage: got panel at ${Date.now()}, isDisposing=${(panel as any)._isDisposing}`);
 
     // CRITICAL: Check if panel was disposed during async operations
     if ((panel as any)._isDisposing) {
-      console.log(`[DEBUG-TRACE] draw2DStdArrayImage: ABORTING - panel was disposed during data pointer fetch`);
+      logDebug(`draw2DStdArrayImage: ABORTING - panel was disposed during data pointer fetch`);
       return;
     }
 
@@ -890,7 +1650,7 @@ export async function draw2DStdArrayImage(
     }
     
     // Read data with progress indicator
-    console.log(`[DEBUG-TRACE] draw2DStdArrayImage: starting readMemoryChunked at ${Date.now()}`);
+    logDebug(`draw2DStdArrayImage: starting readMemoryChunked at ${Date.now()}`);
     const dataResult = await vscode.window.withProgress(
       {
         location: vscode.ProgressLocation.Notification,
@@ -903,20 +1663,25 @@ export async function draw2DStdArrayImage(
         return { buffer };
       }
     );
-    console.log(`[DEBUG-TRACE] draw2DStdArrayImage: readMemoryChunked completed at ${Date.now()}, isDisposing=${(panel as any)._isDisposing}`);
+    logDebug(`draw2DStdArrayImage: readMemoryChunked completed at ${Date.now()}, isDisposing=${(panel as any)._isDisposing}`);
     
     // CRITICAL: Check if panel was disposed during memory read
     if ((panel as any)._isDisposing) {
-      console.log(`[DEBUG-TRACE] draw2DStdArrayImage: ABORTING - panel was disposed during memory read`);
+      logDebug(`draw2DStdArrayImage: ABORTING - panel was disposed during memory read`);
       return;
     }
     
     // Update state token
     PanelManager.updateStateToken("MatImageViewer", debugSession.id, panelName, stateToken);
+    if (dataResult.buffer) {
+      (panel as any)._lastMatData = { buffer: dataResult.buffer, rows, cols, channels, depth };
+      FrameRecorder.capture(panel, { kind: 'mat', data: dataResult.buffer, rows, cols, channels, depth });
+      MatCompare.update(debugSession.id, panelName, (panel as any)._lastMatData);
+    }
     
     // If panel already has content, only send data
     if (panel.webview.html && panel.webview.html.length > 0) {
-      console.log(`[DEBUG-TRACE] draw2DStdArrayImage: panel already has HTML, sending only data at ${Date.now()}`);
+      logDebug(`draw2DStdArrayImage: panel already has HTML, sending only data at ${Date.now()}`);
       
       // Check if panel is being disposed before sending data
       if ((panel as any)._isDisposing) {
@@ -934,8 +1699,7 @@ export async function draw2DStdArrayImage(
             return;
           }
           try {
-            console.log(`[DEBUG-TRACE] draw2DStdArrayImage: sending deferred postMessage at ${Date.now()}`);
-            panelRef.webview.postMessage({
+            tracePost(panelRef.webview, {
               command: 'completeData',
               data: new Uint8Array(buffer),
               rows, cols, channels, depth
@@ -973,16 +1737,18 @@ export async function draw2DStdArrayImage(
         } else if (message.command === 'pixelHighlight') {
           SyncManager.syncPixelHighlight(panelName, message.pixelX, message.pixelY);
         } else if (message.command === 'webviewReady') {
-          console.log(`[DEBUG-TRACE] webviewReady received for 2D array ${panelName}, restoring state`);
+          logDebug(`webviewReady received for 2D array ${panelName}, restoring state`);
           SyncManager.restoreState(panelName);
+        } else if (message.command === 'exportData') {
+          await exportMatData(panel, debugSession, panelName, message.format);
         } else if (message.command === 'reload') {
           // Check if debug session is still active before reloading
           const currentSession = vscode.debug.activeDebugSession;
           if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
             // CRITICAL: Fire-and-forget - don't await to avoid blocking
             Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: variableName, evaluateName: variableName, skipToken: true }))
-              .then(() => console.log(`[DEBUG-TRACE] 2D array reload completed`))
-              .catch((e: Error) => console.log(`[DEBUG-TRACE] 2D array reload failed:`, e));
+              .then(() => logDebug(`2D array reload completed`))
+              .catch((e: Error) => logDebug(`2D array reload failed:`, e));
           } else {
             console.log('Skipping reload - debug session is no longer active or has changed');
           }
@@ -1005,7 +1771,7 @@ export async function draw2DStdArrayImage(
     
     try {
       // Fire and forget - don't await
-      panel.webview.postMessage({
+      tracePost(panel.webview, {
         command: 'completeData',
         data: new Uint8Array(buffer)
       });
@@ -1035,7 +1801,8 @@ export async function draw3DArrayImage(
     width: number; 
     channels: number; 
     elementType: string; 
-    depth: number 
+    depth: number;
+    isVolume?: boolean
   },
   reveal: boolean = true,
   force: boolean = false,
@@ -1072,6 +1839,13 @@ export async function draw3DArrayImage(
     if (!dataPtr) {
       throw new Error("Cannot get data pointer from 3D array. Make sure it's a valid 3D array.");
     }
+
+    // T[D][H][W] whose last extent is not a channel count: D slices of H x W
+    if (arrayInfo.isVolume) {
+      const layout = getVolumeLayout(dataPtr, height, width, channels, depth);
+      await drawSlicedVolume(debugSession, panelName, variableName, layout, reveal, force);
+      return;
+    }
     
     // Check if panel is fresh
     const sample = await getMemorySample(debugSession, dataPtr, totalBytes);
@@ -1107,6 +1881,11 @@ export async function draw3DArrayImage(
     
     // Update state token
     PanelManager.updateStateToken("MatImageViewer", debugSession.id, panelName, stateToken);
+    if (dataResult.buffer) {
+      (panel as any)._lastMatData = { buffer: dataResult.buffer, rows, cols, channels, depth };
+      FrameRecorder.capture(panel, { kind: 'mat', data: dataResult.buffer, rows, cols, channels, depth });
+      MatCompare.update(debugSession.id, panelName, (panel as any)._lastMatData);
+    }
     
     // If panel already has content, only send data to preserve view state (zoom/pan)
     if (panel.webview.html && panel.webview.html.length > 0) {
@@ -1123,7 +1902,7 @@ export async function draw3DArrayImage(
         // CRITICAL: Don't await postMessage - it can block and cause debug freeze
         try {
           // Fire and forget - don't await
-          panel.webview.postMessage({
+          tracePost(panel.webview, {
             command: 'completeData',
             data: new Uint8Array(buffer),
             rows, cols, channels, depth
@@ -1162,25 +1941,27 @@ export async function draw3DArrayImage(
         } else if (message.command === 'pixelHighlight') {
           SyncManager.syncPixelHighlight(panelName, message.pixelX, message.pixelY);
         } else if (message.command === 'webviewReady') {
-          console.log(`[DEBUG-TRACE] webviewReady received for 3D array ${panelName}, restoring state`);
+          logDebug(`webviewReady received for 3D array ${panelName}, restoring state`);
           SyncManager.restoreState(panelName);
+        } else if (message.command === 'exportData') {
+          await exportMatData(panel, debugSession, panelName, message.format);
         } else if (message.command === 'reload') {
           const reloadStartTime = Date.now();
-          console.log(`[DEBUG-TRACE] 3D array reload message received for ${panelName} at ${reloadStartTime}`);
+          logDebug(`3D array reload message received for ${panelName} at ${reloadStartTime}`);
           
           // Check if debug session is still active before reloading
           const currentSession = vscode.debug.activeDebugSession;
           if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
-            console.log(`[DEBUG-TRACE] 3D array reload: starting executeCommand (fire-and-forget) at ${Date.now()}`);
+            logDebug(`3D array reload: starting executeCommand (fire-and-forget) at ${Date.now()}`);
             // CRITICAL: Fire-and-forget - don't await to avoid blocking
             Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: panelName, evaluateName: variableName, skipToken: true }))
-              .then(() => console.log(`[DEBUG-TRACE] 3D array reload: executeCommand completed at ${Date.now()} (took ${Date.now() - reloadStartTime}ms)`))
-              .catch((e: Error) => console.log(`[DEBUG-TRACE] 3D array reload: executeCommand failed:`, e));
+              .then(() => logDebug(`3D array reload: executeCommand completed at ${Date.now()} (took ${Date.now() - reloadStartTime}ms)`))
+              .catch((e: Error) => logDebug(`3D array reload: executeCommand failed:`, e));
           } else {
             console.log('Skipping reload - debug session is no longer active or has changed');
           }
           
-          console.log(`[DEBUG-TRACE] 3D array reload handler finished for ${panelName} at ${Date.now()}`);
+          logDebug(`3D array reload handler finished for ${panelName} at ${Date.now()}`);
         }
       }
     );
@@ -1190,29 +1971,23 @@ export async function draw3DArrayImage(
       throw new Error("Failed to read 3D array data");
     }
     
-    console.log(`[DEBUG-TRACE] 3D array: Sending ${buffer.length} bytes to webview at ${Date.now()}`);
-    
     // CRITICAL: Don't await postMessage - it can block and cause debug freeze
     if ((panel as any)._isDisposing) {
-      console.log("[DEBUG-TRACE] 3D array: Aborting final data send - panel is being disposed");
+      logDebug("3D array: Aborting final data send - panel is being disposed");
       return;
     }
     
     try {
       // Fire and forget - don't await
-      console.log(`[DEBUG-TRACE] 3D array: postMessage starting at ${Date.now()}`);
-      panel.webview.postMessage({
+      tracePost(panel.webview, {
         command: 'completeData',
         data: new Uint8Array(buffer),
         rows, cols, channels, depth
       });
-      console.log(`[DEBUG-TRACE] 3D array: postMessage completed at ${Date.now()}`);
     } catch (e) {
-      console.log("[DEBUG-TRACE] 3D array: postMessage FAILED:", e);
+      logDebug("3D array: postMessage failed:", e);
       return;
     }
-    
-    console.log(`[DEBUG-TRACE] 3D array data sent to webview at ${Date.now()}`);
   } catch (error) {
     console.error("Error drawing 3D array image:", error);
     throw error;
@@ -0,0 +1,191 @@
+import * as vscode from "vscode";
+import { readMemoryChunked, readMemoryGathered } from "../utils/debugger";
+import { getBytesPerElement } from "../utils/opencv";
+import { isReadCancelled, runCancellable } from "../utils/cancellation";
+
+// ============== N-D Slices ==============
+
+/**
+ * N-D cv::Mat (dims > 2) and 3D array volumes (T[D][H][W] whose last extent is
+ * not a channel count) are shown one 2D slice at a time: the last two axes are
+ * the image and the viewer has a slider for each leading axis. Only the selected
+ * slice is read, then its SLICE_PREFETCH neighbours on each side along the axis
+ * that moved are read in the background into the read cache, so stepping the
+ * slider does not wait for the debugger. A 512^3 volume costs 512^2 elements
+ * per slice, never the whole volume.
+ */
+
+export const SLICE_PREFETCH = 2;
+
+// What the webview gets to build its sliders
+export interface SliceAxes {
+  shape: number[];
+  index: number[];
+}
+
+export interface VolumeLayout {
+  base: bigint;
+  // Extents and byte steps of the leading (slider) axes
+  shape: number[];
+  axisSteps: number[];
+  rows: number;
+  cols: number;
+  channels: number;
+  depth: number;
+  // Bytes between the row starts of a slice
+  rowStep: number;
+}
+
+export function sliceRowBytes(layout: VolumeLayout): number {
+  return layout.cols * layout.channels * getBytesPerElement(layout.depth);
+}
+
+export function sameVolumeShape(a: VolumeLayout, b: VolumeLayout): boolean {
+  return a.rows === b.rows && a.cols === b.cols && a.channels === b.channels && a.depth === b.depth &&
+    a.shape.length === b.shape.length && a.shape.every((extent, i) => extent === b.shape[i]);
+}
+
+/**
+ * `index` from the webview, made valid for `layout` (0 where missing).
+ */
+export function clampSliceIndex(layout: VolumeLayout, index: unknown): number[] {
+  const values = Array.isArray(index) ? index : [];
+  return layout.shape.map((extent, i) => {
+    const v = Math.floor(Number(values[i]) || 0);
+    return Math.min(Math.max(v, 0), extent - 1);
+  });
+}
+
+export function sliceAddress(layout: VolumeLayout, index: number[]): string {
+  let address = layout.base;
+  for (let i = 0; i < layout.shape.length; i++) {
+    address += BigInt(index[i]) * BigInt(layout.axisSteps[i]);
+  }
+  return "0x" + address.toString(16);
+}
+
+/**
+ * The dense rows x cols x channels bytes of one slice.
+ */
+export async function readSlice(
+  debugSession: vscode.DebugSession,
+  layout: VolumeLayout,
+  index: number[],
+  progress?: vscode.Progress<{ message?: string; increment?: number }>
+): Promise<Buffer | null> {
+  const rowBytes = sliceRowBytes(layout);
+  return readMemoryGathered(
+    debugSession,
+    sliceAddress(layout, index),
+    layout.rows,
+    rowBytes,
+    Math.max(layout.rowStep, rowBytes),
+    undefined,
+    progress
+  );
+}
+
+/**
+ * Stop the slice prefetch running for `panel`, if any, before the next read.
+ */
+export function cancelSlicePrefetch(panel: vscode.WebviewPanel) {
+  (panel as any)._slicePrefetchGeneration = ((panel as any)._slicePrefetchGeneration || 0) + 1;
+}
+
+/**
+ * Read the slices next to `index` along `axis` into the read cache, nearest first.
+ * A newer prefetch for the panel, or the panel closing, stops this one.
+ */
+export function prefetchSlices(
+  debugSession: vscode.DebugSession,
+  panel: vscode.WebviewPanel,
+  layout: VolumeLayout,
+  index: number[],
+  axis: number
+) {
+  cancelSlicePrefetch(panel);
+  if (axis < 0 || axis >= layout.shape.length) {
+    return;
+  }
+  const neighbours: number[][] = [];
+  for (let distance = 1; distance <= SLICE_PREFETCH; distance++) {
+    for (const position of [index[axis] + distance, index[axis] - distance]) {
+      if (position >= 0 && position < layout.shape[axis]) {
+        const next = index.slice();
+        next[axis] = position;
+        neighbours.push(next);
+      }
+    }
+  }
+  const generation = (panel as any)._slicePrefetchGeneration;
+  const isCancelled = () => (panel as any)._isDisposing || (panel as any)._slicePrefetchGeneration !== generation;
+  runCancellable(isCancelled, async () => {
+    for (const next of neighbours) {
+      if (isCancelled()) return;
+      await readSlice(debugSession, layout, next);
+    }
+  }).catch((e) => {
+    if (!isReadCancelled(e)) console.log("[Slices] Prefetch failed:", e);
+  });
+}
+
+/**
+ * Layout of an N-D cv::Mat from its dims, `size.p` (int[dims]) and `step.p`
+ * (size_t[dims]) pointers. The last two axes are the slice; channels are
+ * interleaved in the last axis as in a 2D Mat.
+ */
+export async function getNdMatLayout(
+  debugSession: vscode.DebugSession,
+  info: { dims: number; sizePtr: string; stepPtr: string; dataPtr: string; channels: number; depth: number }
+): Promise<VolumeLayout> {
+  const { dims, channels, depth } = info;
+  const base = info.dataPtr.match(/0x[0-9a-fA-F]+/)?.[0];
+  const sizePtr = info.sizePtr.match(/0x[0-9a-fA-F]+/)?.[0];
+  const stepPtr = info.stepPtr.match(/0x[0-9a-fA-F]+/)?.[0];
+  if (!base || !sizePtr || !stepPtr) {
+    throw new Error("Cannot find the data, size and step pointers of the N-D Mat");
+  }
+  const [sizes, steps] = await Promise.all([
+    readMemoryChunked(debugSession, sizePtr, dims * 4),
+    readMemoryChunked(debugSession, stepPtr, dims * 8)
+  ]);
+  if (!sizes || sizes.length < dims * 4 || !steps || steps.length < dims * 8) {
+    throw new Error("Failed to read the size and step of the N-D Mat");
+  }
+  const shape: number[] = [];
+  const axisSteps: number[] = [];
+  for (let i = 0; i < dims; i++) {
+    shape.push(sizes.readInt32LE(i * 4));
+    axisSteps.push(Number(steps.readBigUInt64LE(i * 8)));
+  }
+  if (shape.some((extent) => !(extent > 0))) {
+    throw new Error(`N-D Mat has an empty axis (${shape.join("x")})`);
+  }
+  return {
+    base: BigInt(base),
+    shape: shape.slice(0, dims - 2),
+    axisSteps: axisSteps.slice(0, dims - 2),
+    rows: shape[dims - 2],
+    cols: shape[dims - 1],
+    channels,
+    depth,
+    rowStep: axisSteps[dims - 2]
+  };
+}
+
+/**
+ * Layout of a dense T[D][H][W] volume: D slices of H x W single-channel pixels.
+ */
+export function getVolumeLayout(dataPtr: string, d: number, h: number, w: number, depth: number): VolumeLayout {
+  const rowBytes = w * getBytesPerElement(depth);
+  return {
+    base: BigInt(dataPtr.match(/0x[0-9a-fA-F]+/)?.[0] || dataPtr),
+    shape: [d],
+    axisSteps: [h * rowBytes],
+    rows: h,
+    cols: w,
+    channels: 1,
+    depth,
+    rowStep: rowBytes
+  };
+}
@@ -0,0 +1,241 @@
+import * as vscode from "vscode";
+import { tracedCustomRequest } from "../utils/debugger";
+
+// ============== Large Image Tiles ==============
+
+/**
+ * Mats too large to send to the webview in one piece (16k x 16k depth maps,
+ * stitched panoramas) are shown in tiled mode: the webview gets a decimated
+ * overview of the whole image, then asks for the tiles of the pyramid level that
+ * matches its zoom for the visible rect only.
+ *
+ * Level L is the image decimated by 2^L (nearest pixel). Tiles are TILE_SIZE x
+ * TILE_SIZE pixels in level coordinates and are read straight from the debuggee,
+ * one readMemory per source row, and cached in the extension host LRU below.
+ */
+
+export const TILE_SIZE = 256;
+
+// Mats at least this large use tiled mode instead of one complete buffer
+export const LARGE_IMAGE_BYTES = 256 * 1024 * 1024;
+
+// The overview is the first level whose larger side fits in this many pixels
+const OVERVIEW_MAX_DIM = 1024;
+
+const ROW_READ_CONCURRENCY = 8;
+
+// Cached tile bytes are dropped least-recently-used beyond this budget
+const MAX_TILE_CACHE_BYTES = 256 * 1024 * 1024;
+
+export interface TiledImageInfo {
+  tileSize: number;
+  overviewLevel: number;
+}
+
+export interface MatLayout {
+  base: bigint;
+  rows: number;
+  cols: number;
+  bytesPerPixel: number;
+  // Bytes between row starts (> cols * bytesPerPixel for ROIs and padded Mats)
+  step: number;
+}
+
+export function getOverviewLevel(rows: number, cols: number): number {
+  let level = 0;
+  while (Math.ceil(Math.max(rows, cols) / (1 << level)) > OVERVIEW_MAX_DIM) {
+    level++;
+  }
+  return level;
+}
+
+export function getLevelSize(rows: number, cols: number, level: number): { width: number; height: number } {
+  const factor = 1 << level;
+  return { width: Math.ceil(cols / factor), height: Math.ceil(rows / factor) };
+}
+
+/**
+ * LRU cache of tile buffers shared by all tiled panels. Keys carry the session id
+ * and the panel's state token, so a step that changes the Mat never hits old tiles.
+ */
+export class TileCache {
+  private static tiles: Map<string, Buffer> = new Map();
+  private static cachedBytes = 0;
+
+  static get(key: string): Buffer | undefined {
+    const tile = this.tiles.get(key);
+    if (tile) {
+      // Re-insert to mark as most recently used
+      this.tiles.delete(key);
+      this.tiles.set(key, tile);
+    }
+    return tile;
+  }
+
+  static set(key: string, tile: Buffer) {
+    const existing = this.tiles.get(key);
+    if (existing) {
+      this.cachedBytes -= existing.length;
+      this.tiles.delete(key);
+    }
+    this.tiles.set(key, tile);
+    this.cachedBytes += tile.length;
+
+    for (const [oldestKey, oldest] of this.tiles) {
+      if (this.cachedBytes <= MAX_TILE_CACHE_BYTES || this.tiles.size <= 1) break;
+      this.tiles.delete(oldestKey);
+      this.cachedBytes -= oldest.length;
+    }
+  }
+
+  static clearSession(sessionId: string) {
+    for (const [key, tile] of this.tiles) {
+      if (key.startsWith(`${sessionId}|`)) {
+        this.tiles.delete(key);
+        this.cachedBytes -= tile.length;
+      }
+    }
+  }
+}
+
+/**
+ * Read the rect [x0, x0 + width) x [y0, y0 + height) of pyramid `level`, packed
+ * row by row. Each level row is one readMemory over the source row span, decimated
+ * to every 2^level-th pixel. Returns null if any row read fails.
+ */
+export async function readPyramidRegion(
+  debugSession: vscode.DebugSession,
+  layout: MatLayout,
+  level: number,
+  x0: number,
+  y0: number,
+  width: number,
+  height: number
+): Promise<Buffer | null> {
+  const factor = 1 << level;
+  const bpp = layout.bytesPerPixel;
+  const rowStride = layout.step;
+  const spanBytes = ((width - 1) * factor + 1) * bpp;
+  const out = Buffer.alloc(width * height * bpp);
+
+  let nextRow = 0;
+  let failed = false;
+  const readRows = async () => {
+    while (!failed && nextRow < height) {
+      const r = nextRow++;
+      const srcY = (y0 + r) * factor;
+      const address = layout.base + BigInt(srcY * rowStride + x0 * factor * bpp);
+      try {
+        const response = await tracedCustomRequest(debugSession, "readMemory", {
+          memoryReference: "0x" + address.toString(16),
+          offset: 0,
+          count: spanBytes
+        });
+        const span = response && response.data ? Buffer.from(response.data, "base64") : null;
+        if (!span || span.length !== spanBytes) {
+          failed = true;
+          return;
+        }
+        const dst = r * width * bpp;
+        if (factor === 1) {
+          span.copy(out, dst);
+        } else {
+          for (let i = 0; i < width; i++) {
+            span.copy(out, dst + i * bpp, i * factor * bpp, i * factor * bpp + bpp);
+          }
+        }
+      } catch (e) {
+        console.log(`[Tiles] Row ${srcY} of level ${level} failed:`, e);
+        failed = true;
+      }
+    }
+  };
+
+  await Promise.all(Array.from({ length: Math.min(ROW_READ_CONCURRENCY, height) }, () => readRows()));
+  return failed ? null : out;
+}
+
+/**
+ * Serve a webview tile request: `tiles` are [tx, ty] pairs of one level.
+ * Horizontally adjacent missing tiles are read together (one row span per
+ * source row) and split; each tile is posted as soon as its run is read.
+ */
+export async function serveTileRequest(
+  debugSession: vscode.DebugSession,
+  panel: vscode.WebviewPanel,
+  layout: MatLayout,
+  cacheKey: string,
+  level: number,
+  tiles: [number, number][],
+  isCurrent: () => boolean
+) {
+  const { width: levelWidth, height: levelHeight } = getLevelSize(layout.rows, layout.cols, level);
+  const tilesX = Math.ceil(levelWidth / TILE_SIZE);
+  const tilesY = Math.ceil(levelHeight / TILE_SIZE);
+  const bpp = layout.bytesPerPixel;
+
+  const post = (tx: number, ty: number, data: Buffer) => {
+    if (!isCurrent() || (panel as any)._isDisposing) return;
+    try {
+      panel.webview.postMessage({
+        command: 'tileData',
+        level,
+        tx,
+        ty,
+        width: Math.min(TILE_SIZE, levelWidth - tx * TILE_SIZE),
+        height: Math.min(TILE_SIZE, levelHeight - ty * TILE_SIZE),
+        data: new Uint8Array(data)
+      });
+    } catch (e) {
+      // Panel was disposed, ignore
+    }
+  };
+
+  // Group missing tiles per tile row into runs of adjacent columns
+  const missing = new Map<number, number[]>();
+  for (const [tx, ty] of tiles) {
+    if (tx < 0 || ty < 0 || tx >= tilesX || ty >= tilesY) continue;
+    const cached = TileCache.get(`${cacheKey}|${level}|${tx}|${ty}`);
+    if (cached) {
+      post(tx, ty, cached);
+      continue;
+    }
+    if (!missing.has(ty)) missing.set(ty, []);
+    missing.get(ty)!.push(tx);
+  }
+
+  for (const [ty, columns] of missing) {
+    columns.sort((a, b) => a - b);
+    let i = 0;
+    while (i < columns.length) {
+      if (!isCurrent()) return;
+      let j = i;
+      while (j + 1 < columns.length && columns[j + 1] === columns[j] + 1) j++;
+
+      const x0 = columns[i] * TILE_SIZE;
+      const y0 = ty * TILE_SIZE;
+      const runWidth = Math.min((columns[j] + 1) * TILE_SIZE, levelWidth) - x0;
+      const height = Math.min(TILE_SIZE, levelHeight - y0);
+      const region = await readPyramidRegion(debugSession, layout, level, x0, y0, runWidth, height);
+      if (!region) {
+        console.log(`[Tiles] Failed to read level ${level} tiles ${columns[i]}..${columns[j]}, row ${ty}`);
+        i = j + 1;
+        continue;
+      }
+
+      for (let k = i; k <= j; k++) {
+        const tx = columns[k];
+        const tileX = tx * TILE_SIZE - x0;
+        const tileWidth = Math.min(TILE_SIZE, levelWidth - tx * TILE_SIZE);
+        const tile = Buffer.alloc(tileWidth * height * bpp);
+        for (let r = 0; r < height; r++) {
+          const src = (r * runWidth + tileX) * bpp;
+          region.copy(tile, r * tileWidth * bpp, src, src + tileWidth * bpp);
+        }
+        TileCache.set(`${cacheKey}|${level}|${tx}|${ty}`, tile);
+        post(tx, ty, tile);
+      }
+      i = j + 1;
+    }
+  }
+}
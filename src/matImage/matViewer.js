@@ -0,0 +1,2379 @@
+// Mat image viewer script, loaded by the shell from getWebviewContentForMat.
+// esbuild.js bundles it into dist/media; per-panel values come from the
+// viewer-config block.
+import { initRecordingTimeline } from '../utils/recordingTimeline.js';
+import { initSliceBar } from './sliceBar.js';
+import { bytesToTypedArray, getHalfFloatLut } from './matDecode.js';
+
+const viewerConfig = JSON.parse(document.getElementById('viewer-config').textContent);
+
+(function() {
+    const container = document.getElementById('container');
+    const canvas = document.getElementById('canvas');
+    const gridCanvas = document.getElementById('grid-canvas');
+    const textCanvas = document.getElementById('text-canvas');
+    const ctx = canvas.getContext('2d');
+    const gridCtx = gridCanvas.getContext('2d');
+    const textCtx = textCanvas.getContext('2d');
+    const pixelInfo = document.getElementById('pixelInfo');
+    const statsInfo = document.getElementById('statsInfo');
+    const zoomLevelDisplay = document.getElementById('zoomLevel');
+    const controls = document.getElementById('controls');
+    const togglePixelTextBtn = document.getElementById('togglePixelText');
+    const saveImageBtn = document.getElementById('saveImage');
+    const btnSaveFormat = document.getElementById('btnSaveFormat');
+    const btnRenderMode = document.getElementById('btnRenderMode');
+    const btnValueFormat = document.getElementById('btnValueFormat');
+    const ddSaveFormat = document.getElementById('ddSaveFormat');
+    const ddRenderMode = document.getElementById('ddRenderMode');
+    const ddValueFormat = document.getElementById('ddValueFormat');
+    const ddChannel = document.getElementById('ddChannel');
+    const btnChannel = document.getElementById('btnChannel');
+    const loadingOverlay = document.getElementById('loading');
+    const loadingText = document.getElementById('loading-text');
+
+    // Listen for complete data from extension
+    const vscode = acquireVsCodeApi();
+    const timeline = initRecordingTimeline(vscode);
+    // Set for N-D Mats and volumes: the image is one 2D slice, picked by sliders
+    const sliceBar = initSliceBar(vscode, viewerConfig.slices);
+    let rows = viewerConfig.rows;
+    let cols = viewerConfig.cols;
+    let channels = viewerConfig.channels;
+    let depth = viewerConfig.depth;
+    // Set for huge Mats: only a decimated overview plus viewport tiles are loaded
+    const tiledInfo = viewerConfig.tiled;
+
+    // Detect if this is a moved panel
+    // Extension sends 'ready' signal immediately after creating panel
+    // If we don't receive it within 100ms, this is a moved panel
+    let extensionReady = false;
+    setTimeout(() => {
+        if (!extensionReady && !isShuttingDown) {
+            // This is a moved panel, auto-reload
+            loadingText.innerHTML = 'Reloading...';
+            vscode.postMessage({ command: 'reload' });
+        }
+    }, 100);
+
+    window.addEventListener('message', event => handleMessage(event.data));
+
+    function handleMessage(message) {
+        // Patches to an image the worker is still decoding wait until it is back
+        if (workerLoadId && WORKER_QUEUED_COMMANDS.has(message.command)) {
+            queuedMessages.push(message);
+            return;
+        }
+        if (message.command === 'ready') {
+            // Extension is ready, this is not a moved panel
+            extensionReady = true;
+        } else if (message.command === 'completeData') {
+            extensionReady = true;
+            if (message.rows !== undefined) rows = message.rows;
+            if (message.cols !== undefined) cols = message.cols;
+            if (message.channels !== undefined) channels = message.channels;
+            if (message.depth !== undefined) depth = message.depth;
+            dataCols = cols;
+            dataRows = rows;
+
+            const rawBytes = message.data; // This is a Uint8Array
+            loadIsComplete = true;
+            console.log('Received binary data: ' + rawBytes.length + ' bytes');
+            if (message.sliceIndex) sliceBar.shown(message.sliceIndex);
+
+            loadingText.innerText = 'Initializing viewer...';
+
+            // Use setTimeout to allow UI to update
+            setTimeout(() => {
+                try {
+                    initializeImageViewer(rawBytes);
+                } catch (e) {
+                    console.error('Initialization failed:', e);
+                    loadingText.innerText = 'Initialization failed: ' + e.message;
+                }
+            }, 10);
+        } else if (message.command === 'deltaData') {
+            extensionReady = true;
+            if (!isInitialized || !rawData) {
+                // Nothing to patch (e.g. panel was moved), ask for the complete image
+                vscode.postMessage({ command: 'reload' });
+                return;
+            }
+            applyDeltaTiles(message.tiles);
+        } else if (message.command === 'previewData') {
+            extensionReady = true;
+            loadIsComplete = false;
+            try {
+                initializeImageViewer(expandPreviewRows(message.data, message.stride));
+            } catch (e) {
+                console.error('Preview failed:', e);
+            }
+        } else if (message.command === 'bandData') {
+            if (!rawData) return;
+            applyBand(message.y, message.height, message.data);
+        } else if (message.command === 'progressiveDone') {
+            // Min/max was taken from the preview, redo normalized modes with all rows
+            if (rawData) refreshNormalizedRange();
+            reportRenderedOnNextDraw(true);
+        } else if (message.command === 'overviewData') {
+            extensionReady = true;
+            // New overview (first load or the Mat changed): tiles of the old data are stale
+            loadIsComplete = true;
+            tileStore.clear();
+            pendingTiles.clear();
+            try {
+                initializeImageViewer(message.data);
+            } catch (e) {
+                console.error('Initialization failed:', e);
+                loadingText.innerText = 'Initialization failed: ' + e.message;
+            }
+        } else if (message.command === 'tileData') {
+            if (!tiledInfo || !rawData) return;
+            storeTile(message);
+            requestRender();
+        } else if (message.command === 'releaseData') {
+            vscode.postMessage({ command: 'released', thumbnail: makeThumbnail(canvas) });
+        } else if (message.command === 'sliceFailed') {
+            sliceBar.shown(message.sliceIndex);
+        } else if (message.command === 'recordingState') {
+            timeline.update(message);
+        } else if (message.command === 'setView') {
+            const state = message.state;
+            if (!isInitialized) {
+                pendingSyncState = state;
+                return;
+            }
+            applyViewState(state);
+        } else if (message.command === 'setPixelHighlight') {
+            console.log('[MatWebview] Received setPixelHighlight: pixel=(' + message.pixelX + ', ' + message.pixelY + '), localHover=(' + localHoverPixelX + ', ' + localHoverPixelY + ')');
+            // Receive pixel highlight from synced panel
+            // Always update the synced highlight
+            highlightPixelX = message.pixelX;
+            highlightPixelY = message.pixelY;
+
+            // Clear local hover state when receiving sync message
+            // This ensures that synced highlight from another window takes priority
+            // when mouse is not in this window
+            localHoverPixelX = null;
+            localHoverPixelY = null;
+
+            // Always render - drawPixelHighlight will handle priority
+            // (local hover takes priority over synced highlight in drawPixelHighlight)
+            console.log('[MatWebview] Updating synced highlight and rendering: (' + highlightPixelX + ', ' + highlightPixelY + ')');
+            requestRender();
+
+            // Always update pixel info display for synced highlight
+            updatePixelInfoForHighlight(message.pixelX, message.pixelY);
+        }
+    }
+
+    function applyViewState(state) {
+        if (state.scale !== undefined) scale = Math.max(0.05, Math.min(100, state.scale));
+        if (state.offsetX !== undefined) offsetX = state.offsetX;
+        if (state.offsetY !== undefined) offsetY = state.offsetY;
+        requestRender();
+    }
+
+    function emitViewChange() {
+        if (!isInitialized || isShuttingDown) return;
+        vscode.postMessage({
+            command: 'viewChanged',
+            state: { scale, offsetX, offsetY }
+        });
+    }
+
+    // Rough footprint for the extension's memory budget: the values (twice while
+    // the render worker keeps its copy), the RGBA image and its canvas, and tiles
+    function reportMemoryUsage() {
+        let bytes = dataCols * dataRows * 4 * 2;
+        if (rawData) bytes += rawData.byteLength * (workerHasData ? 2 : 1);
+        for (const tile of tileStore.values()) bytes += tile.values.byteLength + tile.width * tile.height * 4;
+        vscode.postMessage({ command: 'memoryUsage', bytes });
+    }
+
+    // The benchmark harness times the first frame drawn from new data: 'rendered'
+    // is posted after it, with complete false while a progressive preview is up.
+    // It also carries how long decoding the data and drawing that frame took,
+    // for the extension's performance trace.
+    let loadIsComplete = true;
+    let renderedPending = null;
+    let decodeStartedAt = 0;
+    function reportRenderedOnNextDraw(complete, decodeMs) {
+        renderedPending = { complete, decodeMs };
+        requestRender();
+    }
+
+    // The extension replaces a released panel's page with this snapshot of the view
+    const THUMBNAIL_SIZE = 320;
+    function makeThumbnail(source) {
+        if (!source.width || !source.height) return null;
+        const t = Math.min(1, THUMBNAIL_SIZE / Math.max(source.width, source.height));
+        const thumb = document.createElement('canvas');
+        thumb.width = Math.max(1, Math.round(source.width * t));
+        thumb.height = Math.max(1, Math.round(source.height * t));
+        thumb.getContext('2d').drawImage(source, 0, 0, thumb.width, thumb.height);
+        try {
+            return thumb.toDataURL('image/jpeg', 0.8);
+        } catch (e) {
+            return null;
+        }
+    }
+
+    // Size of one element in the Mat's memory (rawData widens CV_16F to float32)
+    function sourceBytesPerElement() {
+        return depth === 7 ? 2 : bytesToTypedArray(new Uint8Array(8), depth).BYTES_PER_ELEMENT;
+    }
+
+    // Write raw Mat bytes into values starting at element elementOffset
+    function writeRawBytes(values, elementOffset, bytes) {
+        if (depth === 7) {
+            const decoded = bytesToTypedArray(bytes, depth);
+            values.set(decoded, elementOffset);
+            return;
+        }
+        new Uint8Array(values.buffer, values.byteOffset, values.byteLength).set(bytes, elementOffset * values.BYTES_PER_ELEMENT);
+    }
+
+    function isFloatDepth() {
+        return depth === 5 || depth === 6 || depth === 7;
+    }
+
+    let rawData = null;
+    let isInitialized = false;
+    let pendingSyncState = null;
+    let saveFormat = 'png';
+    let renderMode = 'byte';
+    let valueFormat = 'fixed3';
+    let uiScaleMode = 'auto';
+    let uiScale = 1;
+    let cachedStats = null; // computeStats() result for rawData
+    let selectedChannel = -1; // channel shown as grayscale, -1 = all
+    let intLut = null;
+    let intLutKey = '';
+
+    // Jet colorbar custom limits
+    let jetCustomMin = null; // null = use auto
+    let jetCustomMax = null; // null = use auto
+    let jetDebounceTimer = null;
+    const JET_DEBOUNCE_MS = 300;
+
+    let scale = 1;
+    let isDragging = false;
+    let startX = 0;
+    let startY = 0;
+    let offsetX = 0;
+    let offsetY = 0;
+    let viewW = 0;
+    let viewH = 0;
+    let lastMouseX = 0;
+    let lastMouseY = 0;
+    let hasLastMouse = false;
+
+    // Pixel-value overlay (performance-sensitive)
+    const PIXEL_TEXT_MIN_SCALE = 16; // 像素块 >= 16px 时开始考虑显示像素值
+    const MAX_PIXEL_TEXT_LABELS = 15000; // 视野内超过这个像素数就不画文字（防止卡顿）
+    let pixelTextEnabled = true; // 可手动关掉
+    let renderQueued = false;
+    let isShuttingDown = false; // 面板即将关闭时阻断交互
+
+    // Pixel highlight for synchronized viewing
+    let highlightPixelX = null;
+    let highlightPixelY = null;
+    let localHoverPixelX = null;
+    let localHoverPixelY = null;
+
+    // Make controls draggable
+    let controlsDragging = false;
+    let controlsStartX = 0;
+    let controlsStartY = 0;
+
+    controls.addEventListener('mousedown', (e) => {
+        if (e.target === controls) {
+            controlsDragging = true;
+            controlsStartX = e.clientX - controls.offsetLeft;
+            controlsStartY = e.clientY - controls.offsetTop;
+            e.preventDefault();
+        }
+    });
+
+    document.addEventListener('mousemove', (e) => {
+        if (controlsDragging) {
+            controls.style.left = (e.clientX - controlsStartX) + 'px';
+            controls.style.top = (e.clientY - controlsStartY) + 'px';
+        }
+    });
+
+    document.addEventListener('mouseup', () => {
+        controlsDragging = false;
+    });
+
+    // Toggle controls visibility
+    const toggleControlsBtn = document.getElementById('toggleControls');
+    toggleControlsBtn.addEventListener('click', (e) => {
+        e.stopPropagation();
+        const isCollapsed = controls.classList.toggle('collapsed');
+        toggleControlsBtn.textContent = isCollapsed ? '▶' : '▼';
+    });
+
+    // Create off-screen canvas for the original image
+    // In tiled mode rawData and the off-screen canvas hold the overview level
+    const overviewFactor = tiledInfo ? (1 << tiledInfo.overviewLevel) : 1;
+    let dataCols = Math.ceil(cols / overviewFactor);
+    let dataRows = Math.ceil(rows / overviewFactor);
+    const offscreenCanvas = document.createElement('canvas');
+    offscreenCanvas.width = dataCols;
+    offscreenCanvas.height = dataRows;
+    const offscreenCtx = offscreenCanvas.getContext('2d');
+    const imgData = offscreenCtx.createImageData(dataCols, dataRows);
+
+    function initializeImageViewer(rawBytes) {
+        decodeStartedAt = performance.now();
+        if (renderWorker) {
+            // Decoded and rendered in the worker, finishInitialize() runs on its reply
+            loadInWorker(rawBytes);
+            return;
+        }
+        rawData = bytesToTypedArray(rawBytes, depth);
+        cachedStats = null;
+        glImageReady = false;
+        updateOffscreenFromRaw();
+        finishInitialize();
+    }
+
+    function finishInitialize() {
+        loadingOverlay.classList.add('hidden');
+        updateStatsInfo();
+        if (pendingSyncState) {
+            applyViewState(pendingSyncState);
+            pendingSyncState = null;
+        } else if (!isInitialized) {
+            resetView();
+        }
+
+        isInitialized = true;
+        reportRenderedOnNextDraw(loadIsComplete, performance.now() - decodeStartedAt);
+        updateJetColorbarVisibility();
+
+        // Notify extension that webview is ready to receive sync state
+        vscode.postMessage({ command: 'webviewReady' });
+        reportMemoryUsage();
+    }
+
+    // Patch changed tiles into rawData and re-render only their rects
+    function applyDeltaTiles(tiles) {
+        const bytesPerPixel = channels * sourceBytesPerElement();
+        for (const tile of tiles) {
+            const tileRowBytes = tile.width * bytesPerPixel;
+            for (let r = 0; r < tile.height; r++) {
+                const dst = ((tile.y + r) * cols + tile.x) * channels;
+                writeRawBytes(rawData, dst, tile.data.subarray(r * tileRowBytes, (r + 1) * tileRowBytes));
+            }
+        }
+        patchWorker(tiles);
+
+        for (const tile of tiles) {
+            updateOffscreenFromRaw(tile);
+        }
+        requestRender();
+        // Normalized modes depend on the global min/max: if it moved, every pixel changes
+        refreshNormalizedRange();
+    }
+
+    // Typed array and element index of full-resolution pixel (x, y). In tiled mode
+    // the value comes from the finest level loaded there, else the overview.
+    function locatePixel(x, y) {
+        if (!tiledInfo) return [rawData, (y * cols + x) * channels];
+        const size = tiledInfo.tileSize;
+        for (let level = 0; level < tiledInfo.overviewLevel; level++) {
+            const lx = x >> level;
+            const ly = y >> level;
+            const tile = tileStore.get(level + ':' + Math.floor(lx / size) + ':' + Math.floor(ly / size));
+            if (tile) return [tile.values, ((ly - tile.y) * tile.width + (lx - tile.x)) * channels];
+        }
+        const ox = Math.min(dataCols - 1, x >> tiledInfo.overviewLevel);
+        const oy = Math.min(dataRows - 1, y >> tiledInfo.overviewLevel);
+        return [rawData, (oy * dataCols + ox) * channels];
+    }
+
+    // ===== Tiled mode: viewport tiles of the pyramid level matching the zoom =====
+    const MAX_LOADED_TILES = 192;
+    const TILE_REQUEST_DELAY_MS = 60;
+    const tileStore = new Map(); // 'level:tx:ty' -> tile
+    const pendingTiles = new Set();
+    let tileUseCounter = 0;
+    let queuedTileRequest = null;
+    let tileRequestTimer = null;
+
+    function renderTileCanvas(tile) {
+        const tileCtx = tile.canvas.getContext('2d');
+        if (glTileRenderer && glTileRenderer.supports(tile.width, tile.height)) {
+            glTileRenderer.setImage(tile.values, tile.width, tile.height);
+            glTileRenderer.render();
+            tileCtx.clearRect(0, 0, tile.width, tile.height);
+            tileCtx.drawImage(glTileRenderer.canvas, 0, 0);
+            return;
+        }
+        const tileImg = tileCtx.createImageData(tile.width, tile.height);
+        fillImageData(0, tile.width * tile.height, tile.values, tileImg.data);
+        tileCtx.putImageData(tileImg, 0, 0);
+    }
+
+    function storeTile(message) {
+        const key = message.level + ':' + message.tx + ':' + message.ty;
+        pendingTiles.delete(key);
+        const canvas = document.createElement('canvas');
+        canvas.width = message.width;
+        canvas.height = message.height;
+        const tile = {
+            level: message.level,
+            x: message.tx * tiledInfo.tileSize,
+            y: message.ty * tiledInfo.tileSize,
+            width: message.width,
+            height: message.height,
+            values: bytesToTypedArray(message.data, depth),
+            canvas,
+            lastUsed: ++tileUseCounter
+        };
+        renderTileCanvas(tile);
+        tileStore.set(key, tile);
+
+        while (tileStore.size > MAX_LOADED_TILES) {
+            let oldestKey = null;
+            let oldestUse = Infinity;
+            for (const [k, t] of tileStore) {
+                if (t.lastUsed < oldestUse) {
+                    oldestUse = t.lastUsed;
+                    oldestKey = k;
+                }
+            }
+            tileStore.delete(oldestKey);
+        }
+        reportMemoryUsage();
+    }
+
+    // Finest level needed at the current zoom; the overview covers the rest
+    function tileLevelForScale() {
+        if (scale >= 1) return 0;
+        return Math.min(tiledInfo.overviewLevel, Math.floor(Math.log2(1 / scale)));
+    }
+
+    // Draw loaded tiles over the overview (coarse to fine) and queue the missing ones
+    function drawTiles() {
+        if (!tiledInfo || !rawData) return;
+        const target = tileLevelForScale();
+        if (target >= tiledInfo.overviewLevel) return;
+
+        const left = Math.max(0, -offsetX / scale);
+        const top = Math.max(0, -offsetY / scale);
+        const right = Math.min(cols, (viewW - offsetX) / scale);
+        const bottom = Math.min(rows, (viewH - offsetY) / scale);
+        if (right <= left || bottom <= top) return;
+
+        const wanted = [];
+        for (let level = tiledInfo.overviewLevel - 1; level >= target; level--) {
+            const factor = 1 << level;
+            const span = tiledInfo.tileSize * factor;
+            for (let ty = Math.floor(top / span); ty <= Math.floor((bottom - 1) / span); ty++) {
+                for (let tx = Math.floor(left / span); tx <= Math.floor((right - 1) / span); tx++) {
+                    const key = level + ':' + tx + ':' + ty;
+                    const tile = tileStore.get(key);
+                    if (tile) {
+                        tile.lastUsed = ++tileUseCounter;
+                        ctx.drawImage(
+                            tile.canvas,
+                            offsetX + tile.x * factor * scale,
+                            offsetY + tile.y * factor * scale,
+                            tile.width * factor * scale,
+                            tile.height * factor * scale
+                        );
+                    } else if (level === target && !pendingTiles.has(key)) {
+                        wanted.push([tx, ty]);
+                    }
+                }
+            }
+        }
+        if (wanted.length > 0) {
+            scheduleTileRequest(target, wanted);
+        }
+    }
+
+    // Debounced so zooming/panning only asks for where the view settles
+    function scheduleTileRequest(level, tiles) {
+        queuedTileRequest = { level, tiles };
+        if (tileRequestTimer) clearTimeout(tileRequestTimer);
+        tileRequestTimer = setTimeout(() => {
+            tileRequestTimer = null;
+            const request = queuedTileRequest;
+            queuedTileRequest = null;
+            if (!request || isShuttingDown) return;
+            const tiles = request.tiles.filter(([tx, ty]) => {
+                const key = request.level + ':' + tx + ':' + ty;
+                return !pendingTiles.has(key) && !tileStore.has(key);
+            });
+            if (tiles.length === 0) return;
+            for (const [tx, ty] of tiles) pendingTiles.add(request.level + ':' + tx + ':' + ty);
+            vscode.postMessage({ command: 'requestTiles', level: request.level, tiles });
+        }, TILE_REQUEST_DELAY_MS);
+    }
+
+    // Progressive loading: every stride-th row, repeated down to fill the image
+    function expandPreviewRows(previewBytes, stride) {
+        const rowBytes = previewBytes.byteLength / Math.ceil(rows / stride);
+        const full = new Uint8Array(rows * rowBytes);
+        for (let y = 0; y < rows; y++) {
+            const src = Math.floor(y / stride) * rowBytes;
+            full.set(previewBytes.subarray(src, src + rowBytes), y * rowBytes);
+        }
+        return full;
+    }
+
+    // Progressive loading: replace rows [y, y + height) with full-resolution data
+    function applyBand(y, height, bandBytes) {
+        writeRawBytes(rawData, y * cols * channels, bandBytes);
+        patchWorker([{ x: 0, y: y, width: cols, height: height, data: bandBytes }]);
+        updateOffscreenFromRaw({ x: 0, y: y, width: cols, height: height });
+        requestRender();
+    }
+
+    function clampByte(v) {
+        if (v < 0) return 0;
+        if (v > 255) return 255;
+        return v | 0;
+    }
+
+    // ===== Image statistics: computed once per data arrival, reused by every render mode =====
+    const STATS_HISTOGRAM_BINS = 1024;
+    const PERCENTILE_CLIP_LOW = 0.01;
+    const PERCENTILE_CLIP_HIGH = 0.99;
+    const PERCENTILE_REFINE_LEVELS = 2;
+
+    // Per-channel min/max/mean/std and NaN/Inf counts in one sweep, then a histogram of
+    // all finite values over [min, max] for the percentile clip. min/max ignore NaN/Inf.
+    function computeStats(values) {
+        const mins = new Float64Array(channels).fill(Infinity);
+        const maxs = new Float64Array(channels).fill(-Infinity);
+        const sums = new Float64Array(channels);
+        const sumSqs = new Float64Array(channels);
+        const counts = new Float64Array(channels);
+        let nanCount = 0;
+        let infCount = 0;
+        const len = values.length;
+        for (let i = 0, c = 0; i < len; i++) {
+            const v = values[i];
+            if (v - v !== 0) {
+                if (v !== v) nanCount++;
+                else infCount++;
+            } else {
+                if (v < mins[c]) mins[c] = v;
+                if (v > maxs[c]) maxs[c] = v;
+                sums[c] += v;
+                sumSqs[c] += v * v;
+                counts[c]++;
+            }
+            if (++c === channels) c = 0;
+        }
+
+        let min = Infinity;
+        let max = -Infinity;
+        let finiteCount = 0;
+        const perChannel = [];
+        for (let c = 0; c < channels; c++) {
+            const n = counts[c];
+            const mean = n ? sums[c] / n : 0;
+            perChannel.push({
+                min: n ? mins[c] : 0,
+                max: n ? maxs[c] : 0,
+                mean,
+                std: n ? Math.sqrt(Math.max(0, sumSqs[c] / n - mean * mean)) : 0
+            });
+            if (n) {
+                min = Math.min(min, mins[c]);
+                max = Math.max(max, maxs[c]);
+            }
+            finiteCount += n;
+        }
+        if (min === Infinity || max === -Infinity) {
+            min = 0; max = 1;
+        }
+
+        const histogram = new Uint32Array(STATS_HISTOGRAM_BINS);
+        const binScale = (STATS_HISTOGRAM_BINS - 1) / ((max - min) || 1);
+        for (let i = 0; i < len; i++) {
+            const v = values[i];
+            if (v - v !== 0) continue;
+            histogram[((v - min) * binScale) | 0]++;
+        }
+
+        // Clip points: each refinement sweep splits the bin holding a clip point into
+        // STATS_HISTOGRAM_BINS sub-bins, so a single far outlier does not swallow the range
+        let clip = { min, max };
+        if (finiteCount) {
+            const findBin = (counts, target, before, upper) => {
+                let cumulative = before;
+                for (let b = 0; b < counts.length; b++) {
+                    const next = cumulative + counts[b];
+                    if (upper ? next >= target : next > target) return { bin: b, before: cumulative };
+                    cumulative = next;
+                }
+                return { bin: counts.length - 1, before: cumulative - counts[counts.length - 1] };
+            };
+            const targets = [PERCENTILE_CLIP_LOW * finiteCount, PERCENTILE_CLIP_HIGH * finiteCount];
+            const points = targets.map((target, k) => {
+                const found = findBin(histogram, target, 0, k === 1);
+                return { origin: min, scale: binScale, bin: found.bin, before: found.before };
+            });
+            for (let level = 0; level < PERCENTILE_REFINE_LEVELS; level++) {
+                const fine = points.map(pt => {
+                    pt.origin += pt.bin / pt.scale;
+                    pt.scale *= STATS_HISTOGRAM_BINS;
+                    return new Uint32Array(STATS_HISTOGRAM_BINS);
+                });
+                for (let i = 0; i < len; i++) {
+                    const v = values[i];
+                    if (v - v !== 0) continue;
+                    for (let k = 0; k < 2; k++) {
+                        const idx = (v - points[k].origin) * points[k].scale;
+                        if (idx >= 0 && idx < STATS_HISTOGRAM_BINS) fine[k][idx | 0]++;
+                    }
+                }
+                points.forEach((pt, k) => {
+                    const found = findBin(fine[k], targets[k], pt.before, k === 1);
+                    pt.bin = found.bin;
+                    pt.before = found.before;
+                });
+            }
+            clip = {
+                min: Math.max(min, points[0].origin + points[0].bin / points[0].scale),
+                max: Math.min(max, points[1].origin + (points[1].bin + 1) / points[1].scale)
+            };
+        }
+
+        return {
+            min,
+            max,
+            channels: perChannel,
+            finiteCount,
+            nanCount,
+            infCount,
+            histogram,
+            clip
+        };
+    }
+
+    function getStats() {
+        if (!cachedStats) cachedStats = computeStats(rawData);
+        return cachedStats;
+    }
+
+    // Min/max of the finite values: of the selected channel, else of all channels
+    function getMinMax() {
+        const stats = getStats();
+        return (selectedChannel >= 0 && stats.channels[selectedChannel]) ? stats.channels[selectedChannel] : stats;
+    }
+
+    function isNormalizedMode() {
+        return renderMode === 'minmax' || renderMode === 'jet' || renderMode === 'percentile';
+    }
+
+    // Range mapped to [0, 255] by the minmax and percentile modes
+    // (the percentile clip is over all channels)
+    function getNormRange() {
+        return renderMode === 'percentile' ? getStats().clip : getMinMax();
+    }
+
+    function sameNormRange(a, b) {
+        return a.min === b.min && a.max === b.max && a.clip.min === b.clip.min && a.clip.max === b.clip.max;
+    }
+
+    function mapToByte(v) {
+        if (renderMode === 'norm01') {
+            return clampByte(v * 255);
+        }
+        if (renderMode === 'minmax' || renderMode === 'percentile') {
+            const mm = getNormRange();
+            const denom = (mm.max - mm.min) || 1;
+            return clampByte(((v - mm.min) / denom) * 255);
+        }
+        if (renderMode === 'clamp255') {
+            return clampByte(v);
+        }
+        // 'byte' default
+        return clampByte(v);
+    }
+
+    // Jet colormap: maps a normalized value (0-1) to RGB
+    // Blue -> Cyan -> Green -> Yellow -> Red
+    function jetColormap(t) {
+        // t is in [0, 1]
+        let r, g, b;
+        if (t < 0.125) {
+            r = 0;
+            g = 0;
+            b = 0.5 + t * 4; // 0.5 -> 1.0
+        } else if (t < 0.375) {
+            r = 0;
+            g = (t - 0.125) * 4; // 0 -> 1
+            b = 1;
+        } else if (t < 0.625) {
+            r = (t - 0.375) * 4; // 0 -> 1
+            g = 1;
+            b = 1 - (t - 0.375) * 4; // 1 -> 0
+        } else if (t < 0.875) {
+            r = 1;
+            g = 1 - (t - 0.625) * 4; // 1 -> 0
+            b = 0;
+        } else {
+            r = 1 - (t - 0.875) * 4; // 1 -> 0.5
+            g = 0;
+            b = 0;
+        }
+        return {
+            r: clampByte(r * 255),
+            g: clampByte(g * 255),
+            b: clampByte(b * 255)
+        };
+    }
+
+    // ===== WebGL2 renderer: raw values live in a texture, mapping runs in a fragment shader =====
+    // Render mode / jet limit changes are then one uniform update and one draw instead of a
+    // JS loop over every pixel. fillImageData (Canvas2D) stays the fallback when WebGL2 is
+    // unavailable, the image exceeds the max texture size, or for 2 / >4 channel Mats.
+    const GL_VERTEX_SHADER = [
+        '#version 300 es',
+        'void main() {',
+        '    vec2 p = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));',
+        '    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);',
+        '}'
+    ].join('\n');
+
+    // Same mapping as mapToByte / jetColormap; every output is floor()ed to a byte like clampByte
+    function glFragmentShader(sampler) {
+        return [
+            '#version 300 es',
+            'precision highp float;',
+            'precision highp int;',
+            'uniform highp ' + sampler + ' u_data;',
+            'uniform int u_channels;',
+            'uniform int u_mode;', // 0: clamp to byte, 1: value * 255, 2: min/max, 3: jet
+            'uniform vec2 u_range;',
+            'out vec4 outColor;',
+            'vec3 toByte(vec3 v) {',
+            '    v = mix(v, vec3(0.0), isnan(v));',
+            '    return floor(clamp(v, 0.0, 255.0)) / 255.0;',
+            '}',
+            'vec3 jet(float t) {',
+            '    if (t < 0.125) return vec3(0.0, 0.0, 0.5 + t * 4.0);',
+            '    if (t < 0.375) return vec3(0.0, (t - 0.125) * 4.0, 1.0);',
+            '    if (t < 0.625) return vec3((t - 0.375) * 4.0, 1.0, 1.0 - (t - 0.375) * 4.0);',
+            '    if (t < 0.875) return vec3(1.0, 1.0 - (t - 0.625) * 4.0, 0.0);',
+            '    return vec3(1.0 - (t - 0.875) * 4.0, 0.0, 0.0);',
+            '}',
+            'void main() {',
+            '    ivec2 size = textureSize(u_data, 0);',
+            '    ivec2 p = ivec2(int(gl_FragCoord.x), size.y - 1 - int(gl_FragCoord.y));',
+            '    vec4 v = vec4(texelFetch(u_data, p, 0));',
+            '    float denom = u_range.y - u_range.x;',
+            '    if (denom == 0.0) denom = 1.0;',
+            '    if (u_mode == 3) {',
+            '        float gray = u_channels == 1 ? v.r : (u_channels == 3 ? (v.r + v.g + v.b) / 3.0 : (v.r + v.g + v.b + v.a) / 4.0);',
+            '        if (isnan(gray)) { outColor = vec4(0.0, 0.0, 0.0, 1.0); return; }',
+            '        outColor = vec4(toByte(jet(clamp((gray - u_range.x) / denom, 0.0, 1.0)) * 255.0), 1.0);',
+            '        return;',
+            '    }',
+            '    vec3 c = v.rgb;',
+            '    if (u_mode == 1) c = c * 255.0;',
+            '    else if (u_mode == 2) c = (c - u_range.x) / denom * 255.0;',
+            '    c = toByte(c);',
+            '    float alpha = u_channels == 4 ? toByte(vec3(v.a)).r : 1.0;',
+            '    outColor = vec4(u_channels == 1 ? c.rrr : c, alpha);',
+            '}'
+        ].join('\n');
+    }
+
+    function createGlRenderer() {
+        const glCanvas = document.createElement('canvas');
+        const gl = glCanvas.getContext('webgl2', {
+            premultipliedAlpha: false,
+            preserveDrawingBuffer: true, // drawImage / toDataURL read it after compositing
+            antialias: false,
+            depth: false,
+            stencil: false
+        });
+        if (!gl) return null;
+
+        // depth -> [sampler, component type, internal formats for 1/3/4 channels]
+        // CV_64F is narrowed to float32 on upload, CV_16F arrives widened to float32.
+        // With a channel selected only that plane is uploaded, as one channel.
+        const formats = {
+            0: ['usampler2D', gl.UNSIGNED_BYTE, [gl.R8UI, gl.RGB8UI, gl.RGBA8UI]],
+            1: ['isampler2D', gl.BYTE, [gl.R8I, gl.RGB8I, gl.RGBA8I]],
+            2: ['usampler2D', gl.UNSIGNED_SHORT, [gl.R16UI, gl.RGB16UI, gl.RGBA16UI]],
+            3: ['isampler2D', gl.SHORT, [gl.R16I, gl.RGB16I, gl.RGBA16I]],
+            4: ['isampler2D', gl.INT, [gl.R32I, gl.RGB32I, gl.RGBA32I]],
+            5: ['sampler2D', gl.FLOAT, [gl.R32F, gl.RGB32F, gl.RGBA32F]],
+            6: ['sampler2D', gl.FLOAT, [gl.R32F, gl.RGB32F, gl.RGBA32F]],
+            7: ['sampler2D', gl.FLOAT, [gl.R32F, gl.RGB32F, gl.RGBA32F]]
+        };
+        const channelSlot = { 1: 0, 3: 1, 4: 2 };
+        const maxTextureSize = gl.getParameter(gl.MAX_TEXTURE_SIZE);
+        const programs = {};
+
+        function compileShader(type, source) {
+            const shader = gl.createShader(type);
+            gl.shaderSource(shader, source);
+            gl.compileShader(shader);
+            if (!gl.getShaderParameter(shader, gl.COMPILE_STATUS)) {
+                console.error('[MatWebview] Shader compile failed:', gl.getShaderInfoLog(shader));
+                return null;
+            }
+            return shader;
+        }
+
+        function getProgram(sampler) {
+            if (programs[sampler] !== undefined) return programs[sampler];
+            programs[sampler] = null;
+            const vs = compileShader(gl.VERTEX_SHADER, GL_VERTEX_SHADER);
+            const fs = compileShader(gl.FRAGMENT_SHADER, glFragmentShader(sampler));
+            if (!vs || !fs) return null;
+            const program = gl.createProgram();
+            gl.attachShader(program, vs);
+            gl.attachShader(program, fs);
+            gl.linkProgram(program);
+            if (!gl.getProgramParameter(program, gl.LINK_STATUS)) {
+                console.error('[MatWebview] Program link failed:', gl.getProgramInfoLog(program));
+                return null;
+            }
+            programs[sampler] = {
+                program,
+                channels: gl.getUniformLocation(program, 'u_channels'),
+                mode: gl.getUniformLocation(program, 'u_mode'),
+                range: gl.getUniformLocation(program, 'u_range')
+            };
+            return programs[sampler];
+        }
+
+        const texture = gl.createTexture();
+        gl.bindTexture(gl.TEXTURE_2D, texture);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.NEAREST);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.NEAREST);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_S, gl.CLAMP_TO_EDGE);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_T, gl.CLAMP_TO_EDGE);
+        gl.pixelStorei(gl.UNPACK_ALIGNMENT, 1);
+
+        let uploaded = null; // { format, width, height, channels, selected, source, values }
+
+        function uploadChannels() {
+            return selectedChannel >= 0 ? 1 : channels;
+        }
+
+        function formatFor() {
+            const f = formats[depth];
+            if (!f || channelSlot[uploadChannels()] === undefined) return null;
+            const slot = channelSlot[uploadChannels()];
+            const isFloat = f[0] === 'sampler2D';
+            const pixelFormats = isFloat ? [gl.RED, gl.RGB, gl.RGBA] : [gl.RED_INTEGER, gl.RGB_INTEGER, gl.RGBA_INTEGER];
+            return { sampler: f[0], type: f[1], internalFormat: f[2][slot], format: pixelFormats[slot] };
+        }
+
+        const renderer = {
+            canvas: glCanvas,
+            lost: false,
+            supports(width, height) {
+                return !this.lost && width <= maxTextureSize && height <= maxTextureSize &&
+                    formatFor() !== null && getProgram(formatFor().sampler) !== null;
+            },
+            // Upload a whole image (width x height pixels of the current depth/channels)
+            setImage(values, width, height) {
+                const format = formatFor();
+                const selected = selectedChannel;
+                let source = values;
+                if (selected >= 0) {
+                    source = depth === 6 ? new Float32Array(width * height) : new values.constructor(width * height);
+                    for (let i = 0, j = selected; i < source.length; i++, j += channels) source[i] = values[j];
+                } else if (depth === 6) {
+                    source = new Float32Array(values);
+                }
+                gl.bindTexture(gl.TEXTURE_2D, texture);
+                gl.texImage2D(gl.TEXTURE_2D, 0, format.internalFormat, width, height, 0, format.format, format.type, source);
+                uploaded = { format, width, height, channels: uploadChannels(), selected, source, values };
+                if (glCanvas.width !== width || glCanvas.height !== height) {
+                    glCanvas.width = width;
+                    glCanvas.height = height;
+                }
+            },
+            // Re-upload a dirty rect {x, y, width, height} of the image given to setImage
+            updateRect(rect) {
+                const { format, width, selected, source, values } = uploaded;
+                const n = uploaded.channels;
+                if (selected >= 0) {
+                    for (let y = rect.y; y < rect.y + rect.height; y++) {
+                        for (let x = rect.x; x < rect.x + rect.width; x++) {
+                            source[y * width + x] = values[(y * width + x) * channels + selected];
+                        }
+                    }
+                } else if (source !== values) {
+                    for (let y = rect.y; y < rect.y + rect.height; y++) {
+                        const start = (y * width + rect.x) * n;
+                        source.set(values.subarray(start, start + rect.width * n), start);
+                    }
+                }
+                gl.bindTexture(gl.TEXTURE_2D, texture);
+                gl.pixelStorei(gl.UNPACK_ROW_LENGTH, width);
+                gl.texSubImage2D(gl.TEXTURE_2D, 0, rect.x, rect.y, rect.width, rect.height,
+                    format.format, format.type, source, (rect.y * width + rect.x) * n);
+                gl.pixelStorei(gl.UNPACK_ROW_LENGTH, 0);
+            },
+            render() {
+                const prog = getProgram(uploaded.format.sampler);
+                const params = glRenderParams();
+                gl.viewport(0, 0, uploaded.width, uploaded.height);
+                gl.useProgram(prog.program);
+                gl.uniform1i(prog.channels, uploaded.channels);
+                gl.uniform1i(prog.mode, params.mode);
+                gl.uniform2f(prog.range, params.min, params.max);
+                gl.drawArrays(gl.TRIANGLES, 0, 3);
+            }
+        };
+
+        glCanvas.addEventListener('webglcontextlost', () => {
+            renderer.lost = true;
+            onGlContextLost();
+        });
+        return renderer;
+    }
+
+    function glRenderParams() {
+        if (renderMode === 'jet') {
+            const mm = getMinMax();
+            return {
+                mode: 3,
+                min: (jetCustomMin !== null) ? jetCustomMin : mm.min,
+                max: (jetCustomMax !== null) ? jetCustomMax : mm.max
+            };
+        }
+        if (renderMode === 'minmax' || renderMode === 'percentile') {
+            const mm = getNormRange();
+            return { mode: 2, min: mm.min, max: mm.max };
+        }
+        return { mode: renderMode === 'norm01' ? 1 : 0, min: 0, max: 1 };
+    }
+
+    let glRenderer = createGlRenderer();
+    // Tiles get their own context so rendering one does not clobber the overview
+    let glTileRenderer = (glRenderer && tiledInfo) ? createGlRenderer() : null;
+    let glImageReady = false; // rawData is uploaded into glRenderer's texture
+    let imageSource = offscreenCanvas; // canvas draw() scales onto the view
+
+    function onGlContextLost() {
+        console.log('[MatWebview] WebGL context lost, falling back to Canvas2D');
+        glRenderer = null;
+        glTileRenderer = null;
+        glImageReady = false;
+        updateOffscreenFromRaw();
+        requestRender();
+    }
+
+    // Render rawData on the GPU; false if the Canvas2D path has to do it
+    function renderWithGl(rect) {
+        if (!glRenderer || !glRenderer.supports(dataCols, dataRows)) {
+            glImageReady = false;
+            return false;
+        }
+        if (!glImageReady) {
+            glRenderer.setImage(rawData, dataCols, dataRows);
+            glImageReady = true;
+        } else if (rect) {
+            glRenderer.updateRect(rect);
+        }
+        glRenderer.render();
+        imageSource = glRenderer.canvas;
+        return true;
+    }
+
+    // ===== Render worker: decode, min/max and the Canvas2D colormap fill off the UI thread =====
+    // The message buffer is transferred to the worker and straight back; the worker keeps its
+    // own copy of the values for later statistics and re-renders. Its fill output comes back
+    // as an ImageBitmap drawn into the off-screen canvas, so the UI thread only handles
+    // interaction and draw(). The mapping functions above are shared with the worker by source.
+    const WORKER_QUEUED_COMMANDS = new Set(['deltaData', 'bandData', 'progressiveDone', 'tileData']);
+
+    function renderWorkerMain() {
+        let kept = null; // { width, height }, values in rawData
+
+        function renderBitmap(params) {
+            renderMode = params.renderMode;
+            selectedChannel = params.selectedChannel;
+            jetCustomMin = params.jetCustomMin;
+            jetCustomMax = params.jetCustomMax;
+            const canvas = new OffscreenCanvas(kept.width, kept.height);
+            const canvasCtx = canvas.getContext('2d');
+            imgData = canvasCtx.createImageData(kept.width, kept.height);
+            fillImageData(0, kept.width * kept.height, rawData, imgData.data);
+            canvasCtx.putImageData(imgData, 0, 0);
+            imgData = null;
+            return canvas.transferToImageBitmap();
+        }
+
+        self.onmessage = (event) => {
+            const msg = event.data;
+            if (msg.type === 'load') {
+                depth = msg.depth;
+                channels = msg.channels;
+                kept = { width: msg.width, height: msg.height };
+                // Own copy of the values (CV_16F decoding already makes one)
+                const view = bytesToTypedArray(new Uint8Array(msg.buffer, msg.byteOffset, msg.byteLength), depth);
+                rawData = view.buffer === msg.buffer ? view.slice() : view;
+                cachedStats = null;
+                const stats = getStats();
+                const bitmap = msg.params ? renderBitmap(msg.params) : null;
+                self.postMessage(
+                    { type: 'loaded', id: msg.id, buffer: msg.buffer, byteOffset: msg.byteOffset, byteLength: msg.byteLength, stats, bitmap },
+                    bitmap ? [msg.buffer, bitmap] : [msg.buffer]
+                );
+            } else if (msg.type === 'patch') {
+                if (!kept) return;
+                const bytesPerPixel = channels * sourceBytesPerElement();
+                for (const rect of msg.rects) {
+                    const rectRowBytes = rect.width * bytesPerPixel;
+                    for (let r = 0; r < rect.height; r++) {
+                        const dst = ((rect.y + r) * kept.width + rect.x) * channels;
+                        writeRawBytes(rawData, dst, rect.data.subarray(r * rectRowBytes, (r + 1) * rectRowBytes));
+                    }
+                }
+                cachedStats = null;
+            } else if (msg.type === 'render') {
+                if (!kept) return;
+                const stats = getStats();
+                // Only asked because the data changed: nothing to redo if the range held
+                if (msg.statsOnly || (msg.previousStats && sameNormRange(msg.previousStats, stats))) {
+                    self.postMessage({ type: 'rendered', id: msg.id, stats, unchanged: true });
+                    return;
+                }
+                const bitmap = msg.params ? renderBitmap(msg.params) : null;
+                self.postMessage({ type: 'rendered', id: msg.id, stats, bitmap }, bitmap ? [bitmap] : []);
+            }
+        };
+    }
+
+    function createRenderWorker() {
+        if (typeof Worker === 'undefined' || typeof OffscreenCanvas === 'undefined') return null;
+        try {
+            const source = [
+                'let rawData = null, imgData = null, cachedStats = null;',
+                'let renderMode = "byte", channels = 1, depth = 0, jetCustomMin = null, jetCustomMax = null;',
+                'let selectedChannel = -1, halfFloatLut = null, intLut = null, intLutKey = "";',
+                'const STATS_HISTOGRAM_BINS = ' + STATS_HISTOGRAM_BINS + ';',
+                'const PERCENTILE_CLIP_LOW = ' + PERCENTILE_CLIP_LOW + ', PERCENTILE_CLIP_HIGH = ' + PERCENTILE_CLIP_HIGH +
+                    ', PERCENTILE_REFINE_LEVELS = ' + PERCENTILE_REFINE_LEVELS + ';',
+                clampByte, computeStats, getStats, getMinMax, getNormRange, sameNormRange,
+                mapToByte, jetColormap, fillImageData, intLutBase, getIntLut, isNormalizedMode,
+                bytesToTypedArray, getHalfFloatLut, sourceBytesPerElement, writeRawBytes,
+                '(' + renderWorkerMain + ')();'
+            ].map(String).join('\n');
+            const worker = new Worker(URL.createObjectURL(new Blob([source], { type: 'text/javascript' })));
+            worker.onmessage = (event) => onWorkerResult(event.data);
+            worker.onerror = (event) => {
+                console.error('[MatWebview] Render worker failed, rendering on the UI thread:', event.message);
+                onWorkerFailed();
+            };
+            return worker;
+        } catch (e) {
+            console.log('[MatWebview] Render worker unavailable:', e);
+            return null;
+        }
+    }
+
+    let renderWorker = createRenderWorker();
+    let workerHasData = false;
+    let workerLoadId = 0; // load whose result is still pending, 0 when none
+    let workerLoadParamsKey = '';
+    let workerRenderId = 0;
+    let workerRenderInFlight = false;
+    let workerRenderQueued = false;
+    let queuedMessages = [];
+
+    // Fill parameters for the worker, null when the GPU renders rawData instead
+    function workerRenderParams() {
+        if (glRenderer && glRenderer.supports(dataCols, dataRows)) return null;
+        return { renderMode, selectedChannel, jetCustomMin, jetCustomMax };
+    }
+
+    function loadInWorker(rawBytes) {
+        workerLoadId++;
+        queuedMessages = []; // patches for older data are superseded by this image
+        const params = workerRenderParams();
+        workerLoadParamsKey = JSON.stringify(params);
+        renderWorker.postMessage({
+            type: 'load',
+            id: workerLoadId,
+            buffer: rawBytes.buffer,
+            byteOffset: rawBytes.byteOffset,
+            byteLength: rawBytes.byteLength,
+            depth,
+            channels,
+            width: dataCols,
+            height: dataRows,
+            params
+        }, [rawBytes.buffer]);
+    }
+
+    function patchWorker(rects) {
+        if (renderWorker && workerHasData) {
+            renderWorker.postMessage({ type: 'patch', rects });
+        }
+    }
+
+    // The worker re-renders (and recomputes stats) with its copy of the values.
+    // With previousStats it only does so if the data change moved the range.
+    function requestWorkerRender(previousStats, statsOnly) {
+        if (workerRenderInFlight) {
+            // A stats-only refresh still needs a pass over the new data
+            workerRenderQueued = true;
+            return;
+        }
+        workerRenderInFlight = true;
+        renderWorker.postMessage({
+            type: 'render',
+            id: ++workerRenderId,
+            params: workerRenderParams(),
+            previousStats: previousStats || null,
+            statsOnly: !!statsOnly
+        });
+    }
+
+    function blitWorkerBitmap(bitmap) {
+        offscreenCtx.clearRect(0, 0, offscreenCanvas.width, offscreenCanvas.height);
+        offscreenCtx.drawImage(bitmap, 0, 0);
+        bitmap.close();
+        imageSource = offscreenCanvas;
+        if (tiledInfo) {
+            for (const tile of tileStore.values()) renderTileCanvas(tile);
+        }
+    }
+
+    function onWorkerResult(result) {
+        if (result.type === 'loaded') {
+            if (result.id !== workerLoadId) {
+                // A newer image is on its way
+                if (result.bitmap) result.bitmap.close();
+                return;
+            }
+            workerLoadId = 0;
+            workerHasData = true;
+            rawData = bytesToTypedArray(new Uint8Array(result.buffer, result.byteOffset, result.byteLength), depth);
+            cachedStats = result.stats;
+            glImageReady = false;
+            if (result.bitmap && JSON.stringify(workerRenderParams()) === workerLoadParamsKey) {
+                blitWorkerBitmap(result.bitmap);
+            } else {
+                if (result.bitmap) result.bitmap.close();
+                updateOffscreenFromRaw();
+            }
+            finishInitialize();
+            const replay = queuedMessages;
+            queuedMessages = [];
+            replay.forEach(handleMessage);
+        } else if (result.type === 'rendered') {
+            workerRenderInFlight = false;
+            cachedStats = result.stats;
+            updateStatsInfo();
+            if (workerRenderQueued) {
+                // Parameters changed meanwhile, this frame is already stale
+                workerRenderQueued = false;
+                if (result.bitmap) result.bitmap.close();
+                requestWorkerRender();
+                return;
+            }
+            if (result.unchanged) return;
+            if (result.bitmap) {
+                blitWorkerBitmap(result.bitmap);
+            } else {
+                updateOffscreenFromRaw();
+            }
+            updateJetColorbarValues();
+            requestRender();
+        }
+    }
+
+    function onWorkerFailed() {
+        renderWorker = null;
+        workerRenderInFlight = false;
+        if (workerLoadId) {
+            // The image buffer went down with the worker
+            workerLoadId = 0;
+            vscode.postMessage({ command: 'reload' });
+            return;
+        }
+        if (rawData) {
+            updateOffscreenFromRaw();
+            requestRender();
+        }
+    }
+
+    // After rawData changed in place (delta tiles, progressive bands) the stats are
+    // stale: recompute them, and re-render normalized modes if their range moved
+    function refreshNormalizedRange() {
+        if (renderWorker && workerHasData) {
+            requestWorkerRender(cachedStats, !isNormalizedMode());
+            return;
+        }
+        const before = getStats();
+        cachedStats = null;
+        const after = getStats();
+        updateStatsInfo();
+        if (isNormalizedMode() && !sameNormRange(before, after)) {
+            updateOffscreenFromRaw();
+            updateJetColorbarValues();
+            requestRender();
+        }
+    }
+
+    // Re-render the whole image, or only a dirty rect {x, y, width, height}
+    // (callers that change rawData reset cachedStats)
+    function updateOffscreenFromRaw(rect) {
+        if (!rawData) return;
+        const fullUpdate = !rect;
+        if (renderWithGl(rect)) {
+            if (fullUpdate && tiledInfo) {
+                for (const tile of tileStore.values()) renderTileCanvas(tile);
+            }
+            return;
+        }
+        // Coming back from the GPU path the off-screen canvas is stale everywhere
+        if (!rect || imageSource !== offscreenCanvas) {
+            if (renderWorker && workerHasData) {
+                requestWorkerRender();
+                return;
+            }
+            rect = { x: 0, y: 0, width: dataCols, height: dataRows };
+        }
+        // Fill image data based on selected render mode
+        if (isNormalizedMode()) getStats();
+
+        // Full-width rects are one contiguous span, otherwise one span per row
+        if (rect.x === 0 && rect.width === dataCols) {
+            fillImageData(rect.y * dataCols, (rect.y + rect.height) * dataCols);
+        } else {
+            for (let y = rect.y; y < rect.y + rect.height; y++) {
+                const start = y * dataCols + rect.x;
+                fillImageData(start, start + rect.width);
+            }
+        }
+        offscreenCtx.putImageData(imgData, 0, 0, rect.x, rect.y, rect.width, rect.height);
+        imageSource = offscreenCanvas;
+
+        // Loaded tiles follow render mode / normalization changes
+        if (fullUpdate && tiledInfo) {
+            for (const tile of tileStore.values()) renderTileCanvas(tile);
+        }
+    }
+
+    // Map pixels [start, end) of rawData (or a tile's values) into imgData
+    function fillImageData(start, end, src = rawData, data = imgData.data) {
+        // With a channel selected only that channel is read, as grayscale
+        const sel = selectedChannel;
+        const useIntLut = depth <= 3;
+
+        if (renderMode === 'jet') {
+            // Jet colormap mode: convert to grayscale first, then apply colormap
+            const mm = getMinMax();
+            // Use custom limits if set, otherwise use auto
+            const effectiveMin = (jetCustomMin !== null) ? jetCustomMin : mm.min;
+            const effectiveMax = (jetCustomMax !== null) ? jetCustomMax : mm.max;
+            const denom = (effectiveMax - effectiveMin) || 1;
+
+            if (useIntLut && (channels === 1 || sel >= 0)) {
+                // 8/16-bit single channel: one colormap lookup per pixel
+                const lut = getIntLut(true);
+                const base = intLutBase();
+                const step = channels;
+                const offset = sel >= 0 ? sel : 0;
+                for (let i = start; i < end; i++) {
+                    const k = (src[i * step + offset] - base) * 3;
+                    const outIdx = i << 2;
+                    data[outIdx] = lut[k];
+                    data[outIdx + 1] = lut[k + 1];
+                    data[outIdx + 2] = lut[k + 2];
+                    data[outIdx + 3] = 255;
+                }
+                return;
+            }
+
+            for (let i = start; i < end; i++) {
+                const outIdx = i << 2;
+                let grayValue;
+
+                if (channels === 1) {
+                    grayValue = src[i];
+                } else if (sel >= 0) {
+                    grayValue = src[i * channels + sel];
+                } else {
+                    // For multi-channel, compute average (grayscale)
+                    const inIdx = i * channels;
+                    let sum = 0;
+                    for (let c = 0; c < channels; c++) {
+                        sum += src[inIdx + c];
+                    }
+                    grayValue = sum / channels;
+                }
+
+                // Normalize to [0, 1]
+                const t = (grayValue - effectiveMin) / denom;
+                const color = jetColormap(Math.max(0, Math.min(1, t)));
+
+                data[outIdx] = color.r;
+                data[outIdx + 1] = color.g;
+                data[outIdx + 2] = color.b;
+                data[outIdx + 3] = 255;
+            }
+        } else if (depth === 0 && renderMode === 'byte' && sel < 0) {
+            // Fast path for CV_8U + byte mode
+            if (channels === 1) {
+                for (let i = start; i < end; i++) {
+                    const val = src[i];
+                    const outIdx = i << 2;
+                    data[outIdx] = data[outIdx + 1] = data[outIdx + 2] = val;
+                    data[outIdx + 3] = 255;
+                }
+            } else if (channels === 3) {
+                for (let i = start; i < end; i++) {
+                    const inIdx = i * 3;
+                    const outIdx = i << 2;
+                    data[outIdx] = src[inIdx];
+                    data[outIdx + 1] = src[inIdx + 1];
+                    data[outIdx + 2] = src[inIdx + 2];
+                    data[outIdx + 3] = 255;
+                }
+            } else if (channels === 4) {
+                // RGBA: use alpha channel from source data
+                for (let i = start; i < end; i++) {
+                    const inIdx = i * 4;
+                    const outIdx = i << 2;
+                    data[outIdx] = src[inIdx];
+                    data[outIdx + 1] = src[inIdx + 1];
+                    data[outIdx + 2] = src[inIdx + 2];
+                    data[outIdx + 3] = src[inIdx + 3];
+                }
+            }
+        } else if (useIntLut) {
+            // 8/16-bit integers: every possible value is mapped once, the fill is a lookup
+            const lut = getIntLut(false);
+            const base = intLutBase();
+            for (let i = start; i < end; i++) {
+                const outIdx = i << 2;
+                if (channels === 1 || sel >= 0) {
+                    const value = lut[src[i * channels + (sel >= 0 ? sel : 0)] - base];
+                    data[outIdx] = data[outIdx + 1] = data[outIdx + 2] = value;
+                    data[outIdx + 3] = 255;
+                } else {
+                    const inIdx = i * channels;
+                    data[outIdx] = lut[src[inIdx] - base];
+                    data[outIdx + 1] = lut[src[inIdx + 1] - base];
+                    data[outIdx + 2] = lut[src[inIdx + 2] - base];
+                    // RGBA: map RGB channels, preserve alpha
+                    data[outIdx + 3] = channels === 4 ? clampByte(src[inIdx + 3]) : 255;
+                }
+            }
+        } else {
+            // General path
+            for (let i = start; i < end; i++) {
+                const outIdx = i << 2;
+                if (channels === 1 || sel >= 0) {
+                    const value = mapToByte(src[i * channels + (sel >= 0 ? sel : 0)]);
+                    data[outIdx] = data[outIdx + 1] = data[outIdx + 2] = value;
+                    data[outIdx + 3] = 255;
+                } else if (channels === 4) {
+                    // RGBA: map RGB channels, preserve alpha
+                    const inIdx = i * 4;
+                    data[outIdx] = mapToByte(src[inIdx]);
+                    data[outIdx + 1] = mapToByte(src[inIdx + 1]);
+                    data[outIdx + 2] = mapToByte(src[inIdx + 2]);
+                    data[outIdx + 3] = clampByte(src[inIdx + 3]); // preserve alpha
+                } else {
+                    // 3 channels or other
+                    const inIdx = i * channels;
+                    data[outIdx] = mapToByte(src[inIdx]);
+                    data[outIdx + 1] = mapToByte(src[inIdx + 1]);
+                    data[outIdx + 2] = mapToByte(src[inIdx + 2]);
+                    data[outIdx + 3] = 255;
+                }
+            }
+        }
+    }
+
+    // Lowest value of 8/16-bit integer depths (index 0 of their lookup tables)
+    function intLutBase() {
+        return depth === 1 ? -128 : (depth === 3 ? -32768 : 0);
+    }
+
+    // 256 / 65536-entry table of every value's output under the current mode and limits:
+    // bytes for the gray/RGB modes, RGB triples for jet. Rebuilt when the limits change.
+    function getIntLut(jet) {
+        const size = depth <= 1 ? 256 : 65536;
+        const base = intLutBase();
+        let key;
+        if (jet) {
+            const mm = getMinMax();
+            key = 'jet:' + depth + ':' + ((jetCustomMin !== null) ? jetCustomMin : mm.min) + ':' + ((jetCustomMax !== null) ? jetCustomMax : mm.max);
+        } else {
+            const range = (renderMode === 'minmax' || renderMode === 'percentile') ? getNormRange() : null;
+            key = renderMode + ':' + depth + (range ? ':' + range.min + ':' + range.max : '');
+        }
+        if (intLut && intLutKey === key) return intLut;
+
+        if (jet) {
+            const mm = getMinMax();
+            const effectiveMin = (jetCustomMin !== null) ? jetCustomMin : mm.min;
+            const effectiveMax = (jetCustomMax !== null) ? jetCustomMax : mm.max;
+            const denom = (effectiveMax - effectiveMin) || 1;
+            intLut = new Uint8Array(size * 3);
+            for (let k = 0; k < size; k++) {
+                const color = jetColormap(Math.max(0, Math.min(1, (k + base - effectiveMin) / denom)));
+                intLut[k * 3] = color.r;
+                intLut[k * 3 + 1] = color.g;
+                intLut[k * 3 + 2] = color.b;
+            }
+        } else {
+            intLut = new Uint8Array(size);
+            for (let k = 0; k < size; k++) intLut[k] = mapToByte(k + base);
+        }
+        intLutKey = key;
+        return intLut;
+    }
+
+    // Put the image data on the offscreen canvas
+    function closeAllDropdowns() {
+        ddSaveFormat.classList.remove('open');
+        ddRenderMode.classList.remove('open');
+        ddValueFormat.classList.remove('open');
+    }
+
+    // Measure text width once (used to make dropdown buttons/menus stable-width)
+    const __measureSpan = document.createElement('span');
+    __measureSpan.style.position = 'fixed';
+    __measureSpan.style.left = '-99999px';
+    __measureSpan.style.top = '-99999px';
+    __measureSpan.style.visibility = 'hidden';
+    __measureSpan.style.whiteSpace = 'nowrap';
+    __measureSpan.style.fontSize = '12px';
+    __measureSpan.style.fontFamily = 'Arial, sans-serif';
+    document.body.appendChild(__measureSpan);
+
+    function measureTextPx(text, fontCss) {
+        __measureSpan.style.font = fontCss;
+        __measureSpan.textContent = text;
+        return __measureSpan.getBoundingClientRect().width;
+    }
+
+    document.addEventListener('click', (e) => {
+        // Close dropdowns when clicking anywhere outside the currently open dropdown(s)
+        // (including other toolbar areas, canvas, empty space, etc.)
+        const openDd = document.querySelector('.dd.open');
+        if (!openDd) return;
+        const inOpenDd = e.target.closest && e.target.closest('.dd.open');
+        if (!inOpenDd) closeAllDropdowns();
+    });
+
+    document.addEventListener('keydown', (e) => {
+        if (e.key === 'Escape') closeAllDropdowns();
+    });
+
+    function initDropdown(ddEl, btnEl, options, getValue, setValue) {
+        const menu = ddEl.querySelector('.dd-menu');
+        const fontCss = '12px Arial, sans-serif';
+
+        function updateStableWidth() {
+            // Button width = longest option label + padding + small caret space
+            let maxW = 0;
+            for (const opt of options) {
+                const w = measureTextPx(opt.label, fontCss);
+                if (w > maxW) maxW = w;
+            }
+            // 8px left + 8px right padding + ~18px extra
+            const target = Math.ceil(maxW + 34);
+            btnEl.style.width = target + 'px';
+            // Menu width follows the *actual* rendered button width (including borders)
+            const btnW = Math.ceil(btnEl.getBoundingClientRect().width);
+            menu.style.width = btnW + 'px';
+            menu.style.minWidth = btnW + 'px';
+            // Align menu under the button (dd contains a label + button)
+            menu.style.left = btnEl.offsetLeft + 'px';
+        }
+
+        function renderMenu() {
+            const cur = getValue();
+            menu.innerHTML = '';
+            for (const opt of options) {
+                const item = document.createElement('button');
+                item.type = 'button';
+                item.className = 'dd-item';
+                item.textContent = opt.label;
+                item.setAttribute('role', 'menuitemradio');
+                item.setAttribute('aria-checked', String(opt.value === cur));
+                item.addEventListener('click', () => {
+                    setValue(opt.value);
+                    btnEl.textContent = opt.label;
+                    ddEl.classList.remove('open');
+                });
+                menu.appendChild(item);
+            }
+        }
+
+        btnEl.addEventListener('click', () => {
+            const isOpen = ddEl.classList.contains('open');
+            closeAllDropdowns();
+            if (!isOpen) {
+                renderMenu();
+                updateStableWidth();
+                ddEl.classList.add('open');
+            }
+        });
+
+        // Initialize width once up-front
+        updateStableWidth();
+    }
+
+    // Init dropdowns
+    initDropdown(
+        ddSaveFormat,
+        btnSaveFormat,
+        [
+            { value: 'png', label: 'PNG' },
+            { value: 'tiff', label: 'TIFF' },
+            { value: 'npy', label: 'NPY' },
+        ],
+        () => saveFormat,
+        (v) => { saveFormat = v; }
+    );
+    initDropdown(
+        ddRenderMode,
+        btnRenderMode,
+        [
+            { value: 'byte', label: 'Byte [0, 255]' },
+            { value: 'norm01', label: 'Float * 255 → Byte' },
+            { value: 'minmax', label: '[min, max] → [0, 255]' },
+            { value: 'percentile', label: '[1%, 99%] → [0, 255]' },
+            { value: 'clamp255', label: 'Clamp → [0, 255]' },
+            { value: 'jet', label: 'Jet Colormap' },
+        ],
+        () => renderMode,
+        (v) => { renderMode = v; updateOffscreenFromRaw(); requestRender(); updateJetColorbarVisibility(); updateStatsInfo(); }
+    );
+    // Multi-channel Mats: show one channel as grayscale (only that channel is decoded)
+    if (channels > 1) {
+        const channelOptions = [{ value: -1, label: 'All' }];
+        for (let c = 0; c < channels; c++) channelOptions.push({ value: c, label: 'Ch ' + c });
+        initDropdown(
+            ddChannel,
+            btnChannel,
+            channelOptions,
+            () => selectedChannel,
+            (v) => {
+                selectedChannel = v;
+                glImageReady = false;
+                updateOffscreenFromRaw();
+                requestRender();
+                if (renderMode === 'jet') updateJetColorbarValues();
+            }
+        );
+    } else {
+        ddChannel.style.display = 'none';
+    }
+    initDropdown(
+        ddValueFormat,
+        btnValueFormat,
+        [
+            { value: 'fixed3', label: 'Fixed(3)' },
+            { value: 'fixed6', label: 'Fixed(6)' },
+            { value: 'sci2', label: 'Sci(2)' },
+            { value: 'sci4', label: 'Sci(4)' },
+        ],
+        () => valueFormat,
+        (v) => { valueFormat = v; requestRender(); }
+    );
+
+    // Zoom Level preset dropdown
+    initDropdown(
+        document.getElementById('ddZoomScale'),
+        zoomLevelDisplay,
+        [
+            { value: 'fit', label: 'Fit Window' },
+            { value: '10', label: '10%' },
+            { value: '25', label: '25%' },
+            { value: '50', label: '50%' },
+            { value: '100', label: '100%' },
+            { value: '200', label: '200%' },
+            { value: '400', label: '400%' },
+            { value: '800', label: '800%' },
+            { value: '1600', label: '1600%' }
+        ],
+        () => 'custom', // Doesn't matter because we just use click to set state
+        (v) => { 
+            if (v === 'fit') {
+                resetView();
+            } else {
+                const newScale = parseFloat(v) / 100.0;
+                // Zoom relative to center of view
+                const cx = window.innerWidth / 2;
+                const cy = window.innerHeight / 2;
+                setZoomAt(cx, cy, newScale);
+            }
+        }
+    );
+
+    // Jet Colorbar logic
+    const jetColorbar = document.getElementById('jetColorbar');
+    const sliderMax = document.getElementById('sliderMax');
+    const sliderMin = document.getElementById('sliderMin');
+    const jetMaxInput = document.getElementById('jetMaxInput');
+    const jetMinInput = document.getElementById('jetMinInput');
+    const jetResetBtn = document.getElementById('jetResetBtn');
+    const SLIDER_TRACK_HEIGHT = 150;
+
+    function updateJetColorbarVisibility() {
+        if (renderMode === 'jet' && isInitialized) {
+            jetColorbar.classList.add('visible');
+            updateJetColorbarValues();
+        } else {
+            jetColorbar.classList.remove('visible');
+        }
+    }
+
+    function updateJetColorbarValues() {
+        const mm = getMinMax();
+        const minVal = (jetCustomMin !== null) ? jetCustomMin : mm.min;
+        const maxVal = (jetCustomMax !== null) ? jetCustomMax : mm.max;
+
+        jetMinInput.value = minVal.toPrecision(4);
+        jetMaxInput.value = maxVal.toPrecision(4);
+
+        // Update slider positions based on values relative to auto range
+        const range = mm.max - mm.min || 1;
+        const maxPos = Math.max(0, Math.min(1, (mm.max - maxVal) / range));
+        const minPos = Math.max(0, Math.min(1, (minVal - mm.min) / range));
+
+        sliderMax.style.top = (maxPos * (SLIDER_TRACK_HEIGHT - 6)) + 'px';
+        sliderMin.style.top = 'auto';
+        sliderMin.style.bottom = (minPos * (SLIDER_TRACK_HEIGHT - 6)) + 'px';
+    }
+
+    function applyJetLimitsDebounced() {
+        if (jetDebounceTimer) clearTimeout(jetDebounceTimer);
+        // On the GPU a new limit is one uniform update and one draw, no need to wait
+        // (tiled mode still re-renders every loaded tile)
+        if (imageSource !== offscreenCanvas && !tiledInfo) {
+            updateOffscreenFromRaw();
+            requestRender();
+            return;
+        }
+        jetDebounceTimer = setTimeout(() => {
+            updateOffscreenFromRaw();
+            requestRender();
+        }, JET_DEBOUNCE_MS);
+    }
+
+    // Slider dragging
+    let draggingSlider = null;
+    let sliderStartY = 0;
+    let sliderStartTop = 0;
+
+    function onSliderMouseDown(e, slider, isMax) {
+        e.preventDefault();
+        draggingSlider = { slider, isMax };
+        slider.classList.add('dragging');
+        sliderStartY = e.clientY;
+        const rect = slider.getBoundingClientRect();
+        const trackRect = slider.parentElement.getBoundingClientRect();
+        sliderStartTop = rect.top - trackRect.top;
+    }
+
+    sliderMax.addEventListener('mousedown', (e) => onSliderMouseDown(e, sliderMax, true));
+    sliderMin.addEventListener('mousedown', (e) => onSliderMouseDown(e, sliderMin, false));
+
+    document.addEventListener('mousemove', (e) => {
+        if (!draggingSlider) return;
+
+        const { slider, isMax } = draggingSlider;
+        const deltaY = e.clientY - sliderStartY;
+        let newTop = sliderStartTop + deltaY;
+
+        // Clamp to track bounds
+        newTop = Math.max(0, Math.min(SLIDER_TRACK_HEIGHT - 6, newTop));
+
+        if (isMax) {
+            slider.style.top = newTop + 'px';
+        } else {
+            slider.style.top = 'auto';
+            slider.style.bottom = (SLIDER_TRACK_HEIGHT - 6 - newTop) + 'px';
+        }
+
+        // Calculate value from position
+        const mm = getMinMax();
+        const range = mm.max - mm.min || 1;
+        const normalizedPos = newTop / (SLIDER_TRACK_HEIGHT - 6);
+
+        if (isMax) {
+            // Max slider: top=0 means max value, top=full means min value
+            jetCustomMax = mm.max - normalizedPos * range;
+            jetMaxInput.value = jetCustomMax.toPrecision(4);
+        } else {
+            // Min slider: top=0 means max value, top=full means min value
+            jetCustomMin = mm.max - normalizedPos * range;
+            jetMinInput.value = jetCustomMin.toPrecision(4);
+        }
+
+        applyJetLimitsDebounced();
+    });
+
+    document.addEventListener('mouseup', () => {
+        if (draggingSlider) {
+            draggingSlider.slider.classList.remove('dragging');
+            draggingSlider = null;
+        }
+    });
+
+    // Input field change handlers
+    jetMaxInput.addEventListener('change', () => {
+        const val = parseFloat(jetMaxInput.value);
+        if (!isNaN(val)) {
+            jetCustomMax = val;
+            updateJetColorbarValues();
+            applyJetLimitsDebounced();
+        }
+    });
+
+    jetMinInput.addEventListener('change', () => {
+        const val = parseFloat(jetMinInput.value);
+        if (!isNaN(val)) {
+            jetCustomMin = val;
+            updateJetColorbarValues();
+            applyJetLimitsDebounced();
+        }
+    });
+
+    // Reset button
+    jetResetBtn.addEventListener('click', () => {
+        jetCustomMin = null;
+        jetCustomMax = null;
+        updateJetColorbarValues();
+        updateOffscreenFromRaw();
+        requestRender();
+    });
+
+    // Defaults
+    btnSaveFormat.textContent = 'PNG';
+    btnValueFormat.textContent = 'Fixed(3)';
+
+    // Auto pick a better default for float/double
+    if (isFloatDepth()) {
+        renderMode = 'norm01';
+        btnRenderMode.textContent = 'Float * 255 → Byte';
+        valueFormat = 'sci2'; // Scientific notation by default for floats
+        btnValueFormat.textContent = 'Sci(2)';
+        ddValueFormat.style.display = 'inline-flex';
+    } else {
+        btnRenderMode.textContent = 'Byte [0, 255]';
+        ddValueFormat.style.display = 'none';
+    }
+
+    function clamp(v, lo, hi) {
+        return Math.max(lo, Math.min(hi, v));
+    }
+
+    function computeAutoUiScale() {
+        const dpr = window.devicePixelRatio || 1;
+        // In auto mode, we use 100% scale (1.0) as the base for 1x DPI.
+        const baseScale = dpr;
+        // For scientific notation or high precision, we need even more space.
+        const formatFactor = (valueFormat === 'sci2' || valueFormat === 'sci4' || valueFormat === 'fixed6') ? 1.2 : 1.0;
+        return clamp(baseScale * formatFactor, 1, 4);
+    }
+
+    function updateUiScale() {
+        uiScale = computeAutoUiScale();
+    }
+
+    updateUiScale();
+
+    function formatFloat(v) {
+        if (!isFinite(v)) return ' NaN ';
+        let s = '';
+        if (valueFormat === 'fixed3') s = v.toFixed(3);
+        else if (valueFormat === 'fixed6') s = v.toFixed(6);
+        else if (valueFormat === 'sci2') s = v.toExponential(2);
+        else if (valueFormat === 'sci4') s = v.toExponential(4);
+        else s = v.toFixed(3);
+        // Reserve a space for the sign if positive, to align with negative numbers
+        return (v >= 0 ? ' ' : '') + s;
+    }
+
+    function formatValue(v) {
+        // Float/double: show raw values nicely; ints remain integer
+        if (isFloatDepth()) return formatFloat(v);
+        // For integer-like, keep 3-char alignment with spaces as requested
+        return String(v | 0).padStart(3, ' ');
+    }
+
+    // Per-channel statistics line(s) under the controls
+    function updateStatsInfo() {
+        if (!cachedStats) return;
+        const stats = cachedStats;
+        const lines = stats.channels.map((ch, c) =>
+            (channels > 1 ? 'ch' + c + ' ' : '') +
+            'min ' + formatValue(ch.min).trim() + '  max ' + formatValue(ch.max).trim() +
+            '  mean ' + formatFloat(ch.mean).trim() + '  std ' + formatFloat(ch.std).trim()
+        );
+        if (stats.nanCount || stats.infCount) {
+            lines.push('NaN ' + stats.nanCount + '  Inf ' + stats.infCount);
+        }
+        if (renderMode === 'percentile') {
+            lines.push('1%-99% clip [' + formatFloat(stats.clip.min).trim() + ', ' + formatFloat(stats.clip.max).trim() + ']');
+        }
+        statsInfo.textContent = lines.join('\n');
+    }
+
+    // Update pixel info display for synced highlight from other panels
+    function updatePixelInfoForHighlight(px, py) {
+        if (px === null || py === null) {
+            pixelInfo.textContent = '';
+            return;
+        }
+
+        if (px >= 0 && px < cols && py >= 0 && py < rows) {
+            const [src, idx] = locatePixel(px, py);
+            let valStr = '';
+            if (channels === 1) {
+                valStr = formatValue(src[idx]);
+            } else if (channels === 4) {
+                valStr = `R:${formatValue(src[idx])} G:${formatValue(src[idx+1])} B:${formatValue(src[idx+2])} A:${formatValue(src[idx+3])}`;
+            } else {
+                valStr = `R:${formatValue(src[idx])} G:${formatValue(src[idx+1])} B:${formatValue(src[idx+2])}`;
+            }
+            pixelInfo.textContent = `(${px}, ${py}) : ${valStr}`;
+        } else {
+            pixelInfo.textContent = '';
+        }
+    }
+
+    function updateCanvasSize() {
+        const containerRect = container.getBoundingClientRect();
+        const dpr = window.devicePixelRatio || 1;
+        viewW = containerRect.width;
+        viewH = containerRect.height;
+
+        // Ensure crisp rendering on HiDPI screens by decoupling CSS size and backing store size
+        canvas.style.width = viewW + 'px';
+        canvas.style.height = viewH + 'px';
+        gridCanvas.style.width = viewW + 'px';
+        gridCanvas.style.height = viewH + 'px';
+        textCanvas.style.width = viewW + 'px';
+        textCanvas.style.height = viewH + 'px';
+
+        canvas.width = Math.max(1, Math.floor(viewW * dpr));
+        canvas.height = Math.max(1, Math.floor(viewH * dpr));
+        gridCanvas.width = Math.max(1, Math.floor(viewW * dpr));
+        gridCanvas.height = Math.max(1, Math.floor(viewH * dpr));
+        textCanvas.width = Math.max(1, Math.floor(viewW * dpr));
+        textCanvas.height = Math.max(1, Math.floor(viewH * dpr));
+
+        // Draw in CSS pixels; transform maps to device pixels
+        ctx.setTransform(dpr, 0, 0, dpr, 0, 0);
+        gridCtx.setTransform(dpr, 0, 0, dpr, 0, 0);
+        textCtx.setTransform(dpr, 0, 0, dpr, 0, 0);
+
+        // Keep overlays sharp
+        gridCtx.imageSmoothingEnabled = false;
+        textCtx.imageSmoothingEnabled = false;
+    }
+
+    function drawGrid() {
+        if (scale >= 10) {
+            gridCtx.clearRect(0, 0, viewW, viewH);
+            gridCtx.strokeStyle = 'rgba(128, 128, 128, 0.5)';
+            gridCtx.lineWidth = 1;
+
+            // Draw vertical lines
+            for (let x = 0; x <= cols; x++) {
+                const pixelX = x * scale + offsetX;
+                gridCtx.beginPath();
+                gridCtx.moveTo(pixelX, offsetY);
+                gridCtx.lineTo(pixelX, rows * scale + offsetY);
+                gridCtx.stroke();
+            }
+
+            // Draw horizontal lines
+            for (let y = 0; y <= rows; y++) {
+                const pixelY = y * scale + offsetY;
+                gridCtx.beginPath();
+                gridCtx.moveTo(offsetX, pixelY);
+                gridCtx.lineTo(cols * scale + offsetX, pixelY);
+                gridCtx.stroke();
+            }
+        } else {
+            gridCtx.clearRect(0, 0, viewW, viewH);
+        }
+    }
+
+    function drawPixelTextOverlay() {
+        textCtx.clearRect(0, 0, viewW, viewH);
+        if (!pixelTextEnabled) return;
+
+        // 1. Compute visible image rect
+        const left = Math.max(0, Math.floor((-offsetX) / scale));
+        const top = Math.max(0, Math.floor((-offsetY) / scale));
+        const right = Math.min(cols - 1, Math.ceil((viewW - offsetX) / scale) - 1);
+        const bottom = Math.min(rows - 1, Math.ceil((viewH - offsetY) / scale) - 1);
+        if (right < left || bottom < top) return;
+
+        // 2. Sampling: Find the ACTUAL maximum character length in the current view
+        let actualMaxChars = 1;
+        const step = Math.max(1, Math.floor((right - left) / 10)); // Sample ~10x10 grid
+        const channelsToSample = (channels >= 3) ? channels : 1;
+        for (let y = top; y <= bottom; y += step) {
+            for (let x = left; x <= right; x += step) {
+                const [src, idx] = locatePixel(x, y);
+                for (let c = 0; c < channelsToSample; c++) {
+                    const val = src[idx + c];
+                    let len = formatValue(val).length;
+                    if (channels >= 3) len += 2; // "R:", "G:", "B:", "A:" prefix
+                    if (len > actualMaxChars) actualMaxChars = len;
+                }
+            }
+        }
+
+        const numLines = (channels === 4) ? 4 : (channels === 3) ? 3 : 1;
+        const fillFactor = 0.90; // Use 90% of the cell
+        const usableCellW = scale * fillFactor;
+        const usableCellH = scale * fillFactor;
+
+        // Measure actual character width ratio for the monospace font
+        textCtx.font = "100px ui-monospace, SFMono-Regular, Menlo, Monaco, Consolas, monospace";
+        const charWidthRatio = textCtx.measureText("0").width / 100;
+
+        // Calculate max font size that fits both width and height
+        const fontSizeW = usableCellW / (charWidthRatio * actualMaxChars);
+        const fontSizeH = usableCellH / (1.05 * numLines); // 1.05 for line spacing
+
+        let fontSize = Math.floor(Math.min(fontSizeW, fontSizeH));
+
+        // 3. Minimum 8px requirement
+        if (fontSize < 8) return;
+
+         fontSize = Math.min(16, fontSize);
+
+        const fontFamily = 'ui-monospace, SFMono-Regular, Menlo, Monaco, Consolas, monospace';
+        const lineHeight = Math.floor(fontSize * 1.05);
+
+        textCtx.font = fontSize + 'px ' + fontFamily;
+        textCtx.textAlign = 'center';
+        textCtx.textBaseline = 'middle';
+        textCtx.lineWidth = Math.max(1, Math.floor(fontSize / 6));
+        textCtx.strokeStyle = 'rgba(0, 0, 0, 0.8)';
+        textCtx.fillStyle = 'rgba(255, 255, 255, 0.95)';
+
+        // Since fontSize is derived from actualMaxChars, it is guaranteed to fit.
+        // We remove the secondary fit check that was causing rendering to be skipped.
+        const padGray = 1;
+        const padRgb = 1;
+
+        const visibleW = right - left + 1;
+        const visibleH = bottom - top + 1;
+        const visibleCount = visibleW * visibleH;
+        if (visibleCount > MAX_PIXEL_TEXT_LABELS) return;
+
+        for (let y = top; y <= bottom; y++) {
+            const screenY = y * scale + offsetY + scale / 2;
+            if (screenY < -scale || screenY > viewH + scale) continue;
+
+            for (let x = left; x <= right; x++) {
+                const screenX = x * scale + offsetX + scale / 2;
+                if (screenX < -scale || screenX > viewW + scale) continue;
+
+                const [src, idx] = locatePixel(x, y);
+                if (channels === 3) {
+                    const r = src[idx];
+                    const g = src[idx + 1];
+                    const b = src[idx + 2];
+
+                    const cellX = x * scale + offsetX;
+                    const cellY = y * scale + offsetY;
+                    const cellInnerW = scale - padRgb * 2;
+                    const cellInnerH = scale - padRgb * 2;
+                    const l1 = 'R:' + formatValue(r);
+                    const l2 = 'G:' + formatValue(g);
+                    const l3 = 'B:' + formatValue(b);
+                    const lines = [l1, l2, l3];
+
+                    textCtx.save();
+                    textCtx.beginPath();
+                    textCtx.rect(cellX + padRgb, cellY + padRgb, cellInnerW, cellInnerH);
+                    textCtx.clip();
+
+                    const totalH = lines.length * lineHeight;
+                    const topY = (cellY + padRgb) + (cellInnerH - totalH) / 2 + lineHeight / 2;
+                    textCtx.strokeText(l1, screenX, topY);
+                    textCtx.fillText(l1, screenX, topY);
+                    textCtx.strokeText(l2, screenX, topY + lineHeight);
+                    textCtx.fillText(l2, screenX, topY + lineHeight);
+                    textCtx.strokeText(l3, screenX, topY + lineHeight * 2);
+                    textCtx.fillText(l3, screenX, topY + lineHeight * 2);
+                    textCtx.restore();
+                } else if (channels === 4) {
+                    const r = src[idx];
+                    const g = src[idx + 1];
+                    const b = src[idx + 2];
+                    const a = src[idx + 3];
+
+                    const cellX = x * scale + offsetX;
+                    const cellY = y * scale + offsetY;
+                    const cellInnerW = scale - padRgb * 2;
+                    const cellInnerH = scale - padRgb * 2;
+                    const l1 = 'R:' + formatValue(r);
+                    const l2 = 'G:' + formatValue(g);
+                    const l3 = 'B:' + formatValue(b);
+                    const l4 = 'A:' + formatValue(a);
+
+                    textCtx.save();
+                    textCtx.beginPath();
+                    textCtx.rect(cellX + padRgb, cellY + padRgb, cellInnerW, cellInnerH);
+                    textCtx.clip();
+
+                    const totalH = 4 * lineHeight;
+                    const topY = (cellY + padRgb) + (cellInnerH - totalH) / 2 + lineHeight / 2;
+                    textCtx.strokeText(l1, screenX, topY);
+                    textCtx.fillText(l1, screenX, topY);
+                    textCtx.strokeText(l2, screenX, topY + lineHeight);
+                    textCtx.fillText(l2, screenX, topY + lineHeight);
+                    textCtx.strokeText(l3, screenX, topY + lineHeight * 2);
+                    textCtx.fillText(l3, screenX, topY + lineHeight * 2);
+                    textCtx.strokeText(l4, screenX, topY + lineHeight * 3);
+                    textCtx.fillText(l4, screenX, topY + lineHeight * 3);
+                    textCtx.restore();
+                } else if (channels === 1) {
+                    const label = formatValue(src[idx]);
+                    const cellX = x * scale + offsetX;
+                    const cellY = y * scale + offsetY;
+                    const cellInnerW = scale - padGray * 2;
+                    const cellInnerH = scale - padGray * 2;
+
+                    textCtx.save();
+                    textCtx.beginPath();
+                    textCtx.rect(cellX + padGray, cellY + padGray, cellInnerW, cellInnerH);
+                    textCtx.clip();
+                    textCtx.strokeText(label, screenX, screenY);
+                    textCtx.fillText(label, screenX, screenY);
+                    textCtx.restore();
+                }
+            }
+        }
+    }
+
+    function draw() {
+        const drawStartedAt = performance.now();
+        ctx.clearRect(0, 0, viewW, viewH);
+
+        // Calculate scaled dimensions (an overview pixel covers overviewFactor^2 pixels)
+        const scaledWidth = dataCols * overviewFactor * scale;
+        const scaledHeight = dataRows * overviewFactor * scale;
+
+        // Draw from top-left corner with offset
+        const x = offsetX;
+        const y = offsetY;
+
+        ctx.imageSmoothingEnabled = false; // Disable smoothing
+        ctx.drawImage(imageSource, x, y, scaledWidth, scaledHeight);
+        drawTiles();
+
+        // Draw grid when zoomed in
+        drawGrid();
+        drawPixelTextOverlay();
+
+        // Draw pixel highlight (blue border) for synchronized viewing
+        drawPixelHighlight();
+
+        // Update zoom level display
+        // Set the button text to show the current zoom percentage
+        const pct = Math.max(0, Math.round(scale * 100));
+        zoomLevelDisplay.textContent = pct + '%';
+
+        if (renderedPending) {
+            vscode.postMessage({
+                command: 'rendered',
+                complete: renderedPending.complete,
+                decodeMs: renderedPending.decodeMs,
+                renderMs: performance.now() - drawStartedAt
+            });
+            renderedPending = null;
+        }
+    }
+
+    // Draw pixel highlight with blue border (for synced panels)
+    function drawPixelHighlight() {
+        // Priority: local hover > synced highlight
+        // If local mouse is hovering, show local; otherwise show synced
+        let px, py;
+        if (localHoverPixelX !== null && localHoverPixelY !== null) {
+            // Local mouse is active, use local hover
+            px = localHoverPixelX;
+            py = localHoverPixelY;
+        } else if (highlightPixelX !== null && highlightPixelY !== null) {
+            // No local hover, show synced highlight
+            px = highlightPixelX;
+            py = highlightPixelY;
+        } else {
+            // No highlight to show
+            return;
+        }
+
+        if (px < 0 || px >= cols || py < 0 || py >= rows) return;
+
+        // Calculate screen position of the pixel
+        const screenX = offsetX + px * scale;
+        const screenY = offsetY + py * scale;
+        const pixelSize = scale;
+
+        // Draw blue border (2px thick)
+        ctx.save();
+        ctx.strokeStyle = '#00aaff';
+        ctx.lineWidth = 2;
+        ctx.strokeRect(screenX, screenY, pixelSize, pixelSize);
+        ctx.restore();
+    }
+
+    function requestRender() {
+        if (renderQueued) return;
+        renderQueued = true;
+        requestAnimationFrame(() => {
+            renderQueued = false;
+            draw();
+        });
+    }
+
+    function requestRenderWithSync() {
+        requestRender();
+        emitViewChange();
+    }
+
+    function setZoom(newScale) {
+        scale = Math.max(0.05, Math.min(100, newScale)); // Increased max zoom to 100x
+        requestRenderWithSync();
+    }
+
+    // Zoom around a screen point (mouse cursor), keeping the image coord under cursor stable
+    function setZoomAt(screenX, screenY, newScale) {
+        const prevScale = scale;
+        const nextScale = Math.max(0.05, Math.min(100, newScale));
+        if (nextScale === prevScale) return;
+
+        // Image coordinates under cursor before zoom
+        const imgX = (screenX - offsetX) / prevScale;
+        const imgY = (screenY - offsetY) / prevScale;
+
+        scale = nextScale;
+
+        // Adjust offsets so the same image coord stays under cursor
+        offsetX = screenX - imgX * nextScale;
+        offsetY = screenY - imgY * nextScale;
+
+        requestRenderWithSync();
+    }
+
+    function resetView() {
+        const MIN_DISPLAY_SIZE = 400; // 最小显示尺寸
+        const MAX_AUTO_SCALE = 100;    // 与 setZoom 的上限保持一致（100x = 10000%）
+
+        // 确保 viewW/viewH 已初始化
+        if (viewW === 0 || viewH === 0) {
+            const containerRect = container.getBoundingClientRect();
+            viewW = containerRect.width;
+            viewH = containerRect.height;
+        }
+
+        // 计算使图像至少达到 MIN_DISPLAY_SIZE 的缩放比例
+        const minDimension = Math.min(cols, rows);
+        const minScale = MIN_DISPLAY_SIZE / minDimension;
+
+        // 如果图像本身就很大，使用 1.0；否则使用 minScale，并限制不超过最大缩放
+        scale = Math.max(1, Math.min(MAX_AUTO_SCALE, minScale));
+
+        // 居中显示
+        offsetX = (viewW - cols * scale) / 2;
+        offsetY = (viewH - rows * scale) / 2;
+
+        requestRenderWithSync();
+    }
+
+    // Event Listeners
+    document.getElementById('zoomIn').addEventListener('click', () => {
+        const cx = hasLastMouse ? lastMouseX : viewW / 2;
+        const cy = hasLastMouse ? lastMouseY : viewH / 2;
+        setZoomAt(cx, cy, scale * 1.5); // Increased zoom factor
+    });
+
+    document.getElementById('zoomOut').addEventListener('click', () => {
+        const cx = hasLastMouse ? lastMouseX : viewW / 2;
+        const cy = hasLastMouse ? lastMouseY : viewH / 2;
+        setZoomAt(cx, cy, scale / 1.5);
+    });
+
+    document.getElementById('reset').addEventListener('click', () => {
+        resetView();
+    });
+
+    document.getElementById('reload').addEventListener('click', () => {
+        vscode.postMessage({ command: 'reload' });
+    });
+
+    // Toggle pixel text overlay
+    togglePixelTextBtn.addEventListener('click', () => {
+        pixelTextEnabled = !pixelTextEnabled;
+        togglePixelTextBtn.classList.toggle('active', pixelTextEnabled);
+        requestRender();
+    });
+    togglePixelTextBtn.classList.toggle('active', pixelTextEnabled);
+
+    // Save: PNG as rendered here; TIFF/NPY are written by the extension from the raw data
+    saveImageBtn.addEventListener('click', () => {
+        const fmt = saveFormat;
+        if (fmt === 'png') {
+            const link = document.createElement('a');
+            link.download = 'image.png';
+            link.href = imageSource.toDataURL('image/png');
+            link.click();
+            return;
+        }
+        vscode.postMessage({ command: 'exportData', format: fmt });
+    });
+
+    // Interaction
+    container.addEventListener('mousedown', (e) => {
+        if (isShuttingDown) return;
+        isDragging = true;
+        const containerRect = container.getBoundingClientRect();
+        const mouseX = e.clientX - containerRect.left;
+        const mouseY = e.clientY - containerRect.top;
+        startX = mouseX - offsetX;
+        startY = mouseY - offsetY;
+    });
+
+    // Use container for mousemove to ensure it works in both main window and auxiliary window
+    container.addEventListener('mousemove', (e) => {
+        if (isShuttingDown) return;
+
+        // Get mouse position relative to container
+        const containerRect = container.getBoundingClientRect();
+        const mouseX = e.clientX - containerRect.left;
+        const mouseY = e.clientY - containerRect.top;
+
+        lastMouseX = mouseX;
+        lastMouseY = mouseY;
+        hasLastMouse = true;
+
+        if (isDragging) {
+            offsetX = mouseX - startX;
+            offsetY = mouseY - startY;
+            requestRenderWithSync();
+        }
+
+        // Update pixel info - use relative coordinates
+        const imgX = Math.floor((mouseX - offsetX) / scale);
+        const imgY = Math.floor((mouseY - offsetY) / scale);
+
+        if (imgX >= 0 && imgX < cols && imgY >= 0 && imgY < rows) {
+            const [src, idx] = locatePixel(imgX, imgY);
+            let valStr = '';
+            if (channels === 1) {
+                valStr = formatValue(src[idx]);
+            } else if (channels === 4) {
+                valStr = `R:${formatValue(src[idx])} G:${formatValue(src[idx+1])} B:${formatValue(src[idx+2])} A:${formatValue(src[idx+3])}`;
+            } else {
+                valStr = `R:${formatValue(src[idx])} G:${formatValue(src[idx+1])} B:${formatValue(src[idx+2])}`;
+            }
+            pixelInfo.textContent = `(${imgX}, ${imgY}) : ${valStr}`;
+
+            // Update local hover pixel and send to sync
+            if (localHoverPixelX !== imgX || localHoverPixelY !== imgY) {
+                localHoverPixelX = imgX;
+                localHoverPixelY = imgY;
+                // Don't clear synced highlight - it's stored and drawPixelHighlight will decide priority
+                requestRender();
+                // Send pixel highlight to synced panels
+                if (!isShuttingDown && isInitialized) {
+                    console.log('[MatWebview] Sending pixelHighlight: (' + imgX + ', ' + imgY + ')');
+                    vscode.postMessage({
+                        command: 'pixelHighlight',
+                        pixelX: imgX,
+                        pixelY: imgY
+                    });
+                }
+            }
+        } else {
+            pixelInfo.textContent = '';
+            // Clear local hover when mouse leaves image area
+            if (localHoverPixelX !== null || localHoverPixelY !== null) {
+                localHoverPixelX = null;
+                localHoverPixelY = null;
+                requestRender();
+                // Clear highlight on synced panels
+                if (!isShuttingDown && isInitialized) {
+                    vscode.postMessage({
+                        command: 'pixelHighlight',
+                        pixelX: null,
+                        pixelY: null
+                    });
+                }
+            }
+            // When mouse leaves image area, allow synced highlight to show (don't clear it)
+            // This allows other windows' highlights to be visible when local mouse is outside
+        }
+    });
+
+    // Clear local hover when mouse leaves container
+    container.addEventListener('mouseleave', () => {
+        if (isShuttingDown) return;
+        // Clear local hover state to allow synced highlight to show
+        if (localHoverPixelX !== null || localHoverPixelY !== null) {
+            localHoverPixelX = null;
+            localHoverPixelY = null;
+            requestRender();
+        }
+    });
+
+    document.addEventListener('mouseup', () => {
+        isDragging = false;
+    });
+
+    container.addEventListener('wheel', (e) => {
+        if (isShuttingDown) return;
+        e.preventDefault();
+        const delta = -e.deltaY;
+        const factor = delta > 0 ? 1.1 : 1 / 1.1;
+        const containerRect = container.getBoundingClientRect();
+        const mouseX = e.clientX - containerRect.left;
+        const mouseY = e.clientY - containerRect.top;
+        setZoomAt(mouseX, mouseY, scale * factor);
+    }, { passive: false });
+
+    window.addEventListener('resize', () => {
+        updateCanvasSize();
+        updateUiScale();
+        requestRender();
+    });
+
+    // Mark shutting down to block further interactions/sync
+    window.addEventListener('beforeunload', () => {
+        isShuttingDown = true;
+    });
+
+    // Initial setup
+    updateCanvasSize();
+})();
+
+function getNonce() {
+    let text = "";
+    const possible = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    for (let i = 0; i < 32; i++) {
+        text += possible.charAt(Math.floor(Math.random() * possible.length));
+    }
+    return text;
+}
@@ -0,0 +1,76 @@
+// Slice sliders of an N-D Mat or volume panel (viewer config `slices`).
+// Bundled into matViewer.js by esbuild.js; the viewer calls shown() when a
+// 'completeData' message carries a sliceIndex.
+//
+// One slider per leading axis. Only one 'selectSlice' request is in flight;
+// dragging faster only asks for the latest position once the previous slice
+// has arrived, so the extension never reads slices nobody will see.
+
+export function initSliceBar(vscode, slices) {
+    const bar = document.getElementById('slice-bar');
+    if (!bar || !slices || !slices.shape || slices.shape.length === 0) {
+        return { shown() {} };
+    }
+
+    let index = slices.index.slice();
+    let inFlight = false;
+    let wanted = null;
+    const sliders = [];
+    const labels = [];
+
+    function label(axis) {
+        return 'axis ' + axis + ': ' + index[axis] + ' / ' + (slices.shape[axis] - 1);
+    }
+
+    function request(next, axis) {
+        if (inFlight) {
+            wanted = { index: next, axis };
+            return;
+        }
+        inFlight = true;
+        wanted = null;
+        vscode.postMessage({ command: 'selectSlice', index: next, axis });
+    }
+
+    slices.shape.forEach((extent, axis) => {
+        const group = document.createElement('span');
+        group.className = 'slice-axis';
+        const slider = document.createElement('input');
+        slider.type = 'range';
+        slider.min = '0';
+        slider.max = String(extent - 1);
+        slider.step = '1';
+        slider.value = String(index[axis]);
+        const text = document.createElement('span');
+        text.className = 'slice-label';
+        text.textContent = label(axis);
+        slider.addEventListener('input', () => {
+            const next = index.slice();
+            next[axis] = Number(slider.value);
+            text.textContent = 'axis ' + axis + ': ' + next[axis] + ' / ' + (extent - 1);
+            request(next, axis);
+        });
+        group.appendChild(slider);
+        group.appendChild(text);
+        bar.appendChild(group);
+        sliders.push(slider);
+        labels.push(text);
+    });
+    bar.classList.add('visible');
+
+    return {
+        shown(sliceIndex) {
+            index = sliceIndex.slice();
+            inFlight = false;
+            if (wanted) {
+                const next = wanted;
+                request(next.index, next.axis);
+                return;
+            }
+            sliders.forEach((slider, axis) => {
+                slider.value = String(index[axis]);
+                labels[axis].textContent = label(axis);
+            });
+        }
+    };
+}
@@ -17,7 +17,75 @@ import { PanelManager } from "../utils/panelManager";
 import { SyncManager } from "../utils/syncManager";
 import * as fs from 'fs';
 import { getMatInfoFromVariables } from "../matImage/matProvider";
-import { getBytesPerElement, is1DStdArray } from "../utils/opencv";
+import { isReadCancelled } from "../utils/cancellation";
+import { logDebug, tracePost } from "../utils/logger";
+import {
+  getBytesPerElement,
+  is1DStdArray,
+  NumericArray,
+  bufferToTypedArray,
+  getElementKindFromCppType,
+  getElementKindFromDepth
+} from "../utils/opencv";
+import { readPublishedSegment, SEGMENT_KIND_FLOAT } from "../utils/sharedMemory";
+import { readRbTreeValues } from "../utils/rbTree";
+import { writeCsvSeries, writeNpySeries } from "../utils/exporters";
+import { FrameRecorder } from "../utils/frameRecorder";
+
+/**
+ * Message fields for plot data: the typed array's bytes plus its constructor name,
+ * so the webview can view them as the same element type without a number[] copy.
+ */
+function toPlotPayload(data: NumericArray): { data: Uint8Array, dtype: string } {
+    return {
+        data: new Uint8Array(data.buffer, data.byteOffset, data.byteLength),
+        dtype: data.constructor.name
+    };
+}
+
+/**
+ * Save a plot panel's export. PNG comes rendered from the webview; CSV and NPY
+ * are streamed from the series the extension read for the panel (`_plotY`, and
+ * `_plotX` when the viewer plots against another variable).
+ */
+async function savePlotFile(panel: vscode.WebviewPanel, message: any) {
+    const filters: Record<string, { [name: string]: string[] }> = {
+        png: { 'Images': ['png'] },
+        csv: { 'Data': ['csv'] },
+        npy: { 'NumPy Arrays': ['npy'] }
+    };
+    const fileUri = await vscode.window.showSaveDialog({
+        defaultUri: vscode.Uri.file(message.defaultName),
+        filters: filters[message.type] || filters.csv
+    });
+    if (!fileUri) {
+        return;
+    }
+
+    try {
+        if (message.type === 'png') {
+            const base64Data = message.data.replace(/^data:image\/png;base64,/, "");
+            fs.writeFileSync(fileUri.fsPath, base64Data, 'base64');
+        } else {
+            const y = (panel as any)._plotY as NumericArray | undefined;
+            if (!y) {
+                vscode.window.showWarningMessage('No plot data to save; reload the variable first.');
+                return;
+            }
+            const plotX = (panel as any)._plotX as { name: string; data: NumericArray } | undefined;
+            const x = plotX && plotX.name === message.xName ? plotX.data : undefined;
+            if (message.type === 'npy') {
+                await writeNpySeries(fileUri.fsPath, y, x);
+            } else {
+                await writeCsvSeries(fileUri.fsPath, x ? message.xName : 'Index', message.yName, y, x);
+            }
+        }
+        vscode.window.showInformationMessage(`File saved to ${fileUri.fsPath}`);
+    } catch (error) {
+        vscode.window.showErrorMessage(`Failed to save file: ${error}`);
+        console.error("Error saving plot file:", error);
+    }
+}
 
 /**
  * Helper to detect 1D std::array from type string and extract info
@@ -124,7 +192,7 @@ export async function drawPlot(
         }
 
         // Step 4: Now read full data since we need to update
-        let initialData: number[] | null = null;
+        let initialData: NumericArray | null = null;
         let dataPtrForToken = "";
         
         if (typeof elementTypeOrMat === 'string') {
@@ -194,9 +262,11 @@ export async function drawPlot(
       // CRITICAL: Don't await postMessage - it can block and cause debug freeze
       try {
         // Fire and forget - don't await
-        panel.webview.postMessage({
+        (panel as any)._plotY = initialData;
+        FrameRecorder.capture(panel, { kind: 'plot', data: initialData });
+        tracePost(panel.webview, {
           command: 'updateInitialData',
-          data: initialData
+          ...toPlotPayload(initialData)
         });
       } catch (e) {
         console.log("[drawPlot] postMessage failed - panel likely disposed");
@@ -222,7 +292,7 @@ export async function drawPlot(
     }
 
     // Set HTML without embedding data (data will be sent via postMessage)
-    panel.webview.html = getWebviewContentForPlot(panelName);
+    panel.webview.html = getWebviewContentForPlot(panel.webview, panelName);
     
     // Send ready signal immediately so webview knows this is not a moved panel
     panel.webview.postMessage({ command: 'ready' });
@@ -301,12 +371,12 @@ export async function drawPlot(
             const variables = await vscode.commands.executeCommand<any[]>('cv-debugmate.getVariables');
             const targetVar = variables?.find(v => v.name === message.name);
             if (targetVar) {
-                let newData: number[] | null = null;
+                let newData: NumericArray | null = null;
                 const arrayInfo = parse1DStdArrayFromType(targetVar.type);
                 
                 if (targetVar.type.includes("cv::Mat")) {
                     const frameId = await getCurrentFrameId(debugSession);
-                    const matInfo = await getMatInfoFromVariables(debugSession, targetVar.variablesReference);
+                    const matInfo = await getMatInfoFromVariables(debugSession, targetVar.variablesReference, targetVar.type);
                     newData = await readMatDataInternal(debugSession, targetVar.evaluateName, matInfo);
                 } else if (arrayInfo.is1DArray) {
                     // Handle std::array types
@@ -321,10 +391,13 @@ export async function drawPlot(
                 if (newData) {
                     if ((panel as any)._isDisposing) return;
                     try {
-                        panel.webview.postMessage({ 
+                        if (message.target === 'x') {
+                            (panel as any)._plotX = { name: message.name, data: newData };
+                        }
+                        tracePost(panel.webview, { 
                             command: 'updateData', 
                             target: message.target, 
-                            data: newData, 
+                            ...toPlotPayload(newData),
                             name: message.name 
                         });
                     } catch (e) {
@@ -338,8 +411,8 @@ export async function drawPlot(
             if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
                 // CRITICAL: Fire-and-forget - don't await to avoid blocking
                 Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: variableName, evaluateName: variableName, skipToken: true }))
-                    .then(() => console.log(`[DEBUG-TRACE] Plot reload completed`))
-                    .catch((e: Error) => console.log(`[DEBUG-TRACE] Plot reload failed:`, e));
+                    .then(() => logDebug(`Plot reload completed`))
+                    .catch((e: Error) => logDebug(`Plot reload failed:`, e));
             } else {
                 console.log('Skipping reload - debug session is no longer active or has changed');
             }
@@ -347,21 +420,7 @@ export async function drawPlot(
             // Save view state for persistence across tab switches
             SyncManager.syncView(panelName, message.state);
         } else if (message.command === 'saveFile') {
-            const options: vscode.SaveDialogOptions = {
-                defaultUri: vscode.Uri.file(message.defaultName),
-                filters: message.type === 'png' ? { 'Images': ['png'] } : { 'Data': ['csv'] }
-            };
-
-            const fileUri = await vscode.window.showSaveDialog(options);
-            if (fileUri) {
-                if (message.type === 'png') {
-                    const base64Data = message.data.replace(/^data:image\/png;base64,/, "");
-                    fs.writeFileSync(fileUri.fsPath, base64Data, 'base64');
-                } else {
-                    fs.writeFileSync(fileUri.fsPath, message.data);
-                }
-                vscode.window.showInformationMessage(`File saved to ${fileUri.fsPath}`);
-            }
+            await savePlotFile(panel, message);
         }
     });
 
@@ -376,9 +435,12 @@ export async function drawPlot(
     
     try {
       // Fire and forget - don't await
-      panel.webview.postMessage({
+      (panel as any)._plotY = initialData;
+      FrameRecorder.capture(panel, { kind: 'plot', data: initialData });
+      (panel as any)._plotX = undefined;
+      tracePost(panel.webview, {
         command: 'completeData',
-        data: initialData
+        ...toPlotPayload(initialData)
       });
     } catch (e) {
       console.log("[drawPlot] Final postMessage failed - panel likely disposed");
@@ -386,6 +448,7 @@ export async function drawPlot(
     }
 
   } catch (error: any) {
+    if (isReadCancelled(error)) throw error;
     vscode.window.showErrorMessage(`Failed to draw plot: ${error.message}`);
     console.error(error);
   }
@@ -415,24 +478,7 @@ async function getVectorMetadata(
     }
 
     // Determine bytes per element from type
-    let bytesPerElement = 4;
-    const typeLower = type.toLowerCase();
-    if (typeLower.includes("double")) {
-        bytesPerElement = 8;
-    } else if (typeLower.includes("float")) {
-        bytesPerElement = 4;
-    } else if (typeLower.includes("unsigned char") || typeLower.includes("uchar") || typeLower.includes("uint8_t")) {
-        bytesPerElement = 1;
-    } else if (typeLower.includes("char") || typeLower.includes("int8_t")) {
-        bytesPerElement = 1;
-    } else if (typeLower.includes("unsigned short") || typeLower.includes("ushort") || typeLower.includes("uint16_t")) {
-        bytesPerElement = 2;
-    } else if (typeLower.includes("short") || typeLower.includes("int16_t")) {
-        bytesPerElement = 2;
-    } else if (typeLower.includes("unsigned long long") || typeLower.includes("uint64_t") || 
-               typeLower.includes("long long") || typeLower.includes("int64_t")) {
-        bytesPerElement = 8;
-    }
+    const { bytesPerElement } = getElementKindFromCppType(type);
 
     // Get data pointer
     let dataPtr: string | null = null;
@@ -448,7 +494,7 @@ async function getVectorMetadata(
             `&${variableName}[0]`,
             `reinterpret_cast<long long>(&${variableName}[0])`
         ];
-        dataPtr = await tryGetDataPointer(debugSession, variableName, lldbExpressions, frameId, context);
+        dataPtr = await tryGetDataPointer(debugSession, variableName, lldbExpressions, frameId, context, variableInfo?.type || type);
         
     } else if (isUsingMSVC(debugSession)) {
         const msvcExpressions = [
@@ -457,7 +503,7 @@ async function getVectorMetadata(
             `(long long)${variableName}.data()`,
             `reinterpret_cast<long long>(${variableName}.data())`
         ];
-        dataPtr = await tryGetDataPointer(debugSession, variableName, msvcExpressions, frameId, context);
+        dataPtr = await tryGetDataPointer(debugSession, variableName, msvcExpressions, frameId, context, variableInfo?.type || type);
         
     } else if (isUsingCppdbg(debugSession)) {
         const gdbExpressions = [
@@ -467,7 +513,7 @@ async function getVectorMetadata(
             `reinterpret_cast<long long>(${variableName}.data())`,
             `(long long)&${variableName}[0]`
         ];
-        dataPtr = await tryGetDataPointer(debugSession, variableName, gdbExpressions, frameId, context);
+        dataPtr = await tryGetDataPointer(debugSession, variableName, gdbExpressions, frameId, context, variableInfo?.type || type);
         
     } else {
         const ptrExprs = [
@@ -476,7 +522,7 @@ async function getVectorMetadata(
             `(void*)${variableName}.data()`,
             `(void*)&${variableName}[0]`
         ];
-        dataPtr = await tryGetDataPointer(debugSession, variableName, ptrExprs, frameId, context);
+        dataPtr = await tryGetDataPointer(debugSession, variableName, ptrExprs, frameId, context, variableInfo?.type || type);
     }
 
     console.log(`getVectorMetadata result: size=${size}, dataPtr=${dataPtr}, bytesPerElement=${bytesPerElement}`);
@@ -488,7 +534,7 @@ async function readMatDataInternal(
     variableName: string,
     matInfo: { rows: number, cols: number, channels: number, depth: number, dataPtr: string },
     progress?: vscode.Progress<{ message?: string; increment?: number }>
-): Promise<number[] | null> {
+): Promise<NumericArray | null> {
     const size = matInfo.rows * matInfo.cols;
     const bytesPerElement = getBytesPerElement(matInfo.depth);
     const totalBytes = size * bytesPerElement;
@@ -504,24 +550,7 @@ async function readMatDataInternal(
         progress.report({ message: "Processing data..." });
     }
     
-    const data: number[] = [];
-    const depth = matInfo.depth;
-    
-    for (let i = 0; i < size; i++) {
-        const offset = i * bytesPerElement;
-        let val: number = 0;
-        switch (depth) {
-            case 0: val = buffer.readUInt8(offset); break;
-            case 1: val = buffer.readInt8(offset); break;
-            case 2: val = buffer.readUInt16LE(offset); break;
-            case 3: val = buffer.readInt16LE(offset); break;
-            case 4: val = buffer.readInt32LE(offset); break;
-            case 5: val = buffer.readFloatLE(offset); break;
-            case 6: val = buffer.readDoubleLE(offset); break;
-        }
-        data.push(val);
-    }
-    return data;
+    return bufferToTypedArray(buffer, getElementKindFromDepth(matInfo.depth), size);
 }
 
 async function readVectorDataInternal(
@@ -531,7 +560,7 @@ async function readVectorDataInternal(
     expectedSize?: number,
     variableInfo?: any,
     progress?: vscode.Progress<{ message?: string; increment?: number }>
-): Promise<{ data: number[], dataPtr: string | null } | null> {
+): Promise<{ data: NumericArray, dataPtr: string | null } | null> {
     const frameId = variableInfo?.frameId || await getCurrentFrameId(debugSession);
     const context = getEvaluateContext(debugSession);
 
@@ -562,47 +591,8 @@ async function readVectorDataInternal(
     }
 
     // 2. Determine element size and read function
-    let bytesPerElement = 4;
-    let readMethod: (buffer: Buffer, offset: number) => number = (b, o) => b.readFloatLE(o);
-
     const typeLower = type.toLowerCase();
-    if (typeLower.includes("double")) {
-        bytesPerElement = 8;
-        readMethod = (b, o) => b.readDoubleLE(o);
-    } else if (typeLower.includes("float")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readFloatLE(o);
-    } else if (typeLower.includes("unsigned char") || typeLower.includes("uchar") || typeLower.includes("uint8_t")) {
-        bytesPerElement = 1;
-        readMethod = (b, o) => b.readUInt8(o);
-    } else if (typeLower.includes("char") || typeLower.includes("int8_t")) {
-        bytesPerElement = 1;
-        readMethod = (b, o) => b.readInt8(o);
-    } else if (typeLower.includes("unsigned short") || typeLower.includes("ushort") || typeLower.includes("uint16_t")) {
-        bytesPerElement = 2;
-        readMethod = (b, o) => b.readUInt16LE(o);
-    } else if (typeLower.includes("short") || typeLower.includes("int16_t")) {
-        bytesPerElement = 2;
-        readMethod = (b, o) => b.readInt16LE(o);
-    } else if (typeLower.includes("unsigned int") || typeLower.includes("uint32_t")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readUInt32LE(o);
-    } else if (typeLower.includes("int") || typeLower.includes("int32_t")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readInt32LE(o);
-    } else if (typeLower.includes("unsigned long long") || typeLower.includes("uint64_t")) {
-        bytesPerElement = 8;
-        readMethod = (b, o) => Number(b.readBigUInt64LE(o));
-    } else if (typeLower.includes("long long") || typeLower.includes("int64_t")) {
-        bytesPerElement = 8;
-        readMethod = (b, o) => Number(b.readBigInt64LE(o));
-    } else if (typeLower.includes("unsigned long")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readUInt32LE(o);
-    } else if (typeLower.includes("long")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readInt32LE(o);
-    }
+    const { kind, bytesPerElement } = getElementKindFromCppType(type);
 
     // 3. Get data pointer - with special handling for different debuggers
     let dataPtr: string | null = null;
@@ -621,7 +611,7 @@ async function readVectorDataInternal(
             `&${variableName}[0]`,
             `reinterpret_cast<long long>(&${variableName}[0])`
         ];
-        dataPtr = await tryGetDataPointer(debugSession, variableName, lldbExpressions, frameId, context);
+        dataPtr = await tryGetDataPointer(debugSession, variableName, lldbExpressions, frameId, context, variableInfo?.type || type);
         
     } else if (isUsingMSVC(debugSession)) {
         console.log("Using MSVC-specific approaches for 1D vector");
@@ -631,7 +621,7 @@ async function readVectorDataInternal(
             `(long long)${variableName}.data()`,
             `reinterpret_cast<long long>(${variableName}.data())`
         ];
-        dataPtr = await tryGetDataPointer(debugSession, variableName, msvcExpressions, frameId, context);
+        dataPtr = await tryGetDataPointer(debugSession, variableName, msvcExpressions, frameId, context, variableInfo?.type || type);
         
     } else if (isUsingCppdbg(debugSession)) {
         console.log("Using GDB-specific approaches for 1D vector");
@@ -642,7 +632,7 @@ async function readVectorDataInternal(
             `reinterpret_cast<long long>(${variableName}.data())`,
             `(long long)&${variableName}[0]`
         ];
-        dataPtr = await tryGetDataPointer(debugSession, variableName, gdbExpressions, frameId, context);
+        dataPtr = await tryGetDataPointer(debugSession, variableName, gdbExpressions, frameId, context, variableInfo?.type || type);
         
     } else {
         // Fallback: try all approaches
@@ -653,7 +643,7 @@ async function readVectorDataInternal(
             `(void*)${variableName}.data()`,
             `(void*)&${variableName}[0]`
         ];
-        dataPtr = await tryGetDataPointer(debugSession, variableName, ptrExprs, frameId, context);
+        dataPtr = await tryGetDataPointer(debugSession, variableName, ptrExprs, frameId, context, variableInfo?.type || type);
     }
 
     if (!dataPtr) {
@@ -669,7 +659,11 @@ async function readVectorDataInternal(
     }
     
     console.log(`Reading ${size} elements (${totalBytes} bytes) from ${dataPtr}`);
-    const buffer = await readMemoryChunked(debugSession, dataPtr, totalBytes, progress);
+    // std::vector<float> published by cvdm::publish can be mapped directly
+    const published = bytesPerElement === 4 && typeLower.includes("float")
+        ? await readPublishedSegment(debugSession, dataPtr, totalBytes, SEGMENT_KIND_FLOAT)
+        : null;
+    const buffer = published ? published.buffer : await readMemoryChunked(debugSession, dataPtr, totalBytes, progress);
 
     if (!buffer) {
         vscode.window.showErrorMessage(`Failed to read memory for vector ${variableName}.`);
@@ -680,24 +674,22 @@ async function readVectorDataInternal(
         progress.report({ message: "Processing data..." });
     }
 
-    // 5. Convert to numbers
-    const data: number[] = [];
-    for (let i = 0; i < size; i++) {
-        data.push(readMethod(buffer, i * bytesPerElement));
-    }
+    // View the read bytes in place, no per-element conversion
+    const data = bufferToTypedArray(buffer, kind, size);
     console.log(`Successfully read ${data.length} elements`);
     return { data, dataPtr };
 }
 
-// Read data from std::set by iterating through elements via variablesReference
-// Set is a red-black tree, so we cannot use contiguous memory reading
+// Read data from std::set. Set is a red-black tree, so we cannot use contiguous
+// memory reading: the tree walker reads the nodes in bulk, and iterating through
+// elements via variablesReference is the fallback
 async function readSetDataInternal(
     debugSession: vscode.DebugSession,
     variableName: string,
     type: string,
     variableInfo?: any,
     progress?: vscode.Progress<{ message?: string; increment?: number }>
-): Promise<{ data: number[] } | null> {
+): Promise<{ data: NumericArray } | null> {
     const frameId = variableInfo?.frameId || await getCurrentFrameId(debugSession);
     const context = getEvaluateContext(debugSession);
 
@@ -717,7 +709,16 @@ async function readSetDataInternal(
 
     console.log(`Set size: ${size}`);
 
-    // 2. Determine parse function based on element type
+    // 2. Walk the tree nodes directly; this scales with bytes read, not DAP calls
+    if (progress) {
+        progress.report({ message: `Reading ${size} set nodes...` });
+    }
+    const walked = await readRbTreeValues(debugSession, variableName, type, size, frameId, context, variableInfo?.type);
+    if (walked) {
+        return { data: walked.data };
+    }
+
+    // Fall back to the debugger's child enumeration
     const typeLower = type.toLowerCase();
     let parseValue: (val: string) => number;
     
@@ -810,7 +811,7 @@ async function readSetDataInternal(
     data.sort((a, b) => a - b);
 
     console.log(`Successfully read ${data.length} elements from set`);
-    return { data };
+    return { data: Float64Array.from(data) };
 }
 
 // ============== std::array Support ==============
@@ -824,7 +825,7 @@ export async function read1DStdArrayData(
     elementType: string,
     size: number,
     variableInfo?: any
-): Promise<{ data: number[], dataPtr: string | null } | null> {
+): Promise<{ data: NumericArray, dataPtr: string | null } | null> {
     const frameId = variableInfo?.frameId || await getCurrentFrameId(debugSession);
 
     console.log(`read1DStdArrayData: variableName="${variableName}", elementType="${elementType}", size=${size}`);
@@ -835,47 +836,7 @@ export async function read1DStdArrayData(
     }
 
     // Determine element size and read function
-    let bytesPerElement = 4;
-    let readMethod: (buffer: Buffer, offset: number) => number = (b, o) => b.readFloatLE(o);
-
-    const typeLower = elementType.toLowerCase();
-    if (typeLower.includes("double")) {
-        bytesPerElement = 8;
-        readMethod = (b, o) => b.readDoubleLE(o);
-    } else if (typeLower.includes("float")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readFloatLE(o);
-    } else if (typeLower.includes("unsigned char") || typeLower.includes("uchar") || typeLower.includes("uint8_t")) {
-        bytesPerElement = 1;
-        readMethod = (b, o) => b.readUInt8(o);
-    } else if (typeLower.includes("char") || typeLower.includes("int8_t")) {
-        bytesPerElement = 1;
-        readMethod = (b, o) => b.readInt8(o);
-    } else if (typeLower.includes("unsigned short") || typeLower.includes("ushort") || typeLower.includes("uint16_t")) {
-        bytesPerElement = 2;
-        readMethod = (b, o) => b.readUInt16LE(o);
-    } else if (typeLower.includes("short") || typeLower.includes("int16_t")) {
-        bytesPerElement = 2;
-        readMethod = (b, o) => b.readInt16LE(o);
-    } else if (typeLower.includes("unsigned int") || typeLower.includes("uint32_t")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readUInt32LE(o);
-    } else if (typeLower.includes("int") || typeLower.includes("int32_t")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readInt32LE(o);
-    } else if (typeLower.includes("unsigned long long") || typeLower.includes("uint64_t")) {
-        bytesPerElement = 8;
-        readMethod = (b, o) => Number(b.readBigUInt64LE(o));
-    } else if (typeLower.includes("long long") || typeLower.includes("int64_t")) {
-        bytesPerElement = 8;
-        readMethod = (b, o) => Number(b.readBigInt64LE(o));
-    } else if (typeLower.includes("unsigned long")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readUInt32LE(o);
-    } else if (typeLower.includes("long")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readInt32LE(o);
-    }
+    const { kind, bytesPerElement } = getElementKindFromCppType(elementType);
 
     // Get data pointer using std::array specific function
     const dataPtr = await getStdArrayDataPointer(debugSession, variableName, frameId, variableInfo);
@@ -895,11 +856,8 @@ export async function read1DStdArrayData(
         return null;
     }
 
-    // Convert to numbers
-    const data: number[] = [];
-    for (let i = 0; i < size; i++) {
-        data.push(readMethod(buffer, i * bytesPerElement));
-    }
+    // View the read bytes in place, no per-element conversion
+    const data = bufferToTypedArray(buffer, kind, size);
     console.log(`Successfully read ${data.length} elements from std::array`);
     return { data, dataPtr };
 }
@@ -987,9 +945,11 @@ export async function drawStdArrayPlot(
             // CRITICAL: Don't await postMessage - it can block and cause debug freeze
             try {
                 // Fire and forget - don't await
-                panel.webview.postMessage({
+                (panel as any)._plotY = initialData;
+                FrameRecorder.capture(panel, { kind: 'plot', data: initialData });
+                tracePost(panel.webview, {
                     command: 'updateInitialData',
-                    data: initialData
+                    ...toPlotPayload(initialData)
                 });
             } catch (e) {
                 console.log("[drawStdArrayPlot] postMessage failed - panel likely disposed");
@@ -998,7 +958,7 @@ export async function drawStdArrayPlot(
             return;
         }
 
-        panel.webview.html = getWebviewContentForPlot(panelName);
+        panel.webview.html = getWebviewContentForPlot(panel.webview, panelName);
         
         // Send ready signal immediately so webview knows this is not a moved panel
         panel.webview.postMessage({ command: 'ready' });
@@ -1075,12 +1035,12 @@ export async function drawStdArrayPlot(
                 const variables = await vscode.commands.executeCommand<any[]>('cv-debugmate.getVariables');
                 const targetVar = variables?.find(v => v.name === message.name);
                 if (targetVar) {
-                    let newData: number[] | null = null;
+                    let newData: NumericArray | null = null;
                     const arrayInfo = parse1DStdArrayFromType(targetVar.type);
                     
                     if (targetVar.type.includes("cv::Mat")) {
                         const frameId = await getCurrentFrameId(debugSession);
-                        const matInfo = await getMatInfoFromVariables(debugSession, targetVar.variablesReference);
+                        const matInfo = await getMatInfoFromVariables(debugSession, targetVar.variablesReference, targetVar.type);
                         newData = await readMatDataInternal(debugSession, targetVar.evaluateName, matInfo);
                     } else if (arrayInfo.is1DArray) {
                         // Handle std::array types
@@ -1095,10 +1055,13 @@ export async function drawStdArrayPlot(
                     if (newData) {
                         if ((panel as any)._isDisposing) return;
                         try {
-                            panel.webview.postMessage({ 
+                            if (message.target === 'x') {
+                                (panel as any)._plotX = { name: message.name, data: newData };
+                            }
+                            tracePost(panel.webview, { 
                                 command: 'updateData', 
                                 target: message.target, 
-                                data: newData, 
+                                ...toPlotPayload(newData),
                                 name: message.name 
                             });
                         } catch (e) {
@@ -1112,27 +1075,13 @@ export async function drawStdArrayPlot(
                 if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
                     // CRITICAL: Fire-and-forget - don't await to avoid blocking
                     Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: variableName, evaluateName: variableName, skipToken: true }))
-                        .then(() => console.log(`[DEBUG-TRACE] Vector plot reload completed`))
-                        .catch((e: Error) => console.log(`[DEBUG-TRACE] Vector plot reload failed:`, e));
+                        .then(() => logDebug(`Vector plot reload completed`))
+                        .catch((e: Error) => logDebug(`Vector plot reload failed:`, e));
                 } else {
                     console.log('Skipping reload - debug session is no longer active or has changed');
                 }
             } else if (message.command === 'saveFile') {
-                const options: vscode.SaveDialogOptions = {
-                    defaultUri: vscode.Uri.file(message.defaultName),
-                    filters: message.type === 'png' ? { 'Images': ['png'] } : { 'Data': ['csv'] }
-                };
-
-                const fileUri = await vscode.window.showSaveDialog(options);
-                if (fileUri) {
-                    if (message.type === 'png') {
-                        const base64Data = message.data.replace(/^data:image\/png;base64,/, "");
-                        fs.writeFileSync(fileUri.fsPath, base64Data, 'base64');
-                    } else {
-                        fs.writeFileSync(fileUri.fsPath, message.data);
-                    }
-                    vscode.window.showInformationMessage(`File saved to ${fileUri.fsPath}`);
-                }
+                await savePlotFile(panel, message);
             }
         });
 
@@ -1145,9 +1094,12 @@ export async function drawStdArrayPlot(
         }
         
         try {
-            panel.webview.postMessage({
+            (panel as any)._plotY = initialData;
+            FrameRecorder.capture(panel, { kind: 'plot', data: initialData });
+            (panel as any)._plotX = undefined;
+            tracePost(panel.webview, {
                 command: 'completeData',
-                data: initialData
+                ...toPlotPayload(initialData)
             });
         } catch (e) {
             console.log("[drawStdArrayPlot] Final postMessage failed - panel likely disposed");
@@ -1155,6 +1107,7 @@ export async function drawStdArrayPlot(
         }
 
     } catch (error: any) {
+        if (isReadCancelled(error)) throw error;
         vscode.window.showErrorMessage(`Failed to draw std::array plot: ${error.message}`);
         console.error(error);
     }
@@ -1173,7 +1126,7 @@ export async function read1DCStyleArrayData(
     elementType: string,
     size: number,
     variableInfo?: any
-): Promise<{ data: number[], dataPtr: string | null } | null> {
+): Promise<{ data: NumericArray, dataPtr: string | null } | null> {
     const frameId = variableInfo?.frameId || await getCurrentFrameId(debugSession);
 
     console.log(`read1DCStyleArrayData: variableName="${variableName}", elementType="${elementType}", size=${size}`);
@@ -1184,47 +1137,7 @@ export async function read1DCStyleArrayData(
     }
 
     // Determine element size and read function (same as read1DStdArrayData)
-    let bytesPerElement = 4;
-    let readMethod: (buffer: Buffer, offset: number) => number = (b, o) => b.readFloatLE(o);
-
-    const typeLower = elementType.toLowerCase();
-    if (typeLower.includes("double")) {
-        bytesPerElement = 8;
-        readMethod = (b, o) => b.readDoubleLE(o);
-    } else if (typeLower.includes("float")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readFloatLE(o);
-    } else if (typeLower.includes("unsigned char") || typeLower.includes("uchar") || typeLower.includes("uint8_t")) {
-        bytesPerElement = 1;
-        readMethod = (b, o) => b.readUInt8(o);
-    } else if (typeLower.includes("char") || typeLower.includes("int8_t")) {
-        bytesPerElement = 1;
-        readMethod = (b, o) => b.readInt8(o);
-    } else if (typeLower.includes("unsigned short") || typeLower.includes("ushort") || typeLower.includes("uint16_t")) {
-        bytesPerElement = 2;
-        readMethod = (b, o) => b.readUInt16LE(o);
-    } else if (typeLower.includes("short") || typeLower.includes("int16_t")) {
-        bytesPerElement = 2;
-        readMethod = (b, o) => b.readInt16LE(o);
-    } else if (typeLower.includes("unsigned int") || typeLower.includes("uint32_t")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readUInt32LE(o);
-    } else if (typeLower.includes("int") || typeLower.includes("int32_t")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readInt32LE(o);
-    } else if (typeLower.includes("unsigned long long") || typeLower.includes("uint64_t")) {
-        bytesPerElement = 8;
-        readMethod = (b, o) => Number(b.readBigUInt64LE(o));
-    } else if (typeLower.includes("long long") || typeLower.includes("int64_t")) {
-        bytesPerElement = 8;
-        readMethod = (b, o) => Number(b.readBigInt64LE(o));
-    } else if (typeLower.includes("unsigned long")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readUInt32LE(o);
-    } else if (typeLower.includes("long")) {
-        bytesPerElement = 4;
-        readMethod = (b, o) => b.readInt32LE(o);
-    }
+    const { kind, bytesPerElement } = getElementKindFromCppType(elementType);
 
     // Get data pointer using C-style array specific function
     const dataPtr = await getCStyle1DArrayDataPointer(debugSession, variableName, frameId, variableInfo);
@@ -1244,11 +1157,8 @@ export async function read1DCStyleArrayData(
         return null;
     }
 
-    // Convert to numbers
-    const data: number[] = [];
-    for (let i = 0; i < size; i++) {
-        data.push(readMethod(buffer, i * bytesPerElement));
-    }
+    // View the read bytes in place, no per-element conversion
+    const data = bufferToTypedArray(buffer, kind, size);
     console.log(`Successfully read ${data.length} elements from C-style array`);
     return { data, dataPtr };
 }
@@ -1359,9 +1269,11 @@ export async function drawCStyleArrayPlot(
             // CRITICAL: Don't await postMessage - it can block and cause debug freeze
             try {
                 // Fire and forget - don't await
-                panel.webview.postMessage({
+                (panel as any)._plotY = initialData;
+                FrameRecorder.capture(panel, { kind: 'plot', data: initialData });
+                tracePost(panel.webview, {
                     command: 'updateInitialData',
-                    data: initialData
+                    ...toPlotPayload(initialData)
                 });
             } catch (e) {
                 console.log("[drawCStyleArrayPlot] postMessage failed - panel likely disposed");
@@ -1370,7 +1282,7 @@ export async function drawCStyleArrayPlot(
             return;
         }
 
-        panel.webview.html = getWebviewContentForPlot(panelName);
+        panel.webview.html = getWebviewContentForPlot(panel.webview, panelName);
         
         // Send ready signal immediately so webview knows this is not a moved panel
         panel.webview.postMessage({ command: 'ready' });
@@ -1449,13 +1361,13 @@ export async function drawCStyleArrayPlot(
                 const variables = await vscode.commands.executeCommand<any[]>('cv-debugmate.getVariables');
                 const targetVar = variables?.find(v => v.name === message.name);
                 if (targetVar) {
-                    let newData: number[] | null = null;
+                    let newData: NumericArray | null = null;
                     const stdArrayInfo = parse1DStdArrayFromType(targetVar.type);
                     const cStyleArrayInfo = parse1DCStyleArrayFromType(targetVar.type);
                     
                     if (targetVar.type.includes("cv::Mat")) {
                         const frameId = await getCurrentFrameId(debugSession);
-                        const matInfo = await getMatInfoFromVariables(debugSession, targetVar.variablesReference);
+                        const matInfo = await getMatInfoFromVariables(debugSession, targetVar.variablesReference, targetVar.type);
                         newData = await readMatDataInternal(debugSession, targetVar.evaluateName, matInfo);
                     } else if (stdArrayInfo.is1DArray) {
                         const result = await read1DStdArrayData(debugSession, targetVar.evaluateName, stdArrayInfo.elementType, stdArrayInfo.size, targetVar);
@@ -1469,10 +1381,13 @@ export async function drawCStyleArrayPlot(
                     }
                     
                     if (newData) {
-                        panel.webview.postMessage({ 
+                        if (message.target === 'x') {
+                            (panel as any)._plotX = { name: message.name, data: newData };
+                        }
+                        tracePost(panel.webview, { 
                             command: 'updateData', 
                             target: message.target, 
-                            data: newData, 
+                            ...toPlotPayload(newData),
                             name: message.name 
                         });
                     }
@@ -1483,27 +1398,13 @@ export async function drawCStyleArrayPlot(
                 if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
                     // CRITICAL: Fire-and-forget - don't await to avoid blocking
                     Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: variableName, evaluateName: variableName, skipToken: true }))
-                        .then(() => console.log(`[DEBUG-TRACE] Array plot reload completed`))
-                        .catch((e: Error) => console.log(`[DEBUG-TRACE] Array plot reload failed:`, e));
+                        .then(() => logDebug(`Array plot reload completed`))
+                        .catch((e: Error) => logDebug(`Array plot reload failed:`, e));
                 } else {
                     console.log('Skipping reload - debug session is no longer active or has changed');
                 }
             } else if (message.command === 'saveFile') {
-                const options: vscode.SaveDialogOptions = {
-                    defaultUri: vscode.Uri.file(message.defaultName),
-                    filters: message.type === 'png' ? { 'Images': ['png'] } : { 'Data': ['csv'] }
-                };
-
-                const fileUri = await vscode.window.showSaveDialog(options);
-                if (fileUri) {
-                    if (message.type === 'png') {
-                        const base64Data = message.data.replace(/^data:image\/png;base64,/, "");
-                        fs.writeFileSync(fileUri.fsPath, base64Data, 'base64');
-                    } else {
-                        fs.writeFileSync(fileUri.fsPath, message.data);
-                    }
-                    vscode.window.showInformationMessage(`File saved to ${fileUri.fsPath}`);
-                }
+                await savePlotFile(panel, message);
             }
         });
 
@@ -1516,9 +1417,12 @@ export async function drawCStyleArrayPlot(
         }
         
         try {
-            panel.webview.postMessage({
+            (panel as any)._plotY = initialData;
+            FrameRecorder.capture(panel, { kind: 'plot', data: initialData });
+            (panel as any)._plotX = undefined;
+            tracePost(panel.webview, {
                 command: 'completeData',
-                data: initialData
+                ...toPlotPayload(initialData)
             });
         } catch (e) {
             console.log("[drawCStyleArrayPlot] Final postMessage failed - panel likely disposed");
@@ -1526,6 +1430,7 @@ export async function drawCStyleArrayPlot(
         }
 
     } catch (error: any) {
+        if (isReadCancelled(error)) throw error;
         vscode.window.showErrorMessage(`Failed to draw C-style array plot: ${error.message}`);
         console.error(error);
     }
@@ -0,0 +1,1557 @@
+// Curve plot viewer script, loaded by the shell from getWebviewContentForPlot.
+// esbuild.js bundles it into dist/media; per-panel values come from the
+// viewer-config block.
+import { initRecordingTimeline } from '../utils/recordingTimeline.js';
+
+const viewerConfig = JSON.parse(document.getElementById('viewer-config').textContent);
+
+(function() {
+    try {
+        const vscode = acquireVsCodeApi();
+        const timeline = initRecordingTimeline(vscode);
+        const loadingOverlay = document.getElementById('loading');
+        const loadingText = document.getElementById('loading-text');
+
+        // Plot data stays in the typed array it arrived as (Float32Array, Int16Array, ...)
+        let dataY = new Float64Array(0);
+        let dataX = new Float64Array(0);
+        let currentVariableNameY = viewerConfig.variableName;
+        let currentVariableNameX = "Index";
+        let extensionReady = false;
+        let isShuttingDown = false;
+
+        // Detect if this is a moved panel (same logic as Mat viewer)
+        const waitForData = viewerConfig.waitForData;
+        if (waitForData) {
+            setTimeout(function() {
+                if (!extensionReady && !isShuttingDown) {
+                    loadingText.innerHTML = 'Reloading...';
+                    vscode.postMessage({ command: 'reload' });
+                }
+            }, 100);
+        }
+
+        const canvas = document.getElementById('plotCanvas');
+        const ctx = canvas.getContext('2d');
+        const container = document.getElementById('container');
+        const tooltip = document.getElementById('tooltip');
+        const zoomRectEl = document.getElementById('zoomRect');
+        const zoomRectInfo = document.getElementById('zoomRectInfo');
+
+        const btnHome = document.getElementById('btnHome');
+        const btnZoomRect = document.getElementById('btnZoomRect');
+        const btnPan = document.getElementById('btnPan');
+        const btnBack = document.getElementById('btnBack');
+        const btnForward = document.getElementById('btnForward');
+
+        const triggerX = document.getElementById('triggerX');
+        const menuX = document.getElementById('menuX');
+        const currentXText = document.getElementById('currentXText');
+
+        const btnExport = document.getElementById('btnExport');
+        const exportMenu = document.getElementById('exportMenu');
+        const exportPNG = document.getElementById('exportPNG');
+        const exportCSV = document.getElementById('exportCSV');
+        const exportNPY = document.getElementById('exportNPY');
+
+        let width = 0, height = 0;
+        let padding = { top: 40, right: 40, bottom: 55, left: 70 };
+
+        let interactionMode = 'pan';
+        let plotMode = 'plot'; // 'plot', 'scatter', 'hist'
+        let scaleX = 1, scaleY = 1, offsetX = 0, offsetY = 0;
+        let isDragging = false, dragStartX = 0, dragStartY = 0, lastMouseX = 0, lastMouseY = 0;
+
+        // Maximum zoom level to prevent excessive decimal places in tick labels
+        // This allows zooming in to view 0.1% of the original data range
+        const MAX_ZOOM = 1000;
+
+        const btnPlot = document.getElementById('btnPlot');
+        const btnScatter = document.getElementById('btnScatter');
+        const btnHist = document.getElementById('btnHist');
+
+        // Toggle toolbar visibility
+        const toolbar = document.getElementById('toolbar');
+        const toggleToolbarBtn = document.getElementById('toggleToolbar');
+        toggleToolbarBtn.addEventListener('click', function(e) {
+            e.stopPropagation();
+            const isCollapsed = toolbar.classList.toggle('collapsed');
+            toggleToolbarBtn.textContent = isCollapsed ? '▶' : '▼';
+        });
+
+        // Settings panel elements
+        const btnSettings = document.getElementById('btnSettings');
+        const settingsPanel = document.getElementById('settingsPanel');
+        const plotSettingsSection = document.getElementById('plotSettings');
+        const scatterSettingsSection = document.getElementById('scatterSettings');
+        const histSettingsSection = document.getElementById('histSettings');
+
+        // Settings values
+        let settings = {
+            lineWidth: 1.5,
+            pointSize: 3,
+            binCount: 50,
+            histYMode: 'freq', // 'freq' or 'density'
+            fontSize: 15,
+            customTitle: '',
+            // Core label concepts:
+            // - variableLabel: the data variable (Y in plot/scatter, X in hist)
+            // - indexLabel: the index/x-axis variable (X in plot/scatter)
+            // - histYLabel: the histogram Y-axis label (Frequency/Density)
+            variableLabel: '',
+            indexLabel: '',
+            histYLabel: '',
+            xMin: null,
+            xMax: null,
+            yMin: null,
+            yMax: null,
+            canvasWidth: null,
+            canvasHeight: null
+        };
+
+        // 视图历史记录
+        let viewHistory = [];
+        let historyIndex = -1;
+
+        function pushHistory() {
+            const state = { scaleX: scaleX, scaleY: scaleY, offsetX: offsetX, offsetY: offsetY };
+            // 如果当前状态与上一个记录一致，则不记录
+            if (historyIndex >= 0) {
+                const last = viewHistory[historyIndex];
+                if (last.scaleX === state.scaleX && last.scaleY === state.scaleY && 
+                    last.offsetX === state.offsetX && last.offsetY === state.offsetY) {
+                    return;
+                }
+            }
+
+            // 移除当前索引之后的历史记录
+            if (historyIndex < viewHistory.length - 1) {
+                viewHistory = viewHistory.slice(0, historyIndex + 1);
+            }
+
+            viewHistory.push(state);
+            historyIndex++;
+
+            // 限制历史记录数量
+            if (viewHistory.length > 50) {
+                viewHistory.shift();
+                historyIndex--;
+            }
+            updateHistoryButtons();
+        }
+
+        function updateHistoryButtons() {
+            btnBack.disabled = historyIndex <= 0;
+            btnForward.disabled = historyIndex >= viewHistory.length - 1;
+        }
+
+        function applyHistoryState(index) {
+            if (index >= 0 && index < viewHistory.length) {
+                const state = viewHistory[index];
+                scaleX = state.scaleX; scaleY = state.scaleY;
+                offsetX = state.offsetX; offsetY = state.offsetY;
+                historyIndex = index;
+                // Invalidate tick cache when history state changes
+                tickCache.x.result = null;
+                tickCache.y.result = null;
+                draw();
+                updateHistoryButtons();
+            }
+        }
+
+        btnBack.onclick = function() { applyHistoryState(historyIndex - 1); };
+        btnForward.onclick = function() { applyHistoryState(historyIndex + 1); };
+
+        function updateSize() {
+            const rect = container.getBoundingClientRect();
+            const dpr = window.devicePixelRatio || 1;
+
+            // Use custom size if set, otherwise use container size
+            width = (settings.canvasWidth && settings.canvasWidth > 0) ? settings.canvasWidth : rect.width;
+            height = (settings.canvasHeight && settings.canvasHeight > 0) ? settings.canvasHeight : rect.height;
+
+            if (width <= 0 || height <= 0) return false;
+
+            // If custom size is set, update container style
+            if (settings.canvasWidth && settings.canvasWidth > 0) {
+                container.style.width = settings.canvasWidth + 'px';
+            } else {
+                container.style.width = '';
+            }
+            if (settings.canvasHeight && settings.canvasHeight > 0) {
+                container.style.height = settings.canvasHeight + 'px';
+                container.style.flexGrow = '0';
+            } else {
+                container.style.height = '';
+                container.style.flexGrow = '1';
+            }
+
+            // Set canvas buffer size (for HiDPI rendering)
+            canvas.width = Math.floor(width * dpr);
+            canvas.height = Math.floor(height * dpr);
+
+            // Set explicit CSS dimensions to prevent stretching
+            canvas.style.width = width + 'px';
+            canvas.style.height = height + 'px';
+
+            ctx.setTransform(dpr, 0, 0, dpr, 0, 0);
+            return true;
+        }
+
+        let minY = 0, maxY = 0, rangeY = 1, minX = 0, maxX = 0, rangeX = 1;
+
+        // Cache for tick generation to improve performance
+        // Stores the last computed ticks for each axis to avoid recalculation
+        let tickCache = {
+            x: { min: null, max: null, targetCount: null, pixelLength: null, result: null },
+            y: { min: null, max: null, targetCount: null, pixelLength: null, result: null }
+        };
+
+        /**
+         * Convert a rough number to a "nice" number for axis ticks.
+         * Based on Wilkinson's algorithm for nice numbers.
+         * Nice numbers are 1, 2, 5, or 10 times a power of 10.
+         * 
+         * @param {number} value - The rough number to convert
+         * @param {boolean} round - If true, round to nearest nice number; if false, use ceiling
+         * @returns {number} A nice number close to the input value
+         */
+        function niceNumber(value, round) {
+            // Handle edge cases
+            if (value === 0) return 0;
+            if (!isFinite(value)) return value;
+
+            // Calculate the exponent (power of 10)
+            const exponent = Math.floor(Math.log10(Math.abs(value)));
+            const fraction = Math.abs(value) / Math.pow(10, exponent);
+            let niceFraction;
+
+            if (round) {
+                // Round to nearest nice number
+                if (fraction < 1.5) niceFraction = 1;
+                else if (fraction < 3) niceFraction = 2;
+                else if (fraction < 7) niceFraction = 5;
+                else niceFraction = 10;
+            } else {
+                // Use ceiling (for range calculation)
+                if (fraction <= 1) niceFraction = 1;
+                else if (fraction <= 2) niceFraction = 2;
+                else if (fraction <= 5) niceFraction = 5;
+                else niceFraction = 10;
+            }
+
+            // Preserve the sign of the original value
+            const result = niceFraction * Math.pow(10, exponent);
+            return value < 0 ? -result : result;
+        }
+
+        /**
+         * Generate adaptive tick marks for an axis.
+         * Based on Wilkinson's algorithm for nice numbers.
+         * Uses caching to avoid recalculation when parameters haven't changed.
+         * 
+         * @param {number} min - Minimum value of the visible range
+         * @param {number} max - Maximum value of the visible range
+         * @param {number} targetCount - Target number of ticks (default 6)
+         * @param {number} pixelLength - Length of the axis in pixels (for overlap prevention)
+         * @param {string} axis - Axis identifier ('x' or 'y') for caching
+         * @returns {Object} Object containing values (tick positions), labels (formatted strings), and step (tick interval)
+         */
+        function generateTicks(min, max, targetCount, pixelLength, axis) {
+            // Default parameters
+            targetCount = targetCount || 6;
+            pixelLength = pixelLength || 400;
+            axis = axis || 'x'; // Default to 'x' if not specified
+            const minSpacing = 40; // Minimum pixel spacing between ticks to prevent overlap
+
+            // Check cache - only recalculate if parameters have changed
+            const cache = tickCache[axis];
+            if (cache && cache.result !== null &&
+                cache.min === min && 
+                cache.max === max && 
+                cache.targetCount === targetCount && 
+                cache.pixelLength === pixelLength) {
+                // Return cached result
+                return cache.result;
+            }
+
+            // === INPUT VALIDATION AND ERROR HANDLING ===
+
+            // Handle NaN values - replace with default range
+            if (isNaN(min) || isNaN(max)) {
+                const result = { values: [0, 1], labels: ['0', '1'], step: 1 };
+                // Update cache
+                cache.min = min;
+                cache.max = max;
+                cache.targetCount = targetCount;
+                cache.pixelLength = pixelLength;
+                cache.result = result;
+                return result;
+            }
+
+            // Handle Infinity values - replace with large finite values
+            if (!isFinite(min)) {
+                min = min === Infinity ? 1e10 : -1e10;
+            }
+            if (!isFinite(max)) {
+                max = max === Infinity ? 1e10 : -1e10;
+            }
+
+            // Handle zero range (min === max)
+            if (min === max) {
+                const val = min;
+                // Create artificial range based on magnitude
+                if (val === 0) {
+                    // For zero, use [-1, 1]
+                    min = -1;
+                    max = 1;
+                } else {
+                    // For non-zero, use ±10% of the value
+                    const offset = Math.abs(val) * 0.1;
+                    min = val - offset;
+                    max = val + offset;
+                }
+            }
+
+            // Ensure min < max (swap if necessary)
+            if (min > max) {
+                const temp = min;
+                min = max;
+                max = temp;
+            }
+
+            // Handle extreme ranges
+            let range = max - min;
+
+            // For very small ranges (< 1e-10), expand to a reasonable range
+            if (range > 0 && range < 1e-10) {
+                const center = (min + max) / 2;
+                const halfRange = 5e-11; // Half of 1e-10
+                min = center - halfRange;
+                max = center + halfRange;
+                range = max - min; // Recalculate range after adjustment
+            }
+
+            // For very large ranges (> 1e10), we'll let the algorithm handle it
+            // but ensure we don't have numerical issues
+            if (range > 1e15) {
+                // Cap the range to prevent numerical instability
+                const center = (min + max) / 2;
+                const halfRange = 5e14; // Half of 1e15
+                min = center - halfRange;
+                max = center + halfRange;
+                range = max - min; // Recalculate range after adjustment
+            }
+
+            // Calculate rough step
+            const roughStep = range / (targetCount - 1);
+
+            // Convert to nice step
+            const niceStep = niceNumber(roughStep, true);
+
+            // Calculate tick start (round down to nearest nice step)
+            const tickMin = Math.floor(min / niceStep) * niceStep;
+
+            // Generate tick values
+            const values = [];
+            let currentTick = tickMin;
+
+            // Generate ticks until we exceed max
+            // Add a small epsilon to handle floating point precision
+            const epsilon = niceStep * 1e-10;
+            while (currentTick <= max + epsilon) {
+                values.push(currentTick);
+                currentTick += niceStep;
+
+                // Safety check to prevent infinite loops
+                if (values.length > 100) break;
+            }
+
+            // Ensure we have at least 2 ticks
+            if (values.length < 2) {
+                values.push(tickMin);
+                values.push(tickMin + niceStep);
+            }
+
+            // Check for minimum spacing to prevent label overlap
+            // Calculate pixel spacing between ticks
+            if (values.length > 2) {
+                const pixelSpacing = pixelLength / (values.length - 1);
+
+                // If spacing is too small, reduce tick count by taking every nth tick
+                if (pixelSpacing < minSpacing) {
+                    // Calculate how many ticks we should skip to meet minimum spacing
+                    const skipFactor = Math.ceil(minSpacing / pixelSpacing);
+                    const reducedValues = [];
+
+                    // Always include first tick
+                    reducedValues.push(values[0]);
+
+                    // Add intermediate ticks with proper spacing
+                    for (let i = skipFactor; i < values.length - 1; i += skipFactor) {
+                        reducedValues.push(values[i]);
+                    }
+
+                    // Always include last tick (if not already included)
+                    if (reducedValues[reducedValues.length - 1] !== values[values.length - 1]) {
+                        reducedValues.push(values[values.length - 1]);
+                    }
+
+                    // Ensure we have at least 2 ticks
+                    if (reducedValues.length < 2) {
+                        reducedValues.length = 0;
+                        reducedValues.push(values[0]);
+                        reducedValues.push(values[values.length - 1]);
+                    }
+
+                    // Update values array
+                    values.length = 0;
+                    for (let i = 0; i < reducedValues.length; i++) {
+                        values.push(reducedValues[i]);
+                    }
+                }
+            }
+
+            // Format labels (recalculate step based on potentially reduced tick count)
+            const finalStep = values.length > 1 ? values[1] - values[0] : niceStep;
+            const labels = values.map(function(val) {
+                return formatTickLabel(val, finalStep);
+            });
+
+            const result = {
+                values: values,
+                labels: labels,
+                step: finalStep
+            };
+
+            // Update cache with new result
+            cache.min = min;
+            cache.max = max;
+            cache.targetCount = targetCount;
+            cache.pixelLength = pixelLength;
+            cache.result = result;
+
+            return result;
+        }
+
+        /**
+         * Format a tick label based on the step size.
+         * Uses appropriate decimal places or scientific notation.
+         * 
+         * @param {number} value - The tick value to format
+         * @param {number} step - The step size between ticks
+         * @returns {string} Formatted label string
+         */
+        function formatTickLabel(value, step) {
+            // Handle very large or very small numbers with scientific notation
+            if (Math.abs(value) >= 1e6 || (Math.abs(value) < 1e-3 && value !== 0)) {
+                return value.toExponential(2);
+            }
+
+            // Determine decimal places based on step magnitude
+            const stepMagnitude = Math.floor(Math.log10(Math.abs(step)));
+            let decimalPlaces = Math.max(0, -stepMagnitude + 1);
+
+            // Limit maximum decimal places to 6 to prevent excessive precision
+            // If we need more than 6 decimals, use scientific notation instead
+            if (decimalPlaces > 6) {
+                return value.toExponential(2);
+            }
+
+            return value.toFixed(decimalPlaces);
+        }
+
+        const PLOT_DTYPES = {
+            Int8Array: Int8Array, Uint8Array: Uint8Array,
+            Int16Array: Int16Array, Uint16Array: Uint16Array,
+            Int32Array: Int32Array, Uint32Array: Uint32Array,
+            Float32Array: Float32Array, Float64Array: Float64Array
+        };
+
+        // View the bytes of a data message as the provider's element type
+        function decodePlotData(message) {
+            const Ctor = PLOT_DTYPES[message.dtype];
+            const bytes = message.data;
+            if (!Ctor || !(bytes instanceof Uint8Array)) {
+                return Float64Array.from(bytes || []);
+            }
+            const count = Math.floor(bytes.byteLength / Ctor.BYTES_PER_ELEMENT);
+            if (bytes.byteOffset % Ctor.BYTES_PER_ELEMENT === 0) {
+                return new Ctor(bytes.buffer, bytes.byteOffset, count);
+            }
+            return new Ctor(bytes.slice().buffer, 0, count);
+        }
+
+        function indexArray(length) {
+            const out = new Uint32Array(length);
+            for (let i = 0; i < length; i++) out[i] = i;
+            return out;
+        }
+
+        function getBounds(arr) {
+            if (!arr || arr.length === 0) return { min: 0, max: 1 };
+            let min = arr[0], max = arr[0];
+            for (let i = 1; i < arr.length; i++) {
+                if (arr[i] < min) min = arr[i];
+                if (arr[i] > max) max = arr[i];
+            }
+            return { min: min, max: max };
+        }
+
+        // ===== Level of detail =====
+        // Level k of the pyramid holds the min and max of dataY over buckets of
+        // 2^k consecutive samples (level 0 is dataY itself). Line and scatter
+        // modes draw the level where one bucket covers about one screen column,
+        // so a redraw costs O(canvas width) and every spike keeps its extreme.
+        // The first and last sample of a bucket are read from dataY directly.
+        let lodPyramid = null;
+        let histCache = null;
+
+        function buildLodPyramid(y) {
+            const levels = [];
+            let prevMin = y, prevMax = y;
+            let count = y.length;
+            while (count > 1) {
+                const next = Math.ceil(count / 2);
+                const mins = new Float64Array(next);
+                const maxs = new Float64Array(next);
+                for (let i = 0; i < next; i++) {
+                    const a = 2 * i, b = a + 1 < count ? a + 1 : a;
+                    let lo = prevMin[a], hi = prevMax[a];
+                    // NaN never wins so a gap does not hide its neighbours
+                    if (prevMin[b] < lo || lo !== lo) lo = prevMin[b];
+                    if (prevMax[b] > hi || hi !== hi) hi = prevMax[b];
+                    mins[i] = lo;
+                    maxs[i] = hi;
+                }
+                levels.push({ min: mins, max: maxs });
+                prevMin = mins;
+                prevMax = maxs;
+                count = next;
+            }
+            return levels;
+        }
+
+        function isNonDecreasing(arr) {
+            for (let i = 1; i < arr.length; i++) {
+                if (arr[i] < arr[i - 1]) return false;
+            }
+            return true;
+        }
+
+        // Built once per data arrival, on the first draw that needs it
+        function getLodPyramid() {
+            if (!lodPyramid || lodPyramid.y !== dataY || lodPyramid.x !== dataX) {
+                // Buckets only map to screen columns when X follows the index order
+                const monotonic = dataX.length === dataY.length && isNonDecreasing(dataX);
+                lodPyramid = {
+                    y: dataY,
+                    x: dataX,
+                    monotonic: monotonic,
+                    levels: monotonic ? buildLodPyramid(dataY) : []
+                };
+            }
+            return lodPyramid;
+        }
+
+        // First index whose X is >= value (dataX is non-decreasing)
+        function lowerBoundX(value) {
+            let lo = 0, hi = dataX.length;
+            while (lo < hi) {
+                const mid = (lo + hi) >> 1;
+                if (dataX[mid] < value) lo = mid + 1; else hi = mid;
+            }
+            return lo;
+        }
+
+        // Visible index range and pyramid level for the current view, or null
+        // when X is not monotonic and every sample has to be drawn
+        function getVisibleLod(innerWidth) {
+            const lod = getLodPyramid();
+            if (!lod.monotonic || dataY.length === 0) return null;
+            const n = dataY.length;
+            // One sample beyond each edge so lines run off the plot area
+            const i0 = Math.max(0, lowerBoundX(fromScreenX(padding.left)) - 1);
+            const i1 = Math.min(n, lowerBoundX(fromScreenX(width - padding.right)) + 1);
+            const visible = Math.max(1, i1 - i0);
+            let level = Math.floor(Math.log2(visible / Math.max(1, innerWidth)));
+            level = Math.max(0, Math.min(level, lod.levels.length));
+            return { i0: i0, i1: i1, level: level, levels: lod.levels };
+        }
+
+        // Calls visit(index, y) for the samples to draw, in index order
+        function forEachLodPoint(innerWidth, visit) {
+            const view = getVisibleLod(innerWidth);
+            if (!view) {
+                for (let i = 0; i < dataY.length; i++) visit(i, dataY[i]);
+                return;
+            }
+            if (view.level === 0) {
+                for (let i = view.i0; i < view.i1; i++) visit(i, dataY[i]);
+                return;
+            }
+            const n = dataY.length;
+            const bucket = 1 << view.level;
+            const lvl = view.levels[view.level - 1];
+            const b0 = Math.floor(view.i0 / bucket);
+            const b1 = Math.min(lvl.min.length, Math.ceil(view.i1 / bucket));
+            for (let b = b0; b < b1; b++) {
+                const start = b * bucket;
+                const end = Math.min(n, start + bucket) - 1;
+                const mid = (start + end) >> 1;
+                visit(start, dataY[start]);
+                visit(mid, lvl.min[b]);
+                visit(mid, lvl.max[b]);
+                visit(end, dataY[end]);
+            }
+        }
+
+        // Histogram bins for the current bin count, recomputed only when the
+        // data or the bin count change
+        function getHistogram(numBins) {
+            if (histCache && histCache.y === dataY && histCache.numBins === numBins) {
+                return histCache;
+            }
+            const bounds = getBounds(dataY);
+            const range = (bounds.max - bounds.min) || 1;
+            const binWidth = range / numBins;
+            const bins = new Array(numBins).fill(0);
+            for (let i = 0; i < dataY.length; i++) {
+                let binIdx = Math.floor((dataY[i] - bounds.min) / binWidth);
+                if (binIdx >= numBins) binIdx = numBins - 1;
+                if (binIdx < 0) binIdx = 0;
+                bins[binIdx]++;
+            }
+            histCache = { y: dataY, numBins: numBins, min: bounds.min, max: bounds.max, range: range, binWidth: binWidth, bins: bins };
+            return histCache;
+        }
+
+        function updateDataBounds() {
+            const bY = getBounds(dataY);
+            const bX = getBounds(dataX);
+
+            // Add 5% padding for auto limits so edge points are fully visible
+            const MARGIN_RATIO = 0.05;
+            const yPadding = (bY.max - bY.min) * MARGIN_RATIO || 0.1;
+            const xPadding = (bX.max - bX.min) * MARGIN_RATIO || 0.1;
+
+            // Apply custom limits if set, otherwise use auto with padding
+            minY = (settings.yMin !== null && !isNaN(settings.yMin)) ? settings.yMin : (bY.min - yPadding);
+            maxY = (settings.yMax !== null && !isNaN(settings.yMax)) ? settings.yMax : (bY.max + yPadding);
+            rangeY = (maxY - minY) || 1;
+
+            minX = (settings.xMin !== null && !isNaN(settings.xMin)) ? settings.xMin : (bX.min - xPadding);
+            maxX = (settings.xMax !== null && !isNaN(settings.xMax)) ? settings.xMax : (bX.max + xPadding);
+            rangeX = (maxX - minX) || 1;
+
+            // Invalidate tick cache when data bounds change
+            tickCache.x.result = null;
+            tickCache.y.result = null;
+        }
+
+        function toScreenX(val) {
+            const innerWidth = width - padding.left - padding.right;
+            if (rangeX === 0 || innerWidth <= 0) return padding.left;
+            return padding.left + (((val - minX) / rangeX) * innerWidth + offsetX) * scaleX;
+        }
+
+        function toScreenY(val) {
+            const innerHeight = height - padding.top - padding.bottom;
+            if (rangeY === 0 || innerHeight <= 0) return height - padding.bottom;
+            return height - padding.bottom - (((val - minY) / rangeY) * innerHeight + offsetY) * scaleY;
+        }
+
+        function fromScreenX(screenX) {
+            const innerWidth = width - padding.left - padding.right;
+            if (innerWidth <= 0 || scaleX === 0) return minX;
+            const result = (((screenX - padding.left) / scaleX - offsetX) / innerWidth) * rangeX + minX;
+            return result;
+        }
+
+        function fromScreenY(screenY) {
+            const innerHeight = height - padding.top - padding.bottom;
+            if (innerHeight <= 0 || scaleY === 0) return minY;
+            const result = (((height - padding.bottom - screenY) / scaleY - offsetY) / innerHeight) * rangeY + minY;
+            return result;
+        }
+
+        function draw() {
+            if (!updateSize()) return;
+            ctx.clearRect(0, 0, width, height);
+
+            const axisFontSize = settings.fontSize || 15;
+            const titleFontSize = axisFontSize + 4; // Title is slightly larger
+            const chartTitle = settings.customTitle || '';
+
+            // Initial padding estimates
+            const xTickLabelHeight = axisFontSize + 4;
+            const xAxisLabelHeight = axisFontSize + 6;
+            padding.bottom = Math.max(55, xTickLabelHeight + xAxisLabelHeight + 15);
+            padding.top = chartTitle ? Math.max(45, titleFontSize + 25) : 30;
+            padding.right = 40;
+
+            // Initial left padding estimate (will be refined after measuring Y-axis labels)
+            padding.left = 70;
+
+            // Pre-calculate dimensions for tick generation
+            let innerWidth = width - padding.left - padding.right;
+            let innerHeight = height - padding.top - padding.bottom;
+
+            // For histogram mode, calculate bins first (needed for Y-axis range)
+            let histDataMin = 0, histDataMax = 1, histDataRange = 1;
+            let histMaxY = 1;
+            if (plotMode === 'hist') {
+                const hist = getHistogram(settings.binCount || 50);
+                histDataMin = hist.min;
+                histDataMax = hist.max;
+                histDataRange = hist.range;
+
+                const binWidth = hist.binWidth;
+                const bins = hist.bins;
+                if (settings.histYMode === 'density') {
+                    const totalArea = dataY.length * binWidth;
+                    histMaxY = Math.max(...bins.map(b => b / totalArea));
+                } else {
+                    histMaxY = Math.max(...bins);
+                }
+            }
+
+            // Set font for measurement
+            ctx.font = axisFontSize + 'px Arial';
+
+            // Calculate visible data range for Y-axis tick generation
+            let visibleMinY = fromScreenY(height - padding.bottom);
+            let visibleMaxY = fromScreenY(padding.top);
+
+            // Generate Y-axis ticks (preliminary, for width measurement)
+            let yTicks;
+            if (plotMode === 'hist') {
+                yTicks = generateTicks(0, histMaxY, 6, innerHeight, 'y');
+            } else {
+                yTicks = generateTicks(visibleMinY, visibleMaxY, 6, innerHeight, 'y');
+            }
+
+            // Measure maximum Y-axis label width
+            let maxYLabelWidth = 0;
+            for (let i = 0; i < yTicks.labels.length; i++) {
+                const labelWidth = ctx.measureText(yTicks.labels[i]).width;
+                if (labelWidth > maxYLabelWidth) {
+                    maxYLabelWidth = labelWidth;
+                }
+            }
+
+            // Calculate required left padding
+            const yTickOffset = 8; // Space between tick and label
+            const yAxisLabelSpace = axisFontSize + 10; // Space for rotated Y axis label
+            const tickMarkLength = 4; // Length of tick mark
+            const requiredLeftPadding = maxYLabelWidth + yTickOffset + tickMarkLength + yAxisLabelSpace;
+
+            // Update left padding with minimum of 60px
+            padding.left = Math.max(60, Math.ceil(requiredLeftPadding));
+
+            // Recalculate inner dimensions with updated padding
+            innerWidth = width - padding.left - padding.right;
+            innerHeight = height - padding.top - padding.bottom;
+            if (innerWidth <= 0 || innerHeight <= 0) return;
+
+            // Draw axes
+            ctx.strokeStyle = '#555';
+            ctx.lineWidth = 1;
+            ctx.beginPath();
+            ctx.moveTo(padding.left, padding.top);
+            ctx.lineTo(padding.left, height - padding.bottom);
+            ctx.lineTo(width - padding.right, height - padding.bottom);
+            ctx.stroke();
+
+            // Tick label offsets
+            const xTickOffset = 8;
+            const xLabelHeight = axisFontSize + 4;
+
+            // Y-axis tick labels with custom font size
+            ctx.fillStyle = '#888';
+            ctx.font = axisFontSize + 'px Arial';
+            ctx.textAlign = 'right';
+            ctx.textBaseline = 'middle';
+
+            // Recalculate visible data range with updated padding
+            const visibleMinX = fromScreenX(padding.left);
+            const visibleMaxX = fromScreenX(width - padding.right);
+            visibleMinY = fromScreenY(height - padding.bottom);
+            visibleMaxY = fromScreenY(padding.top);
+
+            // Regenerate Y-axis ticks with updated dimensions
+            if (plotMode === 'hist') {
+                // In histogram: Y-axis shows frequency/density from 0 to max
+                yTicks = generateTicks(0, histMaxY, 6, innerHeight, 'y');
+            } else {
+                // In plot/scatter: Y-axis shows visible data range
+                yTicks = generateTicks(visibleMinY, visibleMaxY, 6, innerHeight, 'y');
+            }
+
+            // Draw Y-axis ticks
+            for (let i = 0; i < yTicks.values.length; i++) {
+                const val = yTicks.values[i];
+                const label = yTicks.labels[i];
+                let yPos;
+
+                if (plotMode === 'hist') {
+                    // In histogram mode, map tick value to screen position
+                    yPos = height - padding.bottom - (val / histMaxY) * innerHeight;
+                } else {
+                    // In plot/scatter mode, use standard coordinate transform
+                    yPos = toScreenY(val);
+                }
+
+                if (yPos >= padding.top && yPos <= height - padding.bottom) {
+                    ctx.fillText(label, padding.left - yTickOffset, yPos);
+                    ctx.beginPath(); 
+                    ctx.moveTo(padding.left - 4, yPos); 
+                    ctx.lineTo(padding.left, yPos); 
+                    ctx.stroke();
+                }
+            }
+
+            // X-axis tick labels
+            ctx.textAlign = 'center';
+            ctx.textBaseline = 'top';
+
+            // Generate X-axis ticks using adaptive algorithm
+            let xTicks;
+            if (plotMode === 'hist') {
+                // In histogram: X-axis shows data value range
+                xTicks = generateTicks(histDataMin, histDataMax, 6, innerWidth, 'x');
+            } else {
+                // In plot/scatter: X-axis shows visible index/custom X range
+                xTicks = generateTicks(visibleMinX, visibleMaxX, 6, innerWidth, 'x');
+            }
+
+            // Draw X-axis ticks
+            for (let i = 0; i < xTicks.values.length; i++) {
+                const val = xTicks.values[i];
+                const label = xTicks.labels[i];
+                let xPos;
+
+                if (plotMode === 'hist') {
+                    // In histogram mode, map tick value to screen position
+                    xPos = padding.left + ((val - histDataMin) / histDataRange) * innerWidth;
+                } else {
+                    // In plot/scatter mode, use standard coordinate transform
+                    xPos = toScreenX(val);
+                }
+
+                if (xPos >= padding.left && xPos <= width - padding.right) {
+                    ctx.fillText(label, xPos, height - padding.bottom + xTickOffset);
+                    ctx.beginPath();
+                    ctx.moveTo(xPos, height - padding.bottom);
+                    ctx.lineTo(xPos, height - padding.bottom + 4);
+                    ctx.stroke();
+                }
+            }
+
+            // Chart title - centered at top
+            if (chartTitle) {
+                ctx.fillStyle = '#4a9eff';
+                ctx.font = 'bold ' + titleFontSize + 'px Arial';
+                ctx.textAlign = 'center';
+                ctx.textBaseline = 'top';
+                ctx.fillText(chartTitle, padding.left + innerWidth / 2, 8);
+            }
+
+            // Axis names with custom font
+            ctx.fillStyle = '#4a9eff';
+            ctx.font = (axisFontSize + 2) + 'px Arial';
+            ctx.textAlign = 'center';
+            // X-axis label - position below tick labels with extra margin
+            const xAxisLabelY = height - padding.bottom + xTickOffset + xLabelHeight + 8;
+
+            // Determine axis labels based on mode using core label concepts:
+            // - variableLabel: data variable (plot/scatter Y, hist X)
+            // - indexLabel: index variable (plot/scatter X)
+            // - histYLabel: histogram Y (Frequency/Density)
+            let xLabelText, yLabelText;
+            if (plotMode === 'hist') {
+                // Hist: X = variableLabel, Y = histYLabel or default
+                xLabelText = settings.variableLabel || currentVariableNameY;
+                const defaultHistY = (settings.histYMode === 'density') ? 'Density' : 'Frequency';
+                yLabelText = settings.histYLabel || defaultHistY;
+            } else {
+                // Plot/Scatter: X = indexLabel, Y = variableLabel
+                xLabelText = settings.indexLabel || currentVariableNameX;
+                yLabelText = settings.variableLabel || currentVariableNameY;
+            }
+
+            ctx.fillText(xLabelText, padding.left + innerWidth / 2, xAxisLabelY);
+            // Y-axis label - rotated on left side
+            ctx.save();
+            ctx.translate(12, padding.top + innerHeight / 2);
+            ctx.rotate(-Math.PI / 2);
+            ctx.fillText(yLabelText, 0, 0);
+            ctx.restore();
+
+            // Clip to plot area
+            ctx.save();
+            ctx.beginPath();
+            ctx.rect(padding.left, padding.top, innerWidth, innerHeight);
+            ctx.clip();
+
+            if (plotMode === 'plot') {
+                // Line plot with custom line width
+                ctx.strokeStyle = '#4a9eff';
+                ctx.lineWidth = settings.lineWidth || 1.5;
+                ctx.beginPath();
+                let started = false;
+                forEachLodPoint(innerWidth, function(i, value) {
+                    const x = toScreenX(dataX[i]);
+                    const y = toScreenY(value);
+                    if (!started) { ctx.moveTo(x, y); started = true; } else ctx.lineTo(x, y);
+                });
+                ctx.stroke();
+            } else if (plotMode === 'scatter') {
+                // Scatter plot with custom point size
+                ctx.fillStyle = '#4a9eff';
+                const pSize = settings.pointSize || 3;
+                forEachLodPoint(innerWidth, function(i, value) {
+                    const x = toScreenX(dataX[i]);
+                    const y = toScreenY(value);
+                    ctx.beginPath();
+                    ctx.arc(x, y, pSize, 0, Math.PI * 2);
+                    ctx.fill();
+                });
+            } else if (plotMode === 'hist') {
+                // Histogram with custom bin count
+                // Get data range from dataY (the original Y values become X axis in histogram)
+                const numBins = settings.binCount || 50;
+                const hist = getHistogram(numBins);
+                const binWidth = hist.binWidth;
+                const bins = hist.bins;
+
+                // Calculate Y values based on mode (frequency or density)
+                let yValues;
+                if (settings.histYMode === 'density') {
+                    // Density: normalize so that the integral equals 1
+                    const totalArea = dataY.length * binWidth;
+                    yValues = bins.map(b => b / totalArea);
+                } else {
+                    // Frequency: raw counts
+                    yValues = bins;
+                }
+                const maxY = Math.max(...yValues);
+
+                ctx.fillStyle = 'rgba(74, 158, 255, 0.7)';
+                ctx.strokeStyle = '#4a9eff';
+                ctx.lineWidth = 1;
+
+                const barWidthPx = innerWidth / numBins;
+                for (let i = 0; i < numBins; i++) {
+                    const barHeight = maxY > 0 ? (yValues[i] / maxY) * innerHeight : 0;
+                    const x = padding.left + i * barWidthPx;
+                    const y = height - padding.bottom - barHeight;
+                    ctx.fillRect(x, y, barWidthPx - 1, barHeight);
+                    ctx.strokeRect(x, y, barWidthPx - 1, barHeight);
+                }
+            }
+            ctx.restore();
+
+            // Update visible range display
+            const viewRangeEl = document.getElementById('viewRange');
+            if (viewRangeEl && plotMode !== 'hist') {
+                const visMinX = fromScreenX(padding.left);
+                const visMaxX = fromScreenX(width - padding.right);
+                const visMinY = fromScreenY(height - padding.bottom);
+                const visMaxY = fromScreenY(padding.top);
+                const formatNum = function(val) {
+                    if (Math.abs(val) >= 1e6 || (Math.abs(val) < 1e-3 && val !== 0)) {
+                        return val.toExponential(2);
+                    }
+                    return val.toFixed(3);
+                };
+                viewRangeEl.textContent = 'View: X[' + formatNum(visMinX) + ',' + formatNum(visMaxX) + '] Y[' + formatNum(visMinY) + ',' + formatNum(visMaxY) + ']';
+            }
+        }
+
+        function resetView() {
+            scaleX = scaleY = 1;
+            offsetX = offsetY = 0;
+            // Invalidate tick cache when view resets
+            tickCache.x.result = null;
+            tickCache.y.result = null;
+            draw();
+            pushHistory();
+            emitViewChange();
+        }
+
+        function emitViewChange() {
+            if (isShuttingDown) return;
+            vscode.postMessage({
+                command: 'viewChanged',
+                state: { scaleX: scaleX, scaleY: scaleY, offsetX: offsetX, offsetY: offsetY }
+            });
+        }
+
+        // The benchmark harness times the first frame of new data ('rendered');
+        // draw() is synchronous, so it goes out right after it. Decode and draw
+        // times go to the extension's performance trace.
+        function reportRendered(decodeMs, renderMs) {
+            vscode.postMessage({ command: 'rendered', complete: true, decodeMs, renderMs });
+        }
+
+        // Footprint for the extension's memory budget
+        function reportMemoryUsage() {
+            vscode.postMessage({ command: 'memoryUsage', bytes: dataY.byteLength + dataX.byteLength });
+        }
+
+        // The extension replaces a released panel's page with this snapshot of the plot
+        const THUMBNAIL_SIZE = 320;
+        function makeThumbnail() {
+            if (!canvas.width || !canvas.height) return null;
+            const t = Math.min(1, THUMBNAIL_SIZE / Math.max(canvas.width, canvas.height));
+            const thumb = document.createElement('canvas');
+            thumb.width = Math.max(1, Math.round(canvas.width * t));
+            thumb.height = Math.max(1, Math.round(canvas.height * t));
+            thumb.getContext('2d').drawImage(canvas, 0, 0, thumb.width, thumb.height);
+            return thumb.toDataURL('image/png');
+        }
+
+        // 下拉菜单切换逻辑
+        function toggleMenu(menu) {
+            const isVisible = menu.style.display === 'block';
+            document.querySelectorAll('.dropdown-menu').forEach(m => m.style.display = 'none');
+            if (!isVisible) menu.style.display = 'block';
+        }
+
+        triggerX.onclick = function(e) {
+            e.stopPropagation();
+            toggleMenu(menuX);
+        };
+
+        btnExport.onclick = function(e) {
+            e.stopPropagation();
+            toggleMenu(exportMenu);
+        };
+
+        window.addEventListener('click', function() {
+            document.querySelectorAll('.dropdown-menu').forEach(m => m.style.display = 'none');
+        });
+
+        function handleXSelect(value, name) {
+            if (value === 'index') {
+                dataX = indexArray(dataY.length);
+                currentVariableNameX = "Index";
+                currentXText.textContent = "Index";
+                updateDataBounds(); resetView();
+            } else {
+                vscode.postMessage({ command: 'requestData', name: value, target: 'x' });
+            }
+
+            menuX.querySelectorAll('.menu-item').forEach(item => {
+                item.classList.toggle('selected', item.getAttribute('data-value') === value);
+            });
+            menuX.style.display = 'none';
+        }
+
+        window.addEventListener('message', function(event) {
+            const message = event.data;
+            if (message.command === 'ready') {
+                // Extension is ready, this is not a moved panel
+                extensionReady = true;
+            } else if (message.command === 'completeData') {
+                // Received plot data via postMessage
+                extensionReady = true;
+                const decodeStart = performance.now();
+                dataY = decodePlotData(message);
+                dataX = indexArray(dataY.length);
+                const drawStart = performance.now();
+                document.getElementById('info').textContent = 'Size: ' + dataY.length;
+                loadingOverlay.classList.add('hidden');
+                updateDataBounds();
+                resetView();
+                reportRendered(drawStart - decodeStart, performance.now() - drawStart);
+                reportMemoryUsage();
+            } else if (message.command === 'updateOptions') {
+                let html = '<div class="menu-item' + (currentVariableNameX === 'Index' ? ' selected' : '') + '" data-value="index">Index</div>';
+                for (let i = 0; i < message.options.length; i++) {
+                    const optName = message.options[i];
+                    html += '<div class="menu-item' + (currentVariableNameX === optName ? ' selected' : '') + '" data-value="' + optName + '">' + optName + '</div>';
+                }
+                menuX.innerHTML = html;
+
+                menuX.querySelectorAll('.menu-item').forEach(item => {
+                    item.onclick = function() {
+                        handleXSelect(this.getAttribute('data-value'), this.textContent);
+                    };
+                });
+            } else if (message.command === 'updateData') {
+                if (message.target === 'x') {
+                    dataX = decodePlotData(message);
+                    currentVariableNameX = message.name;
+                    currentXText.textContent = message.name;
+                    updateDataBounds(); resetView();
+                    reportMemoryUsage();
+                }
+            } else if (message.command === 'updateInitialData') {
+                extensionReady = true;
+                const decodeStart = performance.now();
+                dataY = decodePlotData(message);
+                if (currentVariableNameX === "Index") {
+                    dataX = indexArray(dataY.length);
+                }
+                const drawStart = performance.now();
+                document.getElementById('info').textContent = 'Size: ' + dataY.length;
+                loadingOverlay.classList.add('hidden');
+                updateDataBounds();
+                draw();
+                reportRendered(drawStart - decodeStart, performance.now() - drawStart);
+                reportMemoryUsage();
+            } else if (message.command === 'releaseData') {
+                vscode.postMessage({ command: 'released', thumbnail: makeThumbnail() });
+            } else if (message.command === 'recordingState') {
+                timeline.update(message);
+            } else if (message.command === 'setView') {
+                // Restore saved view state (zoom/pan)
+                const state = message.state;
+                if (state.scaleX !== undefined) scaleX = state.scaleX;
+                if (state.scaleY !== undefined) scaleY = state.scaleY;
+                if (state.offsetX !== undefined) offsetX = state.offsetX;
+                if (state.offsetY !== undefined) offsetY = state.offsetY;
+                // Invalidate tick cache when view state changes
+                tickCache.x.result = null;
+                tickCache.y.result = null;
+                draw();
+            }
+        });
+
+        btnExport.onclick = function(e) {
+            e.stopPropagation();
+            exportMenu.style.display = exportMenu.style.display === 'none' ? 'block' : 'none';
+        };
+        window.addEventListener('click', function() { exportMenu.style.display = 'none'; });
+
+        exportPNG.onclick = function() {
+            const url = canvas.toDataURL('image/png');
+            vscode.postMessage({ command: 'saveFile', type: 'png', data: url, defaultName: currentVariableNameY + '_plot.png' });
+        };
+
+        // CSV and NPY are written by the extension from the data it read
+        function exportData(type, suffix) {
+            vscode.postMessage({
+                command: 'saveFile',
+                type: type,
+                xName: currentVariableNameX,
+                yName: currentVariableNameY,
+                defaultName: currentVariableNameY + suffix
+            });
+        }
+        exportCSV.onclick = function() { exportData('csv', '_data.csv'); };
+        exportNPY.onclick = function() { exportData('npy', '_data.npy'); };
+
+        container.addEventListener('mousedown', function(e) {
+            isDragging = true; dragStartX = e.clientX; dragStartY = e.clientY; lastMouseX = e.clientX; lastMouseY = e.clientY;
+            if (interactionMode === 'zoomRect') {
+                const r = container.getBoundingClientRect();
+                zoomRectEl.style.display = 'block'; zoomRectEl.style.left = (e.clientX - r.left) + 'px'; zoomRectEl.style.top = (e.clientY - r.top) + 'px';
+                zoomRectEl.style.width = '0px'; zoomRectEl.style.height = '0px';
+            }
+        });
+
+        window.addEventListener('mousemove', function(e) {
+            const r = container.getBoundingClientRect();
+            const mx = e.clientX - r.left, my = e.clientY - r.top;
+            if (isDragging) {
+                if (interactionMode === 'pan') {
+                    offsetX += (e.clientX - lastMouseX) / scaleX;
+                    offsetY -= (e.clientY - lastMouseY) / scaleY;
+                    lastMouseX = e.clientX; lastMouseY = e.clientY; draw();
+                } else if (interactionMode === 'zoomRect') {
+                    const startX = dragStartX - r.left, startY = dragStartY - r.top;
+                    const rectLeft = Math.min(startX, mx);
+                    const rectTop = Math.min(startY, my);
+                    const rectWidth = Math.abs(mx - startX);
+                    const rectHeight = Math.abs(my - startY);
+
+                    zoomRectEl.style.left = rectLeft + 'px';
+                    zoomRectEl.style.top = rectTop + 'px';
+                    zoomRectEl.style.width = rectWidth + 'px';
+                    zoomRectEl.style.height = rectHeight + 'px';
+
+                    // Calculate and display the data range being selected
+                    const x1 = fromScreenX(Math.min(startX, mx));
+                    const x2 = fromScreenX(Math.max(startX, mx));
+                    const y1 = fromScreenY(Math.max(startY, my));
+                    const y2 = fromScreenY(Math.min(startY, my));
+
+                    // Format the range info
+                    const formatNum = function(val) {
+                        if (Math.abs(val) >= 1e6 || (Math.abs(val) < 1e-3 && val !== 0)) {
+                            return val.toExponential(2);
+                        }
+                        return val.toFixed(3);
+                    };
+
+                    const rangeInfo = 'X: [' + formatNum(x1) + ', ' + formatNum(x2) + ']  Y: [' + formatNum(y1) + ', ' + formatNum(y2) + ']';
+                    zoomRectInfo.textContent = rangeInfo;
+
+                    // Position the info box intelligently
+                    // Try to place it above the rect, but if there's not enough space, place it inside at the top
+                    if (rectTop > 30) {
+                        // Enough space above - place it above the rect
+                        zoomRectInfo.style.top = '-26px';
+                        zoomRectInfo.style.bottom = 'auto';
+                    } else {
+                        // Not enough space above - place it inside at the top
+                        zoomRectInfo.style.top = '4px';
+                        zoomRectInfo.style.bottom = 'auto';
+                    }
+
+                    // Center horizontally, but keep it within bounds
+                    zoomRectInfo.style.left = '50%';
+                    zoomRectInfo.style.transform = 'translateX(-50%)';
+                }
+            } else {
+                if (mx >= padding.left && mx <= width - padding.right && my >= padding.top && my <= height - padding.bottom) {
+                    const xVal = fromScreenX(mx);
+                    let minDist = Infinity, idx = -1;
+                    for(let i=0; i<dataX.length; i++) {
+                        const d = Math.abs(dataX[i] - xVal);
+                        if(d < minDist) { minDist = d; idx = i; }
+                    }
+                    if (idx !== -1) {
+                        tooltip.style.display = 'block'; tooltip.style.left = (e.clientX + 15) + 'px'; tooltip.style.top = (e.clientY + 15) + 'px';
+                        tooltip.textContent = 'X (' + currentVariableNameX + '): ' + dataX[idx].toFixed(4) + '\nY (' + currentVariableNameY + '): ' + dataY[idx].toFixed(4);
+                    }
+                } else tooltip.style.display = 'none';
+            }
+        });
+
+        window.addEventListener('mouseup', function(e) {
+            if (isDragging) {
+                if (interactionMode === 'zoomRect') {
+                    const r = container.getBoundingClientRect();
+                    const x1 = fromScreenX(Math.min(dragStartX - r.left, e.clientX - r.left));
+                    const x2 = fromScreenX(Math.max(dragStartX - r.left, e.clientX - r.left));
+                    const y1 = fromScreenY(Math.max(dragStartY - r.top, e.clientY - r.top));
+                    const y2 = fromScreenY(Math.min(dragStartY - r.top, e.clientY - r.top));
+
+                    console.log('=== ZOOM OPERATION START ===');
+                    console.log('Selected range: X=[' + x1 + ', ' + x2 + '], Y=[' + y1 + ', ' + y2 + ']');
+                    console.log('Current state: minX=' + minX + ', maxX=' + maxX + ', rangeX=' + rangeX);
+                    console.log('Current state: minY=' + minY + ', maxY=' + maxY + ', rangeY=' + rangeY);
+                    console.log('Current scale: scaleX=' + scaleX + ', scaleY=' + scaleY);
+                    console.log('Current offset: offsetX=' + offsetX + ', offsetY=' + offsetY);
+                    console.log('Current padding: left=' + padding.left + ', right=' + padding.right + ', top=' + padding.top + ', bottom=' + padding.bottom);
+
+                    if (Math.abs(e.clientX - dragStartX) > 5) {
+                        // IMPORTANT: Use current padding values that were used in fromScreenX/Y
+                        const oldPaddingLeft = padding.left;
+                        const oldPaddingBottom = padding.bottom;
+                        const iW = width - padding.left - padding.right;
+                        const iH = height - padding.top - padding.bottom;
+                        console.log('Inner dimensions: iW=' + iW + ', iH=' + iH);
+
+                        // Calculate new scale based on the selected data range
+                        const selectedRangeX = x2 - x1;
+                        const selectedRangeY = y2 - y1;
+                        console.log('Selected range size: X=' + selectedRangeX + ', Y=' + selectedRangeY);
+
+                        // New scale = how much we need to zoom to make the selected range fill the view
+                        const newScaleX = rangeX / selectedRangeX;
+                        const newScaleY = rangeY / selectedRangeY;
+                        console.log('Calculated new scale: X=' + newScaleX + ', Y=' + newScaleY);
+
+                        // Limit maximum zoom to prevent excessive decimal places
+                        const limitedScaleX = Math.min(newScaleX, MAX_ZOOM);
+                        const limitedScaleY = Math.min(newScaleY, MAX_ZOOM);
+                        console.log('Limited scale: X=' + limitedScaleX + ', Y=' + limitedScaleY);
+                        console.log('Was zoom limited? X=' + (newScaleX > MAX_ZOOM) + ', Y=' + (newScaleY > MAX_ZOOM));
+
+                        // If zoom was limited, adjust the selected range to match the actual zoom
+                        let actualSelectedRangeX = rangeX / limitedScaleX;
+                        let actualSelectedRangeY = rangeY / limitedScaleY;
+                        console.log('Actual visible range size: X=' + actualSelectedRangeX + ', Y=' + actualSelectedRangeY);
+
+                        // Center the limited zoom on the originally selected area
+                        const centerX = (x1 + x2) / 2;
+                        const centerY = (y1 + y2) / 2;
+                        console.log('Selected center: X=' + centerX + ', Y=' + centerY);
+
+                        const adjustedX1 = centerX - actualSelectedRangeX / 2;
+                        const adjustedY1 = centerY - actualSelectedRangeY / 2;
+                        const adjustedX2 = centerX + actualSelectedRangeX / 2;
+                        const adjustedY2 = centerY + actualSelectedRangeY / 2;
+                        console.log('Adjusted range: X=[' + adjustedX1 + ', ' + adjustedX2 + '], Y=[' + adjustedY1 + ', ' + adjustedY2 + ']');
+
+                        // Update scale first
+                        scaleX = limitedScaleX;
+                        scaleY = limitedScaleY;
+
+                        // Calculate offset using current padding (before draw() changes it)
+                        offsetX = -((adjustedX1 - minX) / rangeX) * iW;
+                        offsetY = -((adjustedY1 - minY) / rangeY) * iH;
+                        console.log('Initial offset: offsetX=' + offsetX + ', offsetY=' + offsetY);
+
+                        // Invalidate tick cache when zoom changes
+                        tickCache.x.result = null;
+                        tickCache.y.result = null;
+                        draw();
+
+                        // After draw, padding may have changed! Adjust offset to compensate
+                        const newPaddingLeft = padding.left;
+                        const newPaddingBottom = padding.bottom;
+                        const paddingDeltaLeft = newPaddingLeft - oldPaddingLeft;
+                        const paddingDeltaBottom = newPaddingBottom - oldPaddingBottom;
+                        console.log('After draw, padding changed: left delta=' + paddingDeltaLeft + ', bottom delta=' + paddingDeltaBottom);
+
+                        if (paddingDeltaLeft !== 0 || paddingDeltaBottom !== 0) {
+                            // Recalculate offset with new padding to maintain the same visible range
+                            const newIW = width - padding.left - padding.right;
+                            const newIH = height - padding.top - padding.bottom;
+                            offsetX = -((adjustedX1 - minX) / rangeX) * newIW;
+                            offsetY = -((adjustedY1 - minY) / rangeY) * newIH;
+                            console.log('Adjusted offset for padding change: offsetX=' + offsetX + ', offsetY=' + offsetY);
+                            // Redraw with corrected offset
+                            draw();
+                        }
+
+                        // After draw, padding may have changed! Recalculate to verify
+                        console.log('After draw, padding: left=' + padding.left + ', right=' + padding.right);
+                        const finalIW = width - padding.left - padding.right;
+                        const finalIH = height - padding.top - padding.bottom;
+                        console.log('After draw, inner dimensions: iW=' + finalIW + ', iH=' + finalIH);
+
+                        // After draw, calculate and log the actual visible range
+                        const actualVisibleMinX = fromScreenX(padding.left);
+                        const actualVisibleMaxX = fromScreenX(width - padding.right);
+                        const actualVisibleMinY = fromScreenY(height - padding.bottom);
+                        const actualVisibleMaxY = fromScreenY(padding.top);
+                        console.log('AFTER ZOOM - Actual visible range:');
+                        console.log('  X=[' + actualVisibleMinX + ', ' + actualVisibleMaxX + ']');
+                        console.log('  Y=[' + actualVisibleMinY + ', ' + actualVisibleMaxY + ']');
+                        console.log('=== ZOOM OPERATION END ===');
+                    }
+                    zoomRectEl.style.display = 'none';
+                }
+                pushHistory();
+                emitViewChange();
+            }
+            isDragging = false;
+        });
+
+        // Wheel zoom disabled to prevent accidental zooming - use Zoom button instead
+
+        window.onresize = function() { draw(); };
+        btnHome.onclick = resetView;
+        document.getElementById('btnReload').onclick = function() {
+            vscode.postMessage({ command: 'reload' });
+        };
+        btnPan.onclick = function() { interactionMode = 'pan'; btnPan.classList.add('active'); btnZoomRect.classList.remove('active'); };
+        btnZoomRect.onclick = function() { interactionMode = 'zoomRect'; btnZoomRect.classList.add('active'); btnPan.classList.remove('active'); };
+
+        function setPlotMode(mode) {
+            plotMode = mode;
+            btnPlot.classList.toggle('active', mode === 'plot');
+            btnScatter.classList.toggle('active', mode === 'scatter');
+            btnHist.classList.toggle('active', mode === 'hist');
+            updateSettingsSections();
+            // Invalidate tick cache when plot mode changes
+            tickCache.x.result = null;
+            tickCache.y.result = null;
+            draw();
+        }
+        btnPlot.onclick = function() { setPlotMode('plot'); };
+        btnScatter.onclick = function() { setPlotMode('scatter'); };
+        btnHist.onclick = function() { setPlotMode('hist'); };
+
+        // Settings panel logic
+        function updateSettingsSections() {
+            plotSettingsSection.style.display = plotMode === 'plot' ? 'block' : 'none';
+            scatterSettingsSection.style.display = plotMode === 'scatter' ? 'block' : 'none';
+            histSettingsSection.style.display = plotMode === 'hist' ? 'block' : 'none';
+
+            // Update axis label inputs based on mode
+            // Core mapping:
+            // - variableLabel: data variable (plot/scatter Y, hist X)
+            // - indexLabel: index variable (plot/scatter X)
+            // - histYLabel: histogram Y (Frequency/Density)
+            const xLabelInput = document.getElementById('xLabel');
+            const yLabelInput = document.getElementById('yLabel');
+
+            if (plotMode === 'hist') {
+                // In hist mode: X = variableLabel, Y = histYLabel
+                xLabelInput.value = settings.variableLabel;
+                xLabelInput.placeholder = currentVariableNameY;
+                yLabelInput.value = settings.histYLabel;
+                yLabelInput.placeholder = (settings.histYMode === 'density') ? 'Density' : 'Frequency';
+            } else {
+                // In plot/scatter mode: X = indexLabel, Y = variableLabel
+                xLabelInput.value = settings.indexLabel;
+                xLabelInput.placeholder = currentVariableNameX;
+                yLabelInput.value = settings.variableLabel;
+                yLabelInput.placeholder = currentVariableNameY;
+            }
+        }
+
+        btnSettings.onclick = function(e) {
+            e.stopPropagation();
+            const isVisible = settingsPanel.style.display === 'block';
+            settingsPanel.style.display = isVisible ? 'none' : 'block';
+            if (!isVisible) {
+                updateSettingsSections();
+                // Populate current values
+                document.getElementById('lineWidth').value = settings.lineWidth;
+                document.getElementById('pointSize').value = settings.pointSize;
+                document.getElementById('binCount').value = settings.binCount;
+                document.getElementById('fontSize').value = settings.fontSize;
+                document.getElementById('customTitle').value = settings.customTitle || '';
+                document.getElementById('xMin').value = settings.xMin !== null ? settings.xMin : '';
+                document.getElementById('xMax').value = settings.xMax !== null ? settings.xMax : '';
+                document.getElementById('yMin').value = settings.yMin !== null ? settings.yMin : '';
+                document.getElementById('yMax').value = settings.yMax !== null ? settings.yMax : '';
+                document.getElementById('canvasWidth').value = settings.canvasWidth || '';
+                document.getElementById('canvasHeight').value = settings.canvasHeight || '';
+            }
+        };
+
+        settingsPanel.onclick = function(e) {
+            e.stopPropagation();
+        };
+
+        const resetSettingsBtn = document.getElementById('resetSettings');
+
+        // Default settings values
+        const defaultSettings = {
+            lineWidth: 1.5,
+            pointSize: 3,
+            binCount: 50,
+            histYMode: 'freq',
+            fontSize: 15,
+            customTitle: '',
+            variableLabel: '',
+            indexLabel: '',
+            histYLabel: '',
+            xMin: null,
+            xMax: null,
+            yMin: null,
+            yMax: null,
+            canvasWidth: null,
+            canvasHeight: null
+        };
+
+        // Real-time settings update function
+        function updateSettingsFromInputs() {
+            settings.lineWidth = parseFloat(document.getElementById('lineWidth').value) || 1.5;
+            settings.pointSize = parseFloat(document.getElementById('pointSize').value) || 3;
+            settings.binCount = parseInt(document.getElementById('binCount').value) || 50;
+            settings.histYMode = document.getElementById('histYMode').value || 'freq';
+            settings.fontSize = parseInt(document.getElementById('fontSize').value) || 15;
+            settings.customTitle = document.getElementById('customTitle').value || '';
+
+            // Map UI labels to core labels based on current mode
+            const xLabelValue = document.getElementById('xLabel').value || '';
+            const yLabelValue = document.getElementById('yLabel').value || '';
+            if (plotMode === 'hist') {
+                // In hist mode: X = variableLabel, Y = histYLabel
+                settings.variableLabel = xLabelValue;
+                settings.histYLabel = yLabelValue;
+                // Update placeholder when histYMode changes
+                document.getElementById('yLabel').placeholder = (settings.histYMode === 'density') ? 'Density' : 'Frequency';
+            } else {
+                // In plot/scatter mode: X = indexLabel, Y = variableLabel
+                settings.indexLabel = xLabelValue;
+                settings.variableLabel = yLabelValue;
+            }
+
+            const xMinVal = document.getElementById('xMin').value;
+            const xMaxVal = document.getElementById('xMax').value;
+            const yMinVal = document.getElementById('yMin').value;
+            const yMaxVal = document.getElementById('yMax').value;
+            settings.xMin = xMinVal !== '' ? parseFloat(xMinVal) : null;
+            settings.xMax = xMaxVal !== '' ? parseFloat(xMaxVal) : null;
+            settings.yMin = yMinVal !== '' ? parseFloat(yMinVal) : null;
+            settings.yMax = yMaxVal !== '' ? parseFloat(yMaxVal) : null;
+
+            const cw = document.getElementById('canvasWidth').value;
+            const ch = document.getElementById('canvasHeight').value;
+            settings.canvasWidth = cw !== '' ? parseInt(cw) : null;
+            settings.canvasHeight = ch !== '' ? parseInt(ch) : null;
+
+            updateDataBounds();
+            draw();
+        }
+
+        // Add real-time listeners to all setting inputs (including select elements)
+        const settingInputs = settingsPanel.querySelectorAll('input, select');
+        settingInputs.forEach(function(input) {
+            input.addEventListener('input', updateSettingsFromInputs);
+            input.addEventListener('change', updateSettingsFromInputs);
+        });
+
+        resetSettingsBtn.onclick = function() {
+            // Reset all settings to defaults
+            Object.assign(settings, defaultSettings);
+
+            // Update input fields
+            document.getElementById('lineWidth').value = defaultSettings.lineWidth;
+            document.getElementById('pointSize').value = defaultSettings.pointSize;
+            document.getElementById('binCount').value = defaultSettings.binCount;
+            document.getElementById('histYMode').value = defaultSettings.histYMode;
+            document.getElementById('fontSize').value = defaultSettings.fontSize;
+            document.getElementById('customTitle').value = '';
+            // Reset core labels
+            settings.variableLabel = '';
+            settings.indexLabel = '';
+            settings.histYLabel = '';
+            document.getElementById('xLabel').value = '';
+            document.getElementById('yLabel').value = '';
+            document.getElementById('xMin').value = '';
+            document.getElementById('xMax').value = '';
+            document.getElementById('yMin').value = '';
+            document.getElementById('yMax').value = '';
+            document.getElementById('canvasWidth').value = '';
+            document.getElementById('canvasHeight').value = '';
+
+            // Reset container size
+            container.style.width = '';
+            container.style.height = '';
+            container.style.flexGrow = '1';
+
+            updateDataBounds();
+            draw();
+        };
+
+        // Close settings panel when clicking outside
+        document.addEventListener('click', function(e) {
+            if (!settingsPanel.contains(e.target) && e.target !== btnSettings) {
+                settingsPanel.style.display = 'none';
+            }
+        });
+
+        // Initial draw with a small delay to ensure layout is ready
+        updateDataBounds();
+        setTimeout(function() {
+            draw();
+            pushHistory(); // 记录初始状态
+        }, 100);
+        vscode.postMessage({ command: 'requestOptions' });
+
+        // Mark shutting down to block further interactions/sync
+        window.addEventListener('beforeunload', function() {
+            isShuttingDown = true;
+        });
+        document.addEventListener('visibilitychange', function() {
+            if (document.visibilityState === 'hidden') {
+                isShuttingDown = true;
+            }
+        });
+
+    } catch (err) {
+        console.error('Plot script error:', err);
+    }
+})();
+
+function getNonce() {
+    let text = "";
+    const possible = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    for (let i = 0; i < 32; i++) {
+        text += possible.charAt(Math.floor(Math.random() * possible.length));
+    }
+    return text;
+}
@@ -11,10 +11,241 @@ import {
   getVectorSize,
   getStdArrayDataPointer
 } from "../utils/debugger";
-import { getWebviewContentForPointCloud, generatePLYContent, generatePCDContent } from "./pointCloudWebview";
+import { getWebviewContentForPointCloud } from "./pointCloudWebview";
 import { PanelManager } from "../utils/panelManager";
 import { SyncManager } from "../utils/syncManager";
 import { type PCLPointLayout } from "../utils/opencv";
+import { readPublishedSegment, SEGMENT_KIND_POINT3F } from "../utils/sharedMemory";
+import { writePointCloud, type PointCloudFileFormat, type PointCloudEncoding } from "../utils/exporters";
+import { FrameRecorder } from "../utils/frameRecorder";
+import { isReadCancelled } from "../utils/cancellation";
+import { logDebug, tracePost } from "../utils/logger";
+
+// ============== Packed Point Buffers ==============
+
+/**
+ * A point cloud as the webview and the exporters use it: x, y, z interleaved in one
+ * Float32Array, plus the per-point fields the source type has. Invalid (NaN) points
+ * of organised PCL clouds are already dropped, so all arrays hold `count` points.
+ */
+export interface PackedPointCloud {
+  count: number;
+  positions: Float32Array;
+  colors?: Uint8Array;       // r, g, b per point
+  intensity?: Float32Array;
+}
+
+// PCL layouts are float; cv::Point3d vectors use the same description with doubles
+type PointFieldLayout = PCLPointLayout & { isDouble: boolean };
+
+const EMPTY_CLOUD: PackedPointCloud = { count: 0, positions: new Float32Array(0) };
+
+const POINT3F_LAYOUT: PointFieldLayout = { bytesPerPoint: 12, isDouble: false, xOffset: 0, yOffset: 4, zOffset: 8 };
+const POINT3D_LAYOUT: PointFieldLayout = { bytesPerPoint: 24, isDouble: true, xOffset: 0, yOffset: 8, zOffset: 16 };
+
+/**
+ * Decode `size` points of `layout` from `buffer` in one pass. Tightly packed Point3f
+ * data is viewed in place; everything else is read through aligned typed array
+ * views of the buffer instead of one readFloatLE call per coordinate.
+ */
+function packPoints(buffer: Buffer, size: number, layout: PointFieldLayout, dropInvalid: boolean): PackedPointCloud {
+  const stride = layout.bytesPerPoint;
+  const count = Math.min(size, Math.floor(buffer.length / stride));
+  const elementBytes = layout.isDouble ? 8 : 4;
+
+  // Typed array views need the element alignment; copy once when the buffer lacks it
+  let bytes: Uint8Array = buffer;
+  if (buffer.byteOffset % elementBytes !== 0) {
+    bytes = new Uint8Array(buffer.subarray(0, count * stride));
+  }
+
+  const tightFloat = !layout.isDouble && stride === 12 && layout.xOffset === 0 && layout.yOffset === 4 && layout.zOffset === 8;
+  if (tightFloat && !dropInvalid) {
+    return { count, positions: new Float32Array(bytes.buffer, bytes.byteOffset, count * 3) };
+  }
+
+  const values = layout.isDouble
+    ? new Float64Array(bytes.buffer, bytes.byteOffset, Math.floor(count * stride / 8))
+    : new Float32Array(bytes.buffer, bytes.byteOffset, Math.floor(count * stride / 4));
+  const strideElems = stride / elementBytes;
+  const xi = layout.xOffset / elementBytes;
+  const yi = layout.yOffset / elementBytes;
+  const zi = layout.zOffset / elementBytes;
+
+  const positions = new Float32Array(count * 3);
+  const colors = layout.rgbOffset !== undefined ? new Uint8Array(count * 3) : undefined;
+  const intensity = layout.intensityOffset !== undefined ? new Float32Array(count) : undefined;
+  const floats = layout.isDouble ? new Float32Array(bytes.buffer, bytes.byteOffset, Math.floor(count * stride / 4)) : values;
+  const floatStride = stride / 4;
+  const intensityIndex = layout.intensityOffset !== undefined ? layout.intensityOffset / 4 : 0;
+
+  let n = 0;
+  for (let i = 0; i < count; i++) {
+    const base = i * strideElems;
+    const x = values[base + xi];
+    const y = values[base + yi];
+    const z = values[base + zi];
+    // pcl::PointCloud uses NaN for invalid points in organised clouds
+    if (dropInvalid && !(isFinite(x) && isFinite(y) && isFinite(z))) {
+      continue;
+    }
+    positions[n * 3] = x;
+    positions[n * 3 + 1] = y;
+    positions[n * 3 + 2] = z;
+    if (colors) {
+      // PCL packs rgb as b, g, r, a bytes
+      const c = i * stride + layout.rgbOffset!;
+      colors[n * 3] = bytes[c + 2];
+      colors[n * 3 + 1] = bytes[c + 1];
+      colors[n * 3 + 2] = bytes[c];
+    }
+    if (intensity) {
+      intensity[n] = floats[i * floatStride + intensityIndex];
+    }
+    n++;
+  }
+
+  if (n === count) {
+    return { count, positions, colors, intensity };
+  }
+  return {
+    count: n,
+    positions: positions.subarray(0, n * 3),
+    colors: colors ? colors.subarray(0, n * 3) : undefined,
+    intensity: intensity ? intensity.subarray(0, n) : undefined
+  };
+}
+
+/**
+ * Message fields for a packed cloud. The arrays go as byte views so the webview
+ * gets them without any per-point conversion.
+ */
+function toCloudPayload(cloud: PackedPointCloud): any {
+  const asBytes = (a: Float32Array | Uint8Array) => new Uint8Array(a.buffer, a.byteOffset, a.byteLength);
+  return {
+    count: cloud.count,
+    positions: asBytes(cloud.positions),
+    colors: cloud.colors ? asBytes(cloud.colors) : undefined,
+    intensity: cloud.intensity ? asBytes(cloud.intensity) : undefined
+  };
+}
+
+/**
+ * Ask where to save `cloud` and stream it there. `formatString` comes from the
+ * viewer's save menu, e.g. 'ply-binary' or 'pcd-ascii'.
+ */
+async function savePointCloudFile(cloud: PackedPointCloud, panelName: string, formatString: string) {
+  try {
+    const format: PointCloudFileFormat = formatString.startsWith('ply') ? 'ply' : 'pcd';
+    const encoding: PointCloudEncoding = formatString.includes('ascii') ? 'ascii' : 'binary';
+
+    const uri = await vscode.window.showSaveDialog({
+      defaultUri: vscode.Uri.file(`${panelName}.${format}`),
+      filters: format === 'ply'
+          ? { "PLY Files": ["ply"], "All Files": ["*"] }
+          : { "PCD Files": ["pcd"], "All Files": ["*"] }
+    });
+
+    if (uri) {
+      await writePointCloud(uri.fsPath, cloud, format, encoding);
+      const formatLabel = encoding === 'ascii' ? 'ASCII' : 'Binary';
+      vscode.window.showInformationMessage(`Point cloud saved to ${uri.fsPath} (${format.toUpperCase()} ${formatLabel})`);
+    }
+  } catch (error) {
+    vscode.window.showErrorMessage(`Failed to save point cloud: ${error}`);
+    console.error("Error saving point cloud:", error);
+  }
+}
+
+// Clouds at least this large are streamed to the webview while they are read
+const STREAM_MIN_BYTES = 32 * 1024 * 1024;
+const STREAM_CHUNK_POINTS = 1 << 20;
+
+function concatClouds(chunks: PackedPointCloud[]): PackedPointCloud {
+  if (chunks.length === 1) return chunks[0];
+  const count = chunks.reduce((n, c) => n + c.count, 0);
+  const positions = new Float32Array(count * 3);
+  const colors = chunks[0].colors ? new Uint8Array(count * 3) : undefined;
+  const intensity = chunks[0].intensity ? new Float32Array(count) : undefined;
+  let n = 0;
+  for (const chunk of chunks) {
+    positions.set(chunk.positions, n * 3);
+    if (colors && chunk.colors) colors.set(chunk.colors, n * 3);
+    if (intensity && chunk.intensity) intensity.set(chunk.intensity, n);
+    n += chunk.count;
+  }
+  return { count, positions, colors, intensity };
+}
+
+/**
+ * Give a new panel its HTML now, so point chunks can be posted while the rest of
+ * the cloud is still being read. Returns false if the panel is going away.
+ */
+function preparePanelForStreaming(panel: vscode.WebviewPanel): boolean {
+  if ((panel as any)._isDisposing) return false;
+  if (!panel.webview.html) {
+    panel.webview.html = getWebviewContentForPointCloud(panel.webview);
+    try { panel.webview.postMessage({ command: 'ready' }); } catch (e) { return false; }
+  }
+  return true;
+}
+
+/**
+ * Read `size` points of `layout` at `dataPtr` and pack them. Large clouds are read
+ * STREAM_CHUNK_POINTS at a time and each packed chunk is posted to `panel` as soon
+ * as it is read (streamBegin, pointChunk..., streamEnd), so the webview shows the
+ * cloud filling in; `streamed` tells the caller the data is already there.
+ */
+async function readPackedCloud(
+  debugSession: vscode.DebugSession,
+  panel: vscode.WebviewPanel | undefined,
+  dataPtr: string,
+  size: number,
+  layout: PointFieldLayout,
+  dropInvalid: boolean,
+  progress?: vscode.Progress<{ message?: string; increment?: number }>
+): Promise<{ cloud: PackedPointCloud; streamed: boolean }> {
+  const stride = layout.bytesPerPoint;
+  const totalBytes = size * stride;
+
+  if (!panel || totalBytes < STREAM_MIN_BYTES || !preparePanelForStreaming(panel)) {
+    const buffer = await readMemoryChunked(debugSession, dataPtr, totalBytes, progress);
+    if (!buffer) return { cloud: EMPTY_CLOUD, streamed: false };
+    if (progress) progress.report({ message: "Processing point data..." });
+    return { cloud: packPoints(buffer, size, layout, dropInvalid), streamed: false };
+  }
+
+  const post = (message: any) => {
+    if ((panel as any)._isDisposing) return;
+    try { tracePost(panel.webview, message); } catch (e) { /* panel disposed */ }
+  };
+  post({
+    command: 'streamBegin',
+    total: size,
+    hasColors: layout.rgbOffset !== undefined,
+    hasIntensity: layout.intensityOffset !== undefined
+  });
+
+  const base = BigInt(dataPtr);
+  const chunks: PackedPointCloud[] = [];
+  for (let first = 0; first < size; first += STREAM_CHUNK_POINTS) {
+    const n = Math.min(STREAM_CHUNK_POINTS, size - first);
+    const address = "0x" + (base + BigInt(first) * BigInt(stride)).toString(16);
+    const buffer = await readMemoryChunked(debugSession, address, n * stride);
+    if (!buffer || (panel as any)._isDisposing) {
+      post({ command: 'streamAbort' });
+      return { cloud: EMPTY_CLOUD, streamed: true };
+    }
+    const chunk = packPoints(buffer, n, layout, dropInvalid);
+    chunks.push(chunk);
+    post({ command: 'pointChunk', ...toCloudPayload(chunk) });
+    if (progress) {
+      progress.report({ message: `Read ${first + n} / ${size} points`, increment: (n / size) * 100 });
+    }
+  }
+  post({ command: 'streamEnd' });
+  return { cloud: concatClouds(chunks), streamed: true };
+}
 
 // Function to draw point cloud
 export async function drawPointCloud(
@@ -81,30 +312,34 @@ export async function drawPointCloud(
           
           if (PanelManager.isPanelFresh("3DPointViewer", debugSession.id, panelName, stateToken)) {
             console.log(`PointCloud panel is already up-to-date with token: ${stateToken}`);
-            return { panel, points: [], dataPtrForToken: "", skipped: true };
+            return { panel, cloud: EMPTY_CLOUD, dataPtrForToken: "", skipped: true, isNewPanel: false, streamed: false };
           }
         }
 
         // Step 4: Now read full data since we need to update
-        let points: { x: number; y: number; z: number }[] = [];
+        const isNewPanel = !panel.webview.html;
+        let cloud = EMPTY_CLOUD;
         let dataPtrForToken = "";
+        let streamed = false;
         
         if (variableInfo.evaluateName) {
           console.log("Reading full point cloud data");
           
           try {
-            const readResult = await getPointCloudViaReadMemory(debugSession, variableInfo.evaluateName, variableInfo, isDouble, progress);
-            points = readResult.points;
+            const readResult = await getPointCloudViaReadMemory(debugSession, variableInfo.evaluateName, variableInfo, isDouble, progress, panel);
+            cloud = readResult.cloud;
             dataPtrForToken = readResult.dataPtr || "";
-            if (points.length > 0) {
-              console.log(`Loaded ${points.length} points via readMemory`);
+            streamed = readResult.streamed;
+            if (cloud.count > 0) {
+              console.log(`Loaded ${cloud.count} points via readMemory`);
             }
           } catch (e) {
+            if (isReadCancelled(e)) throw e;
             console.log("readMemory approach failed:", e);
           }
         }
 
-        return { panel, points, dataPtrForToken, skipped: false };
+        return { panel, cloud, dataPtrForToken, skipped: false, isNewPanel, streamed };
       }
     );
 
@@ -113,23 +348,25 @@ export async function drawPointCloud(
       return;
     }
 
-    const { panel, points, dataPtrForToken } = result;
+    const { panel, cloud, dataPtrForToken, isNewPanel, streamed } = result;
 
-    console.log(`Loaded ${points.length} points`);
+    console.log(`Loaded ${cloud.count} points`);
 
-    if (points.length === 0) {
+    if (cloud.count === 0) {
       vscode.window.showWarningMessage("No points found in the vector. Make sure the vector is not empty.");
       return;
     }
 
     // Update state token with actual data
-    const totalBytes = points.length * bytesPerPoint;
+    const totalBytes = cloud.count * bytesPerPoint;
     const sample = dataPtrForToken ? await getMemorySample(debugSession, dataPtrForToken, totalBytes) : "";
-    const stateToken = `${points.length}|${dataPtrForToken}|${sample}`;
+    const stateToken = `${cloud.count}|${dataPtrForToken}|${sample}`;
     PanelManager.updateStateToken("3DPointViewer", debugSession.id, panelName, stateToken);
+    (panel as any)._lastCloud = cloud;
+    FrameRecorder.capture(panel, { kind: 'pointCloud', cloud });
 
     // If panel already has content, only send data to preserve view state
-    if (panel.webview.html && panel.webview.html.length > 0) {
+    if (!isNewPanel) {
       console.log("PointCloud panel already has HTML, sending only data");
       
       // Check if panel is being disposed before sending data
@@ -140,11 +377,13 @@ export async function drawPointCloud(
       
       // CRITICAL: Don't await postMessage - it can block and cause debug freeze
       try {
-        // Fire and forget - don't await
-        panel.webview.postMessage({
-          command: 'updateData',
-          points: points
-        });
+        // Fire and forget - don't await; streamed data has already arrived in chunks
+        if (!streamed) {
+          tracePost(panel.webview, {
+            command: 'updateData',
+            ...toCloudPayload(cloud)
+          });
+        }
       } catch (e) {
         console.log("[drawPointCloud] postMessage failed - panel likely disposed");
         return;
@@ -169,15 +408,17 @@ export async function drawPointCloud(
     }
 
     // Set HTML without embedding data (data will be sent via postMessage)
-    panel.webview.html = getWebviewContentForPointCloud();
-    
-    // Send ready signal immediately so webview knows this is not a moved panel
-    try {
-      if (!(panel as any)._isDisposing) {
-        panel.webview.postMessage({ command: 'ready' });
+    if (!streamed) {
+      panel.webview.html = getWebviewContentForPointCloud(panel.webview);
+      
+      // Send ready signal immediately so webview knows this is not a moved panel
+      try {
+        if (!(panel as any)._isDisposing) {
+          panel.webview.postMessage({ command: 'ready' });
+        }
+      } catch (e) {
+        console.log("[drawPointCloud] ready postMessage failed - panel likely disposed");
       }
-    } catch (e) {
-      console.log("[drawPointCloud] ready postMessage failed - panel likely disposed");
     }
     
     SyncManager.registerPanel(panelName, panel);
@@ -195,32 +436,7 @@ export async function drawPointCloud(
           return;
         }
         if (message.command === "savePointCloud") {
-          try {
-            const formatString = message.format; // e.g. 'ply-binary', 'pcd-ascii'
-            const isPLY = formatString.startsWith('ply');
-            const dataFormat = formatString.includes('ascii') ? 'ascii' : 'binary';
-            const fileExt = isPLY ? 'ply' : 'pcd';
-            
-            const fileData = isPLY 
-                ? generatePLYContent(points, dataFormat) 
-                : generatePCDContent(points, dataFormat);
-
-            const uri = await vscode.window.showSaveDialog({
-              defaultUri: vscode.Uri.file(`${panelName}.${fileExt}`),
-              filters: isPLY 
-                  ? { "PLY Files": ["ply"], "All Files": ["*"] }
-                  : { "PCD Files": ["pcd"], "All Files": ["*"] }
-            });
-            
-            if (uri) {
-              await vscode.workspace.fs.writeFile(uri, fileData);
-              const formatLabel = dataFormat === 'ascii' ? 'ASCII' : 'Binary';
-              vscode.window.showInformationMessage(`Point cloud saved to ${uri.fsPath} (${fileExt.toUpperCase()} ${formatLabel})`);
-            }
-          } catch (error) {
-            vscode.window.showErrorMessage(`Failed to save point cloud: ${error}`);
-            console.error("Error saving point cloud:", error);
-          }
+          await savePointCloudFile(cloud, panelName, message.format);
         } else if (message.command === 'viewChanged') {
           SyncManager.syncView(panelName, message.state);
         } else if (message.command === 'reload') {
@@ -229,8 +445,8 @@ export async function drawPointCloud(
           if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
             // CRITICAL: Fire-and-forget - don't await to avoid blocking
             Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: panelName, evaluateName: variableName, skipToken: true }))
-              .then(() => console.log(`[DEBUG-TRACE] PointCloud reload completed`))
-              .catch((e: Error) => console.log(`[DEBUG-TRACE] PointCloud reload failed:`, e));
+              .then(() => logDebug(`PointCloud reload completed`))
+              .catch((e: Error) => logDebug(`PointCloud reload failed:`, e));
           } else {
             console.log('Skipping reload - debug session is no longer active or panel is disposing');
           }
@@ -241,18 +457,18 @@ export async function drawPointCloud(
     );
 
     // Send point cloud data via postMessage (better memory efficiency than embedding in HTML)
-    console.log(`Sending ${points.length} points to webview via postMessage`);
+    console.log(`Sending ${cloud.count} points to webview via postMessage`);
     
-    if ((panel as any)._isDisposing) {
-      console.log("[drawPointCloud] Aborting final data send - panel is being disposed");
+    if ((panel as any)._isDisposing || streamed) {
+      console.log("[drawPointCloud] No final data send - panel is being disposed or data was streamed");
       return;
     }
     
     try {
       // Fire and forget - don't await
-      panel.webview.postMessage({
+      tracePost(panel.webview, {
         command: 'completeData',
-        points: points
+        ...toCloudPayload(cloud)
       });
     } catch (e) {
       console.log("[drawPointCloud] Final postMessage failed - panel likely disposed");
@@ -297,7 +513,7 @@ async function getPointCloudMetadata(
       `reinterpret_cast<long long>(${evaluateName}.data())`,
       `&(${evaluateName}.operator[](0))`
     ];
-    dataPtr = await tryGetDataPointer(debugSession, evaluateName, msvcExpressions, frameId, context);
+    dataPtr = await tryGetDataPointer(debugSession, evaluateName, msvcExpressions, frameId, context, variableInfo?.type);
     
   } else if (isUsingLLDB(debugSession)) {
     // OPTIMIZATION: Skip "variables" request - it's extremely slow for large vectors
@@ -311,7 +527,7 @@ async function getPointCloudMetadata(
       `&${evaluateName}[0]`,
       `reinterpret_cast<long long>(&${evaluateName}[0])`
     ];
-    dataPtr = await tryGetDataPointer(debugSession, evaluateName, lldbExpressions, frameId, context);
+    dataPtr = await tryGetDataPointer(debugSession, evaluateName, lldbExpressions, frameId, context, variableInfo?.type);
     
   } else if (isUsingCppdbg(debugSession)) {
     const gdbExpressions = [
@@ -321,7 +537,7 @@ async function getPointCloudMetadata(
       `reinterpret_cast<long long>(${evaluateName}.data())`,
       `(long long)&${evaluateName}[0]`
     ];
-    dataPtr = await tryGetDataPointer(debugSession, evaluateName, gdbExpressions, frameId, context);
+    dataPtr = await tryGetDataPointer(debugSession, evaluateName, gdbExpressions, frameId, context, variableInfo?.type);
     
   } else {
     const fallbackExpressions = [
@@ -331,7 +547,7 @@ async function getPointCloudMetadata(
       `(long long)${evaluateName}.data()`,
       `reinterpret_cast<long long>(${evaluateName}.data())`
     ];
-    dataPtr = await tryGetDataPointer(debugSession, evaluateName, fallbackExpressions, frameId, context);
+    dataPtr = await tryGetDataPointer(debugSession, evaluateName, fallbackExpressions, frameId, context, variableInfo?.type);
   }
   
   console.log(`getPointCloudMetadata result: size=${size}, dataPtr=${dataPtr}`);
@@ -344,9 +560,9 @@ export async function getPointCloudViaReadMemory(
   evaluateName: string,
   variableInfo?: any,
   isDouble: boolean = false,
-  progress?: vscode.Progress<{ message?: string; increment?: number }>
-): Promise<{ points: { x: number; y: number; z: number }[], dataPtr: string | null }> {
-  const points: { x: number; y: number; z: number }[] = [];
+  progress?: vscode.Progress<{ message?: string; increment?: number }>,
+  streamTo?: vscode.WebviewPanel
+): Promise<{ cloud: PackedPointCloud, dataPtr: string | null, streamed: boolean }> {
   // Use frameId from variableInfo if available, otherwise get current frame
   const frameId = variableInfo?.frameId || await getCurrentFrameId(debugSession);
   const context = getEvaluateContext(debugSession);
@@ -362,7 +578,7 @@ export async function getPointCloudViaReadMemory(
   
   if (isNaN(size) || size <= 0) {
     console.log("Could not get vector size or size is 0");
-    return { points, dataPtr: null };
+    return { cloud: EMPTY_CLOUD, dataPtr: null, streamed: false };
   }
   console.log(`Vector size: ${size}`);
   
@@ -382,7 +598,7 @@ export async function getPointCloudViaReadMemory(
       `reinterpret_cast<long long>(${evaluateName}.data())`,
       `&(${evaluateName}.operator[](0))`
     ];
-    dataPtr = await tryGetDataPointer(debugSession, evaluateName, msvcExpressions, frameId, context);
+    dataPtr = await tryGetDataPointer(debugSession, evaluateName, msvcExpressions, frameId, context, variableInfo?.type);
     
   } else if (isUsingLLDB(debugSession)) {
     // LLDB approaches
@@ -399,7 +615,7 @@ export async function getPointCloudViaReadMemory(
       `&${evaluateName}[0]`,                                    // Try address of first element
       `reinterpret_cast<long long>(&${evaluateName}[0])`       // Try address with C++ cast
     ];
-    dataPtr = await tryGetDataPointer(debugSession, evaluateName, lldbExpressions, frameId, context);
+    dataPtr = await tryGetDataPointer(debugSession, evaluateName, lldbExpressions, frameId, context, variableInfo?.type);
     
   } else if (isUsingCppdbg(debugSession)) {
     // GDB (cppdbg) approaches
@@ -411,7 +627,7 @@ export async function getPointCloudViaReadMemory(
       `reinterpret_cast<long long>(${evaluateName}.data())`,
       `(long long)&${evaluateName}[0]`
     ];
-    dataPtr = await tryGetDataPointer(debugSession, evaluateName, gdbExpressions, frameId, context);
+    dataPtr = await tryGetDataPointer(debugSession, evaluateName, gdbExpressions, frameId, context, variableInfo?.type);
     
   } else {
     // Fallback: try all approaches
@@ -423,12 +639,12 @@ export async function getPointCloudViaReadMemory(
       `(long long)${evaluateName}.data()`,
       `reinterpret_cast<long long>(${evaluateName}.data())`
     ];
-    dataPtr = await tryGetDataPointer(debugSession, evaluateName, fallbackExpressions, frameId, context);
+    dataPtr = await tryGetDataPointer(debugSession, evaluateName, fallbackExpressions, frameId, context, variableInfo?.type);
   }
   
   if (!dataPtr) {
     console.log("Could not extract data pointer with any approach");
-    return { points, dataPtr: null };
+    return { cloud: EMPTY_CLOUD, dataPtr: null, streamed: false };
   }
   
   // Read all points at once
@@ -443,37 +659,20 @@ export async function getPointCloudViaReadMemory(
   
   console.log(`Reading ${size} points (${totalBytes} bytes, ${isDouble ? "Point3d" : "Point3f"}) from ${dataPtr}`);
   
-  const buffer = await readMemoryChunked(debugSession, dataPtr, totalBytes, progress);
-  
-  if (progress) {
-    progress.report({ message: "Processing point data..." });
-  }
-  
-  if (buffer) {
-    if (isDouble) {
-      // Point3d: 3 doubles = 24 bytes per point
-      for (let i = 0; i < size && i * 24 + 23 < buffer.length; i++) {
-        const offset = i * 24;
-        const x = buffer.readDoubleLE(offset);
-        const y = buffer.readDoubleLE(offset + 8);
-        const z = buffer.readDoubleLE(offset + 16);
-        points.push({ x, y, z });
-      }
-    } else {
-      // Point3f: 3 floats = 12 bytes per point
-      for (let i = 0; i < size && i * 12 + 11 < buffer.length; i++) {
-        const offset = i * 12;
-        const x = buffer.readFloatLE(offset);
-        const y = buffer.readFloatLE(offset + 4);
-        const z = buffer.readFloatLE(offset + 8);
-        points.push({ x, y, z });
-      }
-    }
-    
-    console.log(`Loaded ${points.length} points via readMemory`);
+  // std::vector<cv::Point3f> published by cvdm::publish can be mapped directly
+  const layout = isDouble ? POINT3D_LAYOUT : POINT3F_LAYOUT;
+  const published = !isDouble
+    ? await readPublishedSegment(debugSession, dataPtr, totalBytes, SEGMENT_KIND_POINT3F)
+    : null;
+  if (published) {
+    const cloud = packPoints(published.buffer, size, layout, false);
+    console.log(`Loaded ${cloud.count} points from published segment`);
+    return { cloud, dataPtr, streamed: false };
   }
-  
-  return { points, dataPtr };
+
+  const { cloud, streamed } = await readPackedCloud(debugSession, streamTo, dataPtr, size, layout, false, progress);
+  console.log(`Loaded ${cloud.count} points via readMemory${streamed ? " (streamed)" : ""}`);
+  return { cloud, dataPtr, streamed };
 }
 
 // ============== std::array<Point3f/d> Support ==============
@@ -534,12 +733,12 @@ export async function drawStdArrayPointCloud(
           
           if (PanelManager.isPanelFresh("3DPointViewer", debugSession.id, panelName, stateToken)) {
             console.log(`std::array PointCloud panel is already up-to-date`);
-            return { panel, points: [], dataPtrForToken: dataPtr || "", skipped: true };
+            return { panel, cloud: EMPTY_CLOUD, dataPtrForToken: dataPtr || "", skipped: true };
           }
         }
 
         // Read point cloud data
-        let points: { x: number; y: number; z: number }[] = [];
+        let cloud = EMPTY_CLOUD;
 
         if (dataPtr && size > 0) {
           const totalBytes = size * bytesPerPoint;
@@ -552,30 +751,12 @@ export async function drawStdArrayPointCloud(
           if (buffer) {
             progress.report({ message: "Processing point data..." });
             
-            if (isDouble) {
-              // Point3d: 3 doubles = 24 bytes per point
-              for (let i = 0; i < size && i * 24 + 23 < buffer.length; i++) {
-                const offset = i * 24;
-                const x = buffer.readDoubleLE(offset);
-                const y = buffer.readDoubleLE(offset + 8);
-                const z = buffer.readDoubleLE(offset + 16);
-                points.push({ x, y, z });
-              }
-            } else {
-              // Point3f: 3 floats = 12 bytes per point
-              for (let i = 0; i < size && i * 12 + 11 < buffer.length; i++) {
-                const offset = i * 12;
-                const x = buffer.readFloatLE(offset);
-                const y = buffer.readFloatLE(offset + 4);
-                const z = buffer.readFloatLE(offset + 8);
-                points.push({ x, y, z });
-              }
-            }
-            console.log(`Loaded ${points.length} points from std::array via readMemory`);
+            cloud = packPoints(buffer, size, isDouble ? POINT3D_LAYOUT : POINT3F_LAYOUT, false);
+            console.log(`Loaded ${cloud.count} points from std::array via readMemory`);
           }
         }
 
-        return { panel, points, dataPtrForToken: dataPtr || "", skipped: false };
+        return { panel, cloud, dataPtrForToken: dataPtr || "", skipped: false };
       }
     );
 
@@ -584,18 +765,20 @@ export async function drawStdArrayPointCloud(
       return;
     }
 
-    const { panel, points, dataPtrForToken } = result;
+    const { panel, cloud, dataPtrForToken } = result;
 
-    if (points.length === 0) {
+    if (cloud.count === 0) {
       vscode.window.showWarningMessage("No points found in the std::array. Make sure it's not empty.");
       return;
     }
 
     // Update state token
-    const totalBytes = points.length * bytesPerPoint;
+    const totalBytes = cloud.count * bytesPerPoint;
     const sample = dataPtrForToken ? await getMemorySample(debugSession, dataPtrForToken, totalBytes) : "";
-    const stateToken = `${points.length}|${dataPtrForToken}|${sample}`;
+    const stateToken = `${cloud.count}|${dataPtrForToken}|${sample}`;
     PanelManager.updateStateToken("3DPointViewer", debugSession.id, panelName, stateToken);
+    (panel as any)._lastCloud = cloud;
+    FrameRecorder.capture(panel, { kind: 'pointCloud', cloud });
 
     // If panel already has content, only send data
     if (panel.webview.html && panel.webview.html.length > 0) {
@@ -610,9 +793,9 @@ export async function drawStdArrayPointCloud(
       // CRITICAL: Don't await postMessage - it can block and cause debug freeze
       try {
         // Fire and forget - don't await
-        panel.webview.postMessage({
+        tracePost(panel.webview, {
           command: 'updateData',
-          points: points
+          ...toCloudPayload(cloud)
         });
       } catch (e) {
         console.log("[drawStdArrayPointCloud] postMessage failed - panel likely disposed");
@@ -638,7 +821,7 @@ export async function drawStdArrayPointCloud(
     }
 
     // Set HTML without embedding data (data will be sent via postMessage)
-    panel.webview.html = getWebviewContentForPointCloud();
+    panel.webview.html = getWebviewContentForPointCloud(panel.webview);
     
     // Send ready signal immediately so webview knows this is not a moved panel
     panel.webview.postMessage({ command: 'ready' });
@@ -654,32 +837,7 @@ export async function drawStdArrayPointCloud(
     (panel as any)._messageListener = panel.webview.onDidReceiveMessage(
       async (message) => {
         if (message.command === "savePointCloud") {
-          try {
-            const formatString = message.format; 
-            const isPLY = formatString.startsWith('ply');
-            const dataFormat = formatString.includes('ascii') ? 'ascii' : 'binary';
-            const fileExt = isPLY ? 'ply' : 'pcd';
-            
-            const fileData = isPLY 
-                ? generatePLYContent(points, dataFormat) 
-                : generatePCDContent(points, dataFormat);
-
-            const uri = await vscode.window.showSaveDialog({
-              defaultUri: vscode.Uri.file(`${panelName}.${fileExt}`),
-              filters: isPLY 
-                  ? { "PLY Files": ["ply"], "All Files": ["*"] }
-                  : { "PCD Files": ["pcd"], "All Files": ["*"] }
-            });
-            
-            if (uri) {
-              await vscode.workspace.fs.writeFile(uri, fileData);
-              const formatLabel = dataFormat === 'ascii' ? 'ASCII' : 'Binary';
-              vscode.window.showInformationMessage(`Point cloud saved to ${uri.fsPath} (${fileExt.toUpperCase()} ${formatLabel})`);
-            }
-          } catch (error) {
-            vscode.window.showErrorMessage(`Failed to save point cloud: ${error}`);
-            console.error("Error saving point cloud:", error);
-          }
+          await savePointCloudFile(cloud, panelName, message.format);
         } else if (message.command === 'viewChanged') {
           SyncManager.syncView(panelName, message.state);
         } else if (message.command === 'reload') {
@@ -688,8 +846,8 @@ export async function drawStdArrayPointCloud(
           if (currentSession && currentSession.id === debugSession.id && !(panel as any)._isDisposing) {
             // CRITICAL: Fire-and-forget - don't await to avoid blocking
             Promise.resolve(vscode.commands.executeCommand('cv-debugmate.viewVariable', { name: panelName, evaluateName: variableName, skipToken: true }))
-              .then(() => console.log(`[DEBUG-TRACE] StdArray PointCloud reload completed`))
-              .catch((e: Error) => console.log(`[DEBUG-TRACE] StdArray PointCloud reload failed:`, e));
+              .then(() => logDebug(`StdArray PointCloud reload completed`))
+              .catch((e: Error) => logDebug(`StdArray PointCloud reload failed:`, e));
           } else {
             console.log('Skipping reload - debug session is no longer active or has changed');
           }
@@ -700,7 +858,7 @@ export async function drawStdArrayPointCloud(
     );
 
     // Send point cloud data via postMessage (better memory efficiency than embedding in HTML)
-    console.log(`Sending ${points.length} points to webview via postMessage`);
+    console.log(`Sending ${cloud.count} points to webview via postMessage`);
     
     if ((panel as any)._isDisposing) {
       console.log("[drawStdArrayPointCloud] Aborting final data send - panel is being disposed");
@@ -709,9 +867,9 @@ export async function drawStdArrayPointCloud(
     
     try {
       // Fire and forget - don't await
-      panel.webview.postMessage({
+      tracePost(panel.webview, {
         command: 'completeData',
-        points: points
+        ...toCloudPayload(cloud)
       });
     } catch (e) {
       console.log("[drawStdArrayPointCloud] Final postMessage failed - panel likely disposed");
@@ -756,7 +914,7 @@ export async function drawPCLPointCloud(
   try {
     console.log(`[drawPCLPointCloud] variableName="${variableName}", pointType=${pointType}, layout=${JSON.stringify(layout)}`);
     const panelTitle = `View: ${panelName}`;
-    const { bytesPerPoint, xOffset, yOffset, zOffset } = layout;
+    const { bytesPerPoint } = layout;
 
     const result = await vscode.window.withProgress(
       {
@@ -842,7 +1000,7 @@ export async function drawPCLPointCloud(
         }
 
         if (size <= 0) {
-          return { panel: null, points: [], dataPtrForToken: "", skipped: false };
+          return { panel: null, cloud: EMPTY_CLOUD, dataPtrForToken: "", skipped: false };
         }
 
         // Step 2: Get data pointer of cloud.points (std::vector<T>)
@@ -886,7 +1044,7 @@ export async function drawPCLPointCloud(
 
         if (!dataPtr) {
           console.log("[drawPCLPointCloud] Could not get data pointer");
-          return { panel: null, points: [], dataPtrForToken: "", skipped: false };
+          return { panel: null, cloud: EMPTY_CLOUD, dataPtrForToken: "", skipped: false, isNewPanel: false, streamed: false };
         }
 
         // Step 3: Get / create panel
@@ -901,33 +1059,22 @@ export async function drawPCLPointCloud(
           const sample = await getMemorySample(debugSession, dataPtr, totalBytes);
           const stateToken = `${size}|${dataPtr}|${sample}`;
           if (PanelManager.isPanelFresh("3DPointViewer", debugSession.id, panelName, stateToken)) {
-            return { panel, points: [], dataPtrForToken: dataPtr, skipped: true };
+            return { panel, cloud: EMPTY_CLOUD, dataPtrForToken: dataPtr, skipped: true, isNewPanel: false, streamed: false };
           }
         }
 
-        // Step 5: Read memory and extract XYZ
+        // Step 5: Read memory and extract XYZ (streamed to the panel for large clouds)
+        const isNewPanel = !panel.webview.html;
         const totalBytes = size * bytesPerPoint;
         progress.report({ message: `Reading ${size} points (${Math.round(totalBytes / 1024 / 1024 * 10) / 10} MB)...` });
-        const buffer = await readMemoryChunked(debugSession, dataPtr, totalBytes, progress);
-        const points: { x: number; y: number; z: number }[] = [];
-
-        if (buffer) {
-          progress.report({ message: "Processing point data..." });
-          for (let i = 0; i < size; i++) {
-            const base = i * bytesPerPoint;
-            if (base + zOffset + 4 > buffer.length) { break; }
-            const x = buffer.readFloatLE(base + xOffset);
-            const y = buffer.readFloatLE(base + yOffset);
-            const z = buffer.readFloatLE(base + zOffset);
-            // Skip NaN / Inf (pcl::PointCloud uses NaN for invalid points in organised clouds)
-            if (isFinite(x) && isFinite(y) && isFinite(z)) {
-              points.push({ x, y, z });
-            }
-          }
-          console.log(`[drawPCLPointCloud] Loaded ${points.length} valid points (${size - points.length} skipped)`);
+        const { cloud, streamed } = await readPackedCloud(
+          debugSession, panel, dataPtr, size, { ...layout, isDouble: false }, true, progress
+        );
+        if (cloud.count > 0) {
+          console.log(`[drawPCLPointCloud] Loaded ${cloud.count} valid points (${size - cloud.count} skipped)`);
         }
 
-        return { panel, points, dataPtrForToken: dataPtr, skipped: false };
+        return { panel, cloud, dataPtrForToken: dataPtr, skipped: false, isNewPanel, streamed };
       }
     );
 
@@ -939,9 +1086,9 @@ export async function drawPCLPointCloud(
     }
     if (result.skipped) { return; }
 
-    const { panel, points, dataPtrForToken } = result;
+    const { panel, cloud, dataPtrForToken, isNewPanel, streamed } = result;
 
-    if (points.length === 0) {
+    if (cloud.count === 0) {
       vscode.window.showWarningMessage(
         `pcl::PointCloud<${pointType}> "${variableName}" is empty or contains only invalid (NaN) points.`
       );
@@ -949,15 +1096,19 @@ export async function drawPCLPointCloud(
     }
 
     // Update state token
-    const totalBytes = points.length * bytesPerPoint;
+    const totalBytes = cloud.count * bytesPerPoint;
     const sample = dataPtrForToken ? await getMemorySample(debugSession, dataPtrForToken, totalBytes) : "";
-    const stateToken = `${points.length}|${dataPtrForToken}|${sample}`;
+    const stateToken = `${cloud.count}|${dataPtrForToken}|${sample}`;
     PanelManager.updateStateToken("3DPointViewer", debugSession.id, panelName, stateToken);
+    (panel as any)._lastCloud = cloud;
+    FrameRecorder.capture(panel, { kind: 'pointCloud', cloud });
 
     // If panel already has HTML, only send a data update (preserves camera state)
-    if (panel.webview.html && panel.webview.html.length > 0) {
+    if (!isNewPanel) {
       if ((panel as any)._isDisposing) { return; }
-      try { panel.webview.postMessage({ command: "updateData", points }); } catch (e) { return; }
+      if (!streamed) {
+        try { tracePost(panel.webview, { command: "updateData", ...toCloudPayload(cloud) }); } catch (e) { return; }
+      }
       const savedState = SyncManager.getSavedState(panelName);
       if (savedState && !(panel as any)._isDisposing) {
         setTimeout(() => {
@@ -969,11 +1120,13 @@ export async function drawPCLPointCloud(
       return;
     }
 
-    // Fresh panel
-    panel.webview.html = getWebviewContentForPointCloud();
-    try {
-      if (!(panel as any)._isDisposing) { panel.webview.postMessage({ command: "ready" }); }
-    } catch (e) {}
+    // Fresh panel (a streamed read has already set the HTML)
+    if (!streamed) {
+      panel.webview.html = getWebviewContentForPointCloud(panel.webview);
+      try {
+        if (!(panel as any)._isDisposing) { panel.webview.postMessage({ command: "ready" }); }
+      } catch (e) {}
+    }
 
     SyncManager.registerPanel(panelName, panel);
 
@@ -983,30 +1136,7 @@ export async function drawPCLPointCloud(
       async (message) => {
         if ((panel as any)._isDisposing) { return; }
         if (message.command === "savePointCloud") {
-          try {
-            const formatString = message.format; 
-            const isPLY = formatString.startsWith('ply');
-            const dataFormat = formatString.includes('ascii') ? 'ascii' : 'binary';
-            const fileExt = isPLY ? 'ply' : 'pcd';
-            
-            const fileData = isPLY 
-                ? generatePLYContent(points, dataFormat) 
-                : generatePCDContent(points, dataFormat);
-
-            const uri = await vscode.window.showSaveDialog({
-              defaultUri: vscode.Uri.file(`${panelName}.${fileExt}`),
-              filters: isPLY 
-                  ? { "PLY Files": ["ply"], "All Files": ["*"] }
-                  : { "PCD Files": ["pcd"], "All Files": ["*"] }
-            });
-            if (uri) {
-              await vscode.workspace.fs.writeFile(uri, fileData);
-              const formatLabel = dataFormat === 'ascii' ? 'ASCII' : 'Binary';
-              vscode.window.showInformationMessage(`Point cloud saved to ${uri.fsPath} (${fileExt.toUpperCase()} ${formatLabel})`);
-            }
-          } catch (error) {
-            vscode.window.showErrorMessage(`Failed to save point cloud: ${error}`);
-          }
+          await savePointCloudFile(cloud, panelName, message.format);
         } else if (message.command === "viewChanged") {
           SyncManager.syncView(panelName, message.state);
         } else if (message.command === "reload") {
@@ -1026,9 +1156,9 @@ export async function drawPCLPointCloud(
       undefined
     );
 
-    if ((panel as any)._isDisposing) { return; }
+    if ((panel as any)._isDisposing || streamed) { return; }
     try {
-      panel.webview.postMessage({ command: "completeData", points });
+      tracePost(panel.webview, { command: "completeData", ...toCloudPayload(cloud) });
     } catch (e) {
       console.log("[drawPCLPointCloud] Final postMessage failed");
     }
@@ -0,0 +1,1246 @@
+// 3D point viewer script, loaded by the shell from getWebviewContentForPointCloud.
+// esbuild.js bundles it with three.js into dist/media; per-panel values come from
+// the viewer-config block.
+import * as THREE from 'three';
+import { OrbitControls } from 'three/addons/controls/OrbitControls.js';
+import { initRecordingTimeline } from '../utils/recordingTimeline.js';
+
+const viewerConfig = JSON.parse(document.getElementById('viewer-config').textContent);
+
+const vscode = acquireVsCodeApi();
+const timeline = initRecordingTimeline(vscode);
+const loadingOverlay = document.getElementById('loading');
+const loadingText = document.getElementById('loading-text');
+
+// Packed cloud from the extension: positions (x, y, z interleaved) and
+// the optional per-point colors and intensity, all typed arrays
+let cloud = { count: 0, positions: new Float32Array(0), colors: null, intensity: null };
+let minIntensity = 0, maxIntensity = 1;
+let isInitialized = false;
+let pendingSyncState = null;
+let extensionReady = false;
+let isShuttingDownEarly = false;  // For use before full init
+
+// Detect if this is a moved panel (same logic as Mat viewer)
+const waitForData = viewerConfig.waitForData;
+if (waitForData) {
+    setTimeout(() => {
+        if (!extensionReady && !isShuttingDownEarly) {
+            loadingText.innerHTML = 'Reloading...';
+            vscode.postMessage({ command: 'reload' });
+        }
+    }, 100);
+}
+
+// Mark shutting down early (before full initialization)
+window.addEventListener('beforeunload', () => {
+    isShuttingDownEarly = true;
+});
+
+// Colorbar custom limits
+let colorCustomMin = null;
+let colorCustomMax = null;
+let currentColorMode = 'solid';
+const SLIDER_TRACK_HEIGHT = 150;
+
+// Main scene
+const scene = new THREE.Scene();
+scene.background = new THREE.Color(0x1a1a2e);
+
+const camera = new THREE.PerspectiveCamera(60, window.innerWidth / window.innerHeight, 0.1, 100000);
+const renderer = new THREE.WebGLRenderer({ antialias: true });
+renderer.setSize(window.innerWidth, window.innerHeight);
+renderer.autoClear = false;
+document.body.appendChild(renderer.domElement);
+
+// Point cloud objects (will be created when data is available). Packed
+// positions are used as-is; the root's rotation maps world (x, y, z) to
+// Three.js (x, z, -y)
+const pointsRoot = new THREE.Group();
+pointsRoot.rotation.x = -Math.PI / 2;
+scene.add(pointsRoot);
+let geometry = null;
+let pointsObj = null;
+
+// Shared by the whole cloud and every octree node. Solid, axis (jet over
+// [u_min, u_max]), rgb and intensity coloring all happen per vertex, and
+// the size attenuation matches PointsMaterial's
+const COLOR_MODE_IDS = { solid: 0, x: 1, y: 2, z: 3, rgb: 4, intensity: 5 };
+const pointsMaterial = new THREE.ShaderMaterial({
+    uniforms: {
+        u_size: { value: 0.1 },
+        u_scale: { value: renderer.domElement.height * 0.5 },
+        u_mode: { value: 0 },
+        u_min: { value: 0 },
+        u_max: { value: 1 }
+    },
+    vertexShader: [
+        'uniform float u_size;',
+        'uniform float u_scale;',
+        'uniform int u_mode;',
+        'uniform float u_min;',
+        'uniform float u_max;',
+        'attribute vec3 rgb;',
+        'attribute float intensity;',
+        'varying vec3 vColor;',
+        'vec3 jet(float t) {',
+        '    t = clamp(t, 0.0, 1.0);',
+        '    if (t < 0.25) return vec3(0.0, 4.0 * t, 1.0);',
+        '    if (t < 0.5) return vec3(0.0, 1.0, 1.0 - 4.0 * (t - 0.25));',
+        '    if (t < 0.75) return vec3(4.0 * (t - 0.5), 1.0, 0.0);',
+        '    return vec3(1.0, 1.0 - 4.0 * (t - 0.75), 0.0);',
+        '}',
+        'void main() {',
+        '    vec4 mvPosition = modelViewMatrix * vec4(position, 1.0);',
+        '    gl_Position = projectionMatrix * mvPosition;',
+        '    gl_PointSize = u_size * (u_scale / -mvPosition.z);',
+        '    if (u_mode == 0) vColor = vec3(0.5, 0.7, 1.0);',
+        '    else if (u_mode == 4) vColor = rgb;',
+        '    else {',
+        '        float v = u_mode == 1 ? position.x : u_mode == 2 ? position.y : u_mode == 3 ? position.z : intensity;',
+        '        vColor = jet((v - u_min) / (u_max - u_min));',
+        '    }',
+        '}'
+    ].join('\n'),
+    fragmentShader: [
+        'varying vec3 vColor;',
+        'void main() {',
+        '    gl_FragColor = vec4(vColor, 1.0);',
+        '}'
+    ].join('\n')
+});
+let minX = 0, maxX = 1, minY = 0, maxY = 1, minZ = 0, maxZ = 1;
+const controls = new OrbitControls(camera, renderer.domElement);
+
+// Axis view using SVG for crisp vector rendering
+const axisContainer = document.getElementById('axisView');
+const svg = document.createElementNS('http://www.w3.org/2000/svg', 'svg');
+svg.setAttribute('viewBox', '0 0 120 120');
+svg.setAttribute('preserveAspectRatio', 'xMidYMid meet');
+axisContainer.appendChild(svg);
+
+// Function to update axis arrows based on camera direction
+function updateAxisView() {
+    // Clear previous content
+    svg.innerHTML = '';
+
+    // Get camera basis vectors
+    const cameraDir = new THREE.Vector3();
+    camera.getWorldDirection(cameraDir);
+    const cameraUp = camera.up.clone();
+    const cameraRight = new THREE.Vector3();
+    cameraRight.crossVectors(cameraDir, cameraUp).normalize();
+    const cameraUpCorrected = new THREE.Vector3();
+    cameraUpCorrected.crossVectors(cameraRight, cameraDir).normalize();
+
+    // Define axis directions in world space
+    const worldX = new THREE.Vector3(1, 0, 0);
+    const worldY = new THREE.Vector3(0, 0, -1); // Y is forward (negative Z in Three.js)
+    const worldZ = new THREE.Vector3(0, 1, 0);
+
+    // Project to 2D using camera basis
+    // Project onto the plane perpendicular to camera direction
+    function project3DTo2D(worldVec) {
+        // Project onto camera right and up vectors
+        const projRight = worldVec.dot(cameraRight);
+        const projUp = worldVec.dot(cameraUpCorrected);
+        return { x: projRight, y: projUp };
+    }
+
+    const centerX = 60, centerY = 60;
+    const axisLength = 30;
+    const arrowSize = 8;
+
+    // Project axes
+    const xProj = project3DTo2D(worldX);
+    const yProj = project3DTo2D(worldY);
+    const zProj = project3DTo2D(worldZ);
+
+    // Normalize and scale
+    const scale = axisLength;
+    const xEnd = {
+        x: centerX + xProj.x * scale,
+        y: centerY - xProj.y * scale // Flip Y for SVG
+    };
+    const yEnd = {
+        x: centerX + yProj.x * scale,
+        y: centerY - yProj.y * scale
+    };
+    const zEnd = {
+        x: centerX + zProj.x * scale,
+        y: centerY - zProj.y * scale
+    };
+
+    // Draw arrows
+    drawArrow(svg, centerX, centerY, xEnd.x, xEnd.y, '#ff3333', 'X');
+    drawArrow(svg, centerX, centerY, yEnd.x, yEnd.y, '#33ff33', 'Y');
+    drawArrow(svg, centerX, centerY, zEnd.x, zEnd.y, '#3333ff', 'Z');
+}
+
+// Function to draw an arrow with label
+function drawArrow(svg, x1, y1, x2, y2, color, label) {
+    // Draw line
+    const line = document.createElementNS('http://www.w3.org/2000/svg', 'line');
+    line.setAttribute('x1', x1);
+    line.setAttribute('y1', y1);
+    line.setAttribute('x2', x2);
+    line.setAttribute('y2', y2);
+    line.setAttribute('stroke', color);
+    line.setAttribute('stroke-width', '2.5');
+    line.setAttribute('stroke-linecap', 'round');
+    svg.appendChild(line);
+
+    // Draw arrowhead
+    const angle = Math.atan2(y2 - y1, x2 - x1);
+    const arrowLength = 6;
+    const arrowWidth = 4;
+
+    const arrowX1 = x2 - arrowLength * Math.cos(angle - Math.PI / 6);
+    const arrowY1 = y2 - arrowLength * Math.sin(angle - Math.PI / 6);
+    const arrowX2 = x2 - arrowLength * Math.cos(angle + Math.PI / 6);
+    const arrowY2 = y2 - arrowLength * Math.sin(angle + Math.PI / 6);
+
+    const arrow = document.createElementNS('http://www.w3.org/2000/svg', 'polygon');
+    arrow.setAttribute('points', x2 + ',' + y2 + ' ' + arrowX1 + ',' + arrowY1 + ' ' + arrowX2 + ',' + arrowY2);
+    arrow.setAttribute('fill', color);
+    svg.appendChild(arrow);
+
+    // Draw label
+    const text = document.createElementNS('http://www.w3.org/2000/svg', 'text');
+    text.setAttribute('x', x2 + (x2 - x1) * 0.15);
+    text.setAttribute('y', y2 + (y2 - y1) * 0.15);
+    text.setAttribute('fill', color);
+    text.setAttribute('font-size', '14');
+    text.setAttribute('font-weight', 'bold');
+    text.setAttribute('font-family', 'Arial, sans-serif');
+    text.setAttribute('text-anchor', 'middle');
+    text.setAttribute('dominant-baseline', 'middle');
+    text.textContent = label;
+    svg.appendChild(text);
+}
+
+// Initial render
+updateAxisView();
+
+// View the byte arrays of a data message as the packed cloud
+function decodeCloud(message) {
+    const asFloat32 = function(bytes, length) {
+        if (bytes.byteOffset % 4 !== 0) bytes = bytes.slice();
+        return new Float32Array(bytes.buffer, bytes.byteOffset, length);
+    };
+    const count = message.count || 0;
+    return {
+        count: count,
+        positions: asFloat32(message.positions, count * 3),
+        colors: message.colors || null,
+        intensity: message.intensity ? asFloat32(message.intensity, count) : null
+    };
+}
+
+// Bounds are accumulated raw so streamed chunks can extend them
+let rawBounds = null;
+
+function emptyBounds() {
+    return {
+        minX: Infinity, maxX: -Infinity, minY: Infinity, maxY: -Infinity,
+        minZ: Infinity, maxZ: -Infinity, minI: Infinity, maxI: -Infinity
+    };
+}
+
+function extendBounds(from, to) {
+    const pos = cloud.positions, b = rawBounds;
+    for (let i = from * 3; i < to * 3; i += 3) {
+        const x = pos[i], y = pos[i + 1], z = pos[i + 2];
+        if (x < b.minX) b.minX = x; if (x > b.maxX) b.maxX = x;
+        if (y < b.minY) b.minY = y; if (y > b.maxY) b.maxY = y;
+        if (z < b.minZ) b.minZ = z; if (z > b.maxZ) b.maxZ = z;
+    }
+    if (cloud.intensity) {
+        for (let i = from; i < to; i++) {
+            const v = cloud.intensity[i];
+            if (v < b.minI) b.minI = v;
+            if (v > b.maxI) b.maxI = v;
+        }
+    }
+}
+
+function publishBounds() {
+    const b = rawBounds;
+    minX = b.minX; maxX = b.maxX;
+    minY = b.minY; maxY = b.maxY;
+    minZ = b.minZ; maxZ = b.maxZ;
+
+    // Handle edge case of single point or identical points
+    if (minX === maxX) { minX -= 0.5; maxX += 0.5; }
+    if (minY === maxY) { minY -= 0.5; maxY += 0.5; }
+    if (minZ === maxZ) { minZ -= 0.5; maxZ += 0.5; }
+
+    if (cloud.intensity) {
+        minIntensity = b.minI; maxIntensity = b.maxI;
+        if (!(minIntensity < maxIntensity)) { minIntensity = 0; maxIntensity = 1; }
+    }
+
+    document.getElementById('pointCount').textContent = cloud.count;
+    document.getElementById('boundsX').textContent = `[${minX.toFixed(2)}, ${maxX.toFixed(2)}]`;
+    document.getElementById('boundsY').textContent = `[${minY.toFixed(2)}, ${maxY.toFixed(2)}]`;
+    document.getElementById('boundsZ').textContent = `[${minZ.toFixed(2)}, ${maxZ.toFixed(2)}]`;
+}
+
+function updateBounds() {
+    rawBounds = emptyBounds();
+    extendBounds(0, cloud.count);
+    publishBounds();
+}
+
+// Attribute buttons only for the fields this cloud has
+function updateFieldButtons() {
+    document.getElementById('btnRGB').style.display = cloud.colors ? '' : 'none';
+    document.getElementById('btnIntensity').style.display = cloud.intensity ? '' : 'none';
+    if ((currentColorMode === 'rgb' && !cloud.colors) || (currentColorMode === 'intensity' && !cloud.intensity)) {
+        updateColors('solid');
+        updateColorButtons('solid');
+    }
+}
+
+// ---- Octree LOD ----
+// Clouds of OCTREE_MIN_POINTS or more are split into an octree in a worker.
+// Every node keeps at most one point per cell of a GRID^3 grid over its
+// cube and passes the rest down to its octants, so a node plus its
+// ancestors is a uniform sample with the node's cell size as spacing.
+// Each frame the nodes in view are refined while their parent's spacing
+// covers more than LOD_MIN_SPACING_PX on screen, nearest first, until
+// POINT_BUDGET points are drawn.
+const OCTREE_MIN_POINTS = 1 << 20;
+const POINT_BUDGET = 3000000;
+const LOD_MIN_SPACING_PX = 1.0;
+
+// Runs in the octree worker (its source is the worker script) or on the
+// main thread when no worker can be started, so it must stay self-contained
+function buildOctree(input) {
+    const GRID = 32;
+    const NODE_CAPACITY = 32768;
+    const MAX_DEPTH = 16;
+    const pos = input.positions, count = input.count;
+
+    let minX = Infinity, minY = Infinity, minZ = Infinity;
+    let maxX = -Infinity, maxY = -Infinity, maxZ = -Infinity;
+    for (let i = 0; i < count * 3; i += 3) {
+        const x = pos[i], y = pos[i + 1], z = pos[i + 2];
+        if (x < minX) minX = x; if (x > maxX) maxX = x;
+        if (y < minY) minY = y; if (y > maxY) maxY = y;
+        if (z < minZ) minZ = z; if (z > maxZ) maxZ = z;
+    }
+    if (!(minX <= maxX)) { minX = maxX = minY = maxY = minZ = maxZ = 0; }
+
+    const work = new Uint32Array(count);
+    for (let i = 0; i < count; i++) work[i] = i;
+    const temp = new Uint32Array(count);
+    const order = new Uint32Array(count);
+    const stamp = new Int32Array(GRID * GRID * GRID).fill(-1);
+    const nodes = [];
+    let written = 0;
+    const stack = [{
+        lo: 0, hi: count, depth: 0, parent: -1,
+        cx: (minX + maxX) / 2, cy: (minY + maxY) / 2, cz: (minZ + maxZ) / 2,
+        half: Math.max(maxX - minX, maxY - minY, maxZ - minZ, 1e-6) / 2
+    }];
+
+    while (stack.length > 0) {
+        const task = stack.pop();
+        const id = nodes.length;
+        const node = {
+            start: written, count: 0,
+            center: [task.cx, task.cy, task.cz],
+            radius: task.half * Math.sqrt(3),
+            spacing: 2 * task.half / GRID,
+            depth: task.depth,
+            children: []
+        };
+        nodes.push(node);
+        if (task.parent >= 0) nodes[task.parent].children.push(id);
+
+        if (task.hi - task.lo <= NODE_CAPACITY || task.depth >= MAX_DEPTH) {
+            for (let k = task.lo; k < task.hi; k++) order[written++] = work[k];
+            node.count = written - node.start;
+            continue;
+        }
+
+        // First point in each grid cell stays in this node
+        const x0 = task.cx - task.half, y0 = task.cy - task.half, z0 = task.cz - task.half;
+        const inv = GRID / (2 * task.half);
+        let rest = task.lo;
+        for (let k = task.lo; k < task.hi; k++) {
+            const p = work[k], j = p * 3;
+            let ix = ((pos[j] - x0) * inv) | 0;
+            let iy = ((pos[j + 1] - y0) * inv) | 0;
+            let iz = ((pos[j + 2] - z0) * inv) | 0;
+            ix = ix < 0 ? 0 : ix >= GRID ? GRID - 1 : ix;
+            iy = iy < 0 ? 0 : iy >= GRID ? GRID - 1 : iy;
+            iz = iz < 0 ? 0 : iz >= GRID ? GRID - 1 : iz;
+            const cell = (iz * GRID + iy) * GRID + ix;
+            if (stamp[cell] !== id) {
+                stamp[cell] = id;
+                order[written++] = p;
+            } else {
+                work[rest++] = p;
+            }
+        }
+        node.count = written - node.start;
+
+        // Counting sort of the remainder into the eight octants
+        const octant = (p) => (pos[p * 3] > task.cx ? 1 : 0) |
+            (pos[p * 3 + 1] > task.cy ? 2 : 0) | (pos[p * 3 + 2] > task.cz ? 4 : 0);
+        const counts = [0, 0, 0, 0, 0, 0, 0, 0];
+        for (let k = task.lo; k < rest; k++) counts[octant(work[k])]++;
+        const starts = [0, 0, 0, 0, 0, 0, 0, 0];
+        for (let o = 1; o < 8; o++) starts[o] = starts[o - 1] + counts[o - 1];
+        const next = starts.slice();
+        for (let k = task.lo; k < rest; k++) {
+            const p = work[k];
+            temp[task.lo + next[octant(p)]++] = p;
+        }
+        work.set(temp.subarray(task.lo, rest), task.lo);
+
+        const h = task.half / 2;
+        for (let o = 0; o < 8; o++) {
+            if (counts[o] === 0) continue;
+            stack.push({
+                lo: task.lo + starts[o], hi: task.lo + starts[o] + counts[o],
+                depth: task.depth + 1, parent: id,
+                cx: task.cx + (o & 1 ? h : -h),
+                cy: task.cy + (o & 2 ? h : -h),
+                cz: task.cz + (o & 4 ? h : -h),
+                half: h
+            });
+        }
+    }
+
+    // Reorder the point arrays so every node is one contiguous range
+    const positions = new Float32Array(count * 3);
+    const colors = input.colors ? new Uint8Array(count * 3) : null;
+    const intensity = input.intensity ? new Float32Array(count) : null;
+    for (let k = 0; k < count; k++) {
+        const p = order[k];
+        positions[k * 3] = pos[p * 3];
+        positions[k * 3 + 1] = pos[p * 3 + 1];
+        positions[k * 3 + 2] = pos[p * 3 + 2];
+        if (colors) {
+            colors[k * 3] = input.colors[p * 3];
+            colors[k * 3 + 1] = input.colors[p * 3 + 1];
+            colors[k * 3 + 2] = input.colors[p * 3 + 2];
+        }
+        if (intensity) intensity[k] = input.intensity[p];
+    }
+    return { id: input.id, count: count, nodes: nodes, positions: positions, colors: colors, intensity: intensity };
+}
+
+function transferList(c) {
+    const buffers = new Set([c.positions.buffer]);
+    if (c.colors) buffers.add(c.colors.buffer);
+    if (c.intensity) buffers.add(c.intensity.buffer);
+    return Array.from(buffers);
+}
+
+let octreeWorker = null;
+let octreeWorkerFailed = false;
+let octreeBuildId = 0;
+let octree = null;  // { nodes, objects, group }
+let lodDirty = false;
+
+function getOctreeWorker() {
+    if (octreeWorker || octreeWorkerFailed) return octreeWorker;
+    try {
+        const source = buildOctree.toString() + '\n' + transferList.toString() + '\n' +
+            'self.onmessage = function(e) { const r = buildOctree(e.data); self.postMessage(r, transferList(r)); };';
+        octreeWorker = new Worker(URL.createObjectURL(new Blob([source], { type: 'text/javascript' })));
+        octreeWorker.onmessage = (e) => onOctreeBuilt(e.data);
+        octreeWorker.onerror = (e) => {
+            // The worker only had copies; the preview keeps drawing the cloud
+            console.error('Octree worker failed, keeping the full-resolution cloud:', e.message);
+            octreeWorkerFailed = true;
+            octreeWorker = null;
+        };
+    } catch (e) {
+        console.log('Octree worker unavailable, building on the main thread:', e);
+        octreeWorkerFailed = true;
+        octreeWorker = null;
+    }
+    return octreeWorker;
+}
+
+function requestOctree() {
+    const worker = getOctreeWorker();
+    if (worker) {
+        // The worker gets copies to own: the preview keeps drawing (and a
+        // failed build keeps) the viewer's arrays
+        const input = {
+            id: ++octreeBuildId, count: cloud.count,
+            positions: cloud.positions.slice(),
+            colors: cloud.colors ? cloud.colors.slice() : null,
+            intensity: cloud.intensity ? cloud.intensity.slice() : null
+        };
+        worker.postMessage(input, transferList(input));
+    } else {
+        const input = {
+            id: ++octreeBuildId, count: cloud.count,
+            positions: cloud.positions, colors: cloud.colors, intensity: cloud.intensity
+        };
+        setTimeout(() => onOctreeBuilt(buildOctree(input)), 0);
+    }
+}
+
+function onOctreeBuilt(result) {
+    if (result.id !== octreeBuildId) return;  // a newer cloud has arrived
+    disposeDisplay();
+    cloud = { count: result.count, positions: result.positions, colors: result.colors, intensity: result.intensity };
+    const group = new THREE.Group();
+    const objects = result.nodes.map((node) => {
+        const g = new THREE.BufferGeometry();
+        const a = node.start, b = node.start + node.count;
+        g.setAttribute('position', new THREE.BufferAttribute(cloud.positions.subarray(a * 3, b * 3), 3));
+        if (cloud.colors) g.setAttribute('rgb', new THREE.BufferAttribute(cloud.colors.subarray(a * 3, b * 3), 3, true));
+        if (cloud.intensity) g.setAttribute('intensity', new THREE.BufferAttribute(cloud.intensity.subarray(a, b), 1));
+        const obj = new THREE.Points(g, pointsMaterial);
+        obj.frustumCulled = false;
+        obj.visible = false;
+        group.add(obj);
+        return obj;
+    });
+    octree = { nodes: result.nodes, objects: objects, group: group };
+    pointsRoot.add(group);
+    lodDirty = true;
+    console.log('Octree built: ' + result.nodes.length + ' nodes for ' + result.count + ' points');
+    reportMemoryUsage();
+}
+
+function heapPush(heap, item) {
+    let i = heap.length;
+    heap.push(item);
+    while (i > 0) {
+        const parent = (i - 1) >> 1;
+        if (heap[parent].priority >= item.priority) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = item;
+}
+
+function heapPop(heap) {
+    const top = heap[0];
+    const last = heap.pop();
+    if (heap.length > 0) {
+        let i = 0;
+        for (;;) {
+            let c = 2 * i + 1;
+            if (c >= heap.length) break;
+            if (c + 1 < heap.length && heap[c + 1].priority > heap[c].priority) c++;
+            if (heap[c].priority <= last.priority) break;
+            heap[i] = heap[c];
+            i = c;
+        }
+        heap[i] = last;
+    }
+    return top;
+}
+
+const lodFrustum = new THREE.Frustum();
+const lodMatrix = new THREE.Matrix4();
+const lodSphere = new THREE.Sphere();
+const lastLodView = new Float64Array(18);
+
+function lodViewChanged() {
+    camera.updateMatrixWorld();
+    const e = camera.matrixWorld.elements;
+    let changed = false;
+    for (let i = 0; i < 16; i++) {
+        if (lastLodView[i] !== e[i]) { changed = true; lastLodView[i] = e[i]; }
+    }
+    if (lastLodView[16] !== camera.projectionMatrix.elements[0]) { changed = true; lastLodView[16] = camera.projectionMatrix.elements[0]; }
+    if (lastLodView[17] !== renderer.domElement.height) { changed = true; lastLodView[17] = renderer.domElement.height; }
+    return changed;
+}
+
+function updateLod() {
+    pointsRoot.updateMatrixWorld();
+    lodMatrix.multiplyMatrices(camera.projectionMatrix, camera.matrixWorldInverse);
+    lodFrustum.setFromProjectionMatrix(lodMatrix);
+    const projFactor = renderer.domElement.height * 0.5 / Math.tan(camera.fov * Math.PI / 360);
+    const nodes = octree.nodes, objects = octree.objects;
+    for (const obj of objects) obj.visible = false;
+
+    const heap = [{ index: 0, priority: Infinity }];
+    let drawn = 0;
+    while (heap.length > 0) {
+        const item = heapPop(heap);
+        const node = nodes[item.index];
+        if (drawn + node.count > POINT_BUDGET) continue;
+        objects[item.index].visible = true;
+        drawn += node.count;
+        for (const childIndex of node.children) {
+            const child = nodes[childIndex];
+            lodSphere.center.set(child.center[0], child.center[1], child.center[2]).applyMatrix4(pointsRoot.matrixWorld);
+            lodSphere.radius = child.radius;
+            if (!lodFrustum.intersectsSphere(lodSphere)) continue;
+            const dist = lodSphere.center.distanceTo(camera.position) - child.radius;
+            const projected = dist > 0 ? node.spacing / dist * projFactor : Infinity;
+            if (projected > LOD_MIN_SPACING_PX) {
+                heapPush(heap, { index: childIndex, priority: projected });
+            }
+        }
+    }
+    document.getElementById('pointCount').textContent = cloud.count + ' (' + drawn + ' drawn)';
+}
+
+// ---- Display ----
+function disposeDisplay() {
+    if (pointsObj) {
+        pointsRoot.remove(pointsObj);
+        geometry.dispose();
+        pointsObj = null;
+        geometry = null;
+    }
+    if (octree) {
+        pointsRoot.remove(octree.group);
+        for (const obj of octree.objects) obj.geometry.dispose();
+        octree = null;
+    }
+}
+
+// One Points object over the whole arrays, drawing the first c.count points
+function showSinglePoints(c) {
+    disposeDisplay();
+    geometry = new THREE.BufferGeometry();
+    geometry.setAttribute('position', new THREE.BufferAttribute(c.positions, 3));
+    if (c.colors) geometry.setAttribute('rgb', new THREE.BufferAttribute(c.colors, 3, true));
+    if (c.intensity) geometry.setAttribute('intensity', new THREE.BufferAttribute(c.intensity, 1));
+    geometry.setDrawRange(0, c.count);
+    pointsObj = new THREE.Points(geometry, pointsMaterial);
+    // The arrays may be longer than the drawn points while streaming
+    pointsObj.frustumCulled = false;
+    pointsRoot.add(pointsObj);
+}
+
+// Show a complete cloud: drawn whole right away, replaced by its octree
+// once that is built
+function setCloud(newCloud) {
+    octreeBuildId++;
+    cloud = newCloud;
+    updateBounds();
+    updateFieldButtons();
+    showSinglePoints(cloud);
+    if (currentColorMode !== 'solid') {
+        updateColors(currentColorMode, false);
+    }
+    const renderStart = performance.now();
+    renderer.render(scene, camera);
+    reportRendered(true, performance.now() - renderStart);
+    if (cloud.count >= OCTREE_MIN_POINTS) {
+        requestOctree();
+    }
+    reportMemoryUsage();
+}
+
+// The benchmark harness times the first frame of new points: 'rendered' is
+// posted after it, with complete false while a stream is still coming in.
+// Decode and render times go to the extension's performance trace.
+let lastDecodeMs;
+function reportRendered(complete, renderMs) {
+    vscode.postMessage({ command: 'rendered', complete, decodeMs: lastDecodeMs, renderMs });
+    lastDecodeMs = undefined;
+}
+
+function decodeCloudTimed(message) {
+    const start = performance.now();
+    const decoded = decodeCloud(message);
+    lastDecodeMs = performance.now() - start;
+    return decoded;
+}
+
+// Footprint for the extension's memory budget: the arrays here and their GPU copies
+function reportMemoryUsage() {
+    const bytes = cloud.positions.byteLength +
+        (cloud.colors ? cloud.colors.byteLength : 0) +
+        (cloud.intensity ? cloud.intensity.byteLength : 0);
+    vscode.postMessage({ command: 'memoryUsage', bytes: bytes * 2 });
+}
+
+// The extension replaces a released panel's page with this snapshot of the view.
+// The WebGL canvas is only readable right after a render, in the same task.
+const THUMBNAIL_SIZE = 320;
+function makeThumbnail() {
+    renderer.render(scene, camera);
+    const source = renderer.domElement;
+    if (!source.width || !source.height) return null;
+    const t = Math.min(1, THUMBNAIL_SIZE / Math.max(source.width, source.height));
+    const thumb = document.createElement('canvas');
+    thumb.width = Math.max(1, Math.round(source.width * t));
+    thumb.height = Math.max(1, Math.round(source.height * t));
+    thumb.getContext('2d').drawImage(source, 0, 0, thumb.width, thumb.height);
+    return thumb.toDataURL('image/jpeg', 0.8);
+}
+
+// Function to initialize point cloud with data
+function initializePointCloud(newCloud) {
+    setCloud(newCloud);
+
+    // Hide loading overlay
+    loadingOverlay.classList.add('hidden');
+
+    if (pendingSyncState) {
+        applyViewState(pendingSyncState);
+        pendingSyncState = null;
+    } else if (!isInitialized) {
+        resetView();
+    }
+
+    isInitialized = true;
+    renderer.render(scene, camera);
+}
+
+function resetView() {
+    const centerX = (minX + maxX) / 2;
+    const centerY = (minZ + maxZ) / 2;  // Three.js Y = World Z
+    const centerZ = -(minY + maxY) / 2; // Three.js Z = -World Y
+
+    const dist = Math.max(maxX - minX, maxY - minY, maxZ - minZ) * 1.5;
+
+    // Fixed isometric-like view: from front-right-top corner
+    camera.position.set(centerX + dist * 0.7, centerY + dist * 0.7, centerZ + dist * 0.7);
+    camera.up.set(0, 1, 0); // Y is up
+    camera.lookAt(centerX, centerY, centerZ);
+    controls.target.set(centerX, centerY, centerZ);
+    controls.update();
+
+    // Emit view change for sync
+    emitViewChange(true);
+}
+
+// Initialize with embedded data if available
+if (cloud.count > 0) {
+    initializePointCloud(cloud);
+}
+
+function getAxisBounds(mode) {
+    if (mode === 'x') return { min: minX, max: maxX };
+    if (mode === 'y') return { min: minY, max: maxY };
+    if (mode === 'z') return { min: minZ, max: maxZ };
+    if (mode === 'intensity') return { min: minIntensity, max: maxIntensity };
+    return { min: 0, max: 1 };
+}
+
+function updateColorbarUI() {
+    if (currentColorMode === 'solid' || currentColorMode === 'rgb') return;
+
+    const bounds = getAxisBounds(currentColorMode);
+    const effectiveMin = (colorCustomMin !== null) ? colorCustomMin : bounds.min;
+    const effectiveMax = (colorCustomMax !== null) ? colorCustomMax : bounds.max;
+
+    const colorbarMaxInput = document.getElementById('colorbar-max-input');
+    const colorbarMinInput = document.getElementById('colorbar-min-input');
+    const colorbarMid = document.getElementById('colorbar-mid');
+    const sliderMax = document.getElementById('sliderMax');
+    const sliderMin = document.getElementById('sliderMin');
+
+    colorbarMaxInput.value = effectiveMax.toPrecision(4);
+    colorbarMinInput.value = effectiveMin.toPrecision(4);
+    colorbarMid.textContent = ((effectiveMin + effectiveMax) / 2).toPrecision(4);
+
+    // Update slider positions
+    const range = bounds.max - bounds.min || 1;
+    const maxPos = Math.max(0, Math.min(1, (bounds.max - effectiveMax) / range));
+    const minPos = Math.max(0, Math.min(1, (effectiveMin - bounds.min) / range));
+
+    sliderMax.style.top = (maxPos * (SLIDER_TRACK_HEIGHT - 6)) + 'px';
+    sliderMin.style.top = 'auto';
+    sliderMin.style.bottom = (minPos * (SLIDER_TRACK_HEIGHT - 6)) + 'px';
+}
+
+// The colormap runs in the vertex shader, so a new range or mode only
+// changes uniforms
+function applyColorsWithLimits() {
+    if (currentColorMode === 'solid' || currentColorMode === 'rgb') return;
+
+    const bounds = getAxisBounds(currentColorMode);
+    const effectiveMin = (colorCustomMin !== null) ? colorCustomMin : bounds.min;
+    const effectiveMax = (colorCustomMax !== null) ? colorCustomMax : bounds.max;
+    const range = effectiveMax - effectiveMin || 1;
+
+    pointsMaterial.uniforms.u_min.value = effectiveMin;
+    pointsMaterial.uniforms.u_max.value = effectiveMin + range;
+}
+
+function applyColorsDebounced() {
+    // Cheap enough to follow the slider directly
+    applyColorsWithLimits();
+}
+
+function updateColors(mode, resetLimits = true) {
+    const colorbar = document.getElementById('colorbar');
+    const colorbarTitle = document.getElementById('colorbar-title');
+
+    currentColorMode = mode;
+    pointsMaterial.uniforms.u_mode.value = COLOR_MODE_IDS[mode];
+
+    if (resetLimits) {
+        colorCustomMin = null;
+        colorCustomMax = null;
+    }
+
+    if (mode === 'solid' || mode === 'rgb') {
+        colorbar.style.display = 'none';
+    } else {
+        colorbar.style.display = 'block';
+        colorbarTitle.textContent = 'Color by ' + (mode === 'intensity' ? 'Intensity' : mode.toUpperCase());
+        updateColorbarUI();
+        applyColorsWithLimits();
+    }
+}
+
+document.getElementById('btnSolid').onclick = () => { updateColors('solid'); updateColorButtons('solid'); };
+document.getElementById('btnHeightX').onclick = () => { updateColors('x'); updateColorButtons('x'); };
+document.getElementById('btnHeightY').onclick = () => { updateColors('y'); updateColorButtons('y'); };
+document.getElementById('btnHeightZ').onclick = () => { updateColors('z'); updateColorButtons('z'); };
+document.getElementById('btnRGB').onclick = () => { updateColors('rgb'); updateColorButtons('rgb'); };
+document.getElementById('btnIntensity').onclick = () => { updateColors('intensity'); updateColorButtons('intensity'); };
+document.getElementById('btnViewAuto').onclick = resetView;
+document.getElementById('btnResetAll').onclick = () => {
+    resetView();
+    updateColors('solid');
+    updateColorButtons('solid');
+    document.getElementById('pointSizeInput').value = '0.1';
+    pointsMaterial.uniforms.u_size.value = 0.1;
+    document.getElementById('plyFormatSelect').value = 'ply-binary';
+};
+document.getElementById('btnReload').onclick = () => {
+    vscode.postMessage({ command: 'reload' });
+};
+
+// Update color button active state
+function updateColorButtons(mode) {
+    document.querySelectorAll('.color-btn').forEach(btn => btn.classList.remove('active'));
+    if (mode === 'solid') document.getElementById('btnSolid').classList.add('active');
+    else if (mode === 'x') document.getElementById('btnHeightX').classList.add('active');
+    else if (mode === 'y') document.getElementById('btnHeightY').classList.add('active');
+    else if (mode === 'z') document.getElementById('btnHeightZ').classList.add('active');
+    else if (mode === 'rgb') document.getElementById('btnRGB').classList.add('active');
+    else if (mode === 'intensity') document.getElementById('btnIntensity').classList.add('active');
+}
+
+// View angle buttons (like CloudCompare)
+// Note: In Three.js, Y is up. Our coordinate mapping:
+// - World X (Right) -> Three.js X
+// - World Y (Forward) -> Three.js -Z
+// - World Z (Up) -> Three.js Y
+function setViewAngle(direction) {
+    if (!isInitialized) return;
+
+    const centerX = (minX + maxX) / 2;
+    const centerY = (minZ + maxZ) / 2;  // Three.js Y = World Z
+    const centerZ = -(minY + maxY) / 2; // Three.js Z = -World Y
+
+    const dist = Math.max(maxX - minX, maxY - minY, maxZ - minZ) * 1.5;
+
+    let camPos;
+    let upVec = new THREE.Vector3(0, 1, 0); // Default up is Y (World Z)
+
+    switch (direction) {
+        case 'top':    // Looking down from Z+ (World Z+)
+            camPos = new THREE.Vector3(centerX, centerY + dist, centerZ);
+            upVec = new THREE.Vector3(0, 0, -1); // Forward is -Z (World Y+)
+            break;
+        case 'bottom': // Looking up from Z- (World Z-)
+            camPos = new THREE.Vector3(centerX, centerY - dist, centerZ);
+            upVec = new THREE.Vector3(0, 0, 1); // Forward is +Z (World Y-)
+            break;
+        case 'front':  // Looking from Y- (World Y-), seeing front face
+            camPos = new THREE.Vector3(centerX, centerY, centerZ + dist);
+            break;
+        case 'back':   // Looking from Y+ (World Y+), seeing back face
+            camPos = new THREE.Vector3(centerX, centerY, centerZ - dist);
+            break;
+        case 'left':   // Looking from X- (World X-)
+            camPos = new THREE.Vector3(centerX - dist, centerY, centerZ);
+            break;
+        case 'right':  // Looking from X+ (World X+)
+            camPos = new THREE.Vector3(centerX + dist, centerY, centerZ);
+            break;
+        default:
+            return;
+    }
+
+    camera.position.copy(camPos);
+    camera.up.copy(upVec);
+    camera.lookAt(centerX, centerY, centerZ);
+    controls.target.set(centerX, centerY, centerZ);
+    controls.update();
+
+    // Emit view change for sync
+    emitViewChange(true);
+}
+
+document.getElementById('btnViewTop').onclick = () => setViewAngle('top');
+document.getElementById('btnViewBottom').onclick = () => setViewAngle('bottom');
+document.getElementById('btnViewFront').onclick = () => setViewAngle('front');
+document.getElementById('btnViewBack').onclick = () => setViewAngle('back');
+document.getElementById('btnViewLeft').onclick = () => setViewAngle('left');
+document.getElementById('btnViewRight').onclick = () => setViewAngle('right');
+document.getElementById('pointSizeInput').oninput = (e) => {
+    const size = parseFloat(e.target.value);
+    if (!isNaN(size)) {
+        pointsMaterial.uniforms.u_size.value = size;
+    }
+};
+
+// Toggle controls visibility
+const controlsEl = document.getElementById('controls');
+const toggleControlsBtn = document.getElementById('toggleControls');
+toggleControlsBtn.addEventListener('click', (e) => {
+    e.stopPropagation();
+    const isCollapsed = controlsEl.classList.toggle('collapsed');
+    toggleControlsBtn.textContent = isCollapsed ? '▶' : '▼';
+});
+
+// Colorbar slider dragging
+let draggingSlider = null;
+let sliderStartY = 0;
+let sliderStartTop = 0;
+
+function onSliderMouseDown(e, slider, isMax) {
+    e.preventDefault();
+    e.stopPropagation();
+    draggingSlider = { slider, isMax };
+    slider.classList.add('dragging');
+    sliderStartY = e.clientY;
+    const rect = slider.getBoundingClientRect();
+    const trackRect = slider.parentElement.getBoundingClientRect();
+    sliderStartTop = rect.top - trackRect.top;
+}
+
+const sliderMaxEl = document.getElementById('sliderMax');
+const sliderMinEl = document.getElementById('sliderMin');
+
+sliderMaxEl.addEventListener('mousedown', (e) => onSliderMouseDown(e, sliderMaxEl, true));
+sliderMinEl.addEventListener('mousedown', (e) => onSliderMouseDown(e, sliderMinEl, false));
+
+document.addEventListener('mousemove', (e) => {
+    if (!draggingSlider) return;
+
+    const { slider, isMax } = draggingSlider;
+    const deltaY = e.clientY - sliderStartY;
+    let newTop = sliderStartTop + deltaY;
+
+    // Clamp to track bounds
+    newTop = Math.max(0, Math.min(SLIDER_TRACK_HEIGHT - 6, newTop));
+
+    if (isMax) {
+        slider.style.top = newTop + 'px';
+    } else {
+        slider.style.top = 'auto';
+        slider.style.bottom = (SLIDER_TRACK_HEIGHT - 6 - newTop) + 'px';
+    }
+
+    // Calculate value from position
+    const bounds = getAxisBounds(currentColorMode);
+    const range = bounds.max - bounds.min || 1;
+    const normalizedPos = newTop / (SLIDER_TRACK_HEIGHT - 6);
+
+    const colorbarMaxInput = document.getElementById('colorbar-max-input');
+    const colorbarMinInput = document.getElementById('colorbar-min-input');
+    const colorbarMid = document.getElementById('colorbar-mid');
+
+    if (isMax) {
+        colorCustomMax = bounds.max - normalizedPos * range;
+        colorbarMaxInput.value = colorCustomMax.toPrecision(4);
+    } else {
+        colorCustomMin = bounds.max - normalizedPos * range;
+        colorbarMinInput.value = colorCustomMin.toPrecision(4);
+    }
+
+    // Update mid value
+    const effectiveMin = (colorCustomMin !== null) ? colorCustomMin : bounds.min;
+    const effectiveMax = (colorCustomMax !== null) ? colorCustomMax : bounds.max;
+    colorbarMid.textContent = ((effectiveMin + effectiveMax) / 2).toPrecision(4);
+
+    applyColorsDebounced();
+});
+
+document.addEventListener('mouseup', () => {
+    if (draggingSlider) {
+        draggingSlider.slider.classList.remove('dragging');
+        draggingSlider = null;
+        // Apply final colors immediately
+        applyColorsWithLimits();
+    }
+});
+
+// Input field change handlers
+document.getElementById('colorbar-max-input').addEventListener('change', (e) => {
+    const val = parseFloat(e.target.value);
+    if (!isNaN(val)) {
+        colorCustomMax = val;
+        updateColorbarUI();
+        applyColorsWithLimits();
+    }
+});
+
+document.getElementById('colorbar-min-input').addEventListener('change', (e) => {
+    const val = parseFloat(e.target.value);
+    if (!isNaN(val)) {
+        colorCustomMin = val;
+        updateColorbarUI();
+        applyColorsWithLimits();
+    }
+});
+
+// Reset button
+document.getElementById('colorbar-reset').addEventListener('click', () => {
+    colorCustomMin = null;
+    colorCustomMax = null;
+    updateColorbarUI();
+    applyColorsWithLimits();
+});
+
+document.getElementById('btnSavePLY').onclick = () => {
+    const format = document.getElementById('plyFormatSelect').value;
+    vscode.postMessage({ command: 'savePointCloud', format: format });
+};
+
+let isSyncing = false;
+let isShuttingDown = false;
+
+window.addEventListener('message', event => {
+    const message = event.data;
+    if (message.command === 'ready') {
+        // Extension is ready, this is not a moved panel
+        extensionReady = true;
+    } else if (message.command === 'completeData') {
+        // Received point cloud data via postMessage
+        extensionReady = true;
+        loadingOverlay.classList.remove('hidden');
+        loadingText.textContent = 'Initializing point cloud...';
+
+        setTimeout(() => {
+            try {
+                initializePointCloud(decodeCloudTimed(message));
+            } catch (e) {
+                console.error('Failed to initialize point cloud:', e);
+                loadingText.textContent = 'Failed to load: ' + e.message;
+            }
+        }, 10);
+    } else if (message.command === 'setView') {
+        const state = message.state;
+        if (!isInitialized) {
+            pendingSyncState = state;
+            return;
+        }
+        applyViewState(state);
+    } else if (message.command === 'releaseData') {
+        vscode.postMessage({ command: 'released', thumbnail: makeThumbnail() });
+    } else if (message.command === 'recordingState') {
+        timeline.update(message);
+    } else if (message.command === 'updateData') {
+        updatePointCloudData(decodeCloudTimed(message));
+    } else if (message.command === 'streamBegin') {
+        extensionReady = true;
+        beginStream(message);
+    } else if (message.command === 'pointChunk') {
+        if (stream) appendChunk(decodeCloud(message));
+    } else if (message.command === 'streamEnd') {
+        if (stream) endStream();
+    } else if (message.command === 'streamAbort') {
+        if (stream && stream.preview && stream.count === 0) {
+            loadingText.textContent = 'Failed to read point cloud';
+        }
+        stream = null;
+    }
+});
+
+// ---- Streaming ----
+// Large clouds arrive as streamBegin, pointChunk..., streamEnd. A first
+// load shows the points as they come in; a reload keeps the old cloud on
+// screen until the new one is complete.
+let stream = null;
+let userMovedView = false;
+
+function beginStream(message) {
+    const total = message.total;
+    stream = {
+        count: 0,
+        positions: new Float32Array(total * 3),
+        colors: message.hasColors ? new Uint8Array(total * 3) : null,
+        intensity: message.hasIntensity ? new Float32Array(total) : null,
+        preview: !isInitialized,
+        autoView: false
+    };
+    userMovedView = false;
+    if (stream.preview) {
+        loadingOverlay.classList.remove('hidden');
+        loadingText.textContent = 'Reading 0 / ' + total + ' points...';
+    }
+}
+
+// Queue the upload of [offset, offset + count) of an attribute; the bundled
+// three.js keeps a list of pending ranges per attribute
+function markRange(attr, offset, count) {
+    attr.addUpdateRange(offset, count);
+    attr.needsUpdate = true;
+}
+
+function appendChunk(chunk) {
+    const first = stream.count;
+    stream.positions.set(chunk.positions, first * 3);
+    if (stream.colors && chunk.colors) stream.colors.set(chunk.colors, first * 3);
+    if (stream.intensity && chunk.intensity) stream.intensity.set(chunk.intensity, first);
+    stream.count += chunk.count;
+    if (!stream.preview || chunk.count === 0) return;
+
+    if (!pointsObj || geometry.attributes.position.array !== stream.positions) {
+        // First points: show the partial cloud and frame it
+        octreeBuildId++;
+        cloud = { count: stream.count, positions: stream.positions, colors: stream.colors, intensity: stream.intensity };
+        updateBounds();
+        updateFieldButtons();
+        showSinglePoints(cloud);
+        loadingOverlay.classList.add('hidden');
+        isInitialized = true;
+        if (pendingSyncState) {
+            applyViewState(pendingSyncState);
+            pendingSyncState = null;
+        } else {
+            resetView();
+            stream.autoView = true;
+        }
+        requestAnimationFrame(() => reportRendered(false));
+    } else {
+        cloud.count = stream.count;
+        extendBounds(first, stream.count);
+        publishBounds();
+        markRange(geometry.attributes.position, first * 3, chunk.count * 3);
+        if (stream.colors) markRange(geometry.attributes.rgb, first * 3, chunk.count * 3);
+        if (stream.intensity) markRange(geometry.attributes.intensity, first, chunk.count);
+        geometry.setDrawRange(0, stream.count);
+    }
+    if (currentColorMode !== 'solid') {
+        updateColors(currentColorMode, false);
+    }
+}
+
+function endStream() {
+    const s = stream;
+    stream = null;
+    const n = s.count;
+    if (n === 0) {
+        if (s.preview) loadingText.textContent = 'No valid points';
+        return;
+    }
+    const finalCloud = {
+        count: n,
+        positions: s.positions.subarray(0, n * 3),
+        colors: s.colors ? s.colors.subarray(0, n * 3) : null,
+        intensity: s.intensity ? s.intensity.subarray(0, n) : null
+    };
+    if (!s.preview || !isInitialized) {
+        updatePointCloudData(finalCloud);
+        return;
+    }
+    setCloud(finalCloud);
+    // The view was framed on the first chunk; reframe on the whole cloud
+    if (s.autoView && !userMovedView) {
+        resetView();
+    }
+}
+
+function updatePointCloudData(newCloud) {
+    // If nothing is displayed yet, use initializePointCloud instead
+    if (!isInitialized) {
+        initializePointCloud(newCloud);
+        return;
+    }
+
+    // Bounds, field buttons and the color range follow the new cloud; the
+    // camera stays where it is
+    setCloud(newCloud);
+}
+
+function applyViewState(state) {
+    isSyncing = true;
+    if (state.cameraPosition) {
+        camera.position.set(state.cameraPosition.x, state.cameraPosition.y, state.cameraPosition.z);
+    }
+    if (state.cameraQuaternion) {
+        camera.quaternion.set(state.cameraQuaternion.x, state.cameraQuaternion.y, state.cameraQuaternion.z, state.cameraQuaternion.w);
+    }
+    if (state.cameraUp) {
+        camera.up.set(state.cameraUp.x, state.cameraUp.y, state.cameraUp.z);
+    }
+    if (state.controlsTarget) {
+        controls.target.set(state.controlsTarget.x, state.controlsTarget.y, state.controlsTarget.z);
+    }
+    controls.update();
+
+    // Force a render immediately after sync
+    renderer.render(scene, camera);
+    updateAxisView();
+
+    isSyncing = false;
+}
+
+let lastSyncTime = 0;
+function emitViewChange(force = false) {
+    if (isSyncing || !isInitialized || isShuttingDown) return;
+    const now = Date.now();
+    if (!force && (now - lastSyncTime < 30)) return; // Throttle to ~30fps
+    lastSyncTime = now;
+
+    vscode.postMessage({
+        command: 'viewChanged',
+        state: {
+            cameraPosition: { x: camera.position.x, y: camera.position.y, z: camera.position.z },
+            cameraQuaternion: { x: camera.quaternion.x, y: camera.quaternion.y, z: camera.quaternion.z, w: camera.quaternion.w },
+            cameraUp: { x: camera.up.x, y: camera.up.y, z: camera.up.z },
+            controlsTarget: { x: controls.target.x, y: controls.target.y, z: controls.target.z }
+        }
+    });
+}
+
+controls.addEventListener('change', () => {
+    emitViewChange();
+});
+
+controls.addEventListener('start', () => {
+    userMovedView = true;
+});
+
+controls.addEventListener('end', () => {
+    emitViewChange(true); // Force a final sync on interaction end
+});
+
+function animate() {
+    requestAnimationFrame(animate);
+    controls.update();
+    updateAxisView();
+    const viewChanged = lodViewChanged();
+    if (octree && (lodDirty || viewChanged)) {
+        lodDirty = false;
+        updateLod();
+    }
+    renderer.render(scene, camera);
+}
+animate();
+
+window.addEventListener('resize', () => {
+    camera.aspect = window.innerWidth / window.innerHeight;
+    camera.updateProjectionMatrix();
+    renderer.setSize(window.innerWidth, window.innerHeight);
+    pointsMaterial.uniforms.u_scale.value = renderer.domElement.height * 0.5;
+});
+
+// Mark shutting down to block further interactions/sync
+window.addEventListener('beforeunload', () => {
+    isShuttingDown = true;
+});
+document.addEventListener('visibilitychange', () => {
+    if (document.visibilityState === 'hidden') {
+        isShuttingDown = true;
+    }
+});
@@ -0,0 +1,99 @@
+import * as assert from 'assert';
+import { execSync } from 'child_process';
+import * as path from 'path';
+import * as vscode from 'vscode';
+import { runBenchmarks, type BenchDebugger, type ExtensionApi } from './bench/benchDriver';
+import { compareReports, formatChanges, readReport, writeReport, type BenchReport, type BenchResult } from './bench/benchReport';
+
+// End-to-end latency benchmark against test_cpp's bench_debugmate. Skipped
+// unless CVDM_BENCH_PROGRAM points at the built debuggee:
+//
+//   CVDM_BENCH_PROGRAM      path of bench_debugmate
+//   CVDM_BENCH_DEBUGGERS    comma-separated cppdbg,lldb,cppvsdbg (default: the platform's usual one)
+//   CVDM_BENCH_FILTER       only workloads whose name contains this, e.g. "mat_8U"
+//   CVDM_BENCH_MAX_MB       skip workloads larger than this (default 1024)
+//   CVDM_BENCH_REPORT       where to write the JSON report (default bench-report.json)
+//   CVDM_BENCH_BASELINE     report of an earlier commit to compare with
+//   CVDM_BENCH_MAX_REGRESSION  fail when a metric is worse than the baseline by more than this fraction
+
+const program = process.env.CVDM_BENCH_PROGRAM;
+const EXTENSION_ID = 'zwdai.cv-debugmate-cpp';
+
+function defaultDebuggers(): BenchDebugger[] {
+    if (process.platform === 'win32') {
+        return ['cppvsdbg'];
+    }
+    return process.platform === 'darwin' ? ['lldb'] : ['cppdbg'];
+}
+
+function currentCommit(): string {
+    if (process.env.CVDM_BENCH_COMMIT) {
+        return process.env.CVDM_BENCH_COMMIT;
+    }
+    try {
+        return execSync('git rev-parse --short HEAD', { cwd: __dirname }).toString().trim();
+    } catch {
+        return 'unknown';
+    }
+}
+
+(program ? suite : suite.skip)('Benchmark', () => {
+
+    test('bench_debugmate workloads', async function () {
+        this.timeout(0);
+        const extension = vscode.extensions.getExtension(EXTENSION_ID);
+        assert.ok(extension, `${EXTENSION_ID} is not loaded`);
+        const api = (await extension.activate()) as ExtensionApi;
+
+        const debuggers = process.env.CVDM_BENCH_DEBUGGERS
+            ? process.env.CVDM_BENCH_DEBUGGERS.split(',').map((d) => d.trim() as BenchDebugger)
+            : defaultDebuggers();
+        const options = {
+            program: program!,
+            source: path.resolve(__dirname, '../../test_cpp/bench_main.cpp'),
+            filter: process.env.CVDM_BENCH_FILTER || '',
+            maxMB: Number(process.env.CVDM_BENCH_MAX_MB) || 1024,
+            caseTimeoutMs: 10 * 60 * 1000,
+        };
+
+        const results: BenchResult[] = [];
+        for (const type of debuggers) {
+            try {
+                results.push(...await runBenchmarks(type, options, api, (line) => console.log(`[bench] ${line}`)));
+            } catch (e: any) {
+                console.log(`[bench] ${type}: ${e?.message || e}`);
+                results.push({
+                    debugger: type, case: '(session)', kind: '', bytes: 0,
+                    timeToMetadataMs: null, readMBps: null, timeToFirstPixelMs: null, fullRenderMs: null,
+                    error: e?.message || String(e),
+                });
+            }
+        }
+
+        const report: BenchReport = {
+            version: 1,
+            commit: currentCommit(),
+            date: new Date().toISOString(),
+            platform: `${process.platform}-${process.arch}`,
+            vscode: vscode.version,
+            results,
+        };
+        const reportFile = path.resolve(process.env.CVDM_BENCH_REPORT || 'bench-report.json');
+        writeReport(reportFile, report);
+        console.log(`[bench] Report written to ${reportFile}`);
+        assert.ok(results.some((r) => !r.error), 'No workload was measured');
+
+        const baselineFile = process.env.CVDM_BENCH_BASELINE;
+        if (baselineFile) {
+            const baseline = readReport(baselineFile);
+            const changes = compareReports(baseline, report);
+            console.log(`[bench] Compared with ${baseline.commit}:\n${formatChanges(changes)}`);
+            const maxRegression = Number(process.env.CVDM_BENCH_MAX_REGRESSION);
+            if (maxRegression > 0) {
+                const regressions = changes.filter((c) => c.regression > maxRegression);
+                assert.strictEqual(regressions.length, 0,
+                    `Slower than ${baseline.commit} by more than ${(maxRegression * 100).toFixed(0)} %:\n${formatChanges(regressions)}`);
+            }
+        }
+    });
+});
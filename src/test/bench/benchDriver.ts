@@ -0,0 +1,329 @@
+import * as fs from 'fs';
+import * as path from 'path';
+import * as vscode from 'vscode';
+import { getMatInfoFromVariables } from '../../matImage/matProvider';
+import {
+    getEvaluateContext,
+    getVectorSize,
+    tryGetDataPointer,
+    buildDataPointerExpressions,
+    readMemoryChunked,
+    readMemoryGathered,
+} from '../../utils/debugger';
+import { MemoryCache } from '../../utils/memoryCache';
+import { getBytesPerElement } from '../../utils/opencv';
+import type { PanelRenderedEvent } from '../../utils/panelManager';
+import type { BenchResult } from './benchReport';
+
+/**
+ * Drives one debugger type through every workload of bench_debugmate
+ * (test_cpp/bench_main.cpp): breakpoints on the BENCH_BREAK lines, and at each
+ * stop
+ *
+ *   1. metadata and a raw read of the element data are timed through the same
+ *      modules (compiled into out/, so with a read cache of their own), before
+ *      anything has asked the debugger about the variable;
+ *   2. the variable is viewed through the extension's own command, timed until
+ *      its viewer reports the first and the complete frame ('rendered').
+ */
+
+export type BenchDebugger = 'cppdbg' | 'lldb' | 'cppvsdbg';
+
+export interface ExtensionApi {
+    onDidRender: vscode.Event<PanelRenderedEvent>;
+}
+
+export interface BenchOptions {
+    program: string;
+    // bench_main.cpp, for its BENCH_BREAK lines
+    source: string;
+    filter: string;
+    maxMB: number;
+    // Per workload: stop, view and measure
+    caseTimeoutMs: number;
+}
+
+const BENCH_VARIABLE = 'bench_var';
+
+export function findBreakLines(source: string): number[] {
+    return fs.readFileSync(source, 'utf8')
+        .split(/\r?\n/)
+        .map((line, i) => (line.includes('// BENCH_BREAK') ? i : -1))
+        .filter((i) => i >= 0);
+}
+
+export function launchConfiguration(type: BenchDebugger, options: BenchOptions): vscode.DebugConfiguration {
+    const common = {
+        name: `bench_debugmate (${type})`,
+        request: 'launch',
+        program: options.program,
+        args: [options.filter || 'all', String(options.maxMB)],
+        cwd: path.dirname(options.program),
+    };
+    if (type === 'cppdbg') {
+        return {
+            ...common,
+            type,
+            MIMode: process.platform === 'darwin' ? 'lldb' : 'gdb',
+            stopAtEntry: false,
+            externalConsole: false,
+        };
+    }
+    if (type === 'cppvsdbg') {
+        return { ...common, type, console: 'internalConsole' };
+    }
+    return { ...common, type };
+}
+
+export async function runBenchmarks(
+    type: BenchDebugger,
+    options: BenchOptions,
+    api: ExtensionApi,
+    log: (line: string) => void
+): Promise<BenchResult[]> {
+    const results: BenchResult[] = [];
+    const stops = new StopQueue();
+    const tracker = vscode.debug.registerDebugAdapterTrackerFactory(type, {
+        createDebugAdapterTracker: () => ({
+            onDidSendMessage: (message: any) => {
+                if (message.type !== 'event') {
+                    return;
+                }
+                if (message.event === 'stopped' && message.body?.reason === 'breakpoint') {
+                    stops.push(message.body.threadId);
+                } else if (message.event === 'terminated' || message.event === 'exited') {
+                    stops.end();
+                }
+            },
+            onExit: () => stops.end(),
+        }),
+    });
+
+    const sourceUri = vscode.Uri.file(options.source);
+    const breakpoints = findBreakLines(options.source).map((line) =>
+        new vscode.SourceBreakpoint(new vscode.Location(sourceUri, new vscode.Position(line, 0))));
+    vscode.debug.addBreakpoints(breakpoints);
+
+    let session: vscode.DebugSession | undefined;
+    const started = new Promise<vscode.DebugSession>((resolve) => {
+        const listener = vscode.debug.onDidStartDebugSession((s) => {
+            if (s.type === type) {
+                listener.dispose();
+                resolve(s);
+            }
+        });
+    });
+    try {
+        if (!await vscode.debug.startDebugging(undefined, launchConfiguration(type, options))) {
+            throw new Error(`Could not start a ${type} session; is its debugger extension installed?`);
+        }
+        session = await started;
+        for (;;) {
+            const threadId = await stops.next(options.caseTimeoutMs);
+            if (threadId === null) {
+                break;
+            }
+            const result = await measureCase(session, type, threadId, api, options.caseTimeoutMs);
+            log(describe(result));
+            results.push(result);
+            await session.customRequest('continue', { threadId });
+        }
+    } finally {
+        tracker.dispose();
+        vscode.debug.removeBreakpoints(breakpoints);
+        if (session) {
+            await vscode.debug.stopDebugging(session);
+        }
+    }
+    return results;
+}
+
+async function measureCase(
+    session: vscode.DebugSession,
+    type: BenchDebugger,
+    threadId: number,
+    api: ExtensionApi,
+    timeoutMs: number
+): Promise<BenchResult> {
+    const stack = await session.customRequest('stackTrace', { threadId, startFrame: 0, levels: 1 });
+    const frameId: number = stack.stackFrames[0].id;
+    const context = getEvaluateContext(session);
+    const caseResponse = await session.customRequest('evaluate', { expression: 'bench_case', frameId, context });
+    const name = (String(caseResponse.result).match(/"([^"]*)"/) || [])[1] || String(caseResponse.result);
+    const result: BenchResult = {
+        debugger: type,
+        case: name,
+        kind: name.split('_')[0],
+        bytes: 0,
+        timeToMetadataMs: null,
+        readMBps: null,
+        timeToFirstPixelMs: null,
+        fullRenderMs: null,
+    };
+
+    try {
+        // The extension views the user-selected frame; wait until it is this stop's
+        await waitFor(() => {
+            const item = vscode.debug.activeStackItem;
+            return !!item && item.session.id === session.id && 'frameId' in item && item.threadId === threadId;
+        }, timeoutMs);
+
+        MemoryCache.clearSession(session.id);
+        const metadataStart = Date.now();
+        const variable = await session.customRequest('evaluate', { expression: BENCH_VARIABLE, frameId, context });
+        const layout = await readLayout(session, result.kind, frameId, variable);
+        result.timeToMetadataMs = Date.now() - metadataStart;
+        result.bytes = layout.bytes;
+
+        if (layout.read) {
+            const readStart = Date.now();
+            const buffer = await layout.read();
+            const seconds = (Date.now() - readStart) / 1000;
+            if (!buffer || buffer.length < layout.bytes) {
+                throw new Error('Read of the element data failed');
+            }
+            result.readMBps = layout.bytes / (1 << 20) / Math.max(seconds, 0.001);
+        }
+        // The buffer is not needed while the extension reads its own copy
+        MemoryCache.clearSession(session.id);
+
+        const render = await timeRender(session, api, timeoutMs, () =>
+            vscode.commands.executeCommand('extension.viewVariable', {
+                variable: { name: BENCH_VARIABLE, evaluateName: BENCH_VARIABLE },
+            }));
+        result.timeToFirstPixelMs = render.firstPixelMs;
+        result.fullRenderMs = render.fullRenderMs;
+        await vscode.commands.executeCommand('workbench.action.closeAllEditors');
+    } catch (e: any) {
+        result.error = e?.message || String(e);
+    }
+    return result;
+}
+
+/**
+ * Size of the workload's element data, and how to read it in one go (none for
+ * sets, whose elements are not contiguous).
+ */
+async function readLayout(
+    session: vscode.DebugSession,
+    kind: string,
+    frameId: number,
+    variable: any
+): Promise<{ bytes: number; read?: () => Promise<Buffer | null> }> {
+    if (kind === 'mat') {
+        const info = await getMatInfoFromVariables(session, variable.variablesReference, variable.type);
+        const rowBytes = info.cols * info.channels * getBytesPerElement(info.depth);
+        const step = Math.max(info.step, rowBytes);
+        return {
+            bytes: info.rows * rowBytes,
+            read: () => readMemoryGathered(session, info.dataPtr, info.rows, rowBytes, step),
+        };
+    }
+
+    const info = { ...variable, value: variable.result };
+    const size = await getVectorSize(session, BENCH_VARIABLE, frameId, info);
+    if (kind === 'set') {
+        return { bytes: 0 };
+    }
+    const dataPtr = await tryGetDataPointer(
+        session,
+        BENCH_VARIABLE,
+        buildDataPointerExpressions(session, BENCH_VARIABLE),
+        frameId,
+        getEvaluateContext(session),
+        variable.type
+    );
+    if (!dataPtr) {
+        throw new Error('No data pointer');
+    }
+    const bytes = size * (kind === 'cloud' ? 12 : 4);
+    return { bytes, read: () => readMemoryChunked(session, dataPtr, bytes) };
+}
+
+async function timeRender(
+    session: vscode.DebugSession,
+    api: ExtensionApi,
+    timeoutMs: number,
+    view: () => Thenable<unknown>
+): Promise<{ firstPixelMs: number | null; fullRenderMs: number | null }> {
+    const start = Date.now();
+    let firstPixelMs: number | null = null;
+    let fullRenderMs: number | null = null;
+    let done: () => void = () => {};
+    const complete = new Promise<void>((resolve) => { done = resolve; });
+    const listener = api.onDidRender((event) => {
+        if (event.sessionId !== session.id || event.variableName !== BENCH_VARIABLE) {
+            return;
+        }
+        if (firstPixelMs === null) {
+            firstPixelMs = event.time - start;
+        }
+        if (event.complete && fullRenderMs === null) {
+            fullRenderMs = event.time - start;
+            done();
+        }
+    });
+    let timer: ReturnType<typeof setTimeout> | undefined;
+    const timedOut = new Promise<void>((resolve) => { timer = setTimeout(resolve, timeoutMs); });
+    try {
+        await view();
+        await Promise.race([complete, timedOut]);
+    } finally {
+        clearTimeout(timer);
+        listener.dispose();
+    }
+    return { firstPixelMs, fullRenderMs };
+}
+
+class StopQueue {
+    private stops: number[] = [];
+    private ended = false;
+    private wake: (() => void) | null = null;
+
+    push(threadId: number) {
+        this.stops.push(threadId);
+        this.wake?.();
+    }
+
+    end() {
+        this.ended = true;
+        this.wake?.();
+    }
+
+    // The next stop's thread, or null once the program ended (or stopped stopping)
+    async next(timeoutMs: number): Promise<number | null> {
+        const deadline = Date.now() + timeoutMs;
+        while (this.stops.length === 0 && !this.ended && Date.now() < deadline) {
+            await new Promise<void>((resolve) => {
+                this.wake = resolve;
+                setTimeout(resolve, Math.max(0, deadline - Date.now()));
+            });
+            this.wake = null;
+        }
+        return this.stops.shift() ?? null;
+    }
+}
+
+async function waitFor(condition: () => boolean, timeoutMs: number) {
+    const deadline = Date.now() + timeoutMs;
+    while (!condition()) {
+        if (Date.now() > deadline) {
+            throw new Error('Timed out waiting for the stopped frame');
+        }
+        await delay(50);
+    }
+}
+
+function delay(ms: number) {
+    return new Promise<void>((resolve) => setTimeout(resolve, ms));
+}
+
+function describe(result: BenchResult): string {
+    if (result.error) {
+        return `${result.debugger} ${result.case}: ${result.error}`;
+    }
+    const ms = (v: number | null) => (v === null ? '-' : `${Math.round(v)} ms`);
+    return `${result.debugger} ${result.case}: metadata ${ms(result.timeToMetadataMs)}, ` +
+        `read ${result.readMBps === null ? '-' : result.readMBps.toFixed(1) + ' MB/s'}, ` +
+        `first pixel ${ms(result.timeToFirstPixelMs)}, full render ${ms(result.fullRenderMs)}`;
+}
@@ -0,0 +1,109 @@
+import * as fs from 'fs';
+
+/**
+ * JSON report of one benchmark run (src/test/bench.test.ts) and the comparison
+ * of two runs, e.g. the merge base and the head of a branch.
+ */
+
+export interface BenchResult {
+    debugger: string;
+    // Workload name printed by bench_debugmate, e.g. "mat_32F_256MB"
+    case: string;
+    kind: string;
+    // Bytes of element data in the workload (0 when not contiguous, e.g. sets)
+    bytes: number;
+    // Evaluate of the variable until size, type and data pointer are known
+    timeToMetadataMs: number | null;
+    // Raw readMemory throughput of the element data, cold read cache
+    readMBps: number | null;
+    // "View" command until the viewer drew its first frame of the new data
+    timeToFirstPixelMs: number | null;
+    // ...until it drew the complete data (same as first pixel when not progressive)
+    fullRenderMs: number | null;
+    error?: string;
+}
+
+export interface BenchReport {
+    version: 1;
+    commit: string;
+    date: string;
+    platform: string;
+    vscode: string;
+    results: BenchResult[];
+}
+
+type MetricKey = 'timeToMetadataMs' | 'readMBps' | 'timeToFirstPixelMs' | 'fullRenderMs';
+
+export const BENCH_METRICS: { key: MetricKey; higherIsBetter: boolean }[] = [
+    { key: 'timeToMetadataMs', higherIsBetter: false },
+    { key: 'readMBps', higherIsBetter: true },
+    { key: 'timeToFirstPixelMs', higherIsBetter: false },
+    { key: 'fullRenderMs', higherIsBetter: false },
+];
+
+export interface BenchChange {
+    debugger: string;
+    case: string;
+    metric: MetricKey;
+    base: number;
+    head: number;
+    // How much worse head is than base: 0.25 = 25 % worse, negative = better
+    regression: number;
+}
+
+export function writeReport(file: string, report: BenchReport) {
+    fs.writeFileSync(file, JSON.stringify(report, null, 2) + '\n');
+}
+
+export function readReport(file: string): BenchReport {
+    const report = JSON.parse(fs.readFileSync(file, 'utf8'));
+    if (!report || report.version !== 1 || !Array.isArray(report.results)) {
+        throw new Error(`${file} is not a C++ DebugMate benchmark report`);
+    }
+    return report as BenchReport;
+}
+
+/**
+ * Metric changes between two reports, for the cases both measured without
+ * error. Sorted worst first.
+ */
+export function compareReports(base: BenchReport, head: BenchReport): BenchChange[] {
+    const baseResults = new Map<string, BenchResult>();
+    for (const result of base.results) {
+        baseResults.set(`${result.debugger}:${result.case}`, result);
+    }
+
+    const changes: BenchChange[] = [];
+    for (const result of head.results) {
+        const before = baseResults.get(`${result.debugger}:${result.case}`);
+        if (!before || before.error || result.error) {
+            continue;
+        }
+        for (const { key, higherIsBetter } of BENCH_METRICS) {
+            const a = before[key];
+            const b = result[key];
+            if (a === null || b === null || !(a > 0) || !(b > 0)) {
+                continue;
+            }
+            changes.push({
+                debugger: result.debugger,
+                case: result.case,
+                metric: key,
+                base: a,
+                head: b,
+                regression: higherIsBetter ? a / b - 1 : b / a - 1,
+            });
+        }
+    }
+    return changes.sort((x, y) => y.regression - x.regression);
+}
+
+export function formatChanges(changes: BenchChange[], limit: number = 20): string {
+    const lines = changes.slice(0, limit).map((c) => {
+        const percent = (c.regression * 100).toFixed(1);
+        return `${c.debugger.padEnd(9)} ${c.case.padEnd(24)} ${c.metric.padEnd(19)} ` +
+            `${c.base.toFixed(1).padStart(10)} -> ${c.head.toFixed(1).padStart(10)}  ` +
+            `${c.regression >= 0 ? '+' : ''}${percent}% ${c.regression > 0 ? 'worse' : 'better'}`;
+    });
+    return lines.join('\n');
+}
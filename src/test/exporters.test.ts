@@ -0,0 +1,108 @@
+import * as assert from 'assert';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { bufferRasterSource, writeTiff, writeNpyImage, writePointCloud } from '../utils/exporters';
+
+suite('Streaming Exporters', () => {
+
+    const tmpFile = (name: string) => path.join(os.tmpdir(), `cv-debugmate-test-${process.pid}-${name}`);
+
+    // 3 rows x 2 cols, 3 channels of CV_16U, sample i = i * 100
+    function makeBgr16(): Buffer {
+        const buffer = Buffer.alloc(3 * 2 * 3 * 2);
+        for (let i = 0; i < 3 * 2 * 3; i++) {
+            buffer.writeUInt16LE(i * 100, i * 2);
+        }
+        return buffer;
+    }
+
+    function readTiffTags(file: Buffer): Map<number, number> {
+        const ifd = file.readUInt32LE(4);
+        const tags = new Map<number, number>();
+        for (let i = 0; i < file.readUInt16LE(ifd); i++) {
+            const entry = ifd + 2 + i * 12;
+            tags.set(file.readUInt16LE(entry), file.readUInt32LE(entry + 8));
+        }
+        return tags;
+    }
+
+    test('TIFF keeps 16-bit samples and writes BGR as RGB', async () => {
+        const file = tmpFile('image.tiff');
+        await writeTiff(file, bufferRasterSource(makeBgr16(), 3, 2, 3, 2));
+        const tiff = fs.readFileSync(file);
+        fs.unlinkSync(file);
+
+        const tags = readTiffTags(tiff);
+        assert.strictEqual(tags.get(256), 2);
+        assert.strictEqual(tags.get(257), 3);
+        assert.strictEqual(tags.get(262), 2);
+        assert.strictEqual(tags.get(279), 36);
+        const strip = tags.get(273)!;
+        assert.strictEqual(tiff.length, strip + 36);
+        const firstPixels = [0, 1, 2, 3, 4, 5].map(i => tiff.readUInt16LE(strip + i * 2));
+        assert.deepStrictEqual(firstPixels, [200, 100, 0, 500, 400, 300]);
+    });
+
+    test('NPY header is 64-byte aligned and describes the Mat', async () => {
+        const file = tmpFile('image.npy');
+        await writeNpyImage(file, bufferRasterSource(makeBgr16(), 3, 2, 3, 2));
+        const npy = fs.readFileSync(file);
+        fs.unlinkSync(file);
+
+        const headerLength = npy.readUInt16LE(8);
+        assert.strictEqual((10 + headerLength) % 64, 0);
+        const header = npy.subarray(10, 10 + headerLength).toString('latin1');
+        assert.ok(header.includes("'descr': '<u2'"));
+        assert.ok(header.includes("'shape': (3, 2, 3)"));
+        assert.strictEqual(npy.length - 10 - headerLength, 36);
+        // Channels stay in memory (BGR) order
+        assert.strictEqual(npy.readUInt16LE(10 + headerLength), 0);
+    });
+
+    test('binary PLY carries colors and intensity per vertex', async () => {
+        const file = tmpFile('cloud.ply');
+        await writePointCloud(file, {
+            count: 2,
+            positions: new Float32Array([1, 2, 3, 4, 5, 6]),
+            colors: new Uint8Array([255, 0, 0, 0, 0, 255]),
+            intensity: new Float32Array([0.5, 1])
+        }, 'ply', 'binary');
+        const ply = fs.readFileSync(file);
+        fs.unlinkSync(file);
+
+        const body = ply.indexOf('end_header\n') + 'end_header\n'.length;
+        assert.ok(ply.subarray(0, body).toString().includes('property uchar red'));
+        // x y z float, r g b uchar, intensity float
+        assert.strictEqual(ply.length - body, 2 * 19);
+        assert.strictEqual(ply.readFloatLE(body + 19), 4);
+        assert.deepStrictEqual([ply[body + 12], ply[body + 13], ply[body + 14]], [255, 0, 0]);
+        assert.strictEqual(ply.readFloatLE(body + 15), 0.5);
+    });
+
+    test('point cloud chunks are built as they are written', async () => {
+        // One ASCII chunk is 65536 lines; reading past it before the first chunk
+        // is on disk means the body was built up front
+        const linesPerChunk = 65536;
+        const count = linesPerChunk + 1;
+        const intensity = new Proxy(new Float32Array(count), {
+            get(target, key) {
+                if (typeof key === 'string' && Number(key) >= linesPerChunk) {
+                    throw new Error('second chunk built');
+                }
+                return Reflect.get(target, key);
+            }
+        });
+        const file = tmpFile('lazy.ply');
+        await assert.rejects(
+            writePointCloud(file, { count, positions: new Float32Array(count * 3), intensity: intensity as any }, 'ply', 'ascii'),
+            /second chunk built/
+        );
+        const ply = fs.readFileSync(file, 'latin1');
+        fs.unlinkSync(file);
+
+        const body = ply.slice(ply.indexOf('end_header\n') + 'end_header\n'.length);
+        assert.ok(ply.startsWith('ply\n'));
+        assert.strictEqual(body.split('\n').length - 1, linesPerChunk);
+    });
+});
@@ -0,0 +1,59 @@
+import * as assert from 'assert';
+import { matThumbnail, minMaxEnvelope } from '../threads/threadCapture';
+
+suite('Thread Capture Previews', () => {
+
+    function pixel(pixels: Uint8ClampedArray, width: number, x: number, y: number): number[] {
+        const i = (y * width + x) * 4;
+        return Array.from(pixels.subarray(i, i + 4));
+    }
+
+    test('thumbnail takes every colStride-th column, including the last one', () => {
+        // 2 x 5 gray 8U, value = 10 * column + row
+        const values = new Uint8Array(10);
+        for (let y = 0; y < 2; y++) {
+            for (let x = 0; x < 5; x++) {
+                values[y * 5 + x] = 10 * x + y;
+            }
+        }
+        const { width, height, pixels } = matThumbnail(values, 2, 5, 1, 0, 2);
+        assert.strictEqual(width, 3);
+        assert.strictEqual(height, 2);
+        assert.deepStrictEqual(pixel(pixels, width, 0, 0), [0, 0, 0, 255]);
+        assert.deepStrictEqual(pixel(pixels, width, 1, 0), [20, 20, 20, 255]);
+        assert.deepStrictEqual(pixel(pixels, width, 2, 1), [41, 41, 41, 255]);
+    });
+
+    test('8U BGRA keeps its alpha, other depths are opaque', () => {
+        const bgra = new Uint8Array([10, 20, 30, 40]);
+        assert.deepStrictEqual(Array.from(matThumbnail(bgra, 1, 1, 4, 0, 1).pixels), [30, 20, 10, 40]);
+
+        // 32F: alpha is not stretched with the colour channels
+        const float = new Float32Array([0, 1, 2, 0.5, 2, 1, 0, 0.5]);
+        const { pixels } = matThumbnail(float, 1, 2, 4, 5, 1);
+        assert.deepStrictEqual(Array.from(pixels), [255, 128, 0, 255, 0, 128, 255, 255]);
+    });
+
+    test('constant non-8U image maps to black instead of dividing by zero', () => {
+        const values = new Float32Array(12).fill(7);
+        const { pixels } = matThumbnail(values, 3, 4, 1, 5, 1);
+        for (let i = 0; i < pixels.length; i += 4) {
+            assert.deepStrictEqual(Array.from(pixels.subarray(i, i + 4)), [0, 0, 0, 255]);
+        }
+    });
+
+    test('short series are returned unchanged', () => {
+        const values = new Float64Array([3, 1, 2]);
+        assert.deepStrictEqual(Array.from(minMaxEnvelope(values, 2)), [3, 1, 2]);
+    });
+
+    test('envelope keeps each peak in the order it occurs', () => {
+        const values = new Float32Array([
+            1, 9, 2, 3,     // min before max
+            5, 0, 4, 4,     // max before min
+            2, 2, 8, -3,
+        ]);
+        const envelope = minMaxEnvelope(values, 3);
+        assert.deepStrictEqual(Array.from(envelope), [1, 9, 5, 0, 8, -3]);
+    });
+});
@@ -0,0 +1,83 @@
+import * as assert from 'assert';
+import { computeDirtyTiles, matUpdateMessage } from '../utils/tileDiff';
+
+suite('Dirty Tile Diff', () => {
+
+    function makeImage(rows: number, cols: number, bytesPerPixel: number): Uint8Array {
+        const data = new Uint8Array(rows * cols * bytesPerPixel);
+        for (let i = 0; i < data.length; i++) {
+            data[i] = i & 0xFF;
+        }
+        return data;
+    }
+
+    test('identical buffers produce no tiles', () => {
+        const a = makeImage(100, 130, 3);
+        const tiles = computeDirtyTiles(a, a.slice(), 100, 130, 3, 32);
+        assert.deepStrictEqual(tiles, []);
+    });
+
+    test('single changed pixel produces one tile containing it', () => {
+        const a = makeImage(100, 130, 3);
+        const b = a.slice();
+        const x = 70, y = 40;
+        b[(y * 130 + x) * 3 + 1] ^= 0xFF;
+
+        const tiles = computeDirtyTiles(a, b, 100, 130, 3, 32);
+        assert.ok(tiles);
+        assert.strictEqual(tiles!.length, 1);
+        const t = tiles![0];
+        assert.deepStrictEqual([t.x, t.y, t.width, t.height], [64, 32, 32, 32]);
+        assert.strictEqual(t.data.length, 32 * 32 * 3);
+
+        // Packed tile data matches the new image
+        const local = ((y - t.y) * t.width + (x - t.x)) * 3 + 1;
+        assert.strictEqual(t.data[local], b[(y * 130 + x) * 3 + 1]);
+    });
+
+    test('adjacent dirty tiles merge and edge tiles are clipped', () => {
+        const a = makeImage(40, 100, 1);
+        const b = a.slice();
+        // Touch the last three tiles of the first tile row (x = 40..99)
+        b[50] ^= 1;
+        b[70] ^= 1;
+        b[99] ^= 1;
+
+        const tiles = computeDirtyTiles(a, b, 40, 100, 1, 20);
+        assert.ok(tiles);
+        assert.strictEqual(tiles!.length, 1);
+        assert.deepStrictEqual([tiles![0].x, tiles![0].width, tiles![0].height], [40, 60, 20]);
+    });
+
+    test('large changes fall back to a full update', () => {
+        const a = makeImage(64, 64, 1);
+        const b = a.map(v => v ^ 0xFF);
+        assert.strictEqual(computeDirtyTiles(a, b, 64, 64, 1, 16), null);
+    });
+
+    test('size mismatch cannot be diffed', () => {
+        assert.strictEqual(computeDirtyTiles(makeImage(10, 10, 1), makeImage(10, 11, 1), 10, 10, 1), null);
+    });
+
+    test('a second step on an unchanged-geometry Mat posts deltaData', () => {
+        const first = { buffer: makeImage(100, 130, 3), rows: 100, cols: 130, channels: 3, depth: 0 };
+        assert.strictEqual(matUpdateMessage(undefined, first, 1, false)!.command, 'completeData');
+
+        const second = { ...first, buffer: first.buffer.slice() };
+        second.buffer[(40 * 130 + 70) * 3] ^= 0xFF;
+        const update = matUpdateMessage(first, second, 1, false)!;
+        assert.strictEqual(update.command, 'deltaData');
+        assert.strictEqual((update as any).tiles.length, 1);
+
+        assert.strictEqual(matUpdateMessage(second, { ...second, buffer: second.buffer.slice() }, 1, false), null);
+    });
+
+    test('forced refreshes and new geometry send the complete Mat', () => {
+        const a = { buffer: makeImage(32, 32, 1), rows: 32, cols: 32, channels: 1, depth: 0 };
+        assert.strictEqual(matUpdateMessage(a, { ...a, buffer: a.buffer.slice() }, 1, true)!.command, 'completeData');
+        const reshaped = { ...a, rows: 16, cols: 64 };
+        const update = matUpdateMessage(a, reshaped, 1, false)!;
+        assert.strictEqual(update.command, 'completeData');
+        assert.deepStrictEqual([(update as any).rows, (update as any).cols], [16, 64]);
+    });
+});
@@ -0,0 +1,73 @@
+import * as assert from 'assert';
+import {
+    exportChromeTrace,
+    getRefreshBreakdown,
+    isTracingEnabled,
+    recordWebviewTiming,
+    runTraced,
+    setTracingEnabled,
+    traceEnd,
+    traceStart,
+    tracePanelId,
+} from '../utils/logger';
+
+suite('Hot-path Tracing', () => {
+
+    const panel = tracePanelId('session', 'img');
+
+    teardown(() => setTracingEnabled(false));
+
+    test('records nothing while disabled', async () => {
+        setTracingEnabled(false);
+        assert.strictEqual(traceStart(), -1);
+        await runTraced(panel, async () => traceEnd(traceStart(), 'evaluate', 'evaluate'));
+        assert.strictEqual(getRefreshBreakdown(panel), undefined);
+        assert.strictEqual(exportChromeTrace().traceEvents.filter((e: any) => e.ph === 'X').length, 0);
+    });
+
+    test('overlapping spans of a phase count once in the breakdown', async () => {
+        setTracingEnabled(true);
+        assert.ok(isTracingEnabled());
+        await runTraced(panel, async () => {
+            // Two parallel chunks ending now: 50 ms and 30 ms long
+            const now = traceStart();
+            traceEnd(now - 50, 'readMemory', 'readMemory', undefined, 0);
+            traceEnd(now - 30, 'readMemory', 'readMemory', undefined, 1);
+        });
+        recordWebviewTiming(panel, 8, 4);
+
+        const breakdown = getRefreshBreakdown(panel)!;
+        assert.ok(breakdown);
+        const read = breakdown.phases.find((p) => p.phase === 'readMemory')!;
+        assert.strictEqual(read.count, 2);
+        assert.ok(read.busyMs >= 50 && read.busyMs < 60, `busy ${read.busyMs}`);
+        assert.deepStrictEqual(breakdown.phases.map((p) => p.phase), ['readMemory', 'webviewDecode', 'render']);
+    });
+
+    test('a new refresh starts a new breakdown', async () => {
+        setTracingEnabled(true);
+        await runTraced(panel, async () => traceEnd(traceStart() - 5, 'evaluate', 'evaluate'));
+        await runTraced(panel, async () => traceEnd(traceStart() - 5, 'decode', 'base64'));
+        assert.deepStrictEqual(getRefreshBreakdown(panel)!.phases.map((p) => p.phase), ['decode']);
+    });
+
+    test('Chrome trace puts webview phases in their own process', async () => {
+        setTracingEnabled(true);
+        await runTraced(panel, async () => traceEnd(traceStart() - 5, 'readMemory', 'readMemory', { count: 4096 }, 2));
+        recordWebviewTiming(panel, undefined, 3);
+
+        const events = exportChromeTrace().traceEvents as any[];
+        const spans = events.filter((e) => e.ph === 'X');
+        assert.strictEqual(spans.length, 2);
+        const [read, render] = spans;
+        assert.strictEqual(read.cat, 'readMemory');
+        assert.strictEqual(read.args.count, 4096);
+        assert.strictEqual(render.cat, 'render');
+        assert.notStrictEqual(read.pid, render.pid);
+        assert.ok(read.dur >= 5000, 'durations are in microseconds');
+
+        const names = events.filter((e) => e.name === 'thread_name').map((e) => e.args.name);
+        assert.ok(names.includes('img · worker 2'));
+        assert.ok(names.includes('img'));
+    });
+});
@@ -0,0 +1,381 @@
+import * as vscode from "vscode";
+import {
+  evaluateWithTimeout,
+  getEvaluateContext,
+  buildDataPointerExpressions,
+  tryGetDataPointer,
+  getVectorSize,
+  readMemoryChunked,
+  readMemoryGathered
+} from "../utils/debugger";
+import {
+  isMat,
+  isPoint3Vector,
+  is1DVector,
+  isUninitializedOrInvalid,
+  getBytesPerElement,
+  getElementKindFromCppType,
+  getElementKindFromDepth,
+  bufferToTypedArray,
+  type NumericArray
+} from "../utils/opencv";
+import { getMatInfoFromVariables } from "../matImage/matProvider";
+import { ReadCancelledError, currentCancellation, isReadCancelled } from "../utils/cancellation";
+
+// ============== Capture Across Threads ==============
+
+/**
+ * One variable name, every stopped thread. The capture runs in batched rounds
+ * rather than thread by thread:
+ *
+ *   1. `threads`, then `stackTrace` for all threads at once;
+ *   2. the name is evaluated in the top FRAMES_PER_ROUND frames of every thread
+ *      in one pipelined batch, further rounds only for threads where it was not
+ *      found yet; each thread keeps its topmost frame that knows the name;
+ *   3. the metadata (Mat header, vector size and data pointer) of all matches is
+ *      requested together, then all data reads run in parallel.
+ *
+ * Cells carry a preview, not the whole variable: Mats are read only on every
+ * n-th row and thumbnailed to THUMBNAIL_SIZE, vectors reduced to a min/max
+ * envelope, and point clouds read only at the CLOUD_POINTS points kept.
+ *
+ * Run inside runCancellable(), a capture stops between rounds and reads once it
+ * is superseded and throws ReadCancelledError.
+ */
+
+export const STACK_LEVELS = 16;
+export const FRAMES_PER_ROUND = 4;
+const EVALUATE_TIMEOUT_MS = 5000;
+
+export const THUMBNAIL_SIZE = 192;
+const PLOT_BUCKETS = 256;
+const CLOUD_POINTS = 4000;
+// Vectors longer than this are previewed from their start
+const MAX_CELL_ELEMENTS = 1 << 20;
+
+const DEPTH_NAMES = ["8U", "8S", "16U", "16S", "32S", "32F", "64F", "16F"];
+
+export type ThreadCellKind = "mat" | "plot" | "pointcloud";
+
+export interface ThreadCell {
+  threadId: number;
+  threadName: string;
+  frameName: string;
+  frameLine?: number;
+  // Stack level of the frame the variable was found in (0 = top)
+  level: number;
+  kind?: ThreadCellKind;
+  summary?: string;
+  error?: string;
+  // mat: width x height RGBA thumbnail
+  width?: number;
+  height?: number;
+  pixels?: Uint8ClampedArray;
+  // plot: envelope values; pointcloud: interleaved x, y, z
+  values?: Float32Array;
+}
+
+export interface ThreadCapture {
+  name: string;
+  cells: ThreadCell[];
+  // Stopped threads whose top STACK_LEVELS frames do not know the name
+  missing: number;
+  evaluates: number;
+  elapsedMs: number;
+}
+
+interface FoundVariable {
+  thread: { id: number; name: string };
+  frame: any;
+  level: number;
+  variable: any;
+}
+
+export async function captureAcrossThreads(
+  debugSession: vscode.DebugSession,
+  name: string
+): Promise<ThreadCapture> {
+  const start = Date.now();
+  const { found, stopped, evaluates } = await findVariableFrames(debugSession, name);
+  throwIfCancelled();
+  const cells = await Promise.all(found.map((match) => captureCell(debugSession, name, match)));
+  return {
+    name,
+    cells,
+    missing: stopped - found.length,
+    evaluates,
+    elapsedMs: Date.now() - start
+  };
+}
+
+function throwIfCancelled() {
+  const isCancelled = currentCancellation();
+  if (isCancelled && isCancelled()) {
+    throw new ReadCancelledError();
+  }
+}
+
+async function findVariableFrames(
+  debugSession: vscode.DebugSession,
+  name: string
+): Promise<{ found: FoundVariable[]; stopped: number; evaluates: number }> {
+  const threadsResponse = await debugSession.customRequest("threads", {});
+  const threads: { id: number; name: string }[] = threadsResponse?.threads || [];
+
+  // Running threads (non-stop mode) fail stackTrace and are left out
+  const stacks = (await Promise.all(threads.map(async (thread) => {
+    try {
+      const response = await debugSession.customRequest("stackTrace", {
+        threadId: thread.id,
+        startFrame: 0,
+        levels: STACK_LEVELS
+      });
+      return { thread, frames: (response?.stackFrames || []) as any[] };
+    } catch (e) {
+      console.log(`[Threads] No stack for thread ${thread.id}:`, e);
+      return { thread, frames: [] as any[] };
+    }
+  }))).filter((stack) => stack.frames.length > 0);
+
+  const found = new Map<number, FoundVariable>();
+  let evaluates = 0;
+  for (let first = 0; first < STACK_LEVELS; first += FRAMES_PER_ROUND) {
+    throwIfCancelled();
+    const round = stacks
+      .filter((stack) => !found.has(stack.thread.id))
+      .flatMap((stack) => stack.frames.slice(first, first + FRAMES_PER_ROUND).map((frame, i) => ({
+        thread: stack.thread,
+        frame,
+        level: first + i
+      })));
+    if (round.length === 0) {
+      break;
+    }
+    evaluates += round.length;
+    const results = await Promise.all(round.map(async (candidate) => {
+      try {
+        const response = await evaluateWithTimeout(debugSession, name, candidate.frame.id, EVALUATE_TIMEOUT_MS);
+        return isEvaluatedVariable(response) ? response : null;
+      } catch (e) {
+        return null;
+      }
+    }));
+    results.forEach((variable, i) => {
+      const candidate = round[i];
+      const previous = found.get(candidate.thread.id);
+      if (variable && (!previous || candidate.level < previous.level)) {
+        found.set(candidate.thread.id, { ...candidate, variable });
+      }
+    });
+  }
+
+  const ordered = stacks
+    .map((stack) => found.get(stack.thread.id))
+    .filter((match): match is FoundVariable => match !== undefined);
+  return { found: ordered, stopped: stacks.length, evaluates };
+}
+
+function isEvaluatedVariable(response: any): boolean {
+  if (!response || typeof response.result !== "string" || !response.type) {
+    return false;
+  }
+  const result = response.result.trim();
+  return !/^(error|<error)|no symbol|unable to|not in scope|undeclared identifier|identifier .* is undefined/i.test(result) &&
+    !isUninitializedOrInvalid(result);
+}
+
+async function captureCell(debugSession: vscode.DebugSession, name: string, match: FoundVariable): Promise<ThreadCell> {
+  const cell: ThreadCell = {
+    threadId: match.thread.id,
+    threadName: match.thread.name || `Thread ${match.thread.id}`,
+    frameName: match.frame.name || "",
+    frameLine: match.frame.line,
+    level: match.level
+  };
+  const variable = { ...match.variable, value: match.variable.result };
+  try {
+    if (isMat(variable)) {
+      Object.assign(cell, { kind: "mat" }, await captureMat(debugSession, variable));
+    } else if (isPoint3Vector(variable).isPoint3) {
+      Object.assign(cell, { kind: "pointcloud" }, await capturePointCloud(debugSession, name, match.frame.id, variable));
+    } else if (is1DVector(variable).is1D) {
+      Object.assign(cell, { kind: "plot" }, await captureVector(debugSession, name, match.frame.id, variable));
+    } else {
+      cell.error = `${variable.type} is not a Mat, numeric vector or Point3 vector`;
+    }
+  } catch (e: any) {
+    if (isReadCancelled(e)) throw e;
+    console.log(`[Threads] Capture of ${name} in thread ${match.thread.id} failed:`, e);
+    cell.error = e?.message || String(e);
+  }
+  return cell;
+}
+
+async function captureMat(debugSession: vscode.DebugSession, variable: any): Promise<Partial<ThreadCell>> {
+  if (!variable.variablesReference) {
+    throw new Error("The debugger shows no members for this Mat");
+  }
+  const info = await getMatInfoFromVariables(debugSession, variable.variablesReference, variable.type);
+  const summary = `${info.cols}x${info.rows} ${DEPTH_NAMES[info.depth] || "?"}C${info.channels}`;
+  if (info.dims > 2) {
+    return { summary: `${info.dims}-D Mat`, error: "N-D Mats are shown in the image viewer only" };
+  }
+  if (!(info.rows > 0 && info.cols > 0) || !info.dataPtr) {
+    return { summary, error: "Empty Mat" };
+  }
+
+  // Only the rows the thumbnail shows are read
+  const rowBytes = info.cols * info.channels * getBytesPerElement(info.depth);
+  const step = Math.max(info.step, rowBytes);
+  const rowStride = Math.ceil(info.rows / THUMBNAIL_SIZE);
+  const colStride = Math.ceil(info.cols / THUMBNAIL_SIZE);
+  const sampledRows = Math.ceil(info.rows / rowStride);
+  const buffer = await readMemoryGathered(debugSession, info.dataPtr, sampledRows, rowBytes, step * rowStride);
+  if (!buffer) {
+    throw new Error("Failed to read the Mat data");
+  }
+  const values = bufferToTypedArray(buffer, getElementKindFromDepth(info.depth), sampledRows * info.cols * info.channels);
+  return { summary, ...matThumbnail(values, sampledRows, info.cols, info.channels, info.depth, colStride) };
+}
+
+/**
+ * RGBA thumbnail of `rows` Mat rows, taking every `colStride`-th column. BGR(A)
+ * is swapped to RGB(A); other depths than 8U are stretched over their min..max.
+ */
+export function matThumbnail(
+  values: NumericArray,
+  rows: number,
+  cols: number,
+  channels: number,
+  depth: number,
+  colStride: number
+): { width: number; height: number; pixels: Uint8ClampedArray } {
+  const width = Math.ceil(cols / colStride);
+  const shown = Math.min(channels, 3);
+  let offset = 0;
+  let scale = 1;
+  if (depth !== 0) {
+    let min = Infinity;
+    let max = -Infinity;
+    for (let y = 0; y < rows; y++) {
+      for (let x = 0; x < cols; x += colStride) {
+        const src = (y * cols + x) * channels;
+        for (let c = 0; c < shown; c++) {
+          const v = values[src + c];
+          if (Number.isFinite(v)) {
+            if (v < min) min = v;
+            if (v > max) max = v;
+          }
+        }
+      }
+    }
+    offset = Number.isFinite(min) ? min : 0;
+    scale = max > min ? 255 / (max - min) : 0;
+  }
+
+  const pixels = new Uint8ClampedArray(width * rows * 4);
+  for (let y = 0; y < rows; y++) {
+    for (let tx = 0; tx < width; tx++) {
+      const src = (y * cols + tx * colStride) * channels;
+      const dst = (y * width + tx) * 4;
+      const b = (values[src] - offset) * scale;
+      const g = channels >= 3 ? (values[src + 1] - offset) * scale : b;
+      const r = channels >= 3 ? (values[src + 2] - offset) * scale : b;
+      pixels[dst] = r;
+      pixels[dst + 1] = g;
+      pixels[dst + 2] = b;
+      pixels[dst + 3] = channels === 4 && depth === 0 ? values[src + 3] : 255;
+    }
+  }
+  return { width, height: rows, pixels };
+}
+
+async function getElementsPointer(
+  debugSession: vscode.DebugSession,
+  name: string,
+  frameId: number,
+  variable: any
+): Promise<{ size: number; dataPtr: string }> {
+  const size = await getVectorSize(debugSession, name, frameId, variable);
+  if (!(size > 0)) {
+    throw new Error("Empty vector");
+  }
+  const dataPtr = await tryGetDataPointer(
+    debugSession,
+    name,
+    buildDataPointerExpressions(debugSession, name),
+    frameId,
+    getEvaluateContext(debugSession),
+    variable.type
+  );
+  if (!dataPtr) {
+    throw new Error("Cannot find the vector's data pointer");
+  }
+  return { size, dataPtr };
+}
+
+async function captureVector(
+  debugSession: vscode.DebugSession,
+  name: string,
+  frameId: number,
+  variable: any
+): Promise<Partial<ThreadCell>> {
+  const { elementType } = is1DVector(variable);
+  const { size, dataPtr } = await getElementsPointer(debugSession, name, frameId, variable);
+  const { kind, bytesPerElement } = getElementKindFromCppType(elementType);
+  const count = Math.min(size, MAX_CELL_ELEMENTS);
+  const buffer = await readMemoryChunked(debugSession, dataPtr, count * bytesPerElement);
+  if (!buffer || buffer.length < count * bytesPerElement) {
+    throw new Error("Failed to read the vector data");
+  }
+  const shown = count < size ? ` (first ${count})` : "";
+  return {
+    summary: `${size} x ${elementType}${shown}`,
+    values: minMaxEnvelope(bufferToTypedArray(buffer, kind, count), PLOT_BUCKETS)
+  };
+}
+
+/**
+ * `values` reduced to the min and max of each of `buckets` equal runs, in the
+ * order they occur, so a line through them keeps every peak.
+ */
+export function minMaxEnvelope(values: NumericArray, buckets: number): Float32Array {
+  if (values.length <= buckets * 2) {
+    return Float32Array.from(values);
+  }
+  const out = new Float32Array(buckets * 2);
+  for (let b = 0; b < buckets; b++) {
+    const from = Math.floor((b * values.length) / buckets);
+    const to = Math.floor(((b + 1) * values.length) / buckets);
+    let min = from;
+    let max = from;
+    for (let i = from + 1; i < to; i++) {
+      if (values[i] < values[min]) min = i;
+      if (values[i] > values[max]) max = i;
+    }
+    out[b * 2] = values[Math.min(min, max)];
+    out[b * 2 + 1] = values[Math.max(min, max)];
+  }
+  return out;
+}
+
+async function capturePointCloud(
+  debugSession: vscode.DebugSession,
+  name: string,
+  frameId: number,
+  variable: any
+): Promise<Partial<ThreadCell>> {
+  const { isDouble } = isPoint3Vector(variable);
+  const { size, dataPtr } = await getElementsPointer(debugSession, name, frameId, variable);
+  const pointBytes = isDouble ? 24 : 12;
+  // Only the points the preview keeps are read: one per stride, gathered
+  const stride = Math.ceil(size / CLOUD_POINTS);
+  const kept = Math.ceil(size / stride);
+  const buffer = await readMemoryGathered(debugSession, dataPtr, kept, pointBytes, pointBytes * stride);
+  if (!buffer || buffer.length < kept * pointBytes) {
+    throw new Error("Failed to read the point data");
+  }
+  const xyz = bufferToTypedArray(buffer, isDouble ? "f64" : "f32", kept * 3);
+  const values = Float32Array.from(xyz);
+  return { summary: `${size} points${isDouble ? " (double)" : ""}`, values };
+}
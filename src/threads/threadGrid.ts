@@ -0,0 +1,134 @@
+import * as vscode from "vscode";
+import { WebviewAssets } from "../utils/webviewAssets";
+import { isReadCancelled, runCancellable } from "../utils/cancellation";
+import { captureAcrossThreads, type ThreadCapture } from "./threadCapture";
+import { getWebviewContentForThreadGrid } from "./threadGridWebview";
+
+/**
+ * Grid panel showing one variable in every stopped thread, e.g. the
+ * `thread_img` of each worker of a pool. A capture is one batched round of
+ * debugger traffic (see threadCapture.ts); visible grids capture again after
+ * each step, hidden ones when they are shown. A newer capture of the grid, or
+ * the grid closing, stops the one in flight between its reads.
+ */
+
+interface GridEntry {
+  panel: vscode.WebviewPanel;
+  session: vscode.DebugSession;
+  name: string;
+  ready: boolean;
+  // Capture generation; results of superseded captures are dropped
+  generation: number;
+  // The debug position moved since the last capture
+  stale: boolean;
+}
+
+export class ThreadGrid {
+  private static entries: Map<string, GridEntry> = new Map();
+
+  static open(debugSession: vscode.DebugSession, name: string) {
+    const key = `${debugSession.id}:::${name}`;
+    const existing = this.entries.get(key);
+    if (existing) {
+      existing.panel.reveal(undefined, false);
+      this.capture(existing);
+      return;
+    }
+
+    const panel = vscode.window.createWebviewPanel(
+      "ThreadGridViewer",
+      `Threads: ${name}`,
+      { viewColumn: vscode.ViewColumn.Active, preserveFocus: false },
+      {
+        enableScripts: true,
+        retainContextWhenHidden: true,
+        localResourceRoots: WebviewAssets.localResourceRoots,
+      }
+    );
+    const entry: GridEntry = {
+      panel,
+      session: debugSession,
+      name,
+      ready: false,
+      generation: 0,
+      stale: false
+    };
+    this.entries.set(key, entry);
+
+    panel.onDidDispose(() => {
+      (panel as any)._isDisposing = true;
+      this.entries.delete(key);
+    });
+    panel.onDidChangeViewState((e) => {
+      if (e.webviewPanel.visible && entry.stale) {
+        this.capture(entry);
+      }
+    });
+    panel.webview.onDidReceiveMessage((message) => {
+      if (message.command === "ready") {
+        entry.ready = true;
+        this.capture(entry);
+      } else if (message.command === "recapture") {
+        this.capture(entry);
+      }
+    });
+    panel.webview.html = getWebviewContentForThreadGrid(panel.webview, name);
+  }
+
+  /**
+   * Debug position moved: visible grids of `sessionId` capture again, hidden
+   * ones on their next reveal.
+   */
+  static refresh(sessionId: string) {
+    for (const entry of this.entries.values()) {
+      if (entry.session.id !== sessionId) continue;
+      entry.stale = true;
+      if (entry.panel.visible) {
+        this.capture(entry);
+      } else {
+        // Stop a capture of the previous stop
+        entry.generation++;
+      }
+    }
+  }
+
+  static closeSession(sessionId: string) {
+    for (const entry of Array.from(this.entries.values())) {
+      if (entry.session.id === sessionId) entry.panel.dispose();
+    }
+  }
+
+  private static async capture(entry: GridEntry) {
+    if (!entry.ready || (entry.panel as any)._isDisposing) return;
+    // Threads are running; the grid keeps the last capture until the next stop
+    if (!vscode.debug.activeStackItem) return;
+
+    const generation = ++entry.generation;
+    const isCancelled = () => generation !== entry.generation || (entry.panel as any)._isDisposing;
+    entry.stale = false;
+    this.post(entry, { command: "capturing" });
+    try {
+      const result: ThreadCapture = await runCancellable(isCancelled, () =>
+        captureAcrossThreads(entry.session, entry.name)
+      );
+      if (isCancelled()) return;
+      console.log(
+        `[Threads] ${entry.name}: ${result.cells.length} threads, ${result.evaluates} evaluates, ${result.elapsedMs} ms`
+      );
+      this.post(entry, { command: "threadGrid", ...result });
+    } catch (e: any) {
+      if (isCancelled() || isReadCancelled(e)) return;
+      console.log(`[Threads] Capture of ${entry.name} failed:`, e);
+      this.post(entry, { command: "captureFailed", message: e?.message || String(e) });
+    }
+  }
+
+  private static post(entry: GridEntry, message: any) {
+    if ((entry.panel as any)._isDisposing) return;
+    try {
+      entry.panel.webview.postMessage(message);
+    } catch (e) {
+      // Panel was disposed, ignore
+    }
+  }
+}
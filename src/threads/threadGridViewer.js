@@ -0,0 +1,202 @@
+// Thread grid viewer script, loaded by the shell from getWebviewContentForThreadGrid.
+// esbuild.js bundles it into dist/media; the variable name comes from the
+// viewer-config block.
+//
+// One cell per thread. The extension sends previews, not whole variables:
+// an RGBA thumbnail for Mats, a min/max envelope for vectors and a decimated
+// xyz list for point clouds, which is drawn as a top (X/Y) view coloured by Z.
+
+const viewerConfig = JSON.parse(document.getElementById('viewer-config').textContent);
+
+(function() {
+    const vscode = acquireVsCodeApi();
+    const grid = document.getElementById('grid');
+    const statusInfo = document.getElementById('status');
+    const messageBox = document.getElementById('message');
+
+    const KIND_LABELS = { mat: 'Mat', plot: 'vector', pointcloud: 'point cloud' };
+
+    document.getElementById('recapture').addEventListener('click', () => {
+        vscode.postMessage({ command: 'recapture' });
+    });
+
+    window.addEventListener('message', (event) => {
+        const message = event.data;
+        if (message.command === 'capturing') {
+            grid.classList.add('capturing');
+            statusInfo.textContent = 'Capturing ' + viewerConfig.name + '...';
+        } else if (message.command === 'threadGrid') {
+            grid.classList.remove('capturing');
+            showCapture(message);
+        } else if (message.command === 'captureFailed') {
+            grid.classList.remove('capturing');
+            statusInfo.textContent = '';
+            messageBox.textContent = 'Capture failed: ' + message.message;
+        }
+    });
+
+    function showCapture(capture) {
+        const found = capture.cells.length;
+        statusInfo.textContent =
+            found + ' thread' + (found === 1 ? '' : 's') +
+            (capture.missing > 0 ? ' (' + capture.missing + ' without ' + capture.name + ')' : '') +
+            ' · ' + capture.evaluates + ' evaluates · ' + capture.elapsedMs + ' ms';
+        messageBox.textContent = found === 0
+            ? 'No stopped thread has ' + capture.name + ' in its top frames.'
+            : '';
+
+        grid.replaceChildren();
+        const drawn = [];
+        for (const cell of capture.cells) {
+            const element = document.createElement('div');
+            element.className = 'cell';
+
+            const title = document.createElement('div');
+            title.className = 'cell-title';
+            title.textContent = cell.threadName + ' (#' + cell.threadId + ')';
+            title.title = title.textContent;
+            element.appendChild(title);
+
+            const frame = document.createElement('div');
+            frame.className = 'cell-frame';
+            frame.textContent = (cell.frameName || '?') +
+                (cell.frameLine ? ':' + cell.frameLine : '') +
+                (cell.level > 0 ? '  [frame ' + cell.level + ']' : '');
+            frame.title = frame.textContent;
+            element.appendChild(frame);
+
+            if (cell.summary || cell.kind) {
+                const summary = document.createElement('div');
+                summary.className = 'cell-summary';
+                summary.textContent = (cell.kind ? KIND_LABELS[cell.kind] + ' ' : '') + (cell.summary || '');
+                element.appendChild(summary);
+            }
+
+            if (cell.error) {
+                const error = document.createElement('div');
+                error.className = 'cell-error';
+                error.textContent = cell.error;
+                element.appendChild(error);
+            } else {
+                const canvas = document.createElement('canvas');
+                element.appendChild(canvas);
+                drawn.push({ canvas, cell });
+            }
+            grid.appendChild(element);
+        }
+        // Sized after layout so the canvases know their width
+        requestAnimationFrame(() => {
+            for (const { canvas, cell } of drawn) {
+                drawCell(canvas, cell);
+            }
+        });
+    }
+
+    function drawCell(canvas, cell) {
+        const dpr = window.devicePixelRatio || 1;
+        const size = Math.max(1, Math.round(canvas.clientWidth * dpr));
+        canvas.width = size;
+        canvas.height = size;
+        const ctx = canvas.getContext('2d');
+        ctx.clearRect(0, 0, size, size);
+        if (cell.kind === 'mat') {
+            drawThumbnail(ctx, size, cell);
+        } else if (cell.kind === 'plot') {
+            drawEnvelope(ctx, size, cell.values, dpr);
+        } else if (cell.kind === 'pointcloud') {
+            drawTopView(ctx, size, cell.values, dpr);
+        }
+    }
+
+    function drawThumbnail(ctx, size, cell) {
+        const image = new ImageData(new Uint8ClampedArray(cell.pixels), cell.width, cell.height);
+        const source = document.createElement('canvas');
+        source.width = cell.width;
+        source.height = cell.height;
+        source.getContext('2d').putImageData(image, 0, 0);
+        const scale = Math.min(size / cell.width, size / cell.height);
+        const w = cell.width * scale;
+        const h = cell.height * scale;
+        ctx.imageSmoothingEnabled = false;
+        ctx.drawImage(source, (size - w) / 2, (size - h) / 2, w, h);
+    }
+
+    function valueRange(values, offset, stride) {
+        let min = Infinity;
+        let max = -Infinity;
+        for (let i = offset; i < values.length; i += stride) {
+            const v = values[i];
+            if (Number.isFinite(v)) {
+                if (v < min) min = v;
+                if (v > max) max = v;
+            }
+        }
+        if (!Number.isFinite(min)) return { min: 0, max: 1 };
+        if (max === min) return { min: min - 1, max: max + 1 };
+        return { min, max };
+    }
+
+    function drawEnvelope(ctx, size, values, dpr) {
+        const pad = 6 * dpr;
+        const { min, max } = valueRange(values, 0, 1);
+        const toY = (v) => pad + (1 - (v - min) / (max - min)) * (size - 2 * pad);
+        const toX = (i) => pad + (values.length > 1 ? i / (values.length - 1) : 0.5) * (size - 2 * pad);
+
+        if (min < 0 && max > 0) {
+            ctx.strokeStyle = '#555';
+            ctx.lineWidth = dpr;
+            ctx.beginPath();
+            ctx.moveTo(pad, toY(0));
+            ctx.lineTo(size - pad, toY(0));
+            ctx.stroke();
+        }
+        ctx.strokeStyle = '#4fc3f7';
+        ctx.lineWidth = 1.5 * dpr;
+        ctx.beginPath();
+        let started = false;
+        for (let i = 0; i < values.length; i++) {
+            if (!Number.isFinite(values[i])) {
+                started = false;
+                continue;
+            }
+            if (started) ctx.lineTo(toX(i), toY(values[i]));
+            else ctx.moveTo(toX(i), toY(values[i]));
+            started = true;
+        }
+        ctx.stroke();
+
+        ctx.fillStyle = '#aaa';
+        ctx.font = (10 * dpr) + 'px monospace';
+        ctx.fillText(formatValue(max), pad, pad + 10 * dpr);
+        ctx.fillText(formatValue(min), pad, size - pad);
+    }
+
+    function drawTopView(ctx, size, xyz, dpr) {
+        const pad = 6 * dpr;
+        const x = valueRange(xyz, 0, 3);
+        const y = valueRange(xyz, 1, 3);
+        const z = valueRange(xyz, 2, 3);
+        // Same scale on both axes so shapes are not distorted
+        const span = Math.max(x.max - x.min, y.max - y.min);
+        const scale = (size - 2 * pad) / span;
+        const cx = (x.min + x.max) / 2;
+        const cy = (y.min + y.max) / 2;
+        const dot = Math.max(1, Math.round(2 * dpr));
+        for (let i = 0; i + 2 < xyz.length; i += 3) {
+            if (!Number.isFinite(xyz[i]) || !Number.isFinite(xyz[i + 1])) continue;
+            const t = Number.isFinite(xyz[i + 2]) ? (xyz[i + 2] - z.min) / (z.max - z.min) : 0;
+            ctx.fillStyle = 'hsl(' + Math.round(240 - 240 * t) + ', 90%, 55%)';
+            const px = size / 2 + (xyz[i] - cx) * scale;
+            // Y up
+            const py = size / 2 - (xyz[i + 1] - cy) * scale;
+            ctx.fillRect(px - dot / 2, py - dot / 2, dot, dot);
+        }
+    }
+
+    function formatValue(v) {
+        if (Number.isInteger(v)) return String(v);
+        return Math.abs(v) >= 1e4 || Math.abs(v) < 1e-3 ? v.toExponential(2) : v.toFixed(3);
+    }
+
+    vscode.postMessage({ command: 'ready' });
+})();
@@ -0,0 +1,98 @@
+import * as vscode from "vscode";
+import { WebviewAssets } from "../utils/webviewAssets";
+
+export function getWebviewContentForThreadGrid(
+  webview: vscode.Webview,
+  name: string
+): string {
+  const nonce = getNonce();
+
+  return `
+    <!DOCTYPE html>
+    <html lang="en">
+    <head>
+        <meta charset="UTF-8">
+        <meta name="viewport" content="width=device-width, initial-scale=1.0">
+        <meta http-equiv="Content-Security-Policy" content="default-src 'none'; style-src ${webview.cspSource} 'nonce-${nonce}' 'unsafe-inline'; script-src 'nonce-${nonce}';">
+        <title>Thread Grid Viewer</title>
+        <style nonce="${nonce}">
+            body { margin: 0; font-family: Arial, sans-serif; background-color: #333; color: #eee; }
+            #controls {
+                position: sticky;
+                top: 0;
+                background: rgba(255,255,255,0.9);
+                color: #111;
+                padding: 8px 10px;
+                box-shadow: 0 2px 5px rgba(0,0,0,0.2);
+                user-select: none;
+                z-index: 1000;
+                display: flex;
+                gap: 10px;
+                align-items: center;
+                flex-wrap: wrap;
+            }
+            button {
+                padding: 5px 10px;
+                cursor: pointer;
+                border: 1px solid #ccc;
+                border-radius: 3px;
+                background: white;
+                color: #111;
+            }
+            button:hover { background: #f0f0f0; }
+            #status { font-family: monospace; font-size: 11px; color: #333; }
+            #grid {
+                display: grid;
+                grid-template-columns: repeat(auto-fill, minmax(220px, 1fr));
+                gap: 10px;
+                padding: 10px;
+            }
+            #grid.capturing { opacity: 0.6; }
+            .cell {
+                background: #222;
+                border: 1px solid #555;
+                border-radius: 5px;
+                padding: 6px;
+                display: flex;
+                flex-direction: column;
+                gap: 4px;
+                min-width: 0;
+            }
+            .cell-title { font-size: 12px; font-weight: bold; overflow: hidden; text-overflow: ellipsis; white-space: nowrap; }
+            .cell-frame, .cell-summary { font-family: monospace; font-size: 11px; color: #aaa; overflow: hidden; text-overflow: ellipsis; white-space: nowrap; }
+            .cell-error { font-size: 11px; color: #f88; }
+            .cell canvas { width: 100%; aspect-ratio: 1; background: #111; image-rendering: pixelated; }
+            #message {
+                margin: 40px auto;
+                background: rgba(0,0,0,0.7);
+                color: white;
+                padding: 20px;
+                border-radius: 10px;
+                max-width: 70vw;
+                text-align: center;
+            }
+            #message:empty { display: none; }
+        </style>
+    </head>
+    <body>
+        <div id="controls">
+            <button id="recapture" title="Read the variable again in every stopped thread">Recapture</button>
+            <span id="status"></span>
+        </div>
+        <div id="message">Capturing...</div>
+        <div id="grid"></div>
+        ${WebviewAssets.viewerScripts(webview, "threadGridViewer", { name }, nonce)}
+    </body>
+    </html>
+  `;
+}
+
+function getNonce() {
+  let text = "";
+  const possible =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+  for (let i = 0; i < 32; i++) {
+    text += possible.charAt(Math.floor(Math.random() * possible.length));
+  }
+  return text;
+}
@@ -0,0 +1,33 @@
+import { AsyncLocalStorage } from "async_hooks";
+
+/**
+ * Cancellation scope for debugger reads.
+ *
+ * visualizeVariable serves each panel request inside runCancellable() with the
+ * request's cancellation check. Any readMemoryChunked call made while serving it,
+ * however deep in a provider, picks the check up from the async context and stops
+ * between chunks once the request is superseded (a newer debug step, or a newer
+ * request for the same panel). The read then throws ReadCancelledError, which
+ * providers let propagate and visualizeVariable drops without reporting.
+ */
+
+export class ReadCancelledError extends Error {
+  constructor() {
+    super("Read cancelled");
+    this.name = "ReadCancelledError";
+  }
+}
+
+const scope = new AsyncLocalStorage<() => boolean>();
+
+export function runCancellable<T>(isCancelled: () => boolean, fn: () => Promise<T>): Promise<T> {
+  return scope.run(isCancelled, fn);
+}
+
+export function currentCancellation(): (() => boolean) | undefined {
+  return scope.getStore();
+}
+
+export function isReadCancelled(error: unknown): boolean {
+  return error instanceof ReadCancelledError;
+}
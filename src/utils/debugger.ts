@@ -1,5 +1,11 @@
 import * as vscode from "vscode";
 import * as os from "os";
+import * as fs from "fs";
+import * as path from "path";
+import { MemoryCache } from "./memoryCache";
+import { StrategyCache } from "./strategyCache";
+import { ReadCancelledError, currentCancellation } from "./cancellation";
+import { logDebug, traceStart, traceEnd } from "./logger";
 import { getDepthFromCppType, is2DStdArray, is2DCStyleArray, is1DCStyleArray, is3DCStyleArray, is3DStdArray } from "./opencv";
 
 // ============== Debugger Type Detection ==============
@@ -73,23 +79,16 @@ export function getEvaluateContext(debugSession: vscode.DebugSession): string {
 export const STL_ARRAY_MEMBERS = ["__elems_", "_M_elems", "_Elems"];
 export const STL_VECTOR_DATA_MEMBERS = ["__begin_", "_M_start", "_Myfirst"];
 
-// Global counter for tracking customRequest calls
-let customRequestCounter = 0;
-
 /**
- * Traced wrapper for debugSession.customRequest for debugging purposes.
+ * debugSession.customRequest, timed as a readMemory span for readMemory and an
+ * evaluate span for everything else (evaluate, variables) while tracing is on.
  */
-async function tracedCustomRequest(debugSession: vscode.DebugSession, command: string, args: any): Promise<any> {
-  const id = ++customRequestCounter;
-  const startTime = Date.now();
-  console.log(`[DEBUG-TRACE] customRequest #${id} START: ${command} at ${startTime}`);
+export async function tracedCustomRequest(debugSession: vscode.DebugSession, command: string, args: any, lane?: number): Promise<any> {
+  const start = traceStart();
   try {
-    const result = await debugSession.customRequest(command, args);
-    console.log(`[DEBUG-TRACE] customRequest #${id} END: ${command} at ${Date.now()} (took ${Date.now() - startTime}ms)`);
-    return result;
-  } catch (e) {
-    console.log(`[DEBUG-TRACE] customRequest #${id} FAILED: ${command} at ${Date.now()} (took ${Date.now() - startTime}ms)`, e);
-    throw e;
+    return await debugSession.customRequest(command, args);
+  } finally {
+    traceEnd(start, command === "readMemory" ? "readMemory" : "evaluate", command, args, lane);
   }
 }
 
@@ -107,7 +106,7 @@ export async function evaluateWithTimeout(
   const context = getEvaluateContext(debugSession);
   
   return Promise.race([
-    debugSession.customRequest("evaluate", {
+    tracedCustomRequest(debugSession, "evaluate", {
       expression: expression,
       frameId: frameId,
       context: context,
@@ -239,52 +238,269 @@ export async function getCurrentFrameId(debugSession: vscode.DebugSession): Prom
   return 0;
 }
 
+// ============== Memory Fingerprints ==============
+
+/**
+ * Fingerprint modes for the stateToken checked by PanelManager.isPanelFresh:
+ * - "sampled": hash K evenly spaced blocks (cheap, may miss edits between blocks)
+ * - "hash": hash the whole range while it is read (exact; the read is cached, so
+ *   the provider's own read afterwards costs nothing extra)
+ */
+export type FingerprintMode = "sampled" | "hash";
+
+const SAMPLE_BLOCK_SIZE = 256;
+
+function getFingerprintSettings(): { mode: FingerprintMode; blocks: number } {
+  const config = vscode.workspace.getConfiguration("cv-debugmate");
+  const mode = config.get<string>("fingerprint.mode", "sampled") === "hash" ? "hash" : "sampled";
+  const blocks = Math.max(3, Math.min(256, config.get<number>("fingerprint.sampleBlocks", 16)));
+  return { mode, blocks };
+}
+
+/**
+ * FNV-1a over 32-bit words, fed incrementally so chunks can be hashed as they arrive.
+ */
+export class FnvHasher {
+  private hash = 0x811c9dc5;
+  private pending = 0;
+  private pendingBytes = 0;
+  private length = 0;
+
+  private mix(word: number) {
+    this.hash = Math.imul(this.hash ^ word, 0x01000193);
+  }
+
+  update(data: Uint8Array): void {
+    this.length += data.length;
+    let i = 0;
+    // Complete a word left over from the previous chunk
+    while (this.pendingBytes > 0 && i < data.length) {
+      this.pending |= data[i++] << (8 * this.pendingBytes);
+      if (++this.pendingBytes === 4) {
+        this.mix(this.pending);
+        this.pending = 0;
+        this.pendingBytes = 0;
+      }
+    }
+
+    const wordCount = (data.length - i) >> 2;
+    if (wordCount > 0) {
+      const byteOffset = data.byteOffset + i;
+      const words = byteOffset % 4 === 0
+        ? new Uint32Array(data.buffer, byteOffset, wordCount)
+        : new Uint32Array(new Uint8Array(data.subarray(i, i + wordCount * 4)).buffer);
+      for (let w = 0; w < wordCount; w++) {
+        this.mix(words[w]);
+      }
+      i += wordCount * 4;
+    }
+
+    while (i < data.length) {
+      this.pending |= data[i++] << (8 * this.pendingBytes);
+      this.pendingBytes++;
+    }
+  }
+
+  digest(): string {
+    let hash = this.hash;
+    if (this.pendingBytes > 0) {
+      hash = Math.imul(hash ^ this.pending, 0x01000193);
+    }
+    hash = Math.imul(hash ^ this.length, 0x01000193);
+    return (hash >>> 0).toString(16).padStart(8, "0");
+  }
+}
+
+// Hashes computed while a buffer was being read, so fingerprintBuffer doesn't redo them
+const bufferFingerprints = new WeakMap<Buffer, string>();
+
 /**
- * Get a small sample of memory to detect content changes without reading everything.
- * Reads 1KB from start, middle and end.
+ * Exact fingerprint of a buffer (reuses the hash computed during readMemoryChunked).
+ */
+export function fingerprintBuffer(buffer: Buffer): string {
+  const known = bufferFingerprints.get(buffer);
+  if (known) return known;
+  const hasher = new FnvHasher();
+  hasher.update(buffer);
+  const fingerprint = `h:${hasher.digest()}`;
+  bufferFingerprints.set(buffer, fingerprint);
+  return fingerprint;
+}
+
+// Fingerprints taken at the current debug state. Providers fingerprint a range
+// to check freshness before reading it and again for the token they store after;
+// memory cannot change in between, so the second one costs nothing.
+const stepFingerprints = new Map<string, string>();
+let stepFingerprintsVersion = -1;
+
+/**
+ * Get a fingerprint of memory to detect content changes.
+ * The mode is set by `cv-debugmate.fingerprint.mode`: strided sampling over
+ * `cv-debugmate.fingerprint.sampleBlocks` blocks, or an exact hash of the whole range.
+ * `sampledOnly` is for ranges the caller will not read whole (tiled or streamed
+ * Mats), where a hash would read them in full up front.
  */
 export async function getMemorySample(
   debugSession: vscode.DebugSession,
   memoryReference: string,
-  totalBytes: number
+  totalBytes: number,
+  sampledOnly: boolean = false
 ): Promise<string> {
   if (totalBytes <= 0 || !memoryReference) return "";
-  
-  const SIZES = [512, 512, 512]; // Start, middle, end samples
-  const offsets = [
-    0,
-    Math.floor(totalBytes / 2),
-    Math.max(0, totalBytes - 512)
-  ];
-
-  let sampleData = "";
-  for (let i = 0; i < offsets.length; i++) {
+
+  const settings = getFingerprintSettings();
+  const mode: FingerprintMode = sampledOnly ? "sampled" : settings.mode;
+  const blocks = settings.blocks;
+
+  const version = MemoryCache.getVersion();
+  if (version !== stepFingerprintsVersion) {
+    stepFingerprints.clear();
+    stepFingerprintsVersion = version;
+  }
+  const key = `${debugSession.id}|${memoryReference}|${totalBytes}|${mode}|${blocks}`;
+  const known = stepFingerprints.get(key);
+  if (known) return known;
+
+  const fingerprint = await computeMemorySample(debugSession, memoryReference, totalBytes, mode, blocks);
+  // A step may have arrived while sampling; the result then belongs to neither state
+  if (fingerprint && MemoryCache.getVersion() === version) {
+    stepFingerprints.set(key, fingerprint);
+  }
+  return fingerprint;
+}
+
+async function computeMemorySample(
+  debugSession: vscode.DebugSession,
+  memoryReference: string,
+  totalBytes: number,
+  mode: FingerprintMode,
+  blocks: number
+): Promise<string> {
+  if (mode === "hash") {
+    try {
+      const buffer = await readMemoryChunked(debugSession, memoryReference, totalBytes);
+      return buffer && buffer.length === totalBytes ? fingerprintBuffer(buffer) : "";
+    } catch (e) {
+      return "";
+    }
+  }
+
+  // Small ranges are read whole; otherwise K evenly spaced blocks, first and last included
+  const offsets: number[] = [];
+  let blockSize = SAMPLE_BLOCK_SIZE;
+  if (totalBytes <= blocks * SAMPLE_BLOCK_SIZE) {
+    offsets.push(0);
+    blockSize = totalBytes;
+  } else {
+    const span = totalBytes - SAMPLE_BLOCK_SIZE;
+    for (let i = 0; i < blocks; i++) {
+      offsets.push(Math.floor((span * i) / (blocks - 1)));
+    }
+  }
+
+  const responses = await Promise.all(offsets.map(async (offset) => {
     try {
-      const count = Math.min(SIZES[i], totalBytes - offsets[i]);
-      if (count <= 0) continue;
-      
       const response = await debugSession.customRequest("readMemory", {
         memoryReference: memoryReference,
-        offset: offsets[i],
-        count: count
+        offset: offset,
+        count: blockSize
       });
-      
-      if (response && response.data) {
-        // Just take a small slice of the base64 to keep the token compact
-        sampleData += response.data.substring(0, 32);
-      }
+      return response && response.data ? Buffer.from(response.data, "base64") : null;
     } catch (e) {
       // Ignore sample errors
+      return null;
+    }
+  }));
+
+  const hasher = new FnvHasher();
+  let sampled = 0;
+  for (const block of responses) {
+    if (block) {
+      hasher.update(block);
+      sampled++;
+    }
+  }
+  return sampled > 0 ? `s:${hasher.digest()}` : "";
+}
+
+// ============== Adaptive Chunked Reader ==============
+
+/**
+ * Chunk size and worker count used by readMemoryChunked.
+ * Debug adapters differ a lot: cppvsdbg serializes readMemory requests, GDB struggles
+ * with large chunks, CodeLLDB handles both well. The reader adjusts these values
+ * while it runs (AIMD) and remembers the last good settings per debugger type.
+ */
+interface ReadTuning {
+  chunkSize: number;
+  concurrency: number;
+}
+
+const READ_TUNING_STATE_KEY = "cv-debugmate.readTuning";
+const MIN_CHUNK_SIZE = 256 * 1024;
+const MAX_CHUNK_SIZE = 16 * 1024 * 1024;
+const CHUNK_SIZE_STEP = 1024 * 1024;
+const MAX_CONCURRENCY = 8;
+const MAX_CHUNK_RETRIES = 2;
+
+let readTuningState: vscode.Memento | undefined;
+const readTuningByType = new Map<string, ReadTuning>();
+
+/**
+ * Load persisted read tuning from extension globalState. Call once from activate().
+ */
+export function initializeReadTuning(state: vscode.Memento) {
+  readTuningState = state;
+  const saved = state.get<Record<string, ReadTuning>>(READ_TUNING_STATE_KEY) || {};
+  for (const [type, tuning] of Object.entries(saved)) {
+    if (tuning && tuning.chunkSize > 0 && tuning.concurrency > 0) {
+      readTuningByType.set(type, clampTuning(tuning));
     }
   }
-  return sampleData;
+}
+
+function clampTuning(tuning: ReadTuning): ReadTuning {
+  return {
+    chunkSize: Math.min(MAX_CHUNK_SIZE, Math.max(MIN_CHUNK_SIZE, Math.round(tuning.chunkSize))),
+    concurrency: Math.min(MAX_CONCURRENCY, Math.max(1, Math.round(tuning.concurrency)))
+  };
+}
+
+function getReadTuning(debugSession: vscode.DebugSession): ReadTuning {
+  const saved = readTuningByType.get(debugSession.type);
+  if (saved) {
+    return { ...saved };
+  }
+  if (isUsingMSVC(debugSession)) {
+    // cppvsdbg processes requests serially, extra workers only queue up
+    return { chunkSize: 4 * 1024 * 1024, concurrency: 2 };
+  }
+  if (isUsingCppdbg(debugSession)) {
+    // GDB/MI slows down sharply on large chunks
+    return { chunkSize: 1024 * 1024, concurrency: 4 };
+  }
+  const cpuCount = os.cpus().length || 4;
+  return { chunkSize: 4 * 1024 * 1024, concurrency: Math.min(MAX_CONCURRENCY, Math.max(4, Math.floor(cpuCount / 2))) };
+}
+
+function saveReadTuning(debugSession: vscode.DebugSession, tuning: ReadTuning) {
+  readTuningByType.set(debugSession.type, clampTuning(tuning));
+  if (readTuningState) {
+    readTuningState.update(READ_TUNING_STATE_KEY, Object.fromEntries(readTuningByType)).then(undefined, (e: any) => {
+      console.log("Failed to persist read tuning:", e);
+    });
+  }
 }
 
 /**
  * Helper function to read memory in chunks to avoid debugger limitations.
- * Each chunk is 8MB by default.
+ * Chunk size and concurrency start from the tuned values for this debugger type and
+ * adapt per chunk: additive increase while throughput holds, halving on a timeout or
+ * error (the failed range is retried with the smaller chunk size).
  * Includes timeout protection to prevent hanging.
- * @param cancellationCheck Optional function that returns true if the operation should be cancelled
+ * @param cancellationCheck Optional function that returns true if the operation should be cancelled.
+ *   Without one, the check of the enclosing runCancellable() scope is used, and a
+ *   cancelled read throws ReadCancelledError instead of returning null.
  */
 export async function readMemoryChunked(
   debugSession: vscode.DebugSession,
@@ -293,74 +509,200 @@ export async function readMemoryChunked(
   progress?: vscode.Progress<{ message?: string; increment?: number }>,
   cancellationCheck?: () => boolean
 ): Promise<Buffer | null> {
-  // Use smaller chunks (4MB) to allow more parallel requests
-  // MSVC debugger may process requests serially, so smaller chunks help
-  const CHUNK_SIZE = 4 * 1024 * 1024; // 4MB per chunk
+  const isCancelled = cancellationCheck || currentCancellation();
+  try {
+    // Ranges already read this step (by any panel) are served from the session cache
+    return await MemoryCache.read(debugSession.id, memoryReference, totalBytes, async () => {
+      const buffer = await readMemoryChunkedUncached(debugSession, memoryReference, totalBytes, progress, isCancelled);
+      if (buffer === null && isCancelled && isCancelled()) {
+        throw new ReadCancelledError();
+      }
+      return buffer;
+    });
+  } catch (e) {
+    if (cancellationCheck && e instanceof ReadCancelledError) {
+      return null;
+    }
+    throw e;
+  }
+}
+
+// Panels refreshed at once never exceed this, whatever the read tuning allows
+const MAX_PANEL_REFRESH_CONCURRENCY = 4;
+
+/**
+ * How many panels to refresh at once after a step. Sized from the read
+ * concurrency measured for this debugger type: adapters that keep up with many
+ * parallel readMemory requests get more panels in flight, serial ones (cppvsdbg)
+ * get one at a time so the focused panel is not queued behind the others.
+ */
+export function getPanelRefreshConcurrency(debugSession: vscode.DebugSession): number {
+  const { concurrency } = getReadTuning(debugSession);
+  return Math.max(1, Math.min(MAX_PANEL_REFRESH_CONCURRENCY, Math.floor(concurrency / 2)));
+}
+
+async function readMemoryChunkedUncached(
+  debugSession: vscode.DebugSession,
+  memoryReference: string,
+  totalBytes: number,
+  progress?: vscode.Progress<{ message?: string; increment?: number }>,
+  cancellationCheck?: () => boolean
+): Promise<Buffer | null> {
   const CHUNK_TIMEOUT = 30000; // 30 seconds timeout per chunk
-  
-  // Adaptive concurrency, but limit to avoid overwhelming the debugger
-  // MSVC debugger may queue requests, so moderate concurrency works better
-  const cpuCount = os.cpus().length || 4;
-  const CONCURRENCY = Math.min(8, Math.max(4, Math.floor(cpuCount / 2)));
-  
-  const numChunks = Math.ceil(totalBytes / CHUNK_SIZE);
-  const chunks = new Array<Buffer | null>(numChunks).fill(null);
-  
-  console.log(`Starting parallel chunked read: totalBytes=${totalBytes}, chunks=${numChunks}, concurrency=${CONCURRENCY}`);
 
-  let nextChunkIndex = 0;
+  const tuning = getReadTuning(debugSession);
+  let chunkSize = tuning.chunkSize;
+  let concurrency = tuning.concurrency;
+
+  // Ranges still to read: fresh data comes from nextOffset, failed ranges are re-queued
+  const chunks = new Map<number, Buffer>();
+  const retryQueue: { offset: number; count: number; attempts: number }[] = [];
+  let nextOffset = 0;
+
+  logDebug(`Starting adaptive chunked read: totalBytes=${totalBytes}, chunkSize=${chunkSize}, concurrency=${concurrency}, debugger=${debugSession.type}`);
+
   let totalReadBytes = 0;
   let failed = false;
   let cancelled = false;
+  let completedChunks = 0;
+  let goodStreak = 0;
+  let avgMbps = 0;
+
+  // In exact fingerprint mode, hash contiguous chunks as soon as they are available
+  const hasher = getFingerprintSettings().mode === "hash" ? new FnvHasher() : null;
+  let hashedUpTo = 0;
+  function advanceHash() {
+    if (!hasher) return;
+    let next = chunks.get(hashedUpTo);
+    while (next) {
+      hasher.update(next);
+      hashedUpTo += next.length;
+      next = chunks.get(hashedUpTo);
+    }
+  }
 
   // Helper function to read with timeout
-  async function readWithTimeout(offset: number, count: number): Promise<any> {
-    return Promise.race([
-      debugSession.customRequest("readMemory", {
-        memoryReference: memoryReference,
-        offset: offset,
-        count: count
-      }),
-      new Promise((_, reject) => 
-        setTimeout(() => reject(new Error(`Memory read timeout after ${CHUNK_TIMEOUT}ms`)), CHUNK_TIMEOUT)
-      )
-    ]);
+  async function readWithTimeout(offset: number, count: number, workerId: number): Promise<any> {
+    let timer: ReturnType<typeof setTimeout> | undefined;
+    try {
+      return await Promise.race([
+        tracedCustomRequest(debugSession, "readMemory", {
+          memoryReference: memoryReference,
+          offset: offset,
+          count: count
+        }, workerId),
+        new Promise((_, reject) => {
+          timer = setTimeout(() => reject(new Error(`Memory read timeout after ${CHUNK_TIMEOUT}ms`)), CHUNK_TIMEOUT);
+        })
+      ]);
+    } finally {
+      // Each chunk's timer would otherwise stay alive for CHUNK_TIMEOUT
+      clearTimeout(timer);
+    }
   }
 
+  function takeRange(): { offset: number; count: number; attempts: number } | null {
+    const retry = retryQueue.shift();
+    if (retry) return retry;
+    if (nextOffset >= totalBytes) return null;
+    const offset = nextOffset;
+    const count = Math.min(chunkSize, totalBytes - offset);
+    nextOffset += count;
+    return { offset, count, attempts: 0 };
+  }
+
+  // Multiplicative decrease: halve chunk size and workers, re-split the failed range
+  function onChunkFailed(range: { offset: number; count: number; attempts: number }, reason: string) {
+    chunkSize = Math.max(MIN_CHUNK_SIZE, Math.floor(chunkSize / 2));
+    concurrency = Math.max(1, Math.floor(concurrency / 2));
+    goodStreak = 0;
+    if (range.attempts >= MAX_CHUNK_RETRIES) {
+      failed = true;
+      return;
+    }
+    console.log(`[Memory Read] ${reason}: backing off to chunkSize=${chunkSize}, concurrency=${concurrency}`);
+    for (let off = range.offset; off < range.offset + range.count; off += chunkSize) {
+      retryQueue.push({
+        offset: off,
+        count: Math.min(chunkSize, range.offset + range.count - off),
+        attempts: range.attempts + 1
+      });
+    }
+  }
+
+  // Additive increase: one step per round of good chunks while throughput holds
+  function onChunkSucceeded(mbps: number, chunkTime: number) {
+    avgMbps = avgMbps === 0 ? mbps : avgMbps * 0.7 + mbps * 0.3;
+    if (chunkTime > CHUNK_TIMEOUT / 3) {
+      // Close to timing out, shrink before we actually hit it
+      chunkSize = Math.max(MIN_CHUNK_SIZE, Math.floor(chunkSize / 2));
+      goodStreak = 0;
+      return;
+    }
+    if (mbps < avgMbps * 0.5) {
+      goodStreak = 0;
+      return;
+    }
+    goodStreak++;
+    if (goodStreak >= concurrency) {
+      goodStreak = 0;
+      chunkSize = Math.min(MAX_CHUNK_SIZE, chunkSize + CHUNK_SIZE_STEP);
+      concurrency = Math.min(MAX_CONCURRENCY, concurrency + 1);
+    }
+  }
+
+  let activeWorkers = 0;
+  let workerCounter = 0;
+  const workers: Promise<void>[] = [];
+
   const worker = async (workerId: number) => {
-    while (nextChunkIndex < numChunks && !failed && !cancelled) {
+    let processed = 0;
+    while (!failed && !cancelled) {
+      // Shed workers after a multiplicative decrease
+      if (activeWorkers > concurrency) {
+        break;
+      }
+
       // Check for cancellation before starting each chunk
       if (cancellationCheck && cancellationCheck()) {
-        console.log(`[Worker ${workerId}] Memory read cancelled by cancellation check`);
+        logDebug(`[Worker ${workerId}] Memory read cancelled by cancellation check`);
         cancelled = true;
-        return;
+        break;
       }
       
-      const myIndex = nextChunkIndex++;
-      const offset = myIndex * CHUNK_SIZE;
-      const count = Math.min(CHUNK_SIZE, totalBytes - offset);
+      const range = takeRange();
+      if (!range) {
+        break;
+      }
+      const { offset, count } = range;
 
       const chunkStartTime = Date.now();
-      console.log(`[Worker ${workerId}] Starting chunk ${myIndex}/${numChunks} (offset=${offset}, size=${count} bytes)`);
 
       try {
-        const memoryResponse = await readWithTimeout(offset, count);
+        const memoryResponse = await readWithTimeout(offset, count, workerId);
         const chunkTime = Date.now() - chunkStartTime;
 
         // Check for cancellation after each chunk
         if (cancellationCheck && cancellationCheck()) {
-          console.log(`[Worker ${workerId}] Memory read cancelled after chunk completion`);
+          logDebug(`[Worker ${workerId}] Memory read cancelled after chunk completion`);
           cancelled = true;
-          return;
+          break;
         }
 
         if (memoryResponse && memoryResponse.data && !failed && !cancelled) {
+          const decodeStart = traceStart();
           const buffer = Buffer.from(memoryResponse.data, "base64");
-          chunks[myIndex] = buffer;
+          traceEnd(decodeStart, "decode", "base64", { offset, bytes: buffer.length }, workerId);
+          chunks.set(offset, buffer);
+          advanceHash();
           totalReadBytes += buffer.length;
+          completedChunks++;
+          processed++;
 
-          const mbps = (buffer.length / 1024 / 1024) / (chunkTime / 1000);
-          console.log(`[Worker ${workerId}] Chunk ${myIndex} completed in ${chunkTime}ms (${(buffer.length / 1024 / 1024).toFixed(2)}MB @ ${mbps.toFixed(2)}MB/s)`);
+          const mbps = (buffer.length / 1024 / 1024) / (Math.max(1, chunkTime) / 1000);
+          logDebug(`[Worker ${workerId}] Chunk at ${offset} completed in ${chunkTime}ms (${(buffer.length / 1024 / 1024).toFixed(2)}MB @ ${mbps.toFixed(2)}MB/s)`);
+          onChunkSucceeded(mbps, chunkTime);
+          spawnWorkers();
 
           if (progress) {
             const percent = Math.round((totalReadBytes / totalBytes) * 100);
@@ -370,46 +712,390 @@ export async function readMemoryChunked(
             });
           }
         } else if (!failed && !cancelled) {
-          console.error(`[Worker ${workerId}] readMemory returned no data for chunk ${myIndex}`);
-          failed = true;
+          console.error(`[Worker ${workerId}] readMemory returned no data for chunk at ${offset}`);
+          onChunkFailed(range, "Empty response");
         }
       } catch (e: any) {
         const chunkTime = Date.now() - chunkStartTime;
         if (!cancelled) {
-          console.error(`[Worker ${workerId}] Error reading memory chunk ${myIndex} (took ${chunkTime}ms):`, e.message || e);
-          failed = true;
+          console.error(`[Worker ${workerId}] Error reading memory chunk at ${offset} (took ${chunkTime}ms):`, e.message || e);
+          onChunkFailed(range, e.message || "Read error");
         }
       }
     }
-    console.log(`[Worker ${workerId}] Finished (processed ${nextChunkIndex} chunks)`);
+    activeWorkers--;
+    logDebug(`[Worker ${workerId}] Finished (processed ${processed} chunks)`);
   };
 
+  function spawnWorkers() {
+    while (!failed && !cancelled && activeWorkers < concurrency && (nextOffset < totalBytes || retryQueue.length > 0)) {
+      activeWorkers++;
+      workers.push(worker(workerCounter++));
+    }
+  }
+
   // Start workers with IDs for logging
   const overallStartTime = Date.now();
-  console.log(`[Memory Read] Starting ${CONCURRENCY} workers to read ${numChunks} chunks (${(totalBytes / 1024 / 1024).toFixed(2)}MB total)`);
+  logDebug(`[Memory Read] Starting ${concurrency} workers to read ${(totalBytes / 1024 / 1024).toFixed(2)}MB`);
   
-  const workers = Array(CONCURRENCY).fill(null).map((_, idx) => worker(idx));
-  await Promise.all(workers);
+  spawnWorkers();
+  // Workers may spawn more workers as concurrency grows
+  for (let i = 0; i < workers.length; i++) {
+    await workers[i];
+    if (i === workers.length - 1) {
+      // A retry may have been queued after the last worker decided to exit
+      spawnWorkers();
+    }
+  }
   
   const overallTime = Date.now() - overallStartTime;
-  const overallMbps = (totalBytes / 1024 / 1024) / (overallTime / 1000);
-  console.log(`[Memory Read] All chunks completed in ${overallTime}ms (${(totalBytes / 1024 / 1024).toFixed(2)}MB @ ${overallMbps.toFixed(2)}MB/s)`);
+  const overallMbps = (totalBytes / 1024 / 1024) / (Math.max(1, overallTime) / 1000);
+  logDebug(`[Memory Read] All chunks completed in ${overallTime}ms (${(totalBytes / 1024 / 1024).toFixed(2)}MB @ ${overallMbps.toFixed(2)}MB/s), final chunkSize=${chunkSize}, concurrency=${concurrency}`);
 
   if (cancelled) {
     console.log("Memory read was cancelled, returning null");
     return null;
   }
 
-  if (failed || chunks.some(c => c === null)) {
+  // Only remember settings from reads large enough to have exercised the controller
+  if (completedChunks >= 4) {
+    saveReadTuning(debugSession, { chunkSize, concurrency });
+  }
+
+  const ordered = Array.from(chunks.entries()).sort((a, b) => a[0] - b[0]).map(([, buf]) => buf);
+  if (failed || totalReadBytes < totalBytes) {
     // If some chunks failed but we have some data, try to return what we have
-    const validChunks = chunks.filter((c): c is Buffer => c !== null);
-    if (validChunks.length === 0) {
+    if (ordered.length === 0) {
       return null;
     }
-    return Buffer.concat(validChunks as any[]);
+    return Buffer.concat(ordered as any[]);
+  }
+
+  const concatStart = traceStart();
+  const result = Buffer.concat(ordered as any[]);
+  traceEnd(concatStart, "decode", "concat", { bytes: result.length, chunks: ordered.length });
+  if (hasher && hashedUpTo === totalBytes) {
+    bufferFingerprints.set(result, `h:${hasher.digest()}`);
+  }
+  return result;
+}
+
+// ============== Out-of-band Memory Dump ==============
+
+// Below this size the temp-file round trip costs more than a readMemory request
+const DUMP_MIN_BYTES = 1024 * 1024;
+const DUMP_TIMEOUT = 60000;
+
+// Sessions whose debugger refused the dump command; don't retry them
+const dumpUnsupportedSessions = new Set<string>();
+let dumpFileCounter = 0;
+
+// Dump files of commands that timed out, per session. The debugger may still be
+// writing them, so they are deleted on the session's next dump or when it ends.
+const abandonedDumpFiles = new Map<string, Set<string>>();
+
+function removeAbandonedDumpFiles(sessionId: string) {
+  const files = abandonedDumpFiles.get(sessionId);
+  if (!files) {
+    return;
+  }
+  abandonedDumpFiles.delete(sessionId);
+  for (const file of files) {
+    fs.promises.unlink(file).catch(() => { /* already gone */ });
+  }
+}
+
+/** Forget a finished session's dump state and delete the files it left behind. */
+export function releaseDumpFiles(sessionId: string) {
+  removeAbandonedDumpFiles(sessionId);
+  dumpUnsupportedSessions.delete(sessionId);
+}
+
+/**
+ * Check whether the debugger writes files on the same machine as the extension host.
+ * gdbserver, pipe transports and lldb remote platforms would write the dump
+ * on the remote side, where we cannot read it.
+ */
+function isLocalDebugger(debugSession: vscode.DebugSession): boolean {
+  const config = debugSession.configuration || {};
+  if (config.miDebuggerServerAddress || config.pipeTransport || config.debugServerPath) {
+    return false;
   }
 
-  return Buffer.concat(chunks as any[]);
+  const commands: string[] = [];
+  for (const key of ["setupCommands", "initCommands", "preRunCommands", "targetCreateCommands", "processCreateCommands"]) {
+    const list = config[key];
+    if (Array.isArray(list)) {
+      for (const c of list) {
+        if (typeof c === "string") {
+          commands.push(c);
+        } else if (c && typeof c.text === "string") {
+          commands.push(c.text);
+        }
+      }
+    }
+  }
+  return !commands.some(c => /gdb-remote|platform\s+connect|target\s+(extended-)?remote/.test(c));
+}
+
+/**
+ * Read a memory range by letting the debugger dump it to a temp file.
+ *
+ * readMemory returns base64 text through the adapter's JSON pipe, which is slow for
+ * large images. GDB (`dump binary memory`) and LLDB (`memory read --binary --outfile`)
+ * can write the raw bytes to disk instead, and we read the file back in one go.
+ *
+ * Returns null when the transport is unavailable (MSVC, remote debugger, command
+ * refused, size mismatch, timeout) so the caller can fall back to readMemoryChunked.
+ * Cancellation works as in readMemoryChunked: null with an explicit check, a
+ * ReadCancelledError when the check comes from the cancellation scope.
+ */
+export async function readMemoryViaDumpFile(
+  debugSession: vscode.DebugSession,
+  memoryReference: string,
+  totalBytes: number,
+  frameId: number,
+  cancellationCheck?: () => boolean
+): Promise<Buffer | null> {
+  if (totalBytes < DUMP_MIN_BYTES || isUsingMSVC(debugSession) || dumpUnsupportedSessions.has(debugSession.id)) {
+    return null;
+  }
+  const isCancelled = cancellationCheck || currentCancellation();
+  try {
+    return await MemoryCache.read(debugSession.id, memoryReference, totalBytes, () =>
+      dumpMemoryToFile(debugSession, memoryReference, totalBytes, frameId, isCancelled)
+    );
+  } catch (e) {
+    if (cancellationCheck && e instanceof ReadCancelledError) {
+      return null;
+    }
+    throw e;
+  }
+}
+
+async function dumpMemoryToFile(
+  debugSession: vscode.DebugSession,
+  memoryReference: string,
+  totalBytes: number,
+  frameId: number,
+  isCancelled?: () => boolean
+): Promise<Buffer | null> {
+  if (totalBytes < DUMP_MIN_BYTES || !isValidMemoryReference(memoryReference)) {
+    return null;
+  }
+  if (isUsingMSVC(debugSession) || dumpUnsupportedSessions.has(debugSession.id)) {
+    return null;
+  }
+  if (!isLocalDebugger(debugSession)) {
+    console.log("[Dump] Debugger is remote, using readMemory");
+    return null;
+  }
+
+  let start: bigint;
+  try {
+    start = BigInt(memoryReference);
+  } catch {
+    return null;
+  }
+  const startHex = `0x${start.toString(16)}`;
+  const endHex = `0x${(start + BigInt(totalBytes)).toString(16)}`;
+
+  // Forward slashes work for both debuggers on Windows; skip paths the command parser would split
+  const dumpFile = path
+    .join(os.tmpdir(), `cv-debugmate-${process.pid}-${++dumpFileCounter}.bin`)
+    .replace(/\\/g, "/");
+  if (/\s/.test(dumpFile)) {
+    return null;
+  }
+
+  let commands: string[];
+  if (isUsingLLDB(debugSession)) {
+    const cmd = `memory read --force --binary --outfile ${dumpFile} ${startHex} ${endHex}`;
+    // "/cmd" is needed when CodeLLDB's console is in evaluate mode
+    commands = [cmd, `/cmd ${cmd}`];
+  } else if (isUsingCppdbg(debugSession)) {
+    commands = [`-exec dump binary memory ${dumpFile} ${startHex} ${endHex}`];
+  } else {
+    return null;
+  }
+
+  // The command cannot be interrupted once sent; a superseded refresh stops before
+  // and after it
+  if (isCancelled && isCancelled()) {
+    throw new ReadCancelledError();
+  }
+  // Earlier timed-out commands of this session are done by now (requests run in order)
+  removeAbandonedDumpFiles(debugSession.id);
+
+  const startTime = Date.now();
+  let ownFile = true;
+  try {
+    for (const command of commands) {
+      let timer: ReturnType<typeof setTimeout> | undefined;
+      let timedOut = false;
+      try {
+        await Promise.race([
+          debugSession.customRequest("evaluate", {
+            expression: command,
+            frameId: frameId,
+            context: "repl"
+          }),
+          new Promise((_, reject) => {
+            timer = setTimeout(() => {
+              timedOut = true;
+              reject(new Error(`Dump command timed out after ${DUMP_TIMEOUT}ms`));
+            }, DUMP_TIMEOUT);
+          })
+        ]);
+      } catch (e: any) {
+        console.log(`[Dump] Command "${command}" failed:`, e.message || e);
+        if (timedOut) {
+          // Still running in the debugger: leave its file alone, fall back to readMemory
+          ownFile = false;
+          let files = abandonedDumpFiles.get(debugSession.id);
+          if (!files) {
+            files = new Set();
+            abandonedDumpFiles.set(debugSession.id, files);
+          }
+          files.add(dumpFile);
+          return null;
+        }
+        continue;
+      } finally {
+        clearTimeout(timer);
+      }
+
+      if (isCancelled && isCancelled()) {
+        throw new ReadCancelledError();
+      }
+
+      let size = -1;
+      try {
+        size = (await fs.promises.stat(dumpFile)).size;
+      } catch {
+        // File not written, try the next command form
+      }
+      if (size === totalBytes) {
+        const buffer = await fs.promises.readFile(dumpFile);
+        const elapsed = Date.now() - startTime;
+        const mbps = (totalBytes / 1024 / 1024) / (Math.max(1, elapsed) / 1000);
+        console.log(`[Dump] Read ${totalBytes} bytes via dump file in ${elapsed}ms (${mbps.toFixed(2)}MB/s)`);
+        return buffer;
+      }
+      if (size >= 0) {
+        console.log(`[Dump] Dump file has ${size} bytes, expected ${totalBytes}`);
+        return null;
+      }
+    }
+
+    console.log("[Dump] Debugger refused the dump command, disabling for this session");
+    dumpUnsupportedSessions.add(debugSession.id);
+    return null;
+  } catch (e: any) {
+    if (e instanceof ReadCancelledError) {
+      throw e;
+    }
+    console.log("[Dump] Failed to read dump file:", e.message || e);
+    return null;
+  } finally {
+    if (ownFile) {
+      fs.promises.unlink(dumpFile).catch(() => { /* never created */ });
+    }
+  }
+}
+
+// ============== Strided (ROI) Reads ==============
+
+// Row gaps up to this size are read through rather than split into per-row requests
+const GATHER_MERGE_GAP = 64 * 1024;
+const GATHER_ROW_CONCURRENCY = 8;
+
+/**
+ * Read `rows` rows of `rowBytes` bytes that are `step` bytes apart (a cv::Mat ROI or
+ * padded Mat) and pack them densely.
+ *
+ * When the gap between rows is small (<= 64KB or <= one row) the whole span is read
+ * in one go (dump file, then chunked readMemory) and the gaps are dropped; otherwise
+ * exactly the rows are read, one readMemory each.
+ */
+export async function readMemoryGathered(
+  debugSession: vscode.DebugSession,
+  memoryReference: string,
+  rows: number,
+  rowBytes: number,
+  step: number,
+  frameId?: number,
+  progress?: vscode.Progress<{ message?: string; increment?: number }>,
+  cancellationCheck?: () => boolean
+): Promise<Buffer | null> {
+  const totalBytes = rows * rowBytes;
+  if (step <= rowBytes || rows <= 1) {
+    if (frameId !== undefined) {
+      const dumped = await readMemoryViaDumpFile(debugSession, memoryReference, totalBytes, frameId, cancellationCheck);
+      if (dumped) return dumped;
+    }
+    return readMemoryChunked(debugSession, memoryReference, totalBytes, progress, cancellationCheck);
+  }
+
+  let base: bigint;
+  try {
+    base = BigInt(memoryReference.match(/0x[0-9a-fA-F]+/)?.[0] || memoryReference);
+  } catch {
+    console.log(`[Gather] Invalid memory reference: ${memoryReference}`);
+    return null;
+  }
+
+  const gap = step - rowBytes;
+  const out = Buffer.alloc(totalBytes);
+
+  if (gap <= GATHER_MERGE_GAP || gap <= rowBytes) {
+    const spanBytes = (rows - 1) * step + rowBytes;
+    logDebug(`[Gather] Reading ${rows} rows as one ${spanBytes}-byte span (step ${step}, row ${rowBytes})`);
+    let span: Buffer | null = null;
+    if (frameId !== undefined) {
+      span = await readMemoryViaDumpFile(debugSession, memoryReference, spanBytes, frameId, cancellationCheck);
+    }
+    if (!span) {
+      span = await readMemoryChunked(debugSession, memoryReference, spanBytes, progress, cancellationCheck);
+    }
+    if (!span || span.length !== spanBytes) {
+      return null;
+    }
+    const gatherStart = traceStart();
+    for (let r = 0; r < rows; r++) {
+      span.copy(out, r * rowBytes, r * step, r * step + rowBytes);
+    }
+    traceEnd(gatherStart, "decode", "gather", { rows, bytes: totalBytes });
+    return out;
+  }
+
+  logDebug(`[Gather] Reading ${rows} separate rows (step ${step}, row ${rowBytes})`);
+  let nextRow = 0;
+  let doneRows = 0;
+  let failed = false;
+  const readRows = async () => {
+    while (!failed && nextRow < rows) {
+      if (cancellationCheck && cancellationCheck()) {
+        failed = true;
+        return;
+      }
+      const r = nextRow++;
+      const rowRef = "0x" + (base + BigInt(r * step)).toString(16);
+      const row = await readMemoryChunked(debugSession, rowRef, rowBytes, undefined, cancellationCheck);
+      if (!row || row.length !== rowBytes) {
+        console.log(`[Gather] Row ${r} failed`);
+        failed = true;
+        return;
+      }
+      row.copy(out, r * rowBytes);
+      doneRows++;
+      if (progress && doneRows % Math.max(1, Math.floor(rows / 20)) === 0) {
+        progress.report({ message: `Read ${doneRows} / ${rows} rows`, increment: 5 });
+      }
+    }
+  };
+  await Promise.all(Array.from({ length: Math.min(GATHER_ROW_CONCURRENCY, rows) }, () => readRows()));
+  return failed ? null : out;
 }
 
 // Helper function to try getting data pointer using a list of expressions
@@ -418,37 +1104,44 @@ export async function tryGetDataPointer(
   evaluateName: string,
   expressions: string[],
   frameId: number,
-  context: string
+  context: string,
+  typeName?: string
 ): Promise<string | null> {
-  console.log(`tryGetDataPointer: evaluateName="${evaluateName}", context="${context}", frameId=${frameId}`);
+  logDebug(`tryGetDataPointer: evaluateName="${evaluateName}", context="${context}", frameId=${frameId}`);
+
+  // The form that worked for this type before goes first
+  const typeKey = StrategyCache.typeKeyFor(typeName, evaluateName, expressions);
+  const ordered = StrategyCache.orderExpressions(debugSession, "dataPointer", typeKey, evaluateName, expressions);
   
-  for (const expr of expressions) {
+  for (const expr of ordered) {
     try {
-      console.log(`Trying expression: ${expr}`);
-      const dataResponse = await debugSession.customRequest("evaluate", {
+      logDebug(`Trying expression: ${expr}`);
+      const dataResponse = await tracedCustomRequest(debugSession, "evaluate", {
         expression: expr,
         frameId: frameId,
         context: context
       });
       
-      console.log(`Response for "${expr}":`, dataResponse);
+      logDebug(`Response for "${expr}":`, dataResponse);
       
       // Try to extract pointer from result string
       if (dataResponse && dataResponse.result) {
         const ptrMatch = dataResponse.result.match(/0x[0-9a-fA-F]+/);
         if (ptrMatch && isValidMemoryReference(ptrMatch[0])) {
-          console.log(`Successfully extracted pointer: ${ptrMatch[0]}`);
+          logDebug(`Successfully extracted pointer: ${ptrMatch[0]}`);
+          StrategyCache.rememberExpression(debugSession, "dataPointer", typeKey, evaluateName, expr);
           return ptrMatch[0];
         }
       }
       
       // Also check memoryReference field directly
       if (dataResponse && isValidMemoryReference(dataResponse.memoryReference)) {
-        console.log(`Found memoryReference: ${dataResponse.memoryReference}`);
+        logDebug(`Found memoryReference: ${dataResponse.memoryReference}`);
+        StrategyCache.rememberExpression(debugSession, "dataPointer", typeKey, evaluateName, expr);
         return dataResponse.memoryReference;
       }
     } catch (e) {
-      console.log(`Expression "${expr}" failed:`, e);
+      logDebug(`Expression "${expr}" failed:`, e);
     }
   }
   
@@ -477,20 +1170,23 @@ export async function getVectorSize(
     if (sizeMatch) {
       size = parseInt(sizeMatch[1]);
       if (!isNaN(size) && size > 0) {
-        console.log(`Parsed vector size from variableInfo: ${size}`);
+        logDebug(`Parsed vector size from variableInfo: ${size}`);
         return size;
       }
     }
   }
   
-  // Strategy 2: Evaluate size() expression with debugger-specific syntax
+  // Strategy 2: Evaluate size() expression with debugger-specific syntax,
+  // starting with the form that worked for this type before
   const context = getEvaluateContext(debugSession);
-  const sizeExpressions = buildSizeExpressions(debugSession, variableName);
+  const candidates = buildSizeExpressions(debugSession, variableName);
+  const typeKey = StrategyCache.typeKeyFor(variableInfo?.type, variableName, candidates);
+  const sizeExpressions = StrategyCache.orderExpressions(debugSession, "size", typeKey, variableName, candidates);
   
   for (const expr of sizeExpressions) {
     try {
-      console.log(`Trying size expression: ${expr}`);
-      const sizeResponse = await debugSession.customRequest("evaluate", {
+      logDebug(`Trying size expression: ${expr}`);
+      const sizeResponse = await tracedCustomRequest(debugSession, "evaluate", {
         expression: expr,
         frameId: frameId,
         context: context
@@ -498,11 +1194,12 @@ export async function getVectorSize(
       
       const parsed = parseInt(sizeResponse.result);
       if (!isNaN(parsed) && parsed > 0) {
-        console.log(`Got vector size from evaluate (${expr}): ${parsed}`);
+        logDebug(`Got vector size from evaluate (${expr}): ${parsed}`);
+        StrategyCache.rememberExpression(debugSession, "size", typeKey, variableName, expr);
         return parsed;
       }
     } catch (e) {
-      console.log(`Expression "${expr}" failed:`, e);
+      logDebug(`Expression "${expr}" failed:`, e);
     }
   }
   
@@ -660,7 +1357,7 @@ export async function get2DStdArrayDataPointer(
 ): Promise<string | null> {
   const startTime = Date.now();
   const context = getEvaluateContext(debugSession);
-  console.log(`[DEBUG-TRACE] get2DStdArrayDataPointer START: variableName="${variableName}", debugger=${debugSession.type}, at ${startTime}`);
+  logDebug(`get2DStdArrayDataPointer START: variableName="${variableName}", debugger=${debugSession.type}, at ${startTime}`);
   
   let dataPtr: string | null = null;
   
@@ -827,7 +1524,7 @@ export async function get2DStdArrayDataPointer(
     dataPtr = await tryGetDataPointer(debugSession, variableName, expressions, frameId, context);
   }
   
-  console.log(`[DEBUG-TRACE] get2DStdArrayDataPointer END: result=${dataPtr}, took ${Date.now() - startTime}ms`);
+  logDebug(`get2DStdArrayDataPointer END: result=${dataPtr}, took ${Date.now() - startTime}ms`);
   return dataPtr;
 }
 
@@ -1615,7 +2312,8 @@ export async function is3DCStyleArrayEnhanced(
   width: number; 
   channels: number; 
   elementType: string; 
-  depth: number 
+  depth: number;
+  isVolume?: boolean
 }> {
   console.log(`Checking C-style 3D array using debugger command for: ${variableName}`);
   
@@ -1625,16 +2323,14 @@ export async function is3DCStyleArrayEnhanced(
   if (typeInfo) {
     const { height, width, channels, elementType } = typeInfo;
     
-    // Only consider it an image-suitable 3D array if channels is 1, 3, or 4
-    if (channels !== 1 && channels !== 3 && channels !== 4) {
-      console.log(`Debugger detected 3D array but channels=${channels} is not 1, 3, or 4`);
-      return { is3DArray: false, height: 0, width: 0, channels: 0, elementType: "", depth: 0 };
-    }
+    // A last extent of 1, 3 or 4 is channels (an image); anything else is a
+    // volume of `height` slices of width x channels, shown slice by slice
+    const isVolume = channels !== 1 && channels !== 3 && channels !== 4;
     
     const depth = getDepthFromCppType(elementType);
     
     console.log(`Debugger detected C-style 3D array: ${elementType}[${height}][${width}][${channels}], depth=${depth}`);
-    return { is3DArray: true, height, width, channels, elementType, depth };
+    return { is3DArray: true, height, width, channels, elementType, depth, isVolume };
   }
   
   // Fallback to basic string matching from opencv.ts
@@ -1665,7 +2361,8 @@ export async function is3DStdArrayEnhanced(
   width: number; 
   channels: number; 
   elementType: string; 
-  depth: number 
+  depth: number;
+  isVolume?: boolean
 }> {
   console.log(`Checking 3D std::array using debugger command for: ${variableName}`);
   
@@ -1675,16 +2372,14 @@ export async function is3DStdArrayEnhanced(
   if (typeInfo) {
     const { height, width, channels, elementType } = typeInfo;
     
-    // Only consider it an image-suitable 3D array if channels is 1, 3, or 4
-    if (channels !== 1 && channels !== 3 && channels !== 4) {
-      console.log(`Debugger detected 3D array but channels=${channels} is not 1, 3, or 4`);
-      return { is3DArray: false, height: 0, width: 0, channels: 0, elementType: "", depth: 0 };
-    }
+    // A last extent of 1, 3 or 4 is channels (an image); anything else is a
+    // volume of `height` slices of width x channels, shown slice by slice
+    const isVolume = channels !== 1 && channels !== 3 && channels !== 4;
     
     const depth = getDepthFromCppType(elementType);
     
     console.log(`Debugger detected 3D std::array: ${elementType}[${height}][${width}][${channels}], depth=${depth}`);
-    return { is3DArray: true, height, width, channels, elementType, depth };
+    return { is3DArray: true, height, width, channels, elementType, depth, isVolume };
   }
   
   // Fallback to basic string matching from opencv.ts
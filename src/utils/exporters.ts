@@ -0,0 +1,464 @@
+import * as fs from "fs";
+import type { PackedPointCloud } from "../pointCloud/pointCloudProvider";
+import type { NumericArray } from "./opencv";
+
+// ============== Streaming File Export ==============
+
+/**
+ * Host-side writers for the data a panel was drawn from. The bytes read from the
+ * debuggee are written to the file in chunks of about WRITE_CHUNK_BYTES, so an
+ * export never builds a second full-size copy of the data, and nothing goes
+ * through the webview (only "PNG as rendered" still comes from the canvas).
+ */
+
+const WRITE_CHUNK_BYTES = 4 * 1024 * 1024;
+const ASCII_LINES_PER_CHUNK = 65536;
+
+async function writeChunks(filePath: string, chunks: AsyncIterable<Uint8Array> | Iterable<Uint8Array>) {
+  const handle = await fs.promises.open(filePath, "w");
+  try {
+    for await (const chunk of chunks) {
+      let offset = 0;
+      while (offset < chunk.length) {
+        const { bytesWritten } = await handle.write(chunk, offset, chunk.length - offset);
+        offset += bytesWritten;
+      }
+    }
+  } finally {
+    await handle.close();
+  }
+}
+
+// Join generated lines into chunks instead of one string for the whole file
+function* asciiChunks(count: number, line: (i: number) => string): Iterable<Uint8Array> {
+  for (let start = 0; start < count; start += ASCII_LINES_PER_CHUNK) {
+    const end = Math.min(count, start + ASCII_LINES_PER_CHUNK);
+    const lines: string[] = new Array(end - start);
+    for (let i = start; i < end; i++) {
+      lines[i - start] = line(i);
+    }
+    yield Buffer.from(lines.join("\n") + "\n", "latin1");
+  }
+}
+
+// ============== Element Types ==============
+
+interface SampleType {
+  bytes: number;
+  // TIFF SampleFormat: 1 = unsigned, 2 = signed, 3 = IEEE float
+  tiffFormat: number;
+  // NumPy dtype string
+  npyDescr: string;
+}
+
+// Indexed by OpenCV depth; CV_16F is written as half floats, as stored
+const DEPTH_SAMPLES: Record<number, SampleType> = {
+  0: { bytes: 1, tiffFormat: 1, npyDescr: "|u1" }, // CV_8U
+  1: { bytes: 1, tiffFormat: 2, npyDescr: "|i1" }, // CV_8S
+  2: { bytes: 2, tiffFormat: 1, npyDescr: "<u2" }, // CV_16U
+  3: { bytes: 2, tiffFormat: 2, npyDescr: "<i2" }, // CV_16S
+  4: { bytes: 4, tiffFormat: 2, npyDescr: "<i4" }, // CV_32S
+  5: { bytes: 4, tiffFormat: 3, npyDescr: "<f4" }, // CV_32F
+  6: { bytes: 8, tiffFormat: 3, npyDescr: "<f8" }, // CV_64F
+  7: { bytes: 2, tiffFormat: 3, npyDescr: "<f2" }, // CV_16F
+};
+
+function sampleTypeForDepth(depth: number): SampleType {
+  const sample = DEPTH_SAMPLES[depth];
+  if (!sample) {
+    throw new Error(`Unsupported Mat depth ${depth}`);
+  }
+  return sample;
+}
+
+function npyDescrForArray(data: NumericArray): string {
+  if (data instanceof Int8Array) return "|i1";
+  if (data instanceof Uint8Array) return "|u1";
+  if (data instanceof Int16Array) return "<i2";
+  if (data instanceof Uint16Array) return "<u2";
+  if (data instanceof Int32Array) return "<i4";
+  if (data instanceof Uint32Array) return "<u4";
+  if (data instanceof Float32Array) return "<f4";
+  return "<f8";
+}
+
+// ============== Raster Sources ==============
+
+/**
+ * An image to export, read in bands of rows. Rows come back tightly packed
+ * (cols * channels elements each) in the debuggee's element layout.
+ */
+export interface RasterSource {
+  rows: number;
+  cols: number;
+  channels: number;
+  depth: number;
+  readRows(y0: number, count: number): Promise<Buffer>;
+}
+
+export function bufferRasterSource(
+  buffer: Buffer,
+  rows: number,
+  cols: number,
+  channels: number,
+  depth: number
+): RasterSource {
+  const rowBytes = cols * channels * sampleTypeForDepth(depth).bytes;
+  if (buffer.length < rows * rowBytes) {
+    throw new Error(`Image buffer holds ${buffer.length} bytes, expected ${rows * rowBytes}`);
+  }
+  return {
+    rows, cols, channels, depth,
+    readRows: async (y0, count) => buffer.subarray(y0 * rowBytes, (y0 + count) * rowBytes)
+  };
+}
+
+async function* rasterBands(source: RasterSource, rowBytes: number): AsyncIterable<Buffer> {
+  const bandRows = Math.max(1, Math.floor(WRITE_CHUNK_BYTES / rowBytes));
+  for (let y = 0; y < source.rows; y += bandRows) {
+    const count = Math.min(bandRows, source.rows - y);
+    const band = await source.readRows(y, count);
+    if (band.length !== count * rowBytes) {
+      throw new Error(`Could not read rows ${y}-${y + count - 1}`);
+    }
+    yield band;
+  }
+}
+
+// ============== TIFF ==============
+
+/**
+ * Uncompressed little-endian baseline TIFF, one strip. Every OpenCV depth is kept
+ * at full precision (8/16/32/64-bit integer or float samples). 3- and 4-channel
+ * images are swapped from OpenCV's BGR(A) to RGB(A); other channels beyond the
+ * color ones are stored as extra samples.
+ */
+export async function writeTiff(filePath: string, source: RasterSource): Promise<void> {
+  const { rows, cols, channels } = source;
+  const sample = sampleTypeForDepth(source.depth);
+  const rowBytes = cols * channels * sample.bytes;
+  const imageBytes = rows * rowBytes;
+  const header = tiffHeader(cols, rows, channels, sample, imageBytes);
+  if (header.length + imageBytes > 0xffffffff) {
+    throw new Error("Image is too large for TIFF (4 GB limit); export it as NPY instead");
+  }
+
+  const swap = channels === 3 || channels === 4;
+  async function* chunks(): AsyncIterable<Uint8Array> {
+    yield header;
+    for await (const band of rasterBands(source, rowBytes)) {
+      yield swap ? swapRedBlue(band, channels, sample.bytes) : band;
+    }
+  }
+  await writeChunks(filePath, chunks());
+}
+
+// Copy of `band` with the first and third channel of every pixel exchanged
+function swapRedBlue(band: Buffer, channels: number, sampleBytes: number): Buffer {
+  const out = Buffer.from(band);
+  const pixelBytes = channels * sampleBytes;
+  const blueOffset = 2 * sampleBytes;
+  for (let p = 0; p < out.length; p += pixelBytes) {
+    band.copy(out, p, p + blueOffset, p + blueOffset + sampleBytes);
+    band.copy(out, p + blueOffset, p, p + sampleBytes);
+  }
+  return out;
+}
+
+function tiffHeader(width: number, height: number, channels: number, sample: SampleType, imageBytes: number): Buffer {
+  const SHORT = 3, LONG = 4, RATIONAL = 5;
+  const typeBytes: Record<number, number> = { [SHORT]: 2, [LONG]: 4, [RATIONAL]: 8 };
+
+  const colorSamples = channels >= 3 ? 3 : 1;
+  const extraSamples = channels - colorSamples;
+  const repeat = (value: number, n: number) => new Array(n).fill(value);
+
+  // Tags in ascending order, as TIFF requires; StripOffsets is patched below
+  const entries: Array<{ tag: number; type: number; values: number[] }> = [
+    { tag: 256, type: LONG, values: [width] },                                // ImageWidth
+    { tag: 257, type: LONG, values: [height] },                               // ImageLength
+    { tag: 258, type: SHORT, values: repeat(sample.bytes * 8, channels) },    // BitsPerSample
+    { tag: 259, type: SHORT, values: [1] },                                   // Compression = none
+    { tag: 262, type: SHORT, values: [colorSamples === 3 ? 2 : 1] },          // Photometric: RGB / min-is-black
+    { tag: 273, type: LONG, values: [0] },                                    // StripOffsets
+    { tag: 277, type: SHORT, values: [channels] },                            // SamplesPerPixel
+    { tag: 278, type: LONG, values: [height] },                               // RowsPerStrip
+    { tag: 279, type: LONG, values: [imageBytes] },                           // StripByteCounts
+    { tag: 282, type: RATIONAL, values: [72, 1] },                            // XResolution
+    { tag: 283, type: RATIONAL, values: [72, 1] },                            // YResolution
+    { tag: 284, type: SHORT, values: [1] },                                   // PlanarConfiguration = chunky
+    { tag: 296, type: SHORT, values: [2] },                                   // ResolutionUnit = inch
+  ];
+  if (extraSamples > 0) {
+    // A fourth channel is BGRA's unassociated alpha; anything else is unspecified
+    const kind = channels === 4 ? 2 : 0;
+    entries.push({ tag: 338, type: SHORT, values: repeat(kind, extraSamples) }); // ExtraSamples
+  }
+  entries.push({ tag: 339, type: SHORT, values: repeat(sample.tiffFormat, channels) }); // SampleFormat
+
+  const valueBytes = (e: { type: number; values: number[] }) =>
+    e.type === RATIONAL ? e.values.length / 2 * 8 : e.values.length * typeBytes[e.type];
+
+  const ifdOffset = 8;
+  const ifdBytes = 2 + entries.length * 12 + 4;
+  let outOfLineBytes = 0;
+  for (const e of entries) {
+    const n = valueBytes(e);
+    if (n > 4) outOfLineBytes += n;
+  }
+  const stripOffset = ifdOffset + ifdBytes + outOfLineBytes;
+  entries.find(e => e.tag === 273)!.values[0] = stripOffset;
+
+  const header = Buffer.alloc(stripOffset);
+  header.writeUInt16LE(0x4949, 0); // "II": little endian
+  header.writeUInt16LE(42, 2);
+  header.writeUInt32LE(ifdOffset, 4);
+  header.writeUInt16LE(entries.length, ifdOffset);
+
+  const writeValues = (e: { type: number; values: number[] }, at: number) => {
+    for (let i = 0; i < e.values.length; i++) {
+      if (e.type === SHORT) header.writeUInt16LE(e.values[i], at + i * 2);
+      else header.writeUInt32LE(e.values[i], at + i * 4);
+    }
+  };
+
+  let entryAt = ifdOffset + 2;
+  let extraAt = ifdOffset + ifdBytes;
+  for (const e of entries) {
+    header.writeUInt16LE(e.tag, entryAt);
+    header.writeUInt16LE(e.type, entryAt + 2);
+    header.writeUInt32LE(e.type === RATIONAL ? e.values.length / 2 : e.values.length, entryAt + 4);
+    const n = valueBytes(e);
+    if (n <= 4) {
+      writeValues(e, entryAt + 8);
+    } else {
+      header.writeUInt32LE(extraAt, entryAt + 8);
+      writeValues(e, extraAt);
+      extraAt += n;
+    }
+    entryAt += 12;
+  }
+  header.writeUInt32LE(0, entryAt); // No next IFD
+  return header;
+}
+
+// ============== NPY ==============
+
+// NPY v1.0 header: magic, version, length, then the dict padded so data starts on 64 bytes
+function npyHeader(descr: string, shape: number[]): Buffer {
+  const shapeText = shape.length === 1 ? `(${shape[0]},)` : `(${shape.join(", ")})`;
+  let dict = `{'descr': '${descr}', 'fortran_order': False, 'shape': ${shapeText}, }`;
+  const unpadded = 10 + dict.length + 1;
+  dict += " ".repeat((64 - (unpadded % 64)) % 64) + "\n";
+
+  const header = Buffer.alloc(10 + dict.length);
+  header.write("\x93NUMPY", 0, "latin1");
+  header.writeUInt8(1, 6);
+  header.writeUInt8(0, 7);
+  header.writeUInt16LE(dict.length, 8);
+  header.write(dict, 10, "latin1");
+  return header;
+}
+
+/**
+ * The image as a NumPy array of shape (rows, cols) or (rows, cols, channels), in
+ * memory order, so np.load() gives the same array cv2 would (channels stay BGR).
+ */
+export async function writeNpyImage(filePath: string, source: RasterSource): Promise<void> {
+  const sample = sampleTypeForDepth(source.depth);
+  const shape = source.channels === 1
+    ? [source.rows, source.cols]
+    : [source.rows, source.cols, source.channels];
+  const rowBytes = source.cols * source.channels * sample.bytes;
+
+  async function* chunks(): AsyncIterable<Uint8Array> {
+    yield npyHeader(sample.npyDescr, shape);
+    yield* rasterBands(source, rowBytes);
+  }
+  await writeChunks(filePath, chunks());
+}
+
+// Bytes of a typed array in WRITE_CHUNK_BYTES pieces, without copying
+function* arrayChunks(data: NumericArray): Iterable<Uint8Array> {
+  const bytes = new Uint8Array(data.buffer, data.byteOffset, data.byteLength);
+  for (let offset = 0; offset < bytes.length; offset += WRITE_CHUNK_BYTES) {
+    yield bytes.subarray(offset, Math.min(bytes.length, offset + WRITE_CHUNK_BYTES));
+  }
+}
+
+/**
+ * A plotted series as NumPy: shape (n,) in its own element type, or (n, 2)
+ * float64 rows of (x, y) when it is plotted against another variable.
+ */
+export async function writeNpySeries(filePath: string, y: NumericArray, x?: NumericArray): Promise<void> {
+  if (!x) {
+    function* chunks(): Iterable<Uint8Array> {
+      yield npyHeader(npyDescrForArray(y), [y.length]);
+      yield* arrayChunks(y);
+    }
+    await writeChunks(filePath, chunks());
+    return;
+  }
+  const n = Math.min(x.length, y.length);
+  function* pairChunks(): Iterable<Uint8Array> {
+    yield npyHeader("<f8", [n, 2]);
+    const pointsPerChunk = WRITE_CHUNK_BYTES / 16;
+    for (let start = 0; start < n; start += pointsPerChunk) {
+      const end = Math.min(n, start + pointsPerChunk);
+      const pairs = new Float64Array((end - start) * 2);
+      for (let i = start; i < end; i++) {
+        pairs[(i - start) * 2] = x![i];
+        pairs[(i - start) * 2 + 1] = y[i];
+      }
+      yield new Uint8Array(pairs.buffer);
+    }
+  }
+  await writeChunks(filePath, pairChunks());
+}
+
+/**
+ * A plotted series as CSV with an "x,y" header; x is the index when the series
+ * is not plotted against another variable.
+ */
+export async function writeCsvSeries(
+  filePath: string,
+  xName: string,
+  yName: string,
+  y: NumericArray,
+  x?: NumericArray
+): Promise<void> {
+  const n = x ? Math.min(x.length, y.length) : y.length;
+  function* chunks(): Iterable<Uint8Array> {
+    yield Buffer.from(`${xName},${yName}\n`, "utf8");
+    yield* asciiChunks(n, i => `${x ? x[i] : i},${y[i]}`);
+  }
+  await writeChunks(filePath, chunks());
+}
+
+// ============== Point Clouds ==============
+
+export type PointCloudFileFormat = "ply" | "pcd";
+export type PointCloudEncoding = "binary" | "ascii";
+
+/**
+ * PLY or PCD with x, y, z and, when the cloud has them, colors (PLY uchar
+ * red/green/blue, PCD packed rgb) and intensity. Binary files are little endian.
+ */
+export async function writePointCloud(
+  filePath: string,
+  cloud: PackedPointCloud,
+  format: PointCloudFileFormat,
+  encoding: PointCloudEncoding
+): Promise<void> {
+  const header = format === "ply" ? plyHeader(cloud, encoding) : pcdHeader(cloud, encoding);
+  const body = encoding === "ascii"
+    ? asciiChunks(cloud.count, pointLine(cloud, format))
+    : binaryPointChunks(cloud, format);
+  function* chunks(): Iterable<Uint8Array> {
+    yield Buffer.from(header, "latin1");
+    yield* body;
+  }
+  await writeChunks(filePath, chunks());
+}
+
+function plyHeader(cloud: PackedPointCloud, encoding: PointCloudEncoding): string {
+  const lines = [
+    "ply",
+    `format ${encoding === "ascii" ? "ascii" : "binary_little_endian"} 1.0`,
+    `element vertex ${cloud.count}`,
+    "property float x",
+    "property float y",
+    "property float z",
+  ];
+  if (cloud.colors) {
+    lines.push("property uchar red", "property uchar green", "property uchar blue");
+  }
+  if (cloud.intensity) {
+    lines.push("property float intensity");
+  }
+  lines.push("end_header");
+  return lines.join("\n") + "\n";
+}
+
+function pcdHeader(cloud: PackedPointCloud, encoding: PointCloudEncoding): string {
+  const fields = ["x", "y", "z"], sizes = ["4", "4", "4"], types = ["F", "F", "F"];
+  if (cloud.colors) {
+    fields.push("rgb"); sizes.push("4"); types.push("U");
+  }
+  if (cloud.intensity) {
+    fields.push("intensity"); sizes.push("4"); types.push("F");
+  }
+  return [
+    "# .PCD v0.7 - Point Cloud Data file format",
+    "VERSION 0.7",
+    `FIELDS ${fields.join(" ")}`,
+    `SIZE ${sizes.join(" ")}`,
+    `TYPE ${types.join(" ")}`,
+    `COUNT ${fields.map(() => "1").join(" ")}`,
+    `WIDTH ${cloud.count}`,
+    "HEIGHT 1",
+    "VIEWPOINT 0 0 0 1 0 0 0",
+    `POINTS ${cloud.count}`,
+    `DATA ${encoding}`,
+  ].join("\n") + "\n";
+}
+
+function pointLine(cloud: PackedPointCloud, format: PointCloudFileFormat): (i: number) => string {
+  const p = cloud.positions, c = cloud.colors, intensity = cloud.intensity;
+  return (i) => {
+    let line = `${p[i * 3]} ${p[i * 3 + 1]} ${p[i * 3 + 2]}`;
+    if (c) {
+      line += format === "ply"
+        ? ` ${c[i * 3]} ${c[i * 3 + 1]} ${c[i * 3 + 2]}`
+        : ` ${((c[i * 3] << 16) | (c[i * 3 + 1] << 8) | c[i * 3 + 2]) >>> 0}`;
+    }
+    if (intensity) {
+      line += ` ${intensity[i]}`;
+    }
+    return line;
+  };
+}
+
+function* binaryPointChunks(cloud: PackedPointCloud, format: PointCloudFileFormat): Iterable<Uint8Array> {
+  const p = cloud.positions, c = cloud.colors, intensity = cloud.intensity;
+  const colorBytes = c ? (format === "ply" ? 3 : 4) : 0;
+  const stride = 12 + colorBytes + (intensity ? 4 : 0);
+
+  // Positions only: the packed Float32Array already is the file body
+  if (stride === 12) {
+    yield* arrayChunks(p.subarray(0, cloud.count * 3));
+    return;
+  }
+
+  const pointsPerChunk = Math.max(1, Math.floor(WRITE_CHUNK_BYTES / stride));
+  for (let start = 0; start < cloud.count; start += pointsPerChunk) {
+    const end = Math.min(cloud.count, start + pointsPerChunk);
+    const out = Buffer.alloc((end - start) * stride);
+    let o = 0;
+    for (let i = start; i < end; i++) {
+      out.writeFloatLE(p[i * 3], o);
+      out.writeFloatLE(p[i * 3 + 1], o + 4);
+      out.writeFloatLE(p[i * 3 + 2], o + 8);
+      o += 12;
+      if (c) {
+        if (format === "ply") {
+          out[o] = c[i * 3];
+          out[o + 1] = c[i * 3 + 1];
+          out[o + 2] = c[i * 3 + 2];
+        } else {
+          // PCL packs rgb as 0x00RRGGBB, least significant byte (blue) first
+          out[o] = c[i * 3 + 2];
+          out[o + 1] = c[i * 3 + 1];
+          out[o + 2] = c[i * 3];
+          out[o + 3] = 0;
+        }
+        o += colorBytes;
+      }
+      if (intensity) {
+        out.writeFloatLE(intensity[i], o);
+        o += 4;
+      }
+    }
+    yield out;
+  }
+}
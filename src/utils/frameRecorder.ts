@@ -0,0 +1,471 @@
+import * as vscode from "vscode";
+import * as fs from "fs";
+import * as path from "path";
+import * as zlib from "zlib";
+import { promisify } from "util";
+import { fingerprintBuffer } from "./debugger";
+import type { NumericArray } from "./opencv";
+import type { PackedPointCloud } from "../pointCloud/pointCloudProvider";
+
+/**
+ * Per-panel recording of a variable across debug steps.
+ *
+ * While recording is on, every step's data is appended to a ring file in the
+ * extension's storage (cv-debugmate.recording.maxMB per panel; the oldest frames
+ * are overwritten). A frame whose content fingerprint matches the previous one is
+ * stored as a repeat; otherwise it is deflated as the XOR against the previous
+ * frame, with a full keyframe every KEYFRAME_INTERVAL frames or when the layout
+ * changes. The viewer's timeline replays frames from the file, so scrubbing back
+ * never touches the debugger. PanelManager routes the viewer messages here.
+ */
+
+const DEFAULT_MAX_MB = 512;
+const MIN_MAX_MB = 16;
+const KEYFRAME_INTERVAL = 30;
+
+const deflateRaw = promisify(zlib.deflateRaw);
+const inflateRaw = promisify(zlib.inflateRaw);
+const DEFLATE_OPTIONS: zlib.ZlibOptions = { level: zlib.constants.Z_BEST_SPEED };
+
+/**
+ * What a provider hands over after reading a step: the data it sent to the viewer.
+ */
+export type RecordedFrame =
+  | { kind: "mat"; data: Buffer; rows: number; cols: number; channels: number; depth: number }
+  | { kind: "plot"; data: NumericArray }
+  | { kind: "pointCloud"; cloud: PackedPointCloud };
+
+// A frame's layout; frames only delta against a previous frame with the same header
+type FrameHeader =
+  | { kind: "mat"; rows: number; cols: number; channels: number; depth: number }
+  | { kind: "plot"; dtype: string }
+  | { kind: "pointCloud"; count: number; colors: boolean; intensity: boolean };
+
+interface FrameEntry {
+  seq: number;
+  step: number;
+  header: FrameHeader;
+  // Deflated bytes in the ring file; 0 for a repeat of the previous frame
+  offset: number;
+  length: number;
+  // Set for deltas and repeats: the frame they apply to
+  baseSeq?: number;
+}
+
+const PLOT_ARRAY_TYPES: Record<string, new (buffer: ArrayBuffer) => NumericArray> = {
+  Int8Array, Uint8Array, Int16Array, Uint16Array, Int32Array, Uint32Array, Float32Array, Float64Array
+};
+
+function encodeFrame(frame: RecordedFrame): { header: FrameHeader; data: Buffer } {
+  if (frame.kind === "mat") {
+    const { rows, cols, channels, depth } = frame;
+    return { header: { kind: "mat", rows, cols, channels, depth }, data: frame.data };
+  }
+  if (frame.kind === "plot") {
+    const a = frame.data;
+    return {
+      header: { kind: "plot", dtype: a.constructor.name },
+      data: Buffer.from(a.buffer, a.byteOffset, a.byteLength)
+    };
+  }
+  const cloud = frame.cloud;
+  const parts = [cloud.positions.subarray(0, cloud.count * 3), cloud.colors, cloud.intensity]
+    .filter((a): a is Float32Array | Uint8Array => !!a)
+    .map(a => Buffer.from(a.buffer, a.byteOffset, a.byteLength));
+  return {
+    header: { kind: "pointCloud", count: cloud.count, colors: !!cloud.colors, intensity: !!cloud.intensity },
+    data: Buffer.concat(parts)
+  };
+}
+
+// Fresh, aligned bytes of a decoded frame, safe to view as any element type
+function alignedCopy(data: Buffer): Uint8Array {
+  return new Uint8Array(data);
+}
+
+/**
+ * The message that shows a recorded frame in its viewer (the one the provider
+ * sends for a new step), and the provider state that goes with it.
+ */
+function showFrame(panel: vscode.WebviewPanel, header: FrameHeader, data: Buffer) {
+  if (header.kind === "mat") {
+    const { rows, cols, channels, depth } = header;
+    // Deltas and exports continue from what the viewer now shows
+    (panel as any)._lastMatData = { buffer: data, rows, cols, channels, depth };
+    panel.webview.postMessage({ command: "completeData", data: alignedCopy(data), rows, cols, channels, depth });
+  } else if (header.kind === "plot") {
+    const bytes = alignedCopy(data);
+    (panel as any)._plotY = new PLOT_ARRAY_TYPES[header.dtype](bytes.buffer as ArrayBuffer);
+    panel.webview.postMessage({ command: "updateInitialData", data: bytes, dtype: header.dtype });
+  } else {
+    const bytes = alignedCopy(data);
+    const positionBytes = header.count * 12;
+    const colorBytes = header.colors ? header.count * 3 : 0;
+    panel.webview.postMessage({
+      command: "updateData",
+      count: header.count,
+      positions: bytes.subarray(0, positionBytes),
+      colors: header.colors ? bytes.subarray(positionBytes, positionBytes + colorBytes) : undefined,
+      intensity: header.intensity ? bytes.subarray(positionBytes + colorBytes) : undefined
+    });
+  }
+}
+
+function xorBuffers(a: Buffer, b: Buffer): Buffer {
+  const out = Buffer.allocUnsafe(b.length);
+  const n = b.length;
+  let i = 0;
+  if (a.byteOffset % 4 === 0 && b.byteOffset % 4 === 0 && out.byteOffset % 4 === 0) {
+    const words = n >>> 2;
+    const wa = new Uint32Array(a.buffer, a.byteOffset, words);
+    const wb = new Uint32Array(b.buffer, b.byteOffset, words);
+    const wo = new Uint32Array(out.buffer, out.byteOffset, words);
+    for (let w = 0; w < words; w++) {
+      wo[w] = wa[w] ^ wb[w];
+    }
+    i = words * 4;
+  }
+  for (; i < n; i++) {
+    out[i] = a[i] ^ b[i];
+  }
+  return out;
+}
+
+class Recording {
+  recording = true;
+  entries: FrameEntry[] = [];
+  // Index into entries shown by the viewer, or null when it shows live data
+  position: number | null = null;
+  // Serializes appends and replays on the file
+  queue: Promise<void> = Promise.resolve();
+  lastStep = -1;
+
+  private handle: Promise<fs.promises.FileHandle>;
+  private head = 0;
+  private nextSeq = 0;
+  private lastKeySeq = -Infinity;
+  private previous: { seq: number; headerKey: string; fingerprint: string; data: Buffer } | undefined;
+  private replayCache: { seq: number; data: Buffer } | undefined;
+
+  constructor(private readonly filePath: string, private readonly capacity: number) {
+    this.handle = fs.promises.mkdir(path.dirname(filePath), { recursive: true })
+      .then(() => fs.promises.open(filePath, "w+"));
+  }
+
+  get storedBytes(): number {
+    return this.entries.reduce((n, e) => n + e.length, 0);
+  }
+
+  async append(step: number, header: FrameHeader, data: Buffer) {
+    const seq = this.nextSeq++;
+    const headerKey = JSON.stringify(header);
+    const fingerprint = fingerprintBuffer(data);
+    const prev = this.previous;
+    const sameLayout = !!prev && prev.headerKey === headerKey && prev.data.length === data.length;
+
+    let payload: Buffer;
+    let baseSeq: number | undefined;
+    if (sameLayout && prev!.fingerprint === fingerprint) {
+      payload = Buffer.alloc(0);
+      baseSeq = prev!.seq;
+    } else if (sameLayout && seq - this.lastKeySeq < KEYFRAME_INTERVAL) {
+      payload = await deflateRaw(xorBuffers(prev!.data, data), DEFLATE_OPTIONS);
+      baseSeq = prev!.seq;
+    } else {
+      payload = await deflateRaw(data, DEFLATE_OPTIONS);
+    }
+
+    if (payload.length > this.capacity) {
+      console.log(`[FrameRecorder] Frame of ${data.length} bytes does not fit the recording, skipped`);
+      this.previous = undefined;
+      return;
+    }
+    let offset = this.reserve(payload.length);
+    // Making room overwrote the frame this one was encoded against
+    if (baseSeq !== undefined && this.entries[this.entries.length - 1]?.seq !== baseSeq) {
+      payload = await deflateRaw(data, DEFLATE_OPTIONS);
+      baseSeq = undefined;
+      if (payload.length > this.capacity) {
+        this.previous = undefined;
+        return;
+      }
+      offset = this.reserve(payload.length);
+    }
+    if (baseSeq === undefined) {
+      this.lastKeySeq = seq;
+    }
+
+    if (payload.length > 0) {
+      const handle = await this.handle;
+      await handle.write(payload, 0, payload.length, offset);
+    }
+    this.entries.push({ seq, step, header, offset, length: payload.length, baseSeq });
+    this.previous = { seq, headerKey, fingerprint, data };
+  }
+
+  /**
+   * Where the next `length` bytes go: after the last frame, or back at the start
+   * of the file when they would pass its end. Frames in the way are dropped, with
+   * any deltas that depended on them.
+   */
+  private reserve(length: number): number {
+    if (this.head + length > this.capacity) {
+      this.head = 0;
+    }
+    const start = this.head;
+    const end = start + length;
+    const kept: FrameEntry[] = [];
+    for (const e of this.entries) {
+      const overwritten = e.length > 0 && e.offset < end && e.offset + e.length > start;
+      const baseKept = e.baseSeq === undefined || (kept.length > 0 && kept[kept.length - 1].seq === e.baseSeq);
+      if (!overwritten && baseKept) {
+        kept.push(e);
+      }
+    }
+    this.entries = kept;
+    this.head = end;
+    return start;
+  }
+
+  private async readPayload(entry: FrameEntry): Promise<Buffer> {
+    const handle = await this.handle;
+    const compressed = Buffer.alloc(entry.length);
+    await handle.read(compressed, 0, entry.length, entry.offset);
+    return inflateRaw(compressed);
+  }
+
+  /**
+   * Rebuild frame `index` from its keyframe, or from the last replayed frame when
+   * that is on the way (scrubbing forward applies one delta per frame).
+   */
+  async frameAt(index: number): Promise<{ entry: FrameEntry; data: Buffer }> {
+    const target = this.entries[index];
+    let start = index;
+    while (start > 0 && this.entries[start].baseSeq !== undefined) {
+      start--;
+    }
+
+    let data: Buffer;
+    let next: number;
+    const cachedAt = this.replayCache ? this.entries.findIndex(e => e.seq === this.replayCache!.seq) : -1;
+    if (cachedAt >= start && cachedAt <= index) {
+      data = this.replayCache!.data;
+      next = cachedAt + 1;
+    } else {
+      data = await this.readPayload(this.entries[start]);
+      next = start + 1;
+    }
+    for (; next <= index; next++) {
+      const entry = this.entries[next];
+      if (entry.length > 0) {
+        data = xorBuffers(data, await this.readPayload(entry));
+      }
+    }
+    this.replayCache = { seq: target.seq, data };
+    return { entry: target, data };
+  }
+
+  // Stop holding the last frame between steps; the next one starts with a keyframe
+  pause() {
+    this.recording = false;
+    this.previous = undefined;
+  }
+
+  async close() {
+    this.previous = undefined;
+    this.replayCache = undefined;
+    try {
+      await (await this.handle).close();
+    } catch (e) {
+      // Never opened
+    }
+    await fs.promises.rm(this.filePath, { force: true });
+  }
+}
+
+export class FrameRecorder {
+  private static storageDir: string | undefined;
+  private static recordings: Map<vscode.WebviewPanel, Recording> = new Map();
+  private static currentStep = 0;
+  private static fileCounter = 0;
+
+  static initialize(context: vscode.ExtensionContext) {
+    const root = context.storageUri ?? context.globalStorageUri;
+    this.storageDir = path.join(root.fsPath, "recordings");
+    // Recordings do not outlive the session that made them
+    fs.promises.rm(this.storageDir, { recursive: true, force: true })
+      .catch((e) => console.log("[FrameRecorder] Could not clear old recordings:", e));
+  }
+
+  static onDebugStep(version: number) {
+    this.currentStep = version;
+  }
+
+  static isRecording(panel: vscode.WebviewPanel): boolean {
+    return !!this.recordings.get(panel)?.recording;
+  }
+
+  static handlesMessage(message: any): boolean {
+    return message.command === "recordToggle" || message.command === "replayFrame";
+  }
+
+  /**
+   * Viewer messages: start/stop recording, and show a recorded frame. Returns
+   * true once the viewer shows a recorded frame instead of the current data.
+   */
+  static async handleMessage(panel: vscode.WebviewPanel, message: any): Promise<boolean> {
+    if (message.command === "recordToggle") {
+      this.setRecording(panel, !!message.enabled);
+      return false;
+    }
+    return this.replay(panel, Number(message.index));
+  }
+
+  /**
+   * Record `frame` as the panel's data for the current debug step. Does nothing
+   * unless the panel is recording, or when this step is already recorded.
+   */
+  static capture(panel: vscode.WebviewPanel, frame: RecordedFrame) {
+    const rec = this.recordings.get(panel);
+    if (!rec) {
+      return;
+    }
+    // Whatever the provider just sent is live data
+    rec.position = null;
+    const step = this.currentStep;
+    if (!rec.recording || rec.lastStep === step) {
+      this.postState(panel, rec);
+      return;
+    }
+    rec.lastStep = step;
+    const { header, data } = encodeFrame(frame);
+    rec.queue = rec.queue
+      .then(() => rec.append(step, header, data))
+      .catch((e) => console.log("[FrameRecorder] Failed to record frame:", e))
+      .then(() => this.postState(panel, rec));
+  }
+
+  static forget(panel: vscode.WebviewPanel) {
+    const rec = this.recordings.get(panel);
+    if (!rec) {
+      return;
+    }
+    this.recordings.delete(panel);
+    rec.pause();
+    rec.queue = rec.queue
+      .then(() => rec.close())
+      .catch((e) => console.log("[FrameRecorder] Failed to delete recording:", e));
+  }
+
+  private static setRecording(panel: vscode.WebviewPanel, enabled: boolean) {
+    let rec = this.recordings.get(panel);
+    if (!enabled) {
+      rec?.pause();
+    } else if (rec) {
+      rec.recording = true;
+    } else if (this.storageDir) {
+      const config = vscode.workspace.getConfiguration("cv-debugmate");
+      const maxMB = Math.max(MIN_MAX_MB, config.get<number>("recording.maxMB", DEFAULT_MAX_MB));
+      const file = path.join(this.storageDir, `${process.pid}-${Date.now()}-${this.fileCounter++}.bin`);
+      rec = new Recording(file, maxMB * 1024 * 1024);
+      this.recordings.set(panel, rec);
+    }
+    if (rec) {
+      if (enabled) {
+        // Start with what the panel shows now; later frames come from the providers
+        const current = this.currentFrame(panel);
+        if (current) {
+          this.capture(panel, current);
+          return;
+        }
+      }
+      this.postState(panel, rec);
+    }
+  }
+
+  // The data the providers keep for the panel, as a frame
+  private static currentFrame(panel: vscode.WebviewPanel): RecordedFrame | undefined {
+    const mat = (panel as any)._lastMatData;
+    if (mat) {
+      return { kind: "mat", data: mat.buffer, rows: mat.rows, cols: mat.cols, channels: mat.channels, depth: mat.depth };
+    }
+    if ((panel as any)._plotY) {
+      return { kind: "plot", data: (panel as any)._plotY };
+    }
+    if ((panel as any)._lastCloud) {
+      return { kind: "pointCloud", cloud: (panel as any)._lastCloud };
+    }
+    return undefined;
+  }
+
+  private static replay(panel: vscode.WebviewPanel, index: number): Promise<boolean> {
+    const rec = this.recordings.get(panel);
+    if (!rec) {
+      return Promise.resolve(false);
+    }
+    let shown = false;
+    const run = async () => {
+      if (!(index >= 0 && index < rec.entries.length) || (panel as any)._isDisposing) {
+        return;
+      }
+      // A tiled image viewer only takes overview and tile data
+      if ((panel as any)._tiledInfo) {
+        return;
+      }
+      const { entry, data } = await rec.frameAt(index);
+      showFrame(panel, entry.header, data);
+      rec.position = index;
+      shown = true;
+    };
+    rec.queue = rec.queue
+      .then(run)
+      .catch((e) => console.log("[FrameRecorder] Failed to replay frame:", e))
+      .then(() => this.postState(panel, rec));
+    return rec.queue.then(() => shown);
+  }
+
+  private static postState(panel: vscode.WebviewPanel, rec: Recording) {
+    if ((panel as any)._isDisposing) {
+      return;
+    }
+    try {
+      panel.webview.postMessage({
+        command: "recordingState",
+        recording: rec.recording,
+        steps: rec.entries.map(e => e.step),
+        position: rec.position,
+        bytes: rec.storedBytes
+      });
+    } catch (e) {
+      // Panel was disposed
+    }
+  }
+}
+
+/**
+ * Markup of the record button and timeline, placed in each viewer's page;
+ * recordingTimeline.js (bundled into the viewer scripts) drives it.
+ */
+export function getRecordingTimelineHtml(): string {
+  return `
+    <style>
+        #rec-timeline { position: fixed; bottom: 8px; left: 50%; transform: translateX(-50%); z-index: 1000;
+            display: flex; align-items: center; gap: 6px; padding: 4px 8px; border-radius: 4px;
+            background: rgba(30, 30, 30, 0.85); color: #ccc; font: 11px sans-serif; }
+        #rec-timeline button { background: #3c3c3c; color: #ccc; border: 1px solid #555; border-radius: 3px;
+            padding: 2px 6px; font: inherit; cursor: pointer; }
+        #rec-timeline button.active { color: #f14c4c; border-color: #f14c4c; }
+        #rec-timeline .rec-scrub { display: none; align-items: center; gap: 6px; }
+        #rec-timeline.has-frames .rec-scrub { display: flex; }
+        #rec-slider { width: 240px; }
+        #rec-label { min-width: 120px; white-space: nowrap; }
+    </style>
+    <div id="rec-timeline">
+        <button id="rec-toggle" title="Record this variable at every debug step">&#9210; Rec</button>
+        <div class="rec-scrub">
+            <input type="range" id="rec-slider" min="0" max="0" value="0" step="1">
+            <span id="rec-label"></span>
+            <button id="rec-live" title="Back to the current debug state">Live</button>
+        </div>
+    </div>`;
+}
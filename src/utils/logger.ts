@@ -1,3 +1,6 @@
+import { AsyncLocalStorage } from 'async_hooks';
+import { performance } from 'perf_hooks';
+
 // Simple logger with configurable log level
 // Set to false to disable most logs and improve performance
 const ENABLE_DEBUG_LOGS = false;
@@ -23,3 +26,270 @@ export function logError(...args: any[]) {
 export function logWarn(...args: any[]) {
     console.warn('[WARN]', ...args);
 }
+
+// ============== Hot-path tracing ==============
+//
+// Spans of the phases a panel refresh goes through, so a slow refresh can be
+// pinned on the debugger (evaluate, readMemory), the extension host (decode,
+// postMessage) or the webview (webviewDecode, render). Off by default
+// (setting cv-debugmate.tracing.enabled); while off, traceStart() is a flag
+// check and traceEnd() returns at once.
+//
+// visualizeVariable runs each panel request inside runTraced(), so spans started
+// anywhere below, however deep in a provider, are attributed to that panel. The
+// viewers report their own decode and render times with the 'rendered' message.
+// TraceStatus (utils/traceStatus.ts) shows the last refresh of the active panel
+// and exports everything in Chrome trace format (chrome://tracing, Perfetto).
+
+export type TracePhase = 'evaluate' | 'readMemory' | 'decode' | 'postMessage' | 'webviewDecode' | 'render';
+
+export const TRACE_PHASES: TracePhase[] = ['evaluate', 'readMemory', 'decode', 'postMessage', 'webviewDecode', 'render'];
+
+export interface TraceSpan {
+    phase: TracePhase;
+    name: string;
+    // tracePanelId() of the panel the work was for, when known
+    panel?: string;
+    // Milliseconds on the host's performance.now() clock
+    start: number;
+    duration: number;
+    // Concurrent lane within the panel, e.g. the readMemory worker
+    lane?: number;
+    args?: Record<string, unknown>;
+}
+
+export interface PhaseBreakdown {
+    phase: TracePhase;
+    // Wall time covered by the phase's spans (overlapping chunks count once)
+    busyMs: number;
+    count: number;
+}
+
+export interface RefreshBreakdown {
+    panel: string;
+    // From the first span of the refresh to the end of the last
+    totalMs: number;
+    phases: PhaseBreakdown[];
+}
+
+// All spans, for the export; the oldest tenth goes when full
+const MAX_SPANS = 200000;
+// Spans of the latest refresh of each panel, for the breakdown
+const MAX_REFRESH_SPANS = 20000;
+const MAX_TRACED_PANELS = 64;
+
+let tracingEnabled = false;
+const spans: TraceSpan[] = [];
+const lastRefresh = new Map<string, TraceSpan[]>();
+const spanListeners = new Set<(span: TraceSpan) => void>();
+const panelScope = new AsyncLocalStorage<string>();
+
+export function tracePanelId(sessionId: string, variableName: string): string {
+    return `${sessionId}:::${variableName}`;
+}
+
+export function tracePanelLabel(panel: string): string {
+    const separator = panel.indexOf(':::');
+    return separator >= 0 ? panel.slice(separator + 3) : panel;
+}
+
+export function setTracingEnabled(enabled: boolean) {
+    tracingEnabled = enabled;
+    if (!enabled) {
+        clearTrace();
+    }
+}
+
+export function isTracingEnabled(): boolean {
+    return tracingEnabled;
+}
+
+export function clearTrace() {
+    spans.length = 0;
+    lastRefresh.clear();
+}
+
+/**
+ * Serve one refresh of `panel`: its breakdown starts over, and spans of `fn`
+ * are attributed to it.
+ */
+export function runTraced<T>(panel: string, fn: () => Promise<T>): Promise<T> {
+    if (!tracingEnabled) {
+        return fn();
+    }
+    lastRefresh.delete(panel);
+    lastRefresh.set(panel, []);
+    if (lastRefresh.size > MAX_TRACED_PANELS) {
+        lastRefresh.delete(lastRefresh.keys().next().value!);
+    }
+    return panelScope.run(panel, fn);
+}
+
+/** Start time of a span, or -1 while tracing is off (traceEnd then does nothing). */
+export function traceStart(): number {
+    return tracingEnabled ? performance.now() : -1;
+}
+
+export function traceEnd(start: number, phase: TracePhase, name: string, args?: Record<string, unknown>, lane?: number) {
+    if (start < 0 || !tracingEnabled) {
+        return;
+    }
+    recordSpan({ phase, name, panel: panelScope.getStore(), start, duration: performance.now() - start, lane, args });
+}
+
+/** End the span once `done` settles, e.g. a webview postMessage being delivered. */
+export function traceUntil(start: number, phase: TracePhase, name: string, done: PromiseLike<unknown>, args?: Record<string, unknown>) {
+    if (start < 0) {
+        return;
+    }
+    done.then(
+        () => traceEnd(start, phase, name, args),
+        () => traceEnd(start, phase, name, { ...args, failed: true })
+    );
+}
+
+/** webview.postMessage, timed until the webview has the message. */
+export function tracePost(webview: { postMessage(message: any): PromiseLike<boolean> }, message: any): PromiseLike<boolean> {
+    const start = traceStart();
+    const delivered = webview.postMessage(message);
+    if (start >= 0) {
+        let bytes = 0;
+        for (const key in message) {
+            const value = message[key];
+            if (value && typeof value.byteLength === 'number') {
+                bytes += value.byteLength;
+            }
+        }
+        traceUntil(start, 'postMessage', String(message.command), delivered, { bytes });
+    }
+    return delivered;
+}
+
+export async function traceAsync<T>(phase: TracePhase, name: string, fn: () => Promise<T>, args?: Record<string, unknown>): Promise<T> {
+    if (!tracingEnabled) {
+        return fn();
+    }
+    const start = performance.now();
+    try {
+        return await fn();
+    } finally {
+        traceEnd(start, phase, name, args);
+    }
+}
+
+/**
+ * Timings a webview measured on its own clock. They end now, back to back:
+ * decode, then the render it led to.
+ */
+export function recordWebviewTiming(panel: string, decodeMs: unknown, renderMs: unknown) {
+    if (!tracingEnabled) {
+        return;
+    }
+    const now = performance.now();
+    const render = typeof renderMs === 'number' && renderMs >= 0 ? renderMs : 0;
+    if (typeof decodeMs === 'number' && decodeMs >= 0) {
+        recordSpan({ phase: 'webviewDecode', name: 'decode', panel, start: now - render - decodeMs, duration: decodeMs });
+    }
+    if (typeof renderMs === 'number' && renderMs >= 0) {
+        recordSpan({ phase: 'render', name: 'draw', panel, start: now - render, duration: render });
+    }
+}
+
+function recordSpan(span: TraceSpan) {
+    if (spans.length >= MAX_SPANS) {
+        spans.splice(0, MAX_SPANS / 10);
+    }
+    spans.push(span);
+    if (span.panel) {
+        let refresh = lastRefresh.get(span.panel);
+        if (!refresh) {
+            refresh = [];
+            lastRefresh.set(span.panel, refresh);
+        }
+        if (refresh.length < MAX_REFRESH_SPANS) {
+            refresh.push(span);
+        }
+    }
+    for (const listener of spanListeners) {
+        listener(span);
+    }
+}
+
+export function onTraceSpan(listener: (span: TraceSpan) => void): { dispose(): void } {
+    spanListeners.add(listener);
+    return { dispose: () => spanListeners.delete(listener) };
+}
+
+export function getRefreshBreakdown(panel: string): RefreshBreakdown | undefined {
+    const refresh = lastRefresh.get(panel);
+    if (!refresh || refresh.length === 0) {
+        return undefined;
+    }
+    let first = Infinity;
+    let last = -Infinity;
+    const phases: PhaseBreakdown[] = [];
+    for (const phase of TRACE_PHASES) {
+        const intervals = refresh
+            .filter((s) => s.phase === phase)
+            .map((s) => [s.start, s.start + s.duration])
+            .sort((a, b) => a[0] - b[0]);
+        if (intervals.length === 0) {
+            continue;
+        }
+        // Union of the intervals, so parallel readMemory workers are not summed
+        let busyMs = 0;
+        let [from, to] = intervals[0];
+        for (const [start, end] of intervals) {
+            if (start > to) {
+                busyMs += to - from;
+                from = start;
+            }
+            to = Math.max(to, end);
+        }
+        busyMs += to - from;
+        first = Math.min(first, intervals[0][0]);
+        last = Math.max(last, to);
+        phases.push({ phase, busyMs, count: intervals.length });
+    }
+    return { panel, totalMs: last - first, phases };
+}
+
+/** Every recorded span as a Chrome trace (JSON object format). */
+export function exportChromeTrace(): { traceEvents: object[]; displayTimeUnit: string } {
+    const HOST_PID = 1;
+    const WEBVIEW_PID = 2;
+    const events: object[] = [
+        { name: 'process_name', ph: 'M', pid: HOST_PID, tid: 0, args: { name: 'Extension host' } },
+        { name: 'process_name', ph: 'M', pid: WEBVIEW_PID, tid: 0, args: { name: 'Webviews' } },
+    ];
+    // One track per panel (and per readMemory worker within it)
+    const tracks = new Map<string, number>();
+    function trackId(pid: number, name: string): number {
+        const key = `${pid}/${name}`;
+        let tid = tracks.get(key);
+        if (tid === undefined) {
+            tid = tracks.size + 1;
+            tracks.set(key, tid);
+            events.push({ name: 'thread_name', ph: 'M', pid, tid, args: { name } });
+        }
+        return tid;
+    }
+
+    for (const span of spans) {
+        const pid = span.phase === 'webviewDecode' || span.phase === 'render' ? WEBVIEW_PID : HOST_PID;
+        const track = (span.panel ? tracePanelLabel(span.panel) : '(no panel)') +
+            (span.lane !== undefined ? ` · worker ${span.lane}` : '');
+        events.push({
+            name: span.name,
+            cat: span.phase,
+            ph: 'X',
+            // Microseconds
+            ts: Math.round(span.start * 1000),
+            dur: Math.max(1, Math.round(span.duration * 1000)),
+            pid,
+            tid: trackId(pid, track),
+            args: { panel: span.panel, ...span.args },
+        });
+    }
+    return { traceEvents: events, displayTimeUnit: 'ms' };
+}
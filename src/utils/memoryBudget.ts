@@ -0,0 +1,112 @@
+import * as vscode from "vscode";
+import { FrameRecorder } from "./frameRecorder";
+import { MatCompare } from "../matImage/matCompare";
+
+/**
+ * Global budget for the data held by viewer panels.
+ *
+ * Panels are created with retainContextWhenHidden, so every hidden tab keeps its
+ * webview alive with the raw buffer and rendered image inside. Viewers report an
+ * estimate of what they hold ('memoryUsage' messages; PanelManager adds what the
+ * extension keeps for the panel). While the total is over
+ * cv-debugmate.memoryBudgetMB, the hidden panels that were visible longest ago
+ * are released: PanelManager swaps their page for a thumbnail, and the next time
+ * one is shown it reloads its variable, through the read cache when the debug
+ * state has not moved. Visible panels are never released, nor are hidden ones
+ * that must keep their data: panels being recorded, and Mat panels an open
+ * comparison reads from.
+ */
+
+const DEFAULT_BUDGET_MB = 2048;
+const MIN_BUDGET_MB = 256;
+
+export class MemoryBudget {
+  private static usage: Map<vscode.WebviewPanel, number> = new Map();
+
+  static getBudgetBytes(): number {
+    const config = vscode.workspace.getConfiguration("cv-debugmate");
+    const mb = config.get<number>("memoryBudgetMB", DEFAULT_BUDGET_MB);
+    return Math.max(MIN_BUDGET_MB, mb) * 1024 * 1024;
+  }
+
+  /**
+   * Record the bytes `panel` holds. Returns the panels to release to get back
+   * under budget (possibly none).
+   */
+  static report(panel: vscode.WebviewPanel, bytes: number): vscode.WebviewPanel[] {
+    this.usage.set(panel, Math.max(0, bytes || 0));
+    return this.overBudget();
+  }
+
+  static forget(panel: vscode.WebviewPanel) {
+    this.usage.delete(panel);
+  }
+
+  /**
+   * Hidden panels to release, least recently visible first, until the rest fit.
+   * Panels already being released no longer count; recording panels and
+   * comparison sources are kept.
+   */
+  static overBudget(): vscode.WebviewPanel[] {
+    const budget = this.getBudgetBytes();
+    let total = 0;
+    for (const [panel, bytes] of this.usage) {
+      if (!(panel as any)._releasing) total += bytes;
+    }
+    if (total <= budget) {
+      return [];
+    }
+
+    const candidates = Array.from(this.usage.entries())
+      .filter(([panel, bytes]) =>
+        bytes > 0 &&
+        !panel.visible &&
+        !(panel as any)._isDisposing &&
+        !(panel as any)._releasing &&
+        !(panel as any)._released &&
+        !FrameRecorder.isRecording(panel) &&
+        !MatCompare.isSourcePanel(panel)
+      )
+      .sort((a, b) => ((a[0] as any)._hiddenAt || 0) - ((b[0] as any)._hiddenAt || 0));
+
+    const victims: vscode.WebviewPanel[] = [];
+    for (const [panel, bytes] of candidates) {
+      if (total <= budget) break;
+      victims.push(panel);
+      total -= bytes;
+    }
+    if (victims.length > 0) {
+      console.log(
+        `[MemoryBudget] ${(total / 1048576).toFixed(0)} MB after releasing ${victims.length} hidden panel(s), budget ${(budget / 1048576).toFixed(0)} MB`
+      );
+    }
+    return victims;
+  }
+}
+
+/**
+ * Page shown in place of a released panel: the viewer's last frame, scaled down.
+ */
+export function getReleasedPanelHtml(thumbnail: string | null): string {
+  // Only a data: URL from our own viewer is embedded
+  const image = thumbnail && /^data:image\/(png|jpeg);base64,[A-Za-z0-9+/=]+$/.test(thumbnail)
+    ? `<img src="${thumbnail}" alt="">`
+    : "";
+  return `<!DOCTYPE html>
+<html lang="en">
+<head>
+    <meta charset="UTF-8">
+    <meta http-equiv="Content-Security-Policy" content="default-src 'none'; img-src data:; style-src 'unsafe-inline';">
+    <style>
+        body { margin: 0; height: 100vh; display: flex; flex-direction: column; align-items: center; justify-content: center; background: #1e1e1e; color: #ccc; font-family: sans-serif; }
+        img { max-width: 90vw; max-height: 80vh; image-rendering: pixelated; opacity: 0.6; }
+        p { font-size: 12px; margin-top: 12px; text-align: center; }
+    </style>
+</head>
+<body>
+    ${image}
+    <p>Data released to stay within the C++ DebugMate memory budget (cv-debugmate.memoryBudgetMB).<br>
+    It reloads when this tab is shown while the variable is in scope.</p>
+</body>
+</html>`;
+}
@@ -0,0 +1,160 @@
+/**
+ * Session-wide cache of debuggee memory ranges.
+ *
+ * The same buffer is often viewed from several panels in one step (image + plot of
+ * the same cv::Mat, `pMat` and `shared_mat` pointing at one Mat, ROIs into one
+ * buffer). Reads go through MemoryCache.read so each unique range is fetched from
+ * the debugger once per debug-state version; ranges contained in a cached range
+ * are served as sub-buffers, and concurrent reads of the same range share one request.
+ *
+ * PanelManager.incrementDebugStateVersion() invalidates the cache on every step.
+ */
+
+import { isReadCancelled } from "./cancellation";
+
+interface CacheEntry {
+  sessionId: string;
+  start: bigint;
+  length: number;
+  buffer: Buffer;
+  version: number;
+  lastUsed: number;
+}
+
+// Cached bytes are dropped least-recently-used beyond this budget
+const MAX_CACHE_BYTES = 512 * 1024 * 1024;
+
+export class MemoryCache {
+  private static entries: CacheEntry[] = [];
+  private static inflight: Map<string, Promise<Buffer | null>> = new Map();
+  private static version = 0;
+  private static cachedBytes = 0;
+  private static useCounter = 0;
+
+  /**
+   * Debug-state version the cached ranges belong to.
+   */
+  static getVersion(): number {
+    return this.version;
+  }
+
+  /**
+   * Drop all cached ranges and start a new version. Called on each debug step.
+   */
+  static invalidate(version: number) {
+    this.version = version;
+    this.entries = [];
+    this.inflight.clear();
+    this.cachedBytes = 0;
+  }
+
+  /**
+   * Drop cached ranges of an ended debug session.
+   */
+  static clearSession(sessionId: string) {
+    this.entries = this.entries.filter(e => e.sessionId !== sessionId);
+    this.cachedBytes = this.entries.reduce((sum, e) => sum + e.length, 0);
+  }
+
+  private static parseAddress(memoryReference: string): bigint | null {
+    const match = memoryReference?.match(/^\s*(0x[0-9a-fA-F]+)/);
+    if (!match) return null;
+    return BigInt(match[1]);
+  }
+
+  private static lookup(sessionId: string, start: bigint, length: number): Buffer | null {
+    const end = start + BigInt(length);
+    for (const entry of this.entries) {
+      if (entry.sessionId !== sessionId || entry.version !== this.version) continue;
+      if (entry.start <= start && end <= entry.start + BigInt(entry.length)) {
+        entry.lastUsed = ++this.useCounter;
+        const offset = Number(start - entry.start);
+        // Hand out the same Buffer for an exact match so its fingerprint is reused
+        if (offset === 0 && length === entry.length) {
+          return entry.buffer;
+        }
+        return entry.buffer.subarray(offset, offset + length);
+      }
+    }
+    return null;
+  }
+
+  private static store(sessionId: string, start: bigint, buffer: Buffer, version: number) {
+    if (version !== this.version || buffer.length > MAX_CACHE_BYTES) return;
+
+    // A new range that covers older ones replaces them
+    const end = start + BigInt(buffer.length);
+    this.entries = this.entries.filter(e => {
+      const covered = e.sessionId === sessionId && start <= e.start && e.start + BigInt(e.length) <= end;
+      if (covered) this.cachedBytes -= e.length;
+      return !covered;
+    });
+
+    this.entries.push({ sessionId, start, length: buffer.length, buffer, version, lastUsed: ++this.useCounter });
+    this.cachedBytes += buffer.length;
+
+    while (this.cachedBytes > MAX_CACHE_BYTES && this.entries.length > 1) {
+      let oldest = 0;
+      for (let i = 1; i < this.entries.length; i++) {
+        if (this.entries[i].lastUsed < this.entries[oldest].lastUsed) oldest = i;
+      }
+      this.cachedBytes -= this.entries[oldest].length;
+      this.entries.splice(oldest, 1);
+    }
+  }
+
+  /**
+   * Return `length` bytes at `memoryReference`, calling `reader` only when the range
+   * is not already cached (or being read) for the current debug-state version.
+   * Memory references that are not plain hex addresses bypass the cache.
+   */
+  static async read(
+    sessionId: string,
+    memoryReference: string,
+    length: number,
+    reader: () => Promise<Buffer | null>
+  ): Promise<Buffer | null> {
+    const start = this.parseAddress(memoryReference);
+    if (start === null || length <= 0) {
+      return reader();
+    }
+
+    const cached = this.lookup(sessionId, start, length);
+    if (cached) {
+      console.log(`[MemoryCache] Hit ${memoryReference} (${length} bytes)`);
+      return cached;
+    }
+
+    const key = `${sessionId}:${start.toString(16)}:${length}`;
+    const pending = this.inflight.get(key);
+    if (pending) {
+      let shared: Buffer | null = null;
+      try {
+        shared = await pending;
+      } catch (e) {
+        if (!isReadCancelled(e)) throw e;
+      }
+      // The other reader may have been cancelled; read on our own in that case
+      if (shared && shared.length === length) {
+        return shared;
+      }
+      return reader();
+    }
+
+    const version = this.version;
+    const promise = reader();
+    this.inflight.set(key, promise);
+    try {
+      const buffer = await promise;
+      // Partial reads are returned to the caller but never cached
+      if (buffer && buffer.length === length) {
+        this.store(sessionId, start, buffer, version);
+      }
+      return buffer;
+    } finally {
+      if (this.inflight.get(key) === promise) {
+        this.inflight.delete(key);
+      }
+    }
+  }
+}
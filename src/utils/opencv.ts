@@ -520,6 +520,7 @@ export function isMatx(variableInfo: any): { isMatx: boolean; rows: number; cols
 // Helper to get CV depth from C++ type name
 function getDepthFromElementType(elementType: string): number {
   const t = elementType.toLowerCase();
+  if (t.includes('float16') || t.includes('hfloat')) return 7; // CV_16F
   if (t.includes('double')) return 6; // CV_64F
   if (t.includes('float')) return 5;  // CV_32F
   if (t.includes('int') || t === 'int32_t') return 4; // CV_32S
@@ -608,6 +609,7 @@ export function getBytesPerElement(depth: number): number {
       return 1;
     case 2: // CV_16U
     case 3: // CV_16S
+    case 7: // CV_16F
       return 2;
     case 4: // CV_32S
     case 5: // CV_32F
@@ -658,6 +660,9 @@ export function convertBytesToValues(bytes: number[], depth: number, count: numb
         const doubleArr = new Float64Array(new Uint8Array(bytes.slice(offset, offset + 8)).buffer);
         value = doubleArr[0];
         break;
+      case 7: // CV_16F
+        value = halfToFloat(bytes[offset] | (bytes[offset + 1] << 8));
+        break;
       default:
         value = bytes[offset];
     }
@@ -667,10 +672,24 @@ export function convertBytesToValues(bytes: number[], depth: number, count: numb
   return values;
 }
 
+// Decode an IEEE 754 half-precision bit pattern (CV_16F element)
+export function halfToFloat(h: number): number {
+  const sign = (h & 0x8000) ? -1 : 1;
+  const exponent = (h >> 10) & 0x1f;
+  const mantissa = h & 0x3ff;
+  if (exponent === 0) {
+    return sign * mantissa * Math.pow(2, -24);
+  }
+  if (exponent === 31) {
+    return mantissa ? NaN : sign * Infinity;
+  }
+  return sign * (1 + mantissa / 1024) * Math.pow(2, exponent - 15);
+}
+
 // Parse numeric result from evaluate response
 export function parseNumericResult(result: string, depth: number): number {
   let value: number;
-  if (depth === 5 || depth === 6) {
+  if (depth === 5 || depth === 6 || depth === 7) {
     value = parseFloat(result);
     if (isNaN(value)) {
       value = 0;
@@ -684,6 +703,103 @@ export function parseNumericResult(result: string, depth: number): number {
   return value;
 }
 
+// ============== Typed Array Views ==============
+
+/**
+ * Element arrays handed to the plot webview. Memory read from the debuggee is
+ * viewed in place where the element type allows it; only 64-bit integers and
+ * half floats are widened, since JS has no typed array for them as numbers.
+ */
+export type NumericArray =
+  | Int8Array | Uint8Array | Int16Array | Uint16Array
+  | Int32Array | Uint32Array | Float32Array | Float64Array;
+
+export type ElementKind = "u8" | "i8" | "u16" | "i16" | "u32" | "i32" | "u64" | "i64" | "f16" | "f32" | "f64";
+
+const ELEMENT_KIND_BYTES: Record<ElementKind, number> = {
+  u8: 1, i8: 1, u16: 2, i16: 2, u32: 4, i32: 4, u64: 8, i64: 8, f16: 2, f32: 4, f64: 8
+};
+
+/**
+ * Element kind of a C++ scalar type name as the plot readers see it. The checks
+ * run most specific first, e.g. "unsigned char" before "char"; unknown types
+ * are read as float.
+ */
+export function getElementKindFromCppType(type: string): { kind: ElementKind; bytesPerElement: number } {
+  const t = type.toLowerCase();
+  let kind: ElementKind = "f32";
+  if (t.includes("float16") || t.includes("hfloat")) kind = "f16";
+  else if (t.includes("double")) kind = "f64";
+  else if (t.includes("float")) kind = "f32";
+  else if (t.includes("unsigned char") || t.includes("uchar") || t.includes("uint8_t")) kind = "u8";
+  else if (t.includes("char") || t.includes("int8_t")) kind = "i8";
+  else if (t.includes("unsigned short") || t.includes("ushort") || t.includes("uint16_t")) kind = "u16";
+  else if (t.includes("short") || t.includes("int16_t")) kind = "i16";
+  // 64-bit before 32-bit: "uint64_t" and "int64_t" also contain "int"
+  else if (t.includes("unsigned long long") || t.includes("uint64_t")) kind = "u64";
+  else if (t.includes("long long") || t.includes("int64_t")) kind = "i64";
+  else if (t.includes("unsigned int") || t.includes("uint32_t")) kind = "u32";
+  else if (t.includes("int") || t.includes("int32_t")) kind = "i32";
+  else if (t.includes("unsigned long")) kind = "u32";
+  else if (t.includes("long")) kind = "i32";
+  return { kind, bytesPerElement: ELEMENT_KIND_BYTES[kind] };
+}
+
+export function getElementKindFromDepth(depth: number): ElementKind {
+  switch (depth) {
+    case 0: return "u8";
+    case 1: return "i8";
+    case 2: return "u16";
+    case 3: return "i16";
+    case 4: return "i32";
+    case 5: return "f32";
+    case 6: return "f64";
+    case 7: return "f16";
+    default: return "u8";
+  }
+}
+
+/**
+ * View `count` little-endian elements of `buffer` as a typed array. Aligned
+ * buffers are viewed without copying (so the result shares memory with the
+ * buffer); misaligned ones are copied once into a fresh aligned buffer.
+ */
+export function bufferToTypedArray(buffer: Buffer, kind: ElementKind, count: number): NumericArray {
+  const bytesPerElement = ELEMENT_KIND_BYTES[kind];
+  const byteLength = count * bytesPerElement;
+  if (kind === "u64" || kind === "i64") {
+    const out = new Float64Array(count);
+    for (let i = 0; i < count; i++) {
+      out[i] = Number(kind === "u64" ? buffer.readBigUInt64LE(i * 8) : buffer.readBigInt64LE(i * 8));
+    }
+    return out;
+  }
+  if (kind === "f16") {
+    const out = new Float32Array(count);
+    for (let i = 0; i < count; i++) {
+      out[i] = halfToFloat(buffer.readUInt16LE(i * 2));
+    }
+    return out;
+  }
+
+  let source: ArrayBuffer = buffer.buffer as ArrayBuffer;
+  let byteOffset = buffer.byteOffset;
+  if (byteOffset % bytesPerElement !== 0) {
+    source = new Uint8Array(buffer.subarray(0, byteLength)).buffer;
+    byteOffset = 0;
+  }
+  switch (kind) {
+    case "u8": return new Uint8Array(source, byteOffset, count);
+    case "i8": return new Int8Array(source, byteOffset, count);
+    case "u16": return new Uint16Array(source, byteOffset, count);
+    case "i16": return new Int16Array(source, byteOffset, count);
+    case "u32": return new Uint32Array(source, byteOffset, count);
+    case "i32": return new Int32Array(source, byteOffset, count);
+    case "f64": return new Float64Array(source, byteOffset, count);
+    default: return new Float32Array(source, byteOffset, count);
+  }
+}
+
 // ============== std::array Support ==============
 
 /**
@@ -742,7 +858,8 @@ export function is3DStdArray(variableInfo: any): {
   width: number; 
   channels: number; 
   elementType: string; 
-  depth: number 
+  depth: number;
+  isVolume?: boolean
 } {
   const type = variableInfo.type || "";
   console.log("Checking if variable is 3D std::array, type:", type);
@@ -760,17 +877,15 @@ export function is3DStdArray(variableInfo: any): {
     const width = parseInt(match[3]);
     const height = parseInt(match[4]);
     
-    // Only consider it an image-suitable 3D array if channels is 1, 3, or 4
-    if (channels !== 1 && channels !== 3 && channels !== 4) {
-      console.log(`is3DStdArray result: false (channels=${channels} is not 1, 3, or 4)`);
-      return { is3DArray: false, height: 0, width: 0, channels: 0, elementType: "", depth: 0 };
-    }
+    // A last extent of 1, 3 or 4 is channels (an image); anything else is a
+    // volume of `height` slices of width x channels, shown slice by slice
+    const isVolume = channels !== 1 && channels !== 3 && channels !== 4;
     
     // Get depth from element type
     const depth = getDepthFromCppType(elementType);
     
     console.log(`is3DStdArray result: height=${height}, width=${width}, channels=${channels}, elementType=${elementType}, depth=${depth}`);
-    return { is3DArray: true, height, width, channels, elementType, depth };
+    return { is3DArray: true, height, width, channels, elementType, depth, isVolume };
   }
   
   console.log("is3DStdArray result: false");
@@ -871,6 +986,7 @@ export function isPoint3StdArray(variableInfo: any): {
 export function getDepthFromCppType(cppType: string): number {
   const t = cppType.toLowerCase().trim();
   
+  if (t.includes('float16') || t.includes('hfloat') || t === '__fp16') return 7; // CV_16F
   if (t === 'double' || t.includes('double')) return 6; // CV_64F
   if (t === 'float' || t.includes('float')) return 5;  // CV_32F
   if (t === 'int' || t === 'int32_t' || t.includes('int32_t')) return 4; // CV_32S
@@ -984,7 +1100,8 @@ export function is3DCStyleArray(variableInfo: any): {
   width: number; 
   channels: number; 
   elementType: string; 
-  depth: number 
+  depth: number;
+  isVolume?: boolean
 } {
   const type = variableInfo.type || "";
   console.log("Checking if variable is C-style 3D array, type:", type);
@@ -1002,17 +1119,15 @@ export function is3DCStyleArray(variableInfo: any): {
     const width = parseInt(match[3]);
     const channels = parseInt(match[4]);
     
-    // Only consider it an image-suitable 3D array if channels is 1, 3, or 4
-    if (channels !== 1 && channels !== 3 && channels !== 4) {
-      console.log(`is3DCStyleArray result: false (channels=${channels} is not 1, 3, or 4)`);
-      return { is3DArray: false, height: 0, width: 0, channels: 0, elementType: "", depth: 0 };
-    }
+    // A last extent of 1, 3 or 4 is channels (an image); anything else is a
+    // volume of `height` slices of width x channels, shown slice by slice
+    const isVolume = channels !== 1 && channels !== 3 && channels !== 4;
     
     // Get depth from element type
     const depth = getDepthFromCppType(elementType);
     
     console.log(`is3DCStyleArray result: height=${height}, width=${width}, channels=${channels}, elementType=${elementType}, depth=${depth}`);
-    return { is3DArray: true, height, width, channels, elementType, depth };
+    return { is3DArray: true, height, width, channels, elementType, depth, isVolume };
   }
   
   console.log("is3DCStyleArray result: false");
@@ -1031,6 +1146,8 @@ export interface PCLPointLayout {
   xOffset: number; // byte offset of x field
   yOffset: number; // byte offset of y field
   zOffset: number; // byte offset of z field
+  rgbOffset?: number; // byte offset of the packed rgb/rgba field (b, g, r, a bytes)
+  intensityOffset?: number; // byte offset of the float intensity field
 }
 
 /**
@@ -1038,27 +1155,28 @@ export interface PCLPointLayout {
  * Reference: PCL point_types.hpp
  *
  * PointXYZ      — 16 bytes: x@0  y@4  z@8  (pad@12)
- * PointXYZI     — 16 bytes: x@0  y@4  z@8  (intensity@12, same layout)
+ * PointXYZI     — 16 bytes: x@0  y@4  z@8  intensity@12
  * PointXYZRGB   — 32 bytes: x@0  y@4  z@8  (pad@12, rgb union@16, pad×4@20)
  * PointXYZRGBA  — 32 bytes: same as XYZRGB
  * PointXYZRGBL  — 32 bytes: same
  * PointXYZL     — 32 bytes: x@0  y@4  z@8  (label@16)
  * PointNormal   — 48 bytes: x@0  y@4  z@8  (normal_x@16 ...)
+ * PointXYZINormal — 48 bytes: x@0  y@4  z@8  (normal_x@16 ..., intensity@32)
  * PointXYZLNormal — 52 bytes treated as 64 boundary; use 64 to be safe
  */
 const PCL_POINT_LAYOUTS: Record<string, PCLPointLayout> = {
   // 16-byte types
   "PointXYZ":            { bytesPerPoint: 16, xOffset: 0, yOffset: 4, zOffset: 8 },
-  "PointXYZI":           { bytesPerPoint: 16, xOffset: 0, yOffset: 4, zOffset: 8 },
+  "PointXYZI":           { bytesPerPoint: 16, xOffset: 0, yOffset: 4, zOffset: 8, intensityOffset: 12 },
   "PointXYZL":           { bytesPerPoint: 32, xOffset: 0, yOffset: 4, zOffset: 8 },
   // 32-byte types
-  "PointXYZRGB":         { bytesPerPoint: 32, xOffset: 0, yOffset: 4, zOffset: 8 },
-  "PointXYZRGBA":        { bytesPerPoint: 32, xOffset: 0, yOffset: 4, zOffset: 8 },
-  "PointXYZRGBL":        { bytesPerPoint: 32, xOffset: 0, yOffset: 4, zOffset: 8 },
+  "PointXYZRGB":         { bytesPerPoint: 32, xOffset: 0, yOffset: 4, zOffset: 8, rgbOffset: 16 },
+  "PointXYZRGBA":        { bytesPerPoint: 32, xOffset: 0, yOffset: 4, zOffset: 8, rgbOffset: 16 },
+  "PointXYZRGBL":        { bytesPerPoint: 32, xOffset: 0, yOffset: 4, zOffset: 8, rgbOffset: 16 },
   // 48-byte types
   "PointNormal":         { bytesPerPoint: 48, xOffset: 0, yOffset: 4, zOffset: 8 },
   "PointXYZNormal":      { bytesPerPoint: 48, xOffset: 0, yOffset: 4, zOffset: 8 },
-  "PointXYZINormal":     { bytesPerPoint: 48, xOffset: 0, yOffset: 4, zOffset: 8 },
+  "PointXYZINormal":     { bytesPerPoint: 48, xOffset: 0, yOffset: 4, zOffset: 8, intensityOffset: 32 },
   "PointXYZRGBNormal":   { bytesPerPoint: 56, xOffset: 0, yOffset: 4, zOffset: 8 },
 };
 
@@ -1,4 +1,23 @@
 import * as vscode from "vscode";
+import { MemoryCache } from "./memoryCache";
+import { TileCache } from "../matImage/matTiles";
+import { StrategyCache } from "./strategyCache";
+import { WebviewAssets } from "./webviewAssets";
+import { MemoryBudget, getReleasedPanelHtml } from "./memoryBudget";
+import { FrameRecorder } from "./frameRecorder";
+import { recordWebviewTiming, tracePanelId } from "./logger";
+
+// How long a viewer gets to send its thumbnail before it is released without one
+const RELEASE_REPLY_TIMEOUT_MS = 2000;
+
+export interface PanelRenderedEvent {
+  viewType: string;
+  sessionId: string;
+  variableName: string;
+  // false for a preview or overview still being filled in
+  complete: boolean;
+  time: number;
+}
 
 export class PanelManager {
   private static panels: Map<
@@ -16,6 +35,15 @@ export class PanelManager {
 
   private static currentDebugStateVersion = 0;
 
+  // Viewers report when they have drawn new data ('rendered'); the benchmark
+  // harness times first-pixel and full-render latency from these
+  private static renderedEmitter = new vscode.EventEmitter<PanelRenderedEvent>();
+  static readonly onDidRender = PanelManager.renderedEmitter.event;
+
+  // A panel became the active editor; the trace status bar follows it
+  private static activatedEmitter = new vscode.EventEmitter<{ sessionId: string; variableName: string }>();
+  static readonly onDidActivatePanel = PanelManager.activatedEmitter.event;
+
   /**
    * Initialize the panel manager with extension context.
    */
@@ -23,6 +51,10 @@ export class PanelManager {
     console.log(`[PanelManager] Initialized`);
   }
 
+  static getDebugStateVersion(): number {
+    return this.currentDebugStateVersion;
+  }
+
   /**
    * Increment the debug state version to track steps.
    * Also clears the data pointer mappings since memory addresses may change between steps.
@@ -38,6 +70,10 @@ export class PanelManager {
     for (const entry of this.panels.values()) {
       entry.dataPtr = undefined;
     }
+
+    // Memory contents may have changed, drop all cached reads
+    MemoryCache.invalidate(this.currentDebugStateVersion);
+    FrameRecorder.onDebugStep(this.currentDebugStateVersion);
   }
 
   /**
@@ -166,6 +202,7 @@ export class PanelManager {
     // First, check if this exact variable already has a panel
     if (this.panels.has(key)) {
       const entry = this.panels.get(key)!;
+      this.restoreReleasedPanel(entry.panel);
       entry.panel.title = title;
       if (reveal) {
         entry.panel.reveal(entry.panel.viewColumn, false);
@@ -188,6 +225,7 @@ export class PanelManager {
         if (reveal) {
           existing.panel.reveal(existing.panel.viewColumn, false);
         }
+        this.restoreReleasedPanel(existing.panel);
         // Also register this variable name as pointing to the same panel
         this.panels.set(key, this.panels.get(existing.key)!);
         return existing.panel;
@@ -202,10 +240,34 @@ export class PanelManager {
       {
         enableScripts: true,
         retainContextWhenHidden: true,
+        localResourceRoots: WebviewAssets.localResourceRoots,
       }
     );
 
     this.panels.set(key, { panel, dataPtr });
+    // Most recently used panels are refreshed first after a step
+    (panel as any)._lastActive = Date.now();
+    this.activatedEmitter.fire({ sessionId, variableName });
+
+    // Viewers report the memory they hold, and answer release requests with a thumbnail
+    panel.webview.onDidReceiveMessage((message) => {
+      if ((panel as any)._isDisposing) {
+        return;
+      }
+      if (message.command === "memoryUsage") {
+        this.reportMemoryUsage(panel, message.bytes);
+      } else if (message.command === "released") {
+        this.finishRelease(panel, message.thumbnail || null);
+      } else if (message.command === "rendered") {
+        this.renderedEmitter.fire({ viewType, sessionId, variableName, complete: !!message.complete, time: Date.now() });
+        recordWebviewTiming(tracePanelId(sessionId, variableName), message.decodeMs, message.renderMs);
+      } else if (FrameRecorder.handlesMessage(message)) {
+        // A replayed frame is not the current data: the next refresh must send it again
+        FrameRecorder.handleMessage(panel, message).then((replayed) => {
+          if (replayed) this.forgetStateToken(panel);
+        });
+      }
+    });
 
     // Register the data pointer mapping
     if (dataPtr) {
@@ -267,6 +329,10 @@ export class PanelManager {
         }, 300);
       }
 
+      clearTimeout((panel as any)._releaseTimer);
+      MemoryBudget.forget(panel);
+      FrameRecorder.forget(panel);
+
       // Clean up panel references (deferred to avoid blocking)
       setTimeout(() => {
         const entry = this.panels.get(key);
@@ -284,6 +350,20 @@ export class PanelManager {
     });
 
     panel.onDidChangeViewState((e) => {
+      if (e.webviewPanel.active) {
+        (e.webviewPanel as any)._lastActive = Date.now();
+        this.activatedEmitter.fire({ sessionId, variableName });
+      }
+
+      // A released panel reloads its data once it is shown again
+      if (e.webviewPanel.visible && (e.webviewPanel as any)._released) {
+        setTimeout(() => {
+          if (e.webviewPanel.visible && !(e.webviewPanel as any)._isDisposing) {
+            vscode.commands.executeCommand("cv-debugmate.refreshVisiblePanels");
+          }
+        }, 100);
+      }
+
       // Track if panel was moved to auxiliary window
       // When viewColumn becomes undefined, panel is in auxiliary window
       if (e.webviewPanel.viewColumn === undefined) {
@@ -325,12 +405,111 @@ export class PanelManager {
       } else {
         // Panel is not visible, mark as not visible
         (e.webviewPanel as any)._wasVisible = false;
+        // Hidden panels can be released now if others pushed us over the budget
+        if (!e.webviewPanel.visible && !(e.webviewPanel as any)._isDisposing) {
+          (e.webviewPanel as any)._hiddenAt = Date.now();
+          for (const victim of MemoryBudget.overBudget()) {
+            this.releasePanelData(victim);
+          }
+        }
       }
     });
 
     return panel;
   }
 
+  // ============== Memory budget ==============
+
+  /**
+   * Record what the viewer of `panel` holds, plus the data the extension keeps
+   * for it (the last Mat buffer for deltas and exports, plotted series), and
+   * release hidden panels if that puts us over the budget.
+   */
+  private static reportMemoryUsage(panel: vscode.WebviewPanel, viewerBytes: number) {
+    if ((panel as any)._released) {
+      return;
+    }
+    const hostBytes = ((panel as any)._lastMatData?.buffer?.length || 0) +
+      ((panel as any)._plotY?.byteLength || 0) +
+      ((panel as any)._plotX?.data?.byteLength || 0);
+    for (const victim of MemoryBudget.report(panel, (Number(viewerBytes) || 0) + hostBytes)) {
+      this.releasePanelData(victim);
+    }
+  }
+
+  /**
+   * Ask the viewer of a hidden panel for its thumbnail; finishRelease() swaps the
+   * page out when it answers (or after RELEASE_REPLY_TIMEOUT_MS).
+   */
+  private static releasePanelData(panel: vscode.WebviewPanel) {
+    if ((panel as any)._releasing || (panel as any)._released || (panel as any)._isDisposing) {
+      return;
+    }
+    (panel as any)._releasing = true;
+    try {
+      panel.webview.postMessage({ command: "releaseData" });
+    } catch (e) {
+      // Panel was disposed
+    }
+    (panel as any)._releaseTimer = setTimeout(() => this.finishRelease(panel, null), RELEASE_REPLY_TIMEOUT_MS);
+  }
+
+  private static finishRelease(panel: vscode.WebviewPanel, thumbnail: string | null) {
+    if (!(panel as any)._releasing || (panel as any)._isDisposing) {
+      return;
+    }
+    clearTimeout((panel as any)._releaseTimer);
+    (panel as any)._releasing = false;
+    // Shown again while the viewer was answering: it still has its data
+    if (panel.visible) {
+      return;
+    }
+
+    console.log(`[PanelManager] Releasing data of hidden panel "${panel.title}"`);
+    (panel as any)._released = true;
+    // Provider state that describes the page being dropped
+    (panel as any)._lastMatData = undefined;
+    (panel as any)._tiledInfo = undefined;
+    (panel as any)._tiledLayout = undefined;
+    (panel as any)._tileHandler = undefined;
+    (panel as any)._sliceLayout = undefined;
+    (panel as any)._sliceHandler = undefined;
+    (panel as any)._plotY = undefined;
+    (panel as any)._plotX = undefined;
+    (panel as any)._lastCloud = undefined;
+    panel.webview.html = getReleasedPanelHtml(thumbnail);
+    MemoryBudget.report(panel, 0);
+
+    // Make every variable shown in this panel load again on its next refresh
+    for (const entry of this.panels.values()) {
+      if (entry.panel === panel) {
+        entry.lastStateToken = undefined;
+        entry.lastRefreshedVersion = undefined;
+      }
+    }
+  }
+
+  private static forgetStateToken(panel: vscode.WebviewPanel) {
+    for (const entry of this.panels.values()) {
+      if (entry.panel === panel) {
+        entry.lastStateToken = undefined;
+      }
+    }
+  }
+
+  /**
+   * A provider is about to draw into a released panel: clear the thumbnail page so
+   * it sets the viewer up again as for a new panel (view state comes back from
+   * SyncManager).
+   */
+  private static restoreReleasedPanel(panel: vscode.WebviewPanel) {
+    if (!(panel as any)._released) {
+      return;
+    }
+    (panel as any)._released = false;
+    panel.webview.html = "";
+  }
+
   /**
    * Wrap a message handler to ignore messages when panel is disposing
    */
@@ -418,5 +597,8 @@ export class PanelManager {
 
     keysToDelete.forEach((k) => this.panels.delete(k));
     ptrKeysToDelete.forEach((k) => this.dataPtrToKey.delete(k));
+    MemoryCache.clearSession(sessionId);
+    TileCache.clearSession(sessionId);
+    StrategyCache.clearSession(sessionId);
   }
 }
@@ -0,0 +1,249 @@
+import * as vscode from "vscode";
+import { isUsingMSVC, tryGetDataPointer } from "./debugger";
+import { NumericArray, bufferToTypedArray, getElementKindFromCppType } from "./opencv";
+
+// ============== Red-Black Tree Walker (std::set / std::map) ==============
+
+/**
+ * std::set and std::map are red-black trees, so their elements cannot be read as
+ * one block like a vector. Instead of asking the debugger for each element, the
+ * walker reads the tree nodes themselves: breadth-first, one level of the tree per
+ * round, with the nodes of a level sorted by address and merged into as few
+ * readMemory requests as possible (nodes allocated back to back share a request).
+ * A tree of N nodes takes about log2(N) rounds.
+ *
+ * Node layouts (64-bit pointers):
+ *   libstdc++ _Rb_tree_node: color(int) 0, parent 8, left 16, right 24, value 32
+ *   libc++    __tree_node:   left 0, right 8, parent 16, is_black(bool) 24, value 25+
+ *   MSVC      _Tree_node:    left 0, parent 8, right 16, color 24, isnil 25, value 26+
+ * The value starts at the first offset after the links aligned for the value type.
+ * Leaves are null in libstdc++/libc++; MSVC points them at the head node, which is
+ * also the root's parent.
+ *
+ * For std::map the "value" is the pair and its key comes first, so the walker reads
+ * keys when given the key type and the pair's alignment.
+ */
+
+const POINTER_SIZE = 8;
+
+// Nodes closer than this are read within one request, gap included
+const NODE_MERGE_GAP = 512;
+const MAX_REQUEST_BYTES = 64 * 1024;
+const REQUEST_CONCURRENCY = 8;
+
+interface TreeLayout {
+  name: string;
+  rootExpressions: (variableName: string) => string[];
+  leftOffset: number;
+  rightOffset: number;
+  parentOffset: number;
+  linkBytes: number;
+}
+
+const TREE_LAYOUTS: TreeLayout[] = [
+  {
+    name: "libstdc++",
+    rootExpressions: v => [`${v}._M_t._M_impl._M_header._M_parent`],
+    leftOffset: 16,
+    rightOffset: 24,
+    parentOffset: 8,
+    linkBytes: 32
+  },
+  {
+    name: "libc++",
+    rootExpressions: v => [
+      `${v}.__tree_.__end_node_.__left_`,
+      `${v}.__tree_.__pair1_.__value_.__left_`,
+      `${v}.__tree_.__pair1_.__first_.__left_`
+    ],
+    leftOffset: 0,
+    rightOffset: 8,
+    parentOffset: 16,
+    linkBytes: 25
+  },
+  {
+    name: "msvc",
+    rootExpressions: v => [`${v}._Mypair._Myval2._Myval2._Myhead->_Parent`],
+    leftOffset: 0,
+    rightOffset: 16,
+    parentOffset: 8,
+    linkBytes: 26
+  }
+];
+
+export interface TreeWalkResult {
+  data: NumericArray;
+  layout: string;
+  rounds: number;
+  requests: number;
+}
+
+function alignUp(value: number, alignment: number): number {
+  return Math.ceil(value / alignment) * alignment;
+}
+
+async function readRange(debugSession: vscode.DebugSession, address: bigint, count: number): Promise<Buffer | null> {
+  try {
+    const response = await debugSession.customRequest("readMemory", {
+      memoryReference: "0x" + address.toString(16),
+      offset: 0,
+      count
+    });
+    const data = response && response.data ? Buffer.from(response.data, "base64") : null;
+    return data && data.length === count ? data : null;
+  } catch (e) {
+    console.log(`[RbTree] readMemory at 0x${address.toString(16)} failed:`, e);
+    return null;
+  }
+}
+
+/**
+ * Read `addresses` (nodes of nodeBytes each) in merged requests. Returns the node
+ * bytes per address, or null if any request failed.
+ */
+async function readNodes(
+  debugSession: vscode.DebugSession,
+  addresses: bigint[],
+  nodeBytes: number
+): Promise<{ nodes: Map<bigint, Buffer>; requests: number } | null> {
+  const sorted = [...addresses].sort((a, b) => (a < b ? -1 : a > b ? 1 : 0));
+  const ranges: { start: bigint; bytes: number; members: bigint[] }[] = [];
+  for (const address of sorted) {
+    const last = ranges[ranges.length - 1];
+    if (last) {
+      const offset = Number(address - last.start);
+      if (offset - last.bytes <= NODE_MERGE_GAP && offset + nodeBytes <= MAX_REQUEST_BYTES) {
+        last.bytes = Math.max(last.bytes, offset + nodeBytes);
+        last.members.push(address);
+        continue;
+      }
+    }
+    ranges.push({ start: address, bytes: nodeBytes, members: [address] });
+  }
+
+  const nodes = new Map<bigint, Buffer>();
+  let next = 0;
+  let failed = false;
+  const worker = async () => {
+    while (!failed && next < ranges.length) {
+      const range = ranges[next++];
+      const data = await readRange(debugSession, range.start, range.bytes);
+      if (!data) {
+        failed = true;
+        return;
+      }
+      for (const member of range.members) {
+        const offset = Number(member - range.start);
+        nodes.set(member, data.subarray(offset, offset + nodeBytes));
+      }
+    }
+  };
+  await Promise.all(Array.from({ length: Math.min(REQUEST_CONCURRENCY, ranges.length) }, () => worker()));
+  return failed ? null : { nodes, requests: ranges.length };
+}
+
+/**
+ * Read the elements of a std::set (or the keys of a std::map, with the pair's
+ * alignment as `valueAlignment`) in sorted order. Returns null when no known
+ * layout matches or the tree does not have `expectedSize` nodes, so callers can
+ * fall back to the debugger's own child enumeration.
+ */
+export async function readRbTreeValues(
+  debugSession: vscode.DebugSession,
+  variableName: string,
+  elementType: string,
+  expectedSize: number,
+  frameId: number,
+  context: string,
+  typeName?: string,
+  valueAlignment?: number
+): Promise<TreeWalkResult | null> {
+  const { kind, bytesPerElement } = getElementKindFromCppType(elementType);
+  const alignment = Math.min(valueAlignment || bytesPerElement, POINTER_SIZE);
+
+  // MSVC sessions only ever see the MSVC STL; the others can be either library
+  const layouts = isUsingMSVC(debugSession)
+    ? TREE_LAYOUTS.filter(l => l.name === "msvc")
+    : TREE_LAYOUTS.filter(l => l.name !== "msvc");
+
+  for (const layout of layouts) {
+    const rootPtr = await tryGetDataPointer(
+      debugSession, variableName, layout.rootExpressions(variableName), frameId, context,
+      typeName ? `${typeName}#${layout.name}-root` : undefined
+    );
+    if (!rootPtr) continue;
+
+    const valueOffset = alignUp(layout.linkBytes, alignment);
+    const nodeBytes = valueOffset + bytesPerElement;
+    const root = BigInt(rootPtr);
+    const left = new Map<bigint, bigint>();
+    const right = new Map<bigint, bigint>();
+    const values = new Map<bigint, Buffer>();
+    let sentinel = 0n;
+    let frontier = [root];
+    let rounds = 0;
+    let requests = 0;
+    let failed = false;
+
+    while (frontier.length > 0) {
+      // A corrupt or still-being-built tree must not make the walk run away
+      if (values.size + frontier.length > expectedSize) {
+        failed = true;
+        break;
+      }
+      const read = await readNodes(debugSession, frontier, nodeBytes);
+      if (!read) {
+        failed = true;
+        break;
+      }
+      rounds++;
+      requests += read.requests;
+      if (rounds === 1 && layout.name === "msvc") {
+        sentinel = read.nodes.get(root)!.readBigUInt64LE(layout.parentOffset);
+      }
+
+      const nextFrontier: bigint[] = [];
+      for (const address of frontier) {
+        const node = read.nodes.get(address)!;
+        values.set(address, node.subarray(valueOffset, valueOffset + bytesPerElement));
+        const l = node.readBigUInt64LE(layout.leftOffset);
+        const r = node.readBigUInt64LE(layout.rightOffset);
+        left.set(address, l);
+        right.set(address, r);
+        for (const child of [l, r]) {
+          if (child !== 0n && child !== sentinel && !values.has(child)) {
+            nextFrontier.push(child);
+          }
+        }
+      }
+      frontier = nextFrontier;
+    }
+
+    if (failed || values.size !== expectedSize) {
+      console.log(`[RbTree] ${layout.name} walk of ${variableName} found ${values.size} of ${expectedSize} nodes`);
+      continue;
+    }
+
+    // In-order traversal gives the set's sorted order
+    const out = Buffer.alloc(expectedSize * bytesPerElement);
+    const stack: bigint[] = [];
+    let written = 0;
+    let current = root;
+    const isNode = (p: bigint) => p !== 0n && p !== sentinel && values.has(p);
+    while ((isNode(current) || stack.length > 0) && written < expectedSize) {
+      while (isNode(current)) {
+        stack.push(current);
+        current = left.get(current)!;
+      }
+      current = stack.pop()!;
+      values.get(current)!.copy(out, written * bytesPerElement);
+      written++;
+      current = right.get(current)!;
+    }
+
+    console.log(`[RbTree] Read ${written} ${layout.name} nodes of ${variableName} in ${rounds} rounds, ${requests} requests`);
+    return { data: bufferToTypedArray(out, kind, written), layout: layout.name, rounds, requests };
+  }
+
+  return null;
+}
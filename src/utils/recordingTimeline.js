@@ -0,0 +1,76 @@
+// Record button and timeline of a viewer (markup from getRecordingTimelineHtml).
+// Bundled into each viewer script by esbuild.js; the viewer forwards the
+// extension's 'recordingState' messages to update().
+//
+// Recorded frames come back as the viewer's usual data messages, so the viewer
+// needs nothing else to show them. One replay request is in flight at a time;
+// dragging the slider faster only asks for the latest position.
+
+export function initRecordingTimeline(vscode) {
+    const bar = document.getElementById('rec-timeline');
+    if (!bar) {
+        return { update() {} };
+    }
+    const toggle = document.getElementById('rec-toggle');
+    const slider = document.getElementById('rec-slider');
+    const label = document.getElementById('rec-label');
+    const live = document.getElementById('rec-live');
+
+    let recording = false;
+    let steps = [];
+    let position = null;
+    let inFlight = false;
+    let wanted = null;
+
+    function requestFrame(index) {
+        if (inFlight) {
+            wanted = index;
+            return;
+        }
+        inFlight = true;
+        wanted = null;
+        vscode.postMessage({ command: 'replayFrame', index: index });
+    }
+
+    function render() {
+        toggle.classList.toggle('active', recording);
+        toggle.innerHTML = recording ? '&#9209; Stop' : '&#9210; Rec';
+        bar.classList.toggle('has-frames', steps.length > 0);
+        if (steps.length === 0) return;
+        slider.max = String(steps.length - 1);
+        const shown = position === null ? steps.length - 1 : position;
+        if (!inFlight && wanted === null) {
+            slider.value = String(shown);
+        }
+        label.textContent = position === null
+            ? 'Live · ' + steps.length + ' frame' + (steps.length === 1 ? '' : 's')
+            : 'Frame ' + (position + 1) + '/' + steps.length + ' · step ' + steps[position];
+        live.disabled = position === null;
+    }
+
+    toggle.addEventListener('click', () => {
+        vscode.postMessage({ command: 'recordToggle', enabled: !recording });
+    });
+    slider.addEventListener('input', () => {
+        requestFrame(Number(slider.value));
+    });
+    live.addEventListener('click', () => {
+        // The extension reads the variable again and draws it as for a step
+        vscode.postMessage({ command: 'reload' });
+    });
+
+    return {
+        update(state) {
+            recording = !!state.recording;
+            steps = state.steps || [];
+            position = state.position === undefined ? null : state.position;
+            inFlight = false;
+            if (wanted !== null && wanted < steps.length) {
+                requestFrame(wanted);
+            } else {
+                wanted = null;
+            }
+            render();
+        }
+    };
+}
@@ -0,0 +1,144 @@
+import * as vscode from "vscode";
+import { PanelManager } from "./panelManager";
+import { getPanelRefreshConcurrency } from "./debugger";
+import { FrameRecorder } from "./frameRecorder";
+import { MatCompare } from "../matImage/matCompare";
+
+/**
+ * Refreshes visible panels after debug steps.
+ *
+ * Stepping fires onDidChangeActiveStackItem in bursts (F10 held down, frame
+ * changes while a step settles). The scheduler:
+ * - coalesces a burst into one refresh of the newest frame, started
+ *   COALESCE_MS after the last event;
+ * - cancels what is still in flight for the frame it supersedes right away, so
+ *   reads for a frame we already left stop between chunks;
+ * - refreshes the focused panel first, then the others by most recent use;
+ * - runs getPanelRefreshConcurrency() panels at once, sized from the read
+ *   throughput measured for the debugger.
+ * Step refreshes are not forced: a panel whose fingerprint did not change is
+ * skipped, and one whose Mat kept its geometry gets only its dirty tiles.
+ * Requests that do not come from a step (a panel shown again) leave in-flight
+ * work alone and only refresh panels that missed a step, forced, since the
+ * viewer may have been restored or moved. Hidden panels are skipped unless
+ * they are recording.
+ */
+
+const COALESCE_MS = 60;
+
+export interface RefreshTarget {
+  variableName: string;
+  panel: vscode.WebviewPanel;
+  // Send everything even when the panel's fingerprint is unchanged
+  force: boolean;
+}
+
+export class RefreshScheduler {
+  private generation = 0;
+  private timer: NodeJS.Timeout | undefined;
+  private running: Promise<void> | undefined;
+  private fullRefreshPending = false;
+
+  constructor(
+    private readonly refreshPanel: (target: RefreshTarget) => Promise<void>,
+    private readonly cancelInFlight: (sessionId: string) => void
+  ) {}
+
+  /**
+   * Ask for a refresh of the visible panels. Calls within COALESCE_MS of each
+   * other result in a single refresh. `supersedes` is true when the debug state
+   * moved, so everything still in flight is stale.
+   */
+  request(supersedes: boolean = true) {
+    if (supersedes) {
+      this.generation++;
+      this.fullRefreshPending = true;
+      const debugSession = vscode.debug.activeDebugSession;
+      if (debugSession) {
+        this.cancelInFlight(debugSession.id);
+      }
+    }
+    if (this.timer) {
+      clearTimeout(this.timer);
+    }
+    this.timer = setTimeout(() => {
+      this.timer = undefined;
+      this.start(this.generation);
+    }, COALESCE_MS);
+  }
+
+  private async start(generation: number) {
+    // The superseded run has been cancelled; let it unwind before loading the debugger again
+    if (this.running) {
+      await this.running;
+    }
+    if (generation !== this.generation) {
+      return;
+    }
+    const full = this.fullRefreshPending;
+    this.fullRefreshPending = false;
+    const run = this.run(generation, full);
+    this.running = run;
+    try {
+      await run;
+    } finally {
+      if (this.running === run) {
+        this.running = undefined;
+      }
+    }
+  }
+
+  private async run(generation: number, full: boolean) {
+    const debugSession = vscode.debug.activeDebugSession;
+    if (!debugSession) {
+      return;
+    }
+    const queue = this.collectTargets(debugSession.id, full);
+    if (queue.length === 0) {
+      return;
+    }
+
+    const isCurrent = () =>
+      generation === this.generation &&
+      !!vscode.debug.activeDebugSession &&
+      vscode.debug.activeDebugSession.id === debugSession.id;
+
+    const concurrency = Math.min(getPanelRefreshConcurrency(debugSession), queue.length);
+    console.log(`[RefreshScheduler] Refreshing ${queue.length} panels, ${concurrency} at a time`);
+
+    const worker = async () => {
+      while (isCurrent() && queue.length > 0) {
+        const target = queue.shift()!;
+        if ((target.panel as any)._isDisposing) continue;
+        try {
+          await this.refreshPanel(target);
+        } catch (e) {
+          console.log(`[RefreshScheduler] Failed to refresh panel for ${target.variableName}:`, e);
+        }
+      }
+    };
+    await Promise.all(Array.from({ length: concurrency }, () => worker()));
+  }
+
+  /**
+   * Visible, recording and compared panels of the session (only those behind the
+   * current debug state unless `full`), the focused one first and the rest by most
+   * recent use. A panel shared by several variable names is refreshed once.
+   */
+  private collectTargets(sessionId: string, full: boolean): RefreshTarget[] {
+    const targets: RefreshTarget[] = [];
+    const seen = new Set<vscode.WebviewPanel>();
+    for (const [key, entry] of PanelManager.getAllPanels().entries()) {
+      const panel = entry.panel;
+      if ((panel as any)._isDisposing || seen.has(panel)) continue;
+      const [viewType, panelSessionId, variableName] = key.split(":::");
+      if (panelSessionId !== sessionId) continue;
+      if (!panel.visible && !FrameRecorder.isRecording(panel) && !MatCompare.isSource(sessionId, variableName)) continue;
+      if (!full && !PanelManager.needsVersionRefresh(viewType, panelSessionId, variableName)) continue;
+      seen.add(panel);
+      targets.push({ variableName, panel, force: !full });
+    }
+    const rank = (panel: vscode.WebviewPanel) => (panel.active ? Infinity : (panel as any)._lastActive || 0);
+    return targets.sort((a, b) => rank(b.panel) - rank(a.panel));
+  }
+}
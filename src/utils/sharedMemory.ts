@@ -0,0 +1,188 @@
+import * as vscode from "vscode";
+import * as os from "os";
+import * as fs from "fs";
+import * as path from "path";
+
+// ============== Published Segments (cvdm::publish) ==============
+
+/**
+ * The debuggee can link test_cpp/cvdm_publish.hpp and call cvdm::publish(name, data)
+ * to copy a buffer into <temp dir>/cv-debugmate/<name>.cvdm. Reading that file is
+ * limited by disk/page cache bandwidth instead of DAP readMemory.
+ *
+ * A segment is only used when its header records the same source address and byte
+ * size as the variable being viewed, and VERIFY_BLOCKS blocks spread evenly over the
+ * whole range (first and last included) still match the live memory. A segment
+ * modified after publish is ignored when the change touches a sampled block; like
+ * the "sampled" panel fingerprint, edits that fall between samples go unnoticed.
+ */
+
+const SEGMENT_MAGIC = "CVDM";
+const SEGMENT_VERSION = 1;
+const HEADER_SIZE = 64;
+const VERIFY_BYTES = 256;
+const VERIFY_BLOCKS = 16;
+
+export const SEGMENT_KIND_MAT = 1;
+export const SEGMENT_KIND_POINT3F = 2;
+export const SEGMENT_KIND_FLOAT = 3;
+
+export interface SegmentHeader {
+  kind: number;
+  rows: number;
+  cols: number;
+  type: number;
+  step: number;
+  srcAddress: bigint;
+  dataBytes: number;
+  sequence: number;
+}
+
+function getPublishDir(): string {
+  return process.env.CVDM_PUBLISH_DIR || path.join(os.tmpdir(), "cv-debugmate");
+}
+
+function parseHeader(buf: Buffer): SegmentHeader | null {
+  if (buf.length < HEADER_SIZE || buf.toString("latin1", 0, 4) !== SEGMENT_MAGIC) {
+    return null;
+  }
+  if (buf.readUInt32LE(4) !== SEGMENT_VERSION) {
+    return null;
+  }
+  return {
+    kind: buf.readUInt32LE(8),
+    rows: buf.readInt32LE(12),
+    cols: buf.readInt32LE(16),
+    type: buf.readInt32LE(20),
+    step: Number(buf.readBigUInt64LE(24)),
+    srcAddress: buf.readBigUInt64LE(32),
+    dataBytes: Number(buf.readBigUInt64LE(40)),
+    sequence: Number(buf.readBigUInt64LE(48))
+  };
+}
+
+/**
+ * Find a published segment that holds `totalBytes` bytes copied from `dataPtr`.
+ */
+async function findSegment(
+  dataPtr: string,
+  totalBytes: number,
+  kind: number
+): Promise<{ file: string; header: SegmentHeader } | null> {
+  const ptrMatch = dataPtr.match(/0x[0-9a-fA-F]+/);
+  if (!ptrMatch) return null;
+  const address = BigInt(ptrMatch[0]);
+
+  const dir = getPublishDir();
+  let entries: string[];
+  try {
+    entries = await fs.promises.readdir(dir);
+  } catch {
+    // Nothing has been published
+    return null;
+  }
+
+  for (const entry of entries) {
+    if (!entry.endsWith(".cvdm")) continue;
+    const file = path.join(dir, entry);
+    let handle: fs.promises.FileHandle | undefined;
+    try {
+      handle = await fs.promises.open(file, "r");
+      const headerBuf = Buffer.alloc(HEADER_SIZE);
+      const { bytesRead } = await handle.read(headerBuf, 0, HEADER_SIZE, 0);
+      const header = parseHeader(headerBuf.subarray(0, bytesRead));
+      if (header && header.kind === kind && header.srcAddress === address && header.dataBytes === totalBytes) {
+        return { file, header };
+      }
+    } catch (e) {
+      console.log(`[Publish] Failed to read segment header ${file}:`, e);
+    } finally {
+      await handle?.close();
+    }
+  }
+  return null;
+}
+
+async function matchesLiveMemory(
+  debugSession: vscode.DebugSession,
+  dataPtr: string,
+  payload: Buffer,
+  rowBytes: number,
+  sourceStep: number
+): Promise<boolean> {
+  const memoryReference = dataPtr.match(/0x[0-9a-fA-F]+/)?.[0] || dataPtr;
+  // Packed rows of a strided source (ROI) sit sourceStep apart in live memory
+  const strided = sourceStep > rowBytes && rowBytes > 0;
+  const count = Math.min(VERIFY_BYTES, strided ? rowBytes : payload.length);
+
+  const offsets = new Set<number>();
+  const span = payload.length - count;
+  const blocks = span > 0 ? VERIFY_BLOCKS : 1;
+  for (let i = 0; i < blocks; i++) {
+    let offset = blocks > 1 ? Math.floor((span * i) / (blocks - 1)) : 0;
+    // A block must not cross into a row gap of the live source
+    if (strided && (offset % rowBytes) + count > rowBytes) {
+      offset -= (offset % rowBytes) + count - rowBytes;
+    }
+    offsets.add(offset);
+  }
+
+  const matches = await Promise.all(Array.from(offsets, async (offset) => {
+    const liveOffset = strided
+      ? Math.floor(offset / rowBytes) * sourceStep + (offset % rowBytes)
+      : offset;
+    try {
+      const response = await debugSession.customRequest("readMemory", {
+        memoryReference: memoryReference,
+        offset: liveOffset,
+        count: count
+      });
+      if (!response || !response.data) return false;
+      const live = Buffer.from(response.data, "base64");
+      return live.equals(payload.subarray(offset, offset + count));
+    } catch {
+      return false;
+    }
+  }));
+  return matches.every((m) => m);
+}
+
+/**
+ * Read the payload of a segment published from `dataPtr`, or null if there is no
+ * matching, up-to-date segment. `sourceStep` is the live row step of a strided
+ * source (cvdm::publish packs ROIs row by row).
+ */
+export async function readPublishedSegment(
+  debugSession: vscode.DebugSession,
+  dataPtr: string,
+  totalBytes: number,
+  kind: number,
+  sourceStep?: number
+): Promise<{ buffer: Buffer; header: SegmentHeader } | null> {
+  if (!dataPtr || totalBytes <= 0) return null;
+
+  const segment = await findSegment(dataPtr, totalBytes, kind);
+  if (!segment) return null;
+
+  try {
+    const startTime = Date.now();
+    const contents = await fs.promises.readFile(segment.file);
+    const header = parseHeader(contents);
+    // Re-check: the debuggee may have re-published between the scan and the read
+    if (!header || header.sequence !== segment.header.sequence || contents.length < HEADER_SIZE + totalBytes) {
+      return null;
+    }
+    const buffer = contents.subarray(HEADER_SIZE, HEADER_SIZE + totalBytes);
+
+    if (!(await matchesLiveMemory(debugSession, dataPtr, buffer, header.step, sourceStep || header.step))) {
+      console.log(`[Publish] Segment ${segment.file} is stale, ignoring`);
+      return null;
+    }
+
+    console.log(`[Publish] Loaded ${totalBytes} bytes from ${segment.file} in ${Date.now() - startTime}ms`);
+    return { buffer, header };
+  } catch (e) {
+    console.log(`[Publish] Failed to read segment ${segment.file}:`, e);
+    return null;
+  }
+}
@@ -0,0 +1,107 @@
+import * as vscode from "vscode";
+
+/**
+ * Per-session memory of which probe strategy worked for a type.
+ *
+ * Data-pointer and size lookups try a list of candidate expressions
+ * (`v.__begin_`, `reinterpret_cast<long long>(v.data())`, `&v[0]`, ...) one
+ * evaluate round trip at a time. The form that worked depends on the debugger and
+ * the variable's type, not on the variable, so it is remembered per
+ * (session, debugger type, normalized type) and tried first next time.
+ *
+ * Expressions are stored as templates with the variable name replaced by a
+ * placeholder, so `a.data()` learned on `a` is reused as `b.data()` for `b`.
+ */
+
+export type StrategyProbe = "dataPointer" | "size" | "matInfo";
+
+const VARIABLE_PLACEHOLDER = "\u0000";
+
+export class StrategyCache {
+  private static strategies: Map<string, string> = new Map();
+
+  /**
+   * Reduce a debugger type string to the part that decides the strategy:
+   * no const/volatile, trailing reference or pointer, or whitespace.
+   */
+  static normalizeType(typeName: string): string {
+    return typeName
+      .replace(/\b(const|volatile|class|struct)\b/g, "")
+      .replace(/[&*]+\s*$/g, "")
+      .replace(/\s+/g, "");
+  }
+
+  private static key(debugSession: vscode.DebugSession, probe: StrategyProbe, typeKey: string): string {
+    return `${debugSession.id}|${debugSession.type}|${probe}|${typeKey}`;
+  }
+
+  private static toTemplate(expression: string, variableName: string): string {
+    if (!variableName) return expression;
+    // Whole-name matches only, so `v` in `(void*)v.data()` keeps the `void`
+    const escaped = variableName.replace(/[.*+?^${}()|[\]\\]/g, "\\$&");
+    return expression.replace(new RegExp(`(?<![A-Za-z0-9_])${escaped}(?![A-Za-z0-9_])`, "g"), VARIABLE_PLACEHOLDER);
+  }
+
+  private static fromTemplate(template: string, variableName: string): string {
+    return template.split(VARIABLE_PLACEHOLDER).join(variableName);
+  }
+
+  /**
+   * Key for a candidate list: the normalized type when known, else the list itself
+   * (the same candidate list is only built for the same container family).
+   */
+  static typeKeyFor(typeName: string | undefined, variableName: string, expressions: string[]): string {
+    if (typeName) {
+      return this.normalizeType(typeName);
+    }
+    return "list:" + expressions.map(e => this.toTemplate(e, variableName)).join(";");
+  }
+
+  static get(debugSession: vscode.DebugSession, probe: StrategyProbe, typeKey: string): string | undefined {
+    return this.strategies.get(this.key(debugSession, probe, typeKey));
+  }
+
+  static set(debugSession: vscode.DebugSession, probe: StrategyProbe, typeKey: string, strategy: string) {
+    this.strategies.set(this.key(debugSession, probe, typeKey), strategy);
+  }
+
+  /**
+   * Move the expression that worked last time for this type to the front.
+   */
+  static orderExpressions(
+    debugSession: vscode.DebugSession,
+    probe: StrategyProbe,
+    typeKey: string,
+    variableName: string,
+    expressions: string[]
+  ): string[] {
+    const template = this.get(debugSession, probe, typeKey);
+    if (template === undefined) {
+      return expressions;
+    }
+    const known = this.fromTemplate(template, variableName);
+    const index = expressions.indexOf(known);
+    if (index <= 0) {
+      return expressions;
+    }
+    return [known, ...expressions.slice(0, index), ...expressions.slice(index + 1)];
+  }
+
+  static rememberExpression(
+    debugSession: vscode.DebugSession,
+    probe: StrategyProbe,
+    typeKey: string,
+    variableName: string,
+    expression: string
+  ) {
+    this.set(debugSession, probe, typeKey, this.toTemplate(expression, variableName));
+  }
+
+  static clearSession(sessionId: string) {
+    for (const key of this.strategies.keys()) {
+      if (key.startsWith(`${sessionId}|`)) {
+        this.strategies.delete(key);
+      }
+    }
+  }
+}
@@ -0,0 +1,140 @@
+// ============== Dirty Tile Diff ==============
+
+/**
+ * A changed rectangle of an image, with its pixels packed row by row
+ * (width * height * bytesPerPixel bytes).
+ */
+export interface DirtyTile {
+  x: number;
+  y: number;
+  width: number;
+  height: number;
+  data: Uint8Array;
+}
+
+export const DEFAULT_TILE_SIZE = 64;
+
+// Above this fraction of changed pixels a full update is cheaper than tiles
+export const MAX_DIRTY_RATIO = 0.5;
+
+/**
+ * Compare two equally sized image buffers in fixed-size tiles and return the tiles
+ * that differ. Horizontally adjacent dirty tiles in a tile row are merged into one
+ * rectangle to keep the message count low.
+ *
+ * Returns null when the buffers cannot be diffed (size mismatch) or when so much
+ * changed that sending the whole image is the better choice.
+ */
+export function computeDirtyTiles(
+  previous: Uint8Array,
+  next: Uint8Array,
+  rows: number,
+  cols: number,
+  bytesPerPixel: number,
+  tileSize: number = DEFAULT_TILE_SIZE,
+  maxDirtyRatio: number = MAX_DIRTY_RATIO
+): DirtyTile[] | null {
+  const rowBytes = cols * bytesPerPixel;
+  const totalBytes = rows * rowBytes;
+  if (previous.length !== next.length || next.length < totalBytes || rows <= 0 || cols <= 0) {
+    return null;
+  }
+
+  const prevBuf = Buffer.from(previous.buffer, previous.byteOffset, previous.byteLength);
+  const nextBuf = Buffer.from(next.buffer, next.byteOffset, next.byteLength);
+
+  const tilesX = Math.ceil(cols / tileSize);
+  const tileBytes = tileSize * bytesPerPixel;
+  const maxDirtyPixels = rows * cols * maxDirtyRatio;
+  const dirty = new Uint8Array(tilesX);
+  const tiles: DirtyTile[] = [];
+  let dirtyPixels = 0;
+
+  for (let y0 = 0; y0 < rows; y0 += tileSize) {
+    const height = Math.min(tileSize, rows - y0);
+    dirty.fill(0);
+    let bandDirty = false;
+
+    for (let y = y0; y < y0 + height; y++) {
+      const rowStart = y * rowBytes;
+      const rowEnd = rowStart + rowBytes;
+      // Most rows are unchanged: one compare per row before looking at tiles
+      if (prevBuf.compare(nextBuf, rowStart, rowEnd, rowStart, rowEnd) === 0) {
+        continue;
+      }
+      for (let tx = 0; tx < tilesX; tx++) {
+        if (dirty[tx]) continue;
+        const start = rowStart + tx * tileBytes;
+        const end = Math.min(start + tileBytes, rowEnd);
+        if (prevBuf.compare(nextBuf, start, end, start, end) !== 0) {
+          dirty[tx] = 1;
+          bandDirty = true;
+        }
+      }
+    }
+    if (!bandDirty) continue;
+
+    let tx = 0;
+    while (tx < tilesX) {
+      if (!dirty[tx]) {
+        tx++;
+        continue;
+      }
+      const firstTile = tx;
+      while (tx < tilesX && dirty[tx]) tx++;
+
+      const x = firstTile * tileSize;
+      const width = Math.min(tx * tileSize, cols) - x;
+      dirtyPixels += width * height;
+      if (dirtyPixels > maxDirtyPixels) {
+        return null;
+      }
+
+      const packedRowBytes = width * bytesPerPixel;
+      const data = new Uint8Array(packedRowBytes * height);
+      for (let r = 0; r < height; r++) {
+        const src = (y0 + r) * rowBytes + x * bytesPerPixel;
+        data.set(next.subarray(src, src + packedRowBytes), r * packedRowBytes);
+      }
+      tiles.push({ x, y: y0, width, height, data });
+    }
+  }
+
+  return tiles;
+}
+
+/**
+ * A Mat as last sent to (or about to be sent to) its viewer.
+ */
+export interface MatFrame {
+  buffer: Uint8Array;
+  rows: number;
+  cols: number;
+  channels: number;
+  depth: number;
+}
+
+/**
+ * The message that brings a viewer showing `previous` up to `next`: the dirty
+ * tiles when the geometry is unchanged, the complete image otherwise or when
+ * `force`d (reload, moved or restored panel), null when no pixel changed.
+ */
+export function matUpdateMessage(
+  previous: MatFrame | undefined,
+  next: MatFrame,
+  bytesPerElement: number,
+  force: boolean
+): { command: 'deltaData'; tiles: DirtyTile[] } | ({ command: 'completeData'; data: Uint8Array } & Omit<MatFrame, 'buffer'>) | null {
+  const { rows, cols, channels, depth } = next;
+  if (!force && previous && previous.rows === rows && previous.cols === cols &&
+      previous.channels === channels && previous.depth === depth) {
+    const tiles = computeDirtyTiles(previous.buffer, next.buffer, rows, cols, channels * bytesPerElement);
+    if (tiles && tiles.length === 0) {
+      return null;
+    }
+    if (tiles) {
+      return { command: 'deltaData', tiles };
+    }
+  }
+  return { command: 'completeData', data: new Uint8Array(next.buffer), rows, cols, channels, depth };
+}
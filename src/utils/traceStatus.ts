@@ -0,0 +1,156 @@
+import * as vscode from "vscode";
+import { PanelManager } from "./panelManager";
+import {
+  TracePhase,
+  exportChromeTrace,
+  getRefreshBreakdown,
+  isTracingEnabled,
+  onTraceSpan,
+  setTracingEnabled,
+  tracePanelId,
+  tracePanelLabel
+} from "./logger";
+
+/**
+ * Status bar view of the hot-path tracer (utils/logger.ts) while
+ * cv-debugmate.tracing.enabled is on: where the last refresh of the active panel
+ * spent its time, per phase. Clicking it exports every recorded span as a
+ * Chrome trace.
+ */
+
+const PHASE_LABELS: Record<TracePhase, string> = {
+  evaluate: "eval",
+  readMemory: "read",
+  decode: "decode",
+  postMessage: "post",
+  webviewDecode: "wv decode",
+  render: "render",
+};
+
+const PHASE_SOURCES: Record<TracePhase, string> = {
+  evaluate: "debugger",
+  readMemory: "debugger",
+  decode: "extension host",
+  postMessage: "extension host → webview",
+  webviewDecode: "webview",
+  render: "webview",
+};
+
+// Spans arrive per chunk; the item is redrawn at most this often
+const UPDATE_INTERVAL_MS = 250;
+
+export class TraceStatus {
+  private static item: vscode.StatusBarItem | undefined;
+  // tracePanelId() of the panel shown: the active one, else the last traced
+  private static panel: string | undefined;
+  private static panelIsActive = false;
+  private static updateTimer: ReturnType<typeof setTimeout> | undefined;
+
+  static initialize(context: vscode.ExtensionContext) {
+    const item = vscode.window.createStatusBarItem(vscode.StatusBarAlignment.Right, 90);
+    item.command = "cv-debugmate.exportTrace";
+    this.item = item;
+
+    const subscription = onTraceSpan((span) => {
+      if (span.panel && !this.panelIsActive) {
+        this.panel = span.panel;
+      }
+      if (span.panel === this.panel) {
+        this.scheduleUpdate();
+      }
+    });
+    context.subscriptions.push(
+      item,
+      subscription,
+      PanelManager.onDidActivatePanel(({ sessionId, variableName }) => {
+        this.panel = tracePanelId(sessionId, variableName);
+        this.panelIsActive = true;
+        this.scheduleUpdate();
+      }),
+      vscode.workspace.onDidChangeConfiguration((e) => {
+        if (e.affectsConfiguration("cv-debugmate.tracing.enabled")) {
+          this.applySetting();
+        }
+      })
+    );
+    this.applySetting();
+  }
+
+  static async toggle() {
+    const config = vscode.workspace.getConfiguration("cv-debugmate");
+    await config.update("tracing.enabled", !isTracingEnabled(), vscode.ConfigurationTarget.Global);
+  }
+
+  static async exportTrace() {
+    if (!isTracingEnabled()) {
+      vscode.window.showWarningMessage("Tracing is off. Turn it on (C++ DebugMate: Toggle Performance Tracing), refresh the panels, then export.");
+      return;
+    }
+    const trace = exportChromeTrace();
+    if (!trace.traceEvents.some((e: any) => e.ph === "X")) {
+      vscode.window.showInformationMessage("Nothing traced yet: view or refresh a variable first.");
+      return;
+    }
+    const uri = await vscode.window.showSaveDialog({
+      defaultUri: vscode.Uri.file("cv-debugmate-trace.json"),
+      filters: { "Chrome Trace": ["json"], "All Files": ["*"] }
+    });
+    if (!uri) {
+      return;
+    }
+    try {
+      await vscode.workspace.fs.writeFile(uri, Buffer.from(JSON.stringify(trace)));
+      vscode.window.showInformationMessage(`Trace saved to ${uri.fsPath}. Open it in chrome://tracing or ui.perfetto.dev.`);
+    } catch (e: any) {
+      console.log("Failed to write trace:", e);
+      vscode.window.showErrorMessage(`Failed to write trace: ${e.message || e}`);
+    }
+  }
+
+  private static applySetting() {
+    const enabled = vscode.workspace.getConfiguration("cv-debugmate").get<boolean>("tracing.enabled", false);
+    setTracingEnabled(enabled);
+    if (enabled) {
+      this.update();
+      this.item?.show();
+    } else {
+      this.item?.hide();
+    }
+  }
+
+  private static scheduleUpdate() {
+    if (this.updateTimer) {
+      return;
+    }
+    this.updateTimer = setTimeout(() => {
+      this.updateTimer = undefined;
+      this.update();
+    }, UPDATE_INTERVAL_MS);
+  }
+
+  private static update() {
+    const item = this.item;
+    if (!item || !isTracingEnabled()) {
+      return;
+    }
+    const breakdown = this.panel ? getRefreshBreakdown(this.panel) : undefined;
+    if (!breakdown) {
+      item.text = "$(pulse) tracing";
+      item.tooltip = "C++ DebugMate performance tracing is on. View or refresh a variable to see where its refresh spends time; click to export a Chrome trace.";
+      return;
+    }
+
+    const ms = (v: number) => (v >= 10 ? Math.round(v).toString() : v.toFixed(1));
+    item.text = `$(pulse) ${tracePanelLabel(breakdown.panel)}: ` +
+      breakdown.phases.map((p) => `${PHASE_LABELS[p.phase]} ${ms(p.busyMs)}`).join(" · ") + " ms";
+
+    const tooltip = new vscode.MarkdownString();
+    tooltip.appendMarkdown(`**${tracePanelLabel(breakdown.panel)}**, last refresh: ${ms(breakdown.totalMs)} ms\n\n`);
+    tooltip.appendMarkdown("| phase | ms | spans | where |\n|---|--:|--:|---|\n");
+    for (const p of breakdown.phases) {
+      tooltip.appendMarkdown(`| ${p.phase} | ${ms(p.busyMs)} | ${p.count} | ${PHASE_SOURCES[p.phase]} |\n`);
+    }
+    tooltip.appendMarkdown("\nOverlapping spans (parallel reads) count once. Click to export a Chrome trace.");
+    item.tooltip = tooltip;
+  }
+}
@@ -0,0 +1,52 @@
+import * as vscode from "vscode";
+import * as fs from "fs";
+
+/**
+ * Local viewer scripts for the webviews.
+ *
+ * esbuild.js bundles each viewer script (three.js included for the point viewer)
+ * into dist/media under a content-hashed name and lists them in
+ * dist/media/manifest.json. Panels load them through asWebviewUri, so nothing is
+ * fetched from the network and an unchanged script is served from the webview's
+ * cache; the HTML a panel gets is just the markup plus a small JSON block of
+ * per-panel values (`viewer-config`) that the script reads on start.
+ */
+export class WebviewAssets {
+  private static mediaRoot: vscode.Uri | undefined;
+  private static manifest: Record<string, string> = {};
+
+  static initialize(context: vscode.ExtensionContext) {
+    this.mediaRoot = vscode.Uri.joinPath(context.extensionUri, "dist", "media");
+    const manifestPath = vscode.Uri.joinPath(this.mediaRoot, "manifest.json").fsPath;
+    try {
+      this.manifest = JSON.parse(fs.readFileSync(manifestPath, "utf8"));
+    } catch (e) {
+      console.error(`[WebviewAssets] Could not read ${manifestPath}; run the esbuild step to bundle the viewers:`, e);
+      this.manifest = {};
+    }
+  }
+
+  static get localResourceRoots(): vscode.Uri[] {
+    return this.mediaRoot ? [this.mediaRoot] : [];
+  }
+
+  static scriptUri(webview: vscode.Webview, name: string): string {
+    const file = this.manifest[name];
+    if (!file || !this.mediaRoot) {
+      console.error(`[WebviewAssets] No bundled viewer script "${name}"`);
+      return "";
+    }
+    return webview.asWebviewUri(vscode.Uri.joinPath(this.mediaRoot, file)).toString();
+  }
+
+  /**
+   * The config block and script tag that start viewer `name` with `config`.
+   */
+  static viewerScripts(webview: vscode.Webview, name: string, config: object, nonce?: string): string {
+    const nonceAttr = nonce ? ` nonce="${nonce}"` : "";
+    // "<" is escaped so a value can never close the block early
+    const json = JSON.stringify(config).replace(/</g, "\\u003c");
+    return `<script type="application/json" id="viewer-config">${json}</script>
+        <script${nonceAttr} src="${this.scriptUri(webview, name)}"></script>`;
+  }
+}
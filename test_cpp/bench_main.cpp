@@ -0,0 +1,204 @@
+/**
+ * C++ DebugMate - Benchmark Debuggee (target bench_debugmate)
+ *
+ * Builds a fixed grid of workloads, one at a time, so they can be timed the
+ * same way on every commit:
+ *   - cv::Mat of 1 MB, 16 MB, 256 MB and 1 GB in every depth (single channel)
+ *   - std::vector<float> of 1e3 .. 1e8 elements
+ *   - std::vector<cv::Point3f> of 1e4 .. 1e7 points
+ *   - std::set<int> of 1e5 elements
+ *   - an ROI Mat and a non-continuous (column range) Mat
+ *
+ * Each workload is a local named bench_var, and the program stops on a line
+ * marked BENCH_BREAK with bench_case naming the workload (e.g.
+ * "mat_32F_256MB"). The harness in src/test/bench.test.ts sets breakpoints on
+ * those lines, reads bench_case, views bench_var and continues.
+ *
+ * Usage: bench_debugmate [filter] [max_mb]
+ *   filter  only build cases whose name contains it ("all" or empty: every case)
+ *   max_mb  skip cases larger than this many MB (default 1024)
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+static std::string g_filter;
+static size_t g_max_bytes = size_t(1024) << 20;
+
+static bool wanted(const std::string &name, size_t bytes) {
+  if (bytes > g_max_bytes) {
+    std::cout << "  skip " << name << " (" << (bytes >> 20) << " MB > max)"
+              << std::endl;
+    return false;
+  }
+  return g_filter.empty() || name.find(g_filter) != std::string::npos;
+}
+
+// Keeps bench_var observable at the breakpoint line
+static const void *volatile g_sink = nullptr;
+static void bench_stop(const char *bench_case, const void *bench_var) {
+  g_sink = bench_var;
+  std::cout << "  " << bench_case << std::endl;
+}
+
+// Rows of a 2D workload repeat one random row, so building 1 GB stays quick
+static void fill_rows(cv::Mat &mat) {
+  cv::Mat row32(1, mat.cols * mat.channels(), CV_32F);
+  cv::randu(row32, 0, 255);
+  cv::Mat row;
+  row32.convertTo(row, mat.depth());
+  row = row.reshape(mat.channels(), 1);
+  for (int r = 0; r < mat.rows; r++) {
+    row.copyTo(mat.row(r));
+  }
+}
+
+// ============================================================
+// SECTION 1: MATS (every depth, 1 MB .. 1 GB)
+// ============================================================
+
+static void bench_mat(int depth, const char *depth_name, size_t megabytes) {
+  const std::string name =
+      std::string("mat_") + depth_name + "_" + std::to_string(megabytes) + "MB";
+  const size_t bytes = megabytes << 20;
+  if (!wanted(name, bytes)) {
+    return;
+  }
+  const size_t elem = CV_ELEM_SIZE(CV_MAKETYPE(depth, 1));
+  const int side = static_cast<int>(std::sqrt(static_cast<double>(bytes / elem)));
+
+  cv::Mat bench_var(side, side, CV_MAKETYPE(depth, 1));
+  fill_rows(bench_var);
+  const char *bench_case = name.c_str();
+  bench_stop(bench_case, &bench_var); // BENCH_BREAK
+}
+
+static void bench_mats() {
+  struct Depth {
+    int depth;
+    const char *name;
+  };
+  const Depth depths[] = {
+    {CV_8U, "8U"}, {CV_8S, "8S"}, {CV_16U, "16U"}, {CV_16S, "16S"},
+    {CV_32S, "32S"}, {CV_32F, "32F"}, {CV_64F, "64F"},
+#ifdef CV_16F
+    {CV_16F, "16F"},
+#endif
+  };
+  const size_t sizes_mb[] = {1, 16, 256, 1024};
+  for (const Depth &d : depths) {
+    for (size_t mb : sizes_mb) {
+      bench_mat(d.depth, d.name, mb);
+    }
+  }
+}
+
+// ============================================================
+// SECTION 2: ROI / NON-CONTINUOUS MATS
+// ============================================================
+
+static void bench_strided_mats() {
+  {
+    const std::string name = "mat_roi_8UC3";
+    if (wanted(name, size_t(2048) * 2048 * 3)) {
+      cv::Mat parent(4096, 4096, CV_8UC3);
+      fill_rows(parent);
+      cv::Mat bench_var = parent(cv::Rect(512, 512, 2048, 2048));
+      const char *bench_case = name.c_str();
+      bench_stop(bench_case, &bench_var); // BENCH_BREAK
+    }
+  }
+  {
+    const std::string name = "mat_colrange_32F";
+    if (wanted(name, size_t(4096) * 2000 * 4)) {
+      cv::Mat parent(4096, 4096, CV_32FC1);
+      fill_rows(parent);
+      cv::Mat bench_var = parent.colRange(1000, 3000);
+      const char *bench_case = name.c_str();
+      bench_stop(bench_case, &bench_var); // BENCH_BREAK
+    }
+  }
+}
+
+// ============================================================
+// SECTION 3: VECTORS (1e3 .. 1e8 elements)
+// ============================================================
+
+static void bench_vector(int exponent) {
+  const std::string name = "vector_float_1e" + std::to_string(exponent);
+  const size_t n = static_cast<size_t>(std::pow(10.0, exponent));
+  if (!wanted(name, n * sizeof(float))) {
+    return;
+  }
+  std::vector<float> bench_var(n);
+  for (size_t i = 0; i < n; i++) {
+    bench_var[i] = std::sin(static_cast<float>(i) * 0.001f) * 100.0f;
+  }
+  const char *bench_case = name.c_str();
+  bench_stop(bench_case, &bench_var); // BENCH_BREAK
+}
+
+// ============================================================
+// SECTION 4: POINT CLOUDS (1e4 .. 1e7 points)
+// ============================================================
+
+static void bench_cloud(int exponent) {
+  const std::string name = "cloud_point3f_1e" + std::to_string(exponent);
+  const size_t n = static_cast<size_t>(std::pow(10.0, exponent));
+  if (!wanted(name, n * sizeof(cv::Point3f))) {
+    return;
+  }
+  std::vector<cv::Point3f> bench_var(n);
+  for (size_t i = 0; i < n; i++) {
+    const float t = static_cast<float>(i) / static_cast<float>(n) * 40.0f;
+    bench_var[i] = cv::Point3f(std::cos(t) * (1.0f + t), std::sin(t) * (1.0f + t), t);
+  }
+  const char *bench_case = name.c_str();
+  bench_stop(bench_case, &bench_var); // BENCH_BREAK
+}
+
+// ============================================================
+// SECTION 5: SETS (1e5 elements)
+// ============================================================
+
+static void bench_set() {
+  const std::string name = "set_int_1e5";
+  const size_t n = 100000;
+  // Tree nodes, not the ints, are what the debugger walks
+  if (!wanted(name, n * 40)) {
+    return;
+  }
+  std::set<int> bench_var;
+  for (size_t i = 0; i < n; i++) {
+    bench_var.insert(static_cast<int>((i * 7919) % 1000003));
+  }
+  const char *bench_case = name.c_str();
+  bench_stop(bench_case, &bench_var); // BENCH_BREAK
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1 && std::string(argv[1]) != "all") {
+    g_filter = argv[1];
+  }
+  if (argc > 2) {
+    g_max_bytes = static_cast<size_t>(std::atoll(argv[2])) << 20;
+  }
+
+  std::cout << "C++ DebugMate benchmark debuggee" << std::endl;
+  bench_mats();
+  bench_strided_mats();
+  for (int e = 3; e <= 8; e++) {
+    bench_vector(e);
+  }
+  for (int e = 4; e <= 7; e++) {
+    bench_cloud(e);
+  }
+  bench_set();
+  std::cout << "done" << std::endl;
+  return 0;
+}
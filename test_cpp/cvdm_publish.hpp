@@ -0,0 +1,236 @@
+/**
+ * C++ DebugMate - Shared-memory publish helper (header-only)
+ *
+ * Copies a buffer into a memory-mapped file that C++ DebugMate maps directly,
+ * instead of pulling every byte through the debugger's readMemory.
+ *
+ * Usage:
+ *   #include "cvdm_publish.hpp"
+ *   cvdm::publish("img_bgr", img_bgr);   // cv::Mat
+ *   cvdm::publish("cloud_f", cloud_f);   // std::vector<cv::Point3f>
+ *   cvdm::publish("vec_sin", vec_sin);   // std::vector<float>
+ *
+ * The extension matches a segment to a variable by the source data address
+ * and size recorded in the header, so publish after the last write and
+ * before the breakpoint. Segments live in $CVDM_PUBLISH_DIR, or
+ * <temp dir>/cv-debugmate when it is not set.
+ *
+ * Segment layout (little endian):
+ *   0  char     magic[4]   "CVDM" (written last, zeroed while updating)
+ *   4  uint32   version    1
+ *   8  uint32   kind       1 = cv::Mat, 2 = Point3f vector, 3 = float vector
+ *   12 int32    rows
+ *   16 int32    cols
+ *   20 int32    type       OpenCV type (CV_8UC3, CV_32FC3, ...)
+ *   24 uint64   step       bytes per row in the payload
+ *   32 uint64   srcAddress address of the source data in this process
+ *   40 uint64   dataBytes  payload size
+ *   48 uint64   sequence   incremented on every publish
+ *   56 char     reserved[8]
+ *   64          payload
+ */
+
+#ifndef CVDM_PUBLISH_HPP
+#define CVDM_PUBLISH_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cvdm {
+
+enum SegmentKind : uint32_t {
+  kSegmentMat = 1,
+  kSegmentPoint3f = 2,
+  kSegmentFloat = 3
+};
+
+#pragma pack(push, 1)
+struct SegmentHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t kind;
+  int32_t rows;
+  int32_t cols;
+  int32_t type;
+  uint64_t step;
+  uint64_t srcAddress;
+  uint64_t dataBytes;
+  uint64_t sequence;
+  char reserved[8];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader must be 64 bytes");
+
+namespace detail {
+
+inline std::string publish_dir() {
+  const char* env = std::getenv("CVDM_PUBLISH_DIR");
+  std::string dir;
+  if (env && *env) {
+    dir = env;
+  } else {
+#ifdef _WIN32
+    char buf[MAX_PATH + 1];
+    DWORD len = GetTempPathA(sizeof(buf), buf);
+    dir = (len > 0 && len <= MAX_PATH) ? std::string(buf, len) : std::string(".");
+#else
+    const char* tmp = std::getenv("TMPDIR");
+    dir = (tmp && *tmp) ? tmp : "/tmp";
+#endif
+    if (!dir.empty() && dir.back() != '/' && dir.back() != '\\') {
+      dir += '/';
+    }
+    dir += "cv-debugmate";
+  }
+#ifdef _WIN32
+  CreateDirectoryA(dir.c_str(), NULL);
+#else
+  mkdir(dir.c_str(), 0777);
+#endif
+  return dir;
+}
+
+// Map <dir>/<name>.cvdm with the given size, write header + payload, unmap.
+inline bool write_segment(const std::string& name, SegmentHeader header,
+                          const void* payload) {
+  static uint64_t sequence = 0;
+  header.sequence = ++sequence;
+
+  const std::string path = publish_dir() + "/" + name + ".cvdm";
+  const uint64_t total = sizeof(SegmentHeader) + header.dataBytes;
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) return false;
+  HANDLE mapping =
+      CreateFileMappingA(file, NULL, PAGE_READWRITE,
+                         static_cast<DWORD>(total >> 32),
+                         static_cast<DWORD>(total & 0xFFFFFFFFu), NULL);
+  if (!mapping) {
+    CloseHandle(file);
+    return false;
+  }
+  char* base = static_cast<char*>(
+      MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(total)));
+  if (!base) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+#else
+  int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return false;
+  if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+    close(fd);
+    return false;
+  }
+  void* addr = mmap(NULL, static_cast<size_t>(total), PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  char* base = static_cast<char*>(addr);
+#endif
+
+  // Invalidate first so a reader never sees a new header with old payload
+  std::memset(base, 0, sizeof(header.magic));
+  std::memcpy(base + sizeof(header.magic),
+              reinterpret_cast<const char*>(&header) + sizeof(header.magic),
+              sizeof(SegmentHeader) - sizeof(header.magic));
+  if (header.dataBytes > 0) {
+    std::memcpy(base + sizeof(SegmentHeader), payload,
+                static_cast<size_t>(header.dataBytes));
+  }
+  std::memcpy(base, "CVDM", 4);
+
+#ifdef _WIN32
+  FlushViewOfFile(base, 0);
+  UnmapViewOfFile(base);
+  CloseHandle(mapping);
+  // Shrink a segment left over from a larger publish
+  LARGE_INTEGER size;
+  size.QuadPart = static_cast<LONGLONG>(total);
+  if (SetFilePointerEx(file, size, NULL, FILE_BEGIN)) SetEndOfFile(file);
+  CloseHandle(file);
+#else
+  munmap(base, static_cast<size_t>(total));
+  close(fd);
+#endif
+  return true;
+}
+
+inline SegmentHeader make_header(SegmentKind kind, int rows, int cols,
+                                 int type, uint64_t step, const void* src,
+                                 uint64_t dataBytes) {
+  SegmentHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.version = 1;
+  header.kind = kind;
+  header.rows = rows;
+  header.cols = cols;
+  header.type = type;
+  header.step = step;
+  header.srcAddress = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(src));
+  header.dataBytes = dataBytes;
+  return header;
+}
+
+}  // namespace detail
+
+// Publish a 2D cv::Mat. Non-continuous Mats (ROIs) are packed row by row.
+inline bool publish(const std::string& name, const cv::Mat& mat) {
+  if (mat.dims > 2 || mat.empty()) return false;
+  const uint64_t rowBytes = static_cast<uint64_t>(mat.cols) * mat.elemSize();
+  SegmentHeader header = detail::make_header(
+      kSegmentMat, mat.rows, mat.cols, mat.type(), rowBytes, mat.data,
+      rowBytes * static_cast<uint64_t>(mat.rows));
+  if (mat.isContinuous()) {
+    return detail::write_segment(name, header, mat.data);
+  }
+  cv::Mat packed = mat.clone();
+  return detail::write_segment(name, header, packed.data);
+}
+
+// Publish a point cloud
+inline bool publish(const std::string& name,
+                    const std::vector<cv::Point3f>& points) {
+  const uint64_t bytes = points.size() * sizeof(cv::Point3f);
+  SegmentHeader header = detail::make_header(
+      kSegmentPoint3f, static_cast<int>(points.size()), 1, CV_32FC3,
+      sizeof(cv::Point3f), points.data(), bytes);
+  return detail::write_segment(name, header, points.data());
+}
+
+// Publish a 1D float series
+inline bool publish(const std::string& name, const std::vector<float>& values) {
+  const uint64_t bytes = values.size() * sizeof(float);
+  SegmentHeader header = detail::make_header(
+      kSegmentFloat, 1, static_cast<int>(values.size()), CV_32FC1, bytes,
+      values.data(), bytes);
+  return detail::write_segment(name, header, values.data());
+}
+
+}  // namespace cvdm
+
+#endif  // CVDM_PUBLISH_HPP
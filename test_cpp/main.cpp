@@ -19,6 +19,8 @@
  * cv::Mat*)
  *   - Multi-threaded: Variables from any thread can be visualized by selecting
  *                     the thread in the debugger
+ *   - Shared memory: cvdm::publish() (cvdm_publish.hpp) lets the extension map
+ *                    large buffers instead of reading them via the debugger
  */
 
 #include <array>
@@ -31,6 +33,8 @@
 #include <thread>
 #include <vector>
 
+#include "cvdm_publish.hpp"
+
 // PCL headers — only included when PCL is available
 #ifdef HAVE_PCL
 #include <pcl/point_cloud.h>
@@ -74,6 +78,9 @@ void demo_2d_images() {
   cv::Mat_<cv::Vec3f> mat_template_float;
   img_float.copyTo(mat_template_float);
 
+  // --- ROI view (not continuous: rows are img_bgr.step apart) ---
+  cv::Mat img_roi = img_bgr(cv::Rect(1600, 1200, 640, 480));
+
   // --- cv::Matx (fixed-size matrix) ---
   cv::Matx33f matx_3x3(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f);
   cv::Matx44d matx_4x4(1, 0, 0, 0, 0, 2, 0, 0, 0, 0, 3, 0, 0, 0, 0, 4);
@@ -177,6 +184,10 @@ void demo_2d_images() {
   std::cout << "  std_img: 100x150x3 std::array<std::array<Pixel,150>,100>"
             << std::endl;
 
+  // --- Shared-memory publish (viewed without readMemory) ---
+  cvdm::publish("img_bgr", img_bgr);
+  cvdm::publish("img_float", img_float);
+
   // ===== BREAKPOINT HERE =====
 
   int bp1 = 0; // Set breakpoint here to view all 2D images
@@ -187,6 +198,7 @@ void demo_2d_images() {
   (void)mat_template_gray;
   (void)mat_template_bgr;
   (void)mat_template_float;
+  (void)img_roi;
   (void)matx_3x3;
   (void)matx_4x4;
   (void)array_2d_int;
@@ -257,6 +269,9 @@ void demo_3d_pointcloud() {
   std::cout << "  array_cloud_f: " << array_cloud_f.size()
             << " Point3f (std::array)" << std::endl;
 
+  // --- Shared-memory publish (viewed without readMemory) ---
+  cvdm::publish("cloud_f", cloud_f);
+
   // ===== BREAKPOINT HERE =====
   int bp2 = 0; // Set breakpoint here to view all point clouds
   (void)bp2;
@@ -319,6 +334,9 @@ void demo_1d_plots() {
   std::cout << "  set_double: " << set_double.size() << " doubles" << std::endl;
   std::cout << "  mat_1d_row: 1x10 CV_32F" << std::endl;
 
+  // --- Shared-memory publish (viewed without readMemory) ---
+  cvdm::publish("vec_sin", vec_sin);
+
   // ===== BREAKPOINT HERE =====
   int bp3 = 0; // Set breakpoint here to view all 1D plots
   (void)bp3;